@@ -74,6 +74,13 @@ public class CASAuthenticationProvider extends AbstractAuthenticationProvider {
         return authProviderService.authenticateUser(credentials);
 
     }
+
+    @Override
+    public boolean isUserContextReusable() {
+        // Decoration depends only on the tokens of the authenticated user,
+        // which are part of its identity fingerprint
+        return true;
+    }
     
     @Override
     public UserContext decorate(UserContext context,
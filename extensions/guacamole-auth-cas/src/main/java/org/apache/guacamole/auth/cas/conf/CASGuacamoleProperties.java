@@ -21,6 +21,7 @@ package org.apache.guacamole.auth.cas.conf;
 
 import org.apache.guacamole.auth.cas.group.GroupFormat;
 import org.apache.guacamole.properties.EnumGuacamoleProperty;
+import org.apache.guacamole.properties.IntegerGuacamoleProperty;
 import org.apache.guacamole.properties.URIGuacamoleProperty;
 import org.apache.guacamole.properties.StringGuacamoleProperty;
 
@@ -118,4 +119,28 @@ public class CASGuacamoleProperties {
 
     };
 
+    /**
+     * The maximum number of seconds to wait for a connection to the CAS
+     * server to be established when validating a ticket.
+     */
+    public static final IntegerGuacamoleProperty CAS_CONNECT_TIMEOUT =
+            new IntegerGuacamoleProperty() {
+
+        @Override
+        public String getName() { return "cas-connect-timeout"; }
+
+    };
+
+    /**
+     * The maximum number of seconds to wait for the CAS server to respond
+     * when validating a ticket.
+     */
+    public static final IntegerGuacamoleProperty CAS_READ_TIMEOUT =
+            new IntegerGuacamoleProperty() {
+
+        @Override
+        public String getName() { return "cas-read-timeout"; }
+
+    };
+
 }
@@ -160,6 +160,37 @@ public class ConfigurationService {
         return environment.getProperty(CASGuacamoleProperties.CAS_GROUP_LDAP_ATTRIBUTE);
     }
 
+    /**
+     * Returns the maximum number of seconds to wait for a connection to the
+     * CAS server to be established when validating a ticket, as configured
+     * with guacamole.properties. By default, this will be 10.
+     *
+     * @return
+     *     The maximum number of seconds to wait for a connection to the CAS
+     *     server to be established.
+     *
+     * @throws GuacamoleException
+     *     If guacamole.properties cannot be parsed.
+     */
+    public int getConnectTimeout() throws GuacamoleException {
+        return environment.getProperty(CASGuacamoleProperties.CAS_CONNECT_TIMEOUT, 10);
+    }
+
+    /**
+     * Returns the maximum number of seconds to wait for the CAS server to
+     * respond when validating a ticket, as configured with
+     * guacamole.properties. By default, this will be 10.
+     *
+     * @return
+     *     The maximum number of seconds to wait for the CAS server to respond.
+     *
+     * @throws GuacamoleException
+     *     If guacamole.properties cannot be parsed.
+     */
+    public int getReadTimeout() throws GuacamoleException {
+        return environment.getProperty(CASGuacamoleProperties.CAS_READ_TIMEOUT, 10);
+    }
+
     /**
      * Returns a GroupParser instance that can be used to parse CAS group
      * names. The parser returned will take into account the configured CAS
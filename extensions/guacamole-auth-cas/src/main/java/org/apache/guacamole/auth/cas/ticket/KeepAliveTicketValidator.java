@@ -0,0 +1,160 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+package org.apache.guacamole.auth.cas.ticket;
+
+import java.io.ByteArrayOutputStream;
+import java.io.IOException;
+import java.io.InputStream;
+import java.net.HttpURLConnection;
+import java.net.URL;
+import org.jasig.cas.client.validation.Assertion;
+import org.jasig.cas.client.validation.Cas20ProxyTicketValidator;
+import org.jasig.cas.client.validation.TicketValidationException;
+
+/**
+ * Cas20ProxyTicketValidator which retrieves validation responses from the CAS
+ * server over persistent, reusable connections. The CAS client library
+ * explicitly disconnects after each validation request, forcing a new TCP
+ * (and TLS) connection for every ticket. This validator instead reads each
+ * response fully and closes only the response stream, allowing the JVM to
+ * return the underlying connection to its keep-alive pool for use by the
+ * next validation request. Connection and read timeouts are always applied.
+ */
+public class KeepAliveTicketValidator extends Cas20ProxyTicketValidator {
+
+    /**
+     * The size of the buffer used when reading responses from the CAS server,
+     * in bytes.
+     */
+    private static final int BUFFER_SIZE = 4096;
+
+    /**
+     * The maximum number of milliseconds to wait for a connection to the CAS
+     * server to be established.
+     */
+    private final int connectTimeout;
+
+    /**
+     * The maximum number of milliseconds to wait for data to be received
+     * from the CAS server.
+     */
+    private final int readTimeout;
+
+    /**
+     * Creates a new KeepAliveTicketValidator which validates tickets against
+     * the CAS server having the given URL.
+     *
+     * @param casServerUrlPrefix
+     *     The URL of the CAS server.
+     *
+     * @param connectTimeout
+     *     The maximum number of milliseconds to wait for a connection to the
+     *     CAS server to be established.
+     *
+     * @param readTimeout
+     *     The maximum number of milliseconds to wait for data to be received
+     *     from the CAS server.
+     */
+    public KeepAliveTicketValidator(String casServerUrlPrefix,
+            int connectTimeout, int readTimeout) {
+        super(casServerUrlPrefix);
+        this.connectTimeout = connectTimeout;
+        this.readTimeout = readTimeout;
+    }
+
+    /**
+     * Reads the entire contents of the given InputStream, closing the stream
+     * once all data has been read.
+     *
+     * @param input
+     *     The InputStream to read, or null if there is no data to read.
+     *
+     * @return
+     *     All data read from the given InputStream.
+     *
+     * @throws IOException
+     *     If an error occurs while reading from the InputStream.
+     */
+    private static byte[] readFully(InputStream input) throws IOException {
+
+        ByteArrayOutputStream output = new ByteArrayOutputStream(BUFFER_SIZE);
+        if (input == null)
+            return output.toByteArray();
+
+        try (InputStream stream = input) {
+            byte[] buffer = new byte[BUFFER_SIZE];
+            int length;
+            while ((length = stream.read(buffer)) != -1)
+                output.write(buffer, 0, length);
+        }
+
+        return output.toByteArray();
+
+    }
+
+    /**
+     * Validates the given ticket against the CAS server, using a pooled
+     * connection to the CAS server if one is available. This function is
+     * otherwise identical to {@link #validate(java.lang.String, java.lang.String)}.
+     *
+     * @param ticket
+     *     The ticket to validate.
+     *
+     * @param service
+     *     The URL of the service the ticket was issued for.
+     *
+     * @return
+     *     The assertion produced by the CAS server for the given ticket.
+     *
+     * @throws TicketValidationException
+     *     If the ticket is not valid, or the CAS server cannot be contacted.
+     */
+    public Assertion validateTicket(String ticket, String service)
+            throws TicketValidationException {
+
+        String response;
+        try {
+
+            URL url = new URL(constructValidationUrl(ticket, service));
+            HttpURLConnection connection = (HttpURLConnection) url.openConnection();
+            connection.setConnectTimeout(connectTimeout);
+            connection.setReadTimeout(readTimeout);
+
+            // Always consume the response body, even for errors, such that
+            // the connection remains reusable
+            int status = connection.getResponseCode();
+            if (status != HttpURLConnection.HTTP_OK) {
+                readFully(connection.getErrorStream());
+                throw new TicketValidationException("CAS server responded to "
+                        + "ticket validation request with HTTP status " + status + ".");
+            }
+
+            response = new String(readFully(connection.getInputStream()), getEncoding());
+
+        }
+        catch (IOException e) {
+            throw new TicketValidationException("Unable to contact CAS server.", e);
+        }
+
+        return parseResponseFromServer(response);
+
+    }
+
+}
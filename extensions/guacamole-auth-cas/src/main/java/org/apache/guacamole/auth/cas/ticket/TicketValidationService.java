@@ -22,6 +22,7 @@ package org.apache.guacamole.auth.cas.ticket;
 import com.google.common.io.BaseEncoding;
 import com.google.inject.Inject;
 import com.google.inject.Provider;
+import com.google.inject.Singleton;
 import java.net.URI;
 import java.security.InvalidKeyException;
 import java.security.NoSuchAlgorithmException;
@@ -41,20 +42,23 @@ import org.apache.guacamole.GuacamoleException;
 import org.apache.guacamole.GuacamoleSecurityException;
 import org.apache.guacamole.GuacamoleServerException;
 import org.apache.guacamole.auth.cas.conf.ConfigurationService;
+import org.apache.guacamole.auth.cas.group.GroupParser;
 import org.apache.guacamole.auth.cas.user.CASAuthenticatedUser;
 import org.apache.guacamole.net.auth.Credentials;
 import org.apache.guacamole.token.TokenName;
 import org.jasig.cas.client.authentication.AttributePrincipal;
 import org.jasig.cas.client.validation.Assertion;
-import org.jasig.cas.client.validation.Cas20ProxyTicketValidator;
 import org.jasig.cas.client.validation.TicketValidationException;
 import org.slf4j.Logger;
 import org.slf4j.LoggerFactory;
 
 /**
  * Service for validating ID tickets forwarded to us by the client, verifying
- * that they did indeed come from the CAS service.
+ * that they did indeed come from the CAS service. As CAS tickets are
+ * single-use, every ticket is validated against the CAS server, and the
+ * results of validation are never remembered.
  */
+@Singleton
 public class TicketValidationService {
 
     /**
@@ -79,6 +83,69 @@ public class TicketValidationService {
     @Inject
     private Provider<CASAuthenticatedUser> authenticatedUserProvider;
 
+    /**
+     * The validator used to validate tickets against the CAS server, or null
+     * if no ticket has yet been validated.
+     */
+    private KeepAliveTicketValidator validator;
+
+    /**
+     * The parser used to parse the names of the groups that users are
+     * members of, or null if no ticket has yet been validated.
+     */
+    private GroupParser groupParser;
+
+    /**
+     * Returns the validator which should be used to validate tickets against
+     * the CAS server, creating that validator and the parser for group names
+     * if they have not yet been created.
+     *
+     * @return
+     *     The validator which should be used to validate tickets.
+     *
+     * @throws GuacamoleException
+     *     If guacamole.properties cannot be parsed, or if the CAS
+     *     authorization endpoint is not configured.
+     */
+    private synchronized KeepAliveTicketValidator getValidator()
+            throws GuacamoleException {
+
+        if (validator == null) {
+
+            // Create a ticket validator that uses the configured CAS URL
+            URI casServerUrl = confService.getAuthorizationEndpoint();
+            KeepAliveTicketValidator newValidator = new KeepAliveTicketValidator(
+                    casServerUrl.toString(),
+                    confService.getConnectTimeout() * 1000,
+                    confService.getReadTimeout() * 1000);
+            newValidator.setAcceptAnyProxy(true);
+            newValidator.setEncoding("UTF-8");
+
+            groupParser = confService.getGroupParser();
+            validator = newValidator;
+
+        }
+
+        return validator;
+
+    }
+
+    /**
+     * Returns the parser which should be used to parse the names of the
+     * groups that users are members of.
+     *
+     * @return
+     *     The parser which should be used to parse group names.
+     *
+     * @throws GuacamoleException
+     *     If guacamole.properties cannot be parsed.
+     */
+    private synchronized GroupParser getGroupParser()
+            throws GuacamoleException {
+        getValidator();
+        return groupParser;
+    }
+
     /**
      * Converts the given CAS attribute value object (whose type is variable)
      * to a Set of String values. If the value is already a Collection of some
@@ -135,17 +202,11 @@ public class TicketValidationService {
     public CASAuthenticatedUser validateTicket(String ticket,
             Credentials credentials) throws GuacamoleException {
 
-        // Create a ticket validator that uses the configured CAS URL
-        URI casServerUrl = confService.getAuthorizationEndpoint();
-        Cas20ProxyTicketValidator validator = new Cas20ProxyTicketValidator(casServerUrl.toString());
-        validator.setAcceptAnyProxy(true);
-        validator.setEncoding("UTF-8");
-
         // Attempt to validate the supplied ticket
         Assertion assertion;
         try {
             URI confRedirectURI = confService.getRedirectURI();
-            assertion = validator.validate(ticket, confRedirectURI.toString());
+            assertion = getValidator().validateTicket(ticket, confRedirectURI.toString());
         }
         catch (TicketValidationException e) {
             throw new GuacamoleException("Ticket validation failed.", e);
@@ -179,7 +240,7 @@ public class TicketValidationService {
         String groupAttribute = confService.getGroupAttribute();
         if (groupAttribute != null) {
             effectiveGroups = toStringSet(ticketAttrs.get(groupAttribute)).stream()
-                    .map(confService.getGroupParser()::parse)
+                    .map(getGroupParser()::parse)
                     .collect(Collectors.toSet());
         }
 
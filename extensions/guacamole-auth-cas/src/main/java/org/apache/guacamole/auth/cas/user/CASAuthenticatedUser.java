@@ -26,6 +26,7 @@ import java.util.Set;
 import org.apache.guacamole.net.auth.AbstractAuthenticatedUser;
 import org.apache.guacamole.net.auth.AuthenticationProvider;
 import org.apache.guacamole.net.auth.Credentials;
+import org.apache.guacamole.net.auth.IdentityFingerprint;
 
 /**
  * An CAS-specific implementation of AuthenticatedUser, associating a
@@ -119,4 +120,10 @@ public class CASAuthenticatedUser extends AbstractAuthenticatedUser {
         return effectiveGroups;
     }
 
+    @Override
+    public String getIdentityFingerprint() {
+        return IdentityFingerprint.generate(getIdentifier(),
+                getEffectiveUserGroups(), getCredentials(), getTokens());
+    }
+
 }
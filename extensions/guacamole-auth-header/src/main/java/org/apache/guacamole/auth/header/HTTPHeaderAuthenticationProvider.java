@@ -72,4 +72,10 @@ public class HTTPHeaderAuthenticationProvider extends AbstractAuthenticationProv
 
     }
 
+    @Override
+    public boolean isUserContextReusable() {
+        // No UserContexts are provided, and no decoration is applied
+        return true;
+    }
+
 }
@@ -23,6 +23,7 @@ import com.google.inject.Inject;
 import org.apache.guacamole.net.auth.AbstractAuthenticatedUser;
 import org.apache.guacamole.net.auth.AuthenticationProvider;
 import org.apache.guacamole.net.auth.Credentials;
+import org.apache.guacamole.net.auth.IdentityFingerprint;
 
 /**
  * An HTTP header implementation of AuthenticatedUser, associating a
@@ -68,4 +69,9 @@ public class AuthenticatedUser extends AbstractAuthenticatedUser {
         return credentials;
     }
 
+    @Override
+    public String getIdentityFingerprint() {
+        return IdentityFingerprint.generate(this);
+    }
+
 }
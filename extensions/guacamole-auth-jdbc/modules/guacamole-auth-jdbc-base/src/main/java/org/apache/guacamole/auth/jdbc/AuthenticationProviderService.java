@@ -110,4 +110,15 @@ public interface AuthenticationProviderService  {
             UserContext context, AuthenticatedUser authenticatedUser,
             Credentials credentials) throws GuacamoleException;
 
+    /**
+     * Returns whether the UserContexts produced by this service depend only
+     * on the identity of the user, such that they may be reused without
+     * invoking updateUserContext() while that identity is unchanged.
+     *
+     * @return
+     *     true if the UserContexts produced by this service may be reused
+     *     while the identity of the user is unchanged, false otherwise.
+     */
+    public boolean isUserContextReusable();
+
 }
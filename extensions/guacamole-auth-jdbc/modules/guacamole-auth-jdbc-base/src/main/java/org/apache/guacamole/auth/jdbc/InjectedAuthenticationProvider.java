@@ -90,4 +90,9 @@ public abstract class InjectedAuthenticationProvider extends AbstractAuthenticat
                 authenticatedUser, credentials);
     }
 
+    @Override
+    public boolean isUserContextReusable() {
+        return authProviderService.isUserContextReusable();
+    }
+
 }
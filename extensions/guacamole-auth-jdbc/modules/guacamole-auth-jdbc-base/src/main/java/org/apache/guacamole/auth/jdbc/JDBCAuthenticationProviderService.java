@@ -162,4 +162,12 @@ public class JDBCAuthenticationProviderService implements AuthenticationProvider
 
     }
 
+    @Override
+    public boolean isUserContextReusable() {
+
+        // Contexts are never updated, thus reuse is always equivalent
+        return true;
+
+    }
+
 }
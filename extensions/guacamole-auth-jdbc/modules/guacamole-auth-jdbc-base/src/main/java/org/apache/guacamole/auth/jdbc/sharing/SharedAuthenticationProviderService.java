@@ -109,4 +109,13 @@ public class SharedAuthenticationProviderService implements AuthenticationProvid
 
     }
 
+    @Override
+    public boolean isUserContextReusable() {
+
+        // Share keys are provided through request parameters rather than a
+        // change in identity, thus contexts must always be updated
+        return false;
+
+    }
+
 }
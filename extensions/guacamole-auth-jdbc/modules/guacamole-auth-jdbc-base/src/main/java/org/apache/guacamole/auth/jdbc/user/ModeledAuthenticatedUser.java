@@ -27,6 +27,7 @@ import org.apache.guacamole.GuacamoleException;
 import org.apache.guacamole.net.auth.AuthenticatedUser;
 import org.apache.guacamole.net.auth.AuthenticationProvider;
 import org.apache.guacamole.net.auth.Credentials;
+import org.apache.guacamole.net.auth.IdentityFingerprint;
 
 /**
  * Associates a user with the credentials they used to authenticate, their
@@ -177,6 +178,11 @@ public class ModeledAuthenticatedUser extends RemoteAuthenticatedUser {
                 super.getEffectiveUserGroups());
     }
 
+    @Override
+    public String getIdentityFingerprint() {
+        return IdentityFingerprint.generate(this);
+    }
+
     /**
      * Returns whether this user is effectively unrestricted by permissions,
      * such as a system administrator or an internal user operating via a
@@ -19,6 +19,7 @@
 
 package org.apache.guacamole.auth.json;
 
+import com.google.inject.Singleton;
 import java.security.InvalidAlgorithmParameterException;
 import java.security.InvalidKeyException;
 import java.security.Key;
@@ -36,8 +37,10 @@ import org.apache.guacamole.GuacamoleServerException;
 
 /**
  * Service for handling cryptography-related operations, such as decrypting
- * encrypted data.
+ * encrypted data. The underlying Cipher and Mac instances are created once
+ * per thread and reused, being reinitialized only if the key changes.
  */
+@Singleton
 public class CryptoService {
 
     /**
@@ -78,6 +81,54 @@ public class CryptoService {
         0, 0, 0, 0, 0, 0, 0, 0
     });
 
+    /**
+     * A cryptographic primitive (Cipher or Mac) which has been initialized
+     * with a specific key, and can thus be reused without reinitialization
+     * for as long as that same key is used.
+     *
+     * @param <T>
+     *     The type of the cryptographic primitive.
+     */
+    private static class InitializedPrimitive<T> {
+
+        /**
+         * The cryptographic primitive.
+         */
+        private final T primitive;
+
+        /**
+         * The key that the primitive was most recently initialized with, or
+         * null if the primitive has not yet been initialized.
+         */
+        private Key key;
+
+        /**
+         * Creates a new InitializedPrimitive wrapping the given, not yet
+         * initialized, cryptographic primitive.
+         *
+         * @param primitive
+         *     The cryptographic primitive to wrap.
+         */
+        public InitializedPrimitive(T primitive) {
+            this.primitive = primitive;
+        }
+
+    }
+
+    /**
+     * The Cipher used by decrypt() within the current thread, or null if no
+     * such Cipher has yet been created.
+     */
+    private final ThreadLocal<InitializedPrimitive<Cipher>> decryptionCipher =
+            new ThreadLocal<>();
+
+    /**
+     * The Mac used by sign() within the current thread, or null if no such
+     * Mac has yet been created.
+     */
+    private final ThreadLocal<InitializedPrimitive<Mac>> signatureMac =
+            new ThreadLocal<>();
+
     /**
      * Creates a new key suitable for decryption using the provided raw key
      * bytes. The algorithm used to generate this key is dictated by
@@ -137,12 +188,23 @@ public class CryptoService {
 
         try {
 
-            // Init cipher for descryption using secret key
-            Cipher cipher = Cipher.getInstance(DECRYPTION_CIPHER_NAME);
-            cipher.init(Cipher.DECRYPT_MODE, key, NULL_IV);
+            // Reuse this thread's cipher, if any
+            InitializedPrimitive<Cipher> cipher = decryptionCipher.get();
+            if (cipher == null) {
+                cipher = new InitializedPrimitive<>(Cipher.getInstance(DECRYPTION_CIPHER_NAME));
+                decryptionCipher.set(cipher);
+            }
+
+            // Init cipher for decryption using secret key only if not already
+            // initialized with that key (doFinal() restores the cipher to its
+            // initialized state)
+            if (!key.equals(cipher.key)) {
+                cipher.primitive.init(Cipher.DECRYPT_MODE, key, NULL_IV);
+                cipher.key = key;
+            }
 
             // Perform decryption
-            return cipher.doFinal(cipherText);
+            return cipher.primitive.doFinal(cipherText);
 
         }
 
@@ -153,7 +215,11 @@ public class CryptoService {
                 | InvalidKeyException
                 | IllegalBlockSizeException
                 | BadPaddingException e) {
+
+            // Do not reuse a cipher which may be in an inconsistent state
+            decryptionCipher.remove();
             throw new GuacamoleServerException(e);
+
         }
 
     }
@@ -180,18 +246,33 @@ public class CryptoService {
 
         try {
 
-            // Init MAC for signing using secret key
-            Mac mac = Mac.getInstance(SIGNATURE_MAC_ALGORITHM_NAME);
-            mac.init(key);
+            // Reuse this thread's MAC, if any
+            InitializedPrimitive<Mac> mac = signatureMac.get();
+            if (mac == null) {
+                mac = new InitializedPrimitive<>(Mac.getInstance(SIGNATURE_MAC_ALGORITHM_NAME));
+                signatureMac.set(mac);
+            }
+
+            // Init MAC for signing using secret key only if not already
+            // initialized with that key (doFinal() resets the MAC for reuse
+            // with the same key)
+            if (!key.equals(mac.key)) {
+                mac.primitive.init(key);
+                mac.key = key;
+            }
 
             // Sign provided data
-            return mac.doFinal(data);
+            return mac.primitive.doFinal(data);
 
         }
 
         // Rethrow all signature failures identically
         catch (NoSuchAlgorithmException | InvalidKeyException | IllegalStateException e) {
+
+            // Do not reuse a MAC which may be in an inconsistent state
+            signatureMac.remove();
             throw new GuacamoleServerException(e);
+
         }
 
     }
@@ -20,10 +20,7 @@
 package org.apache.guacamole.auth.json.user;
 
 import com.google.common.io.BaseEncoding;
-import java.util.Iterator;
-import java.util.Map;
-import java.util.concurrent.ConcurrentHashMap;
-import java.util.concurrent.ConcurrentMap;
+import org.apache.guacamole.cache.ExpiringSet;
 import org.slf4j.Logger;
 import org.slf4j.LoggerFactory;
 
@@ -41,30 +38,20 @@ public class UserDataDenylist {
     private static final Logger logger = LoggerFactory.getLogger(UserDataDenylist.class);
 
     /**
-     * All denylisted UserData objects, stored by their associated
-     * cryptographic signatures. NOTE: Each key into this map is the hex
-     * string produced by encoding the binary signature using DatatypeConverter.
-     * A byte[] cannot be used directly.
+     * The cryptographic signatures of all denylisted UserData objects, each
+     * expiring along with its associated UserData. NOTE: Each member of this
+     * set is the hex string produced by encoding the binary signature using
+     * BaseEncoding. A byte[] cannot be used directly.
      */
-    private final ConcurrentMap<String, UserData> denylist = new ConcurrentHashMap<>();
+    private final ExpiringSet<String> denylist = new ExpiringSet<>();
 
     /**
      * Removes all expired UserData objects from the denylist. This will
-     * automatically be invoked whenever new UserData is added to the denylist.
+     * automatically be invoked whenever new UserData is added to the denylist,
+     * and visits only those entries which have actually expired.
      */
     public void removeExpired() {
-
-        // Remove expired data from denylist
-        Iterator<Map.Entry<String, UserData>> current = denylist.entrySet().iterator();
-        while (current.hasNext()) {
-
-            // Remove entry from map if its associated with expired data
-            Map.Entry<String, UserData> entry = current.next();
-            if (entry.getValue().isExpired())
-                current.remove();
-            
-        }
-
+        denylist.removeExpired();
     }
 
     /**
@@ -93,16 +80,14 @@ public class UserDataDenylist {
             return false;
         }
 
-        // Remove any expired entries
-        removeExpired();
-
         // Expired user data is implicitly denylisted
         if (data.isExpired())
             return false;
 
-        // Add to denylist only if not already present
+        // Add to denylist only if not already present (expired entries are
+        // removed automatically)
         String signatureHex = BaseEncoding.base16().encode(signature);
-        return denylist.putIfAbsent(signatureHex, data) == null;
+        return denylist.add(signatureHex, data.getExpires());
 
     }
 
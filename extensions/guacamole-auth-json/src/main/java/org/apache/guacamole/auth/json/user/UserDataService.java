@@ -31,11 +31,13 @@ import java.util.Collections;
 import java.util.HashMap;
 import java.util.Map;
 import java.util.Set;
+import javax.crypto.SecretKey;
 import javax.servlet.http.HttpServletRequest;
 import org.apache.guacamole.GuacamoleException;
 import org.apache.guacamole.auth.json.ConfigurationService;
 import org.apache.guacamole.auth.json.CryptoService;
 import org.apache.guacamole.auth.json.RequestValidationService;
+import org.apache.guacamole.cache.ExpiringMap;
 import org.apache.guacamole.net.auth.Connection;
 import org.apache.guacamole.net.auth.Credentials;
 import org.apache.guacamole.net.auth.Directory;
@@ -68,6 +70,51 @@ public class UserDataService {
      */
     private final UserDataDenylist denylist = new UserDataDenylist();
 
+    /**
+     * The maximum number of previously-validated UserData objects which may
+     * be cached at any one time.
+     */
+    private static final int MAX_CACHED_USER_DATA = 10000;
+
+    /**
+     * The maximum amount of time that a previously-validated UserData object
+     * may be cached, in milliseconds, regardless of its own expiration
+     * timestamp.
+     */
+    private static final long MAX_USER_DATA_CACHE_AGE = 300000;
+
+    /**
+     * The decrypted JSON of previously-validated, reusable UserData, stored
+     * by the exact encrypted, base64-encoded data from which that JSON was
+     * derived. As that data is encrypted and signed using the secret key, an
+     * exact match can only be data which has already been decrypted and
+     * verified with the current key. Each entry expires no later than its
+     * UserData. Only the JSON is cached, such that each use of the data
+     * receives its own UserData object. Data which is single-use, or which
+     * contains any single-use connections, is never cached. All entries are
+     * removed whenever the secret key changes.
+     */
+    private final ExpiringMap<String, String> validatedData =
+            new ExpiringMap<>(MAX_CACHED_USER_DATA);
+
+    /**
+     * The raw bytes of the secret key from which encryptionKey and
+     * signatureKey were derived, or null if those keys have not yet been
+     * derived.
+     */
+    private byte[] secretKey;
+
+    /**
+     * The key used to decrypt received data, derived from secretKey.
+     */
+    private SecretKey encryptionKey;
+
+    /**
+     * The key used to verify the signatures of received data, derived from
+     * secretKey.
+     */
+    private SecretKey signatureKey;
+
     /**
      * Service for retrieving configuration information regarding the
      * JSONAuthenticationProvider.
@@ -102,6 +149,63 @@ public class UserDataService {
      */
     public static final String ENCRYPTED_DATA_PARAMETER = "data";
 
+    /**
+     * Derives the encryption and signature keys from the configured secret
+     * key, if not already derived from that same secret key.
+     *
+     * @throws GuacamoleException
+     *     If guacamole.properties cannot be parsed, or if the secret key is
+     *     missing.
+     */
+    private synchronized void deriveKeys() throws GuacamoleException {
+
+        byte[] currentSecretKey = confService.getSecretKey();
+        if (Arrays.equals(secretKey, currentSecretKey))
+            return;
+
+        encryptionKey = cryptoService.createEncryptionKey(currentSecretKey);
+        signatureKey = cryptoService.createSignatureKey(currentSecretKey);
+        secretKey = currentSecretKey;
+
+        // Data validated with any previous key must be validated again
+        validatedData.clear();
+
+    }
+
+    /**
+     * Returns the key which should be used to decrypt received data, deriving
+     * that key from the configured secret key if necessary.
+     *
+     * @return
+     *     The key which should be used to decrypt received data.
+     *
+     * @throws GuacamoleException
+     *     If guacamole.properties cannot be parsed, or if the secret key is
+     *     missing.
+     */
+    private synchronized SecretKey getEncryptionKey() throws GuacamoleException {
+        deriveKeys();
+        return encryptionKey;
+    }
+
+    /**
+     * Returns the key which should be used to verify the signatures of
+     * received data, deriving that key from the configured secret key if
+     * necessary.
+     *
+     * @return
+     *     The key which should be used to verify the signatures of received
+     *     data.
+     *
+     * @throws GuacamoleException
+     *     If guacamole.properties cannot be parsed, or if the secret key is
+     *     missing.
+     */
+    private synchronized SecretKey getSignatureKey() throws GuacamoleException {
+        deriveKeys();
+        return signatureKey;
+    }
+
     /**
      * Derives a new UserData object from the data contained within the given
      * Credentials. If no such data is present, or the data present is invalid,
@@ -139,9 +243,16 @@ public class UserDataService {
         // Decrypt base64-encoded parameter
         try {
 
+            // Skip decryption entirely if this exact data has already been
+            // validated using the current key (only reusable data is cached)
+            deriveKeys();
+            String cachedJSON = validatedData.get(base64);
+            if (cachedJSON != null)
+                return parseUserData(cachedJSON, null, null);
+
             // Decrypt using defined encryption key
             byte[] decrypted = cryptoService.decrypt(
-                cryptoService.createEncryptionKey(confService.getSecretKey()),
+                getEncryptionKey(),
                 BaseEncoding.base64().decode(base64)
             );
 
@@ -157,7 +268,7 @@ public class UserDataService {
 
             // Produce signature for decrypted data
             correctSignature = cryptoService.sign(
-                cryptoService.createSignatureKey(confService.getSecretKey()),
+                getSignatureKey(),
                 receivedJSON
             );
 
@@ -193,6 +304,60 @@ public class UserDataService {
             return null;
         }
 
+        return parseUserData(json, base64, correctSignature);
+
+    }
+
+    /**
+     * Returns whether the given UserData contains any single-use connections.
+     * Using such a connection removes it from the UserData.
+     *
+     * @param userData
+     *     The UserData to test.
+     *
+     * @return
+     *     true if the given UserData contains at least one single-use
+     *     connection, false otherwise.
+     */
+    private boolean hasSingleUseConnections(UserData userData) {
+
+        Map<String, UserData.Connection> connections = userData.getConnections();
+        if (connections == null)
+            return false;
+
+        for (UserData.Connection connection : connections.values()) {
+            if (connection.isSingleUse())
+                return true;
+        }
+
+        return false;
+
+    }
+
+    /**
+     * Deserializes a new UserData object from the given JSON, which must
+     * already have been decrypted and its signature verified. If the JSON was
+     * freshly decrypted, the data is checked against the denylist if
+     * single-use, or cached for later reuse otherwise.
+     *
+     * @param json
+     *     The decrypted and verified JSON to deserialize.
+     *
+     * @param base64
+     *     The encrypted, base64-encoded data from which the JSON was freshly
+     *     decrypted, or null if the JSON was retrieved from the cache.
+     *
+     * @param signature
+     *     The verified signature of the JSON, or null if the JSON was
+     *     retrieved from the cache.
+     *
+     * @return
+     *     A new UserData object deserialized from the given JSON, or null if
+     *     the JSON is invalid, the data has expired, or the data is
+     *     single-use and has already been used.
+     */
+    private UserData parseUserData(String json, String base64, byte[] signature) {
+
         // Deserialize UserData from submitted JSON data
         try {
 
@@ -201,9 +366,27 @@ public class UserDataService {
             if (userData.isExpired())
                 return null;
 
+            // Data retrieved from the cache has already been checked
+            if (base64 == null)
+                return userData;
+
             // Reject if data is single-use and already present in the denylist
-            if (userData.isSingleUse() && !denylist.add(userData, correctSignature))
-                return null;
+            if (userData.isSingleUse()) {
+                if (!denylist.add(userData, signature))
+                    return null;
+            }
+
+            // Cache reusable data such that further presentations of the
+            // same data within its lifetime need not be decrypted (data with
+            // single-use connections is modified as those connections are
+            // used, and so must always be derived afresh)
+            else if (!hasSingleUseConnections(userData)) {
+                long expires = System.currentTimeMillis() + MAX_USER_DATA_CACHE_AGE;
+                Long dataExpires = userData.getExpires();
+                if (dataExpires != null)
+                    expires = Math.min(expires, dataExpires);
+                validatedData.putIfAbsent(base64, json, expires);
+            }
 
             return userData;
 
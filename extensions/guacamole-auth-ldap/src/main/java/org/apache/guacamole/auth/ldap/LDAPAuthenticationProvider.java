@@ -102,4 +102,14 @@ public class LDAPAuthenticationProvider extends AbstractAuthenticationProvider {
 
     }
 
+    @Override
+    public boolean isUserContextReusable() {
+
+        // Both the LDAP UserContext and the tokens applied via decoration are
+        // derived only from the credentials, groups and tokens covered by the
+        // identity fingerprint of LDAPAuthenticatedUser
+        return true;
+
+    }
+
 }
@@ -27,6 +27,7 @@ import org.apache.directory.api.ldap.model.name.Dn;
 import org.apache.guacamole.net.auth.AbstractAuthenticatedUser;
 import org.apache.guacamole.net.auth.AuthenticationProvider;
 import org.apache.guacamole.net.auth.Credentials;
+import org.apache.guacamole.net.auth.IdentityFingerprint;
 
 /**
  * An LDAP-specific implementation of AuthenticatedUser, associating a
@@ -129,4 +130,10 @@ public class LDAPAuthenticatedUser extends AbstractAuthenticatedUser {
         return effectiveGroups;
     }
 
+    @Override
+    public String getIdentityFingerprint() {
+        return IdentityFingerprint.generate(getIdentifier(), effectiveGroups,
+                credentials, tokens);
+    }
+
 }
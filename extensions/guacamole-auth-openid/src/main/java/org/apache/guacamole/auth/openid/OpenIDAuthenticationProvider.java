@@ -22,6 +22,7 @@ package org.apache.guacamole.auth.openid;
 import com.google.inject.Guice;
 import com.google.inject.Injector;
 import org.apache.guacamole.GuacamoleException;
+import org.apache.guacamole.auth.openid.token.TokenValidationService;
 import org.apache.guacamole.net.auth.AbstractAuthenticationProvider;
 import org.apache.guacamole.net.auth.AuthenticatedUser;
 import org.apache.guacamole.net.auth.Credentials;
@@ -72,4 +73,15 @@ public class OpenIDAuthenticationProvider extends AbstractAuthenticationProvider
 
     }
 
+    @Override
+    public boolean isUserContextReusable() {
+        // No UserContexts are provided, and no decoration is applied
+        return true;
+    }
+
+    @Override
+    public void shutdown() {
+        injector.getInstance(TokenValidationService.class).shutdown();
+    }
+
 }
@@ -68,6 +68,19 @@ public class ConfigurationService {
      */
     private static final int DEFAULT_MAX_NONCE_VALIDITY = 10;
 
+    /**
+     * The default amount of time that the contents of the JWKS endpoint
+     * should be cached if the endpoint does not specify a lifetime via the
+     * "Cache-Control" header, in seconds.
+     */
+    private static final int DEFAULT_JWKS_CACHE_DURATION = 3600;
+
+    /**
+     * The default minimum amount of time between refreshes of the JWKS
+     * triggered by tokens signed with unknown keys, in seconds.
+     */
+    private static final int DEFAULT_JWKS_MIN_REFRESH_INTERVAL = 30;
+
     /**
      * The authorization endpoint (URI) of the OpenID service.
      */
@@ -176,6 +189,33 @@ public class ConfigurationService {
 
     };
 
+    /**
+     * The amount of time that the contents of the JWKS endpoint should be
+     * cached if the endpoint does not specify a lifetime via the
+     * "Cache-Control" header, in seconds.
+     */
+    private static final IntegerGuacamoleProperty OPENID_JWKS_CACHE_DURATION =
+            new IntegerGuacamoleProperty() {
+
+        @Override
+        public String getName() { return "openid-jwks-cache-duration"; }
+
+    };
+
+    /**
+     * The minimum amount of time between refreshes of the JWKS triggered by
+     * tokens signed with keys that are not present in the cached JWKS, in
+     * seconds. This limits the rate at which tokens signed with unknown keys
+     * can result in requests to the OpenID service.
+     */
+    private static final IntegerGuacamoleProperty OPENID_JWKS_MIN_REFRESH_INTERVAL =
+            new IntegerGuacamoleProperty() {
+
+        @Override
+        public String getName() { return "openid-jwks-min-refresh-interval"; }
+
+    };
+
     /**
      * OpenID client ID which should be submitted to the OpenID service when
      * necessary. This value is typically provided by the OpenID service when
@@ -395,4 +435,37 @@ public class ConfigurationService {
         return environment.getProperty(OPENID_MAX_NONCE_VALIDITY, DEFAULT_MAX_NONCE_VALIDITY);
     }
 
+    /**
+     * Returns the amount of time that the contents of the JWKS endpoint should
+     * be cached if the endpoint does not specify a lifetime via the
+     * "Cache-Control" header, in seconds. By default, this will be 3600 (1
+     * hour).
+     *
+     * @return
+     *     The amount of time that the contents of the JWKS endpoint should be
+     *     cached by default, in seconds.
+     *
+     * @throws GuacamoleException
+     *     If guacamole.properties cannot be parsed.
+     */
+    public int getJWKSCacheDuration() throws GuacamoleException {
+        return environment.getProperty(OPENID_JWKS_CACHE_DURATION, DEFAULT_JWKS_CACHE_DURATION);
+    }
+
+    /**
+     * Returns the minimum amount of time between refreshes of the JWKS
+     * triggered by tokens signed with keys that are not present in the cached
+     * JWKS, in seconds. By default, this will be 30.
+     *
+     * @return
+     *     The minimum amount of time between refreshes of the JWKS triggered
+     *     by unknown keys, in seconds.
+     *
+     * @throws GuacamoleException
+     *     If guacamole.properties cannot be parsed.
+     */
+    public int getJWKSMinRefreshInterval() throws GuacamoleException {
+        return environment.getProperty(OPENID_JWKS_MIN_REFRESH_INTERVAL, DEFAULT_JWKS_MIN_REFRESH_INTERVAL);
+    }
+
 }
@@ -0,0 +1,334 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+package org.apache.guacamole.auth.openid.token;
+
+import java.io.IOException;
+import java.security.Key;
+import java.util.List;
+import java.util.concurrent.Executors;
+import java.util.concurrent.ScheduledExecutorService;
+import java.util.concurrent.ScheduledFuture;
+import java.util.concurrent.ThreadFactory;
+import java.util.concurrent.TimeUnit;
+import java.util.concurrent.atomic.AtomicLong;
+import org.jose4j.http.Get;
+import org.jose4j.http.SimpleGet;
+import org.jose4j.http.SimpleResponse;
+import org.jose4j.jwk.HttpsJwks;
+import org.jose4j.jwk.JsonWebKey;
+import org.jose4j.jwk.VerificationJwkSelector;
+import org.jose4j.jws.JsonWebSignature;
+import org.jose4j.jwx.JsonWebStructure;
+import org.jose4j.keys.resolvers.VerificationKeyResolver;
+import org.jose4j.lang.JoseException;
+import org.jose4j.lang.UnresolvableKeyException;
+import org.slf4j.Logger;
+import org.slf4j.LoggerFactory;
+
+/**
+ * VerificationKeyResolver which resolves JWT signature verification keys
+ * against a long-lived, shared cache of the keys published at an OpenID
+ * provider's JWKS endpoint. The cache honors the lifetime advertised by the
+ * "Cache-Control" header of the JWKS response and is refreshed in the
+ * background before that lifetime elapses, such that validating a token does
+ * not normally require any request to the OpenID provider. If a token is
+ * signed with a key that is not present in the cache (as may happen when the
+ * provider rotates its keys), the cache is refreshed immediately, subject to
+ * a minimum interval between such refreshes.
+ */
+public class CachedJWKSKeyResolver implements VerificationKeyResolver {
+
+    /**
+     * Logger for this class.
+     */
+    private static final Logger logger = LoggerFactory.getLogger(CachedJWKSKeyResolver.class);
+
+    /**
+     * The fraction of the JWKS cache lifetime which should elapse before the
+     * cache is proactively refreshed in the background.
+     */
+    private static final double BACKGROUND_REFRESH_FACTOR = 0.75;
+
+    /**
+     * The number of milliseconds to wait before retrying a background refresh
+     * which has failed.
+     */
+    private static final long REFRESH_RETRY_DELAY = 30000;
+
+    /**
+     * The maximum number of milliseconds to wait for the connection to the
+     * JWKS endpoint to be established, or for data to be read from that
+     * connection.
+     */
+    private static final int HTTP_TIMEOUT = 10000;
+
+    /**
+     * The jose4j JWKS cache which retrieves and stores the keys published at
+     * the JWKS endpoint.
+     */
+    private final HttpsJwks jwks;
+
+    /**
+     * The number of seconds that the contents of the JWKS endpoint should be
+     * cached if the endpoint does not specify a lifetime via "Cache-Control".
+     */
+    private final long defaultCacheDuration;
+
+    /**
+     * The minimum number of milliseconds which must elapse between refreshes
+     * of the cache which are triggered by an unknown key ID.
+     */
+    private final long minRefreshInterval;
+
+    /**
+     * The timestamp of the most recent refresh triggered by an unknown key
+     * ID, or zero if no such refresh has occurred.
+     */
+    private final AtomicLong lastForcedRefresh = new AtomicLong(0);
+
+    /**
+     * Executor which performs proactive, background refreshes of the cache.
+     */
+    private final ScheduledExecutorService executor =
+            Executors.newSingleThreadScheduledExecutor(new ThreadFactory() {
+
+        @Override
+        public Thread newThread(Runnable runnable) {
+            Thread thread = new Thread(runnable, "openid-jwks-refresh");
+            thread.setDaemon(true);
+            return thread;
+        }
+
+    });
+
+    /**
+     * The next scheduled background refresh, or null if no refresh is
+     * currently scheduled.
+     */
+    private ScheduledFuture<?> scheduledRefresh;
+
+    /**
+     * HTTP client which retrieves the contents of the JWKS endpoint on behalf
+     * of the jose4j JWKS cache, scheduling the next background refresh based
+     * on each response received.
+     */
+    private class RefreshSchedulingGet implements SimpleGet {
+
+        /**
+         * The underlying HTTP client.
+         */
+        private final Get get = new Get();
+
+        /**
+         * Creates a new RefreshSchedulingGet which applies the standard
+         * connection and read timeouts.
+         */
+        public RefreshSchedulingGet() {
+            get.setConnectTimeout(HTTP_TIMEOUT);
+            get.setReadTimeout(HTTP_TIMEOUT);
+        }
+
+        @Override
+        public SimpleResponse get(String location) throws IOException {
+            SimpleResponse response = get.get(location);
+            scheduleRefresh((long) (getCacheLifetime(response) * BACKGROUND_REFRESH_FACTOR));
+            return response;
+        }
+
+    }
+
+    /**
+     * Creates a new CachedJWKSKeyResolver which resolves keys against the
+     * given JWKS endpoint. No request is made to the endpoint until a key is
+     * first resolved or {@link #refresh()} is invoked.
+     *
+     * @param location
+     *     The URL of the JWKS endpoint.
+     *
+     * @param defaultCacheDuration
+     *     The number of seconds that the contents of the JWKS endpoint should
+     *     be cached if the endpoint does not specify a lifetime via
+     *     "Cache-Control".
+     *
+     * @param minRefreshInterval
+     *     The minimum number of milliseconds which must elapse between
+     *     refreshes triggered by tokens signed with unknown keys.
+     */
+    public CachedJWKSKeyResolver(String location, long defaultCacheDuration,
+            long minRefreshInterval) {
+
+        this.defaultCacheDuration = defaultCacheDuration;
+        this.minRefreshInterval = minRefreshInterval;
+
+        this.jwks = new HttpsJwks(location);
+        this.jwks.setDefaultCacheDuration(defaultCacheDuration);
+        this.jwks.setSimpleHttpGet(new RefreshSchedulingGet());
+
+    }
+
+    /**
+     * Returns the number of milliseconds that the given JWKS response may be
+     * cached, as dictated by its "Cache-Control" header. If the response
+     * does not specify a lifetime, the default cache duration is used.
+     *
+     * @param response
+     *     The response received from the JWKS endpoint.
+     *
+     * @return
+     *     The number of milliseconds that the given response may be cached.
+     */
+    private long getCacheLifetime(SimpleResponse response) {
+
+        List<String> values = response.getHeaderValues("Cache-Control");
+        if (values != null) {
+            for (String value : values) {
+                for (String directive : value.split(",")) {
+
+                    directive = directive.trim().toLowerCase();
+
+                    // Responses which must not be cached are still retained
+                    // until the next refresh, but that refresh should happen
+                    // as soon as allowed
+                    if (directive.equals("no-cache") || directive.equals("no-store"))
+                        return 0;
+
+                    if (directive.startsWith("max-age=")) {
+                        try {
+                            return Long.parseLong(directive.substring(8).trim()) * 1000;
+                        }
+                        catch (NumberFormatException e) {
+                            logger.debug("Ignoring invalid JWKS max-age: \"{}\"", directive);
+                        }
+                    }
+
+                }
+            }
+        }
+
+        return defaultCacheDuration * 1000;
+
+    }
+
+    /**
+     * Schedules the next background refresh of the cache, replacing any
+     * previously-scheduled refresh. The refresh is never scheduled sooner
+     * than the minimum refresh interval.
+     *
+     * @param delay
+     *     The number of milliseconds to wait before refreshing the cache.
+     */
+    private synchronized void scheduleRefresh(long delay) {
+
+        if (executor.isShutdown())
+            return;
+
+        if (scheduledRefresh != null)
+            scheduledRefresh.cancel(false);
+
+        scheduledRefresh = executor.schedule(new Runnable() {
+
+            @Override
+            public void run() {
+                try {
+                    jwks.refresh();
+                }
+                catch (JoseException | IOException e) {
+                    logger.warn("Background refresh of OpenID JWKS failed: {}", e.getMessage());
+                    logger.debug("Unable to refresh JWKS.", e);
+                    scheduleRefresh(REFRESH_RETRY_DELAY);
+                }
+            }
+
+        }, Math.max(delay, minRefreshInterval), TimeUnit.MILLISECONDS);
+
+    }
+
+    /**
+     * Immediately refreshes the cache from the JWKS endpoint.
+     *
+     * @throws JoseException
+     *     If the contents of the JWKS endpoint cannot be parsed.
+     *
+     * @throws IOException
+     *     If the JWKS endpoint cannot be reached.
+     */
+    public void refresh() throws JoseException, IOException {
+        jwks.refresh();
+    }
+
+    /**
+     * Returns whether a refresh triggered by an unknown key ID is currently
+     * allowed, recording the current time as the time of that refresh if so.
+     *
+     * @return
+     *     true if the cache may be refreshed now, false if insufficient time
+     *     has elapsed since the last such refresh.
+     */
+    private boolean acquireForcedRefresh() {
+        long now = System.currentTimeMillis();
+        long last = lastForcedRefresh.get();
+        return now - last >= minRefreshInterval
+                && lastForcedRefresh.compareAndSet(last, now);
+    }
+
+    @Override
+    public Key resolveKey(JsonWebSignature jws, List<JsonWebStructure> nestingContext)
+            throws UnresolvableKeyException {
+
+        VerificationJwkSelector selector = new VerificationJwkSelector();
+
+        try {
+
+            // Attempt to locate key within cached JWKS first
+            JsonWebKey key = selector.select(jws, jwks.getJsonWebKeys());
+
+            // If no such key is cached, the provider may have rotated its
+            // keys since the last refresh
+            if (key == null && acquireForcedRefresh()) {
+                logger.debug("No cached JWKS key matches token (kid \"{}\"). "
+                        + "Refreshing JWKS.", jws.getKeyIdHeaderValue());
+                jwks.refresh();
+                key = selector.select(jws, jwks.getJsonWebKeys());
+            }
+
+            if (key != null)
+                return key.getKey();
+
+        }
+        catch (JoseException | IOException e) {
+            throw new UnresolvableKeyException("Unable to retrieve JWKS "
+                    + "from \"" + jwks.getLocation() + "\".", e);
+        }
+
+        throw new UnresolvableKeyException("No key within the JWKS at \""
+                + jwks.getLocation() + "\" matches the key used to sign the "
+                + "token (kid \"" + jws.getKeyIdHeaderValue() + "\").");
+
+    }
+
+    /**
+     * Stops all background refreshes of the cache. Keys which are already
+     * cached remain available, but will no longer be proactively refreshed.
+     */
+    public synchronized void shutdown() {
+        executor.shutdownNow();
+    }
+
+}
@@ -22,9 +22,9 @@ package org.apache.guacamole.auth.openid.token;
 import com.google.inject.Singleton;
 import java.math.BigInteger;
 import java.security.SecureRandom;
-import java.util.Iterator;
-import java.util.Map;
-import java.util.concurrent.ConcurrentHashMap;
+import org.apache.guacamole.cache.ExpiringSet;
+import org.slf4j.Logger;
+import org.slf4j.LoggerFactory;
 
 /**
  * Service for generating and validating single-use random tokens (nonces).
@@ -33,57 +33,29 @@ import java.util.concurrent.ConcurrentHashMap;
 public class NonceService {
 
     /**
-     * Cryptographically-secure random number generator for generating the
-     * required nonce.
+     * Logger for this class.
      */
-    private final SecureRandom random = new SecureRandom();
+    private static final Logger logger = LoggerFactory.getLogger(NonceService.class);
 
     /**
-     * Map of all generated nonces to their corresponding expiration timestamps.
-     * This Map must be periodically swept of expired nonces to avoid growing
-     * without bound.
+     * The maximum number of outstanding, unexpired nonces. Once this limit is
+     * reached, generating a new nonce invalidates the outstanding nonce which
+     * would otherwise expire soonest, such that generating large numbers of
+     * nonces cannot prevent new logins.
      */
-    private final Map<String, Long> nonces = new ConcurrentHashMap<String, Long>();
+    private static final int MAX_NONCES = 100000;
 
     /**
-     * The timestamp of the last expired nonce sweep.
+     * Cryptographically-secure random number generator for generating the
+     * required nonce.
      */
-    private long lastSweep = System.currentTimeMillis();
+    private final SecureRandom random = new SecureRandom();
 
     /**
-     * The minimum amount of time to wait between sweeping expired nonces from
-     * the Map.
+     * All generated nonces which have not yet been used, each of which is
+     * automatically removed upon expiration.
      */
-    private static final long SWEEP_INTERVAL = 60000;
-
-    /**
-     * Iterates through the entire Map of generated nonces, removing any nonce
-     * that has exceeded its expiration timestamp. If insufficient time has
-     * elapsed since the last sweep, as dictated by SWEEP_INTERVAL, this
-     * function has no effect.
-     */
-    private void sweepExpiredNonces() {
-
-        // Do not sweep until enough time has elapsed since the last sweep
-        long currentTime = System.currentTimeMillis();
-        if (currentTime - lastSweep < SWEEP_INTERVAL)
-            return;
-
-        // Record time of sweep
-        lastSweep = currentTime;
-
-        // For each stored nonce
-        Iterator<Map.Entry<String, Long>> entries = nonces.entrySet().iterator();
-        while (entries.hasNext()) {
-
-            // Remove all entries which have expired
-            Map.Entry<String, Long> current = entries.next();
-            if (current.getValue() <= System.currentTimeMillis())
-                entries.remove();
-
-        }
-
-    }
+    private final ExpiringSet<String> nonces = new ExpiringSet<>(MAX_NONCES);
 
     /**
      * Generates a cryptographically-secure nonce value. The nonce is intended
@@ -98,12 +70,13 @@ public class NonceService {
      */
     public String generate(long maxAge) {
 
-        // Sweep expired nonces if enough time has passed
-        sweepExpiredNonces();
-
-        // Generate and store nonce, along with expiration timestamp
+        // Generate and store nonce, along with expiration timestamp (expired
+        // nonces are removed automatically)
         String nonce = new BigInteger(130, random).toString(32);
-        nonces.put(nonce, System.currentTimeMillis() + maxAge);
+        if (!nonces.add(nonce, System.currentTimeMillis() + maxAge))
+            logger.warn("Newly-generated OpenID nonce could not be stored and "
+                    + "will not be accepted.");
+
         return nonce;
 
     }
@@ -122,13 +95,8 @@ public class NonceService {
      */
     public boolean isValid(String nonce) {
 
-        // Remove nonce, verifying whether it was present at all
-        Long expires = nonces.remove(nonce);
-        if (expires == null)
-            return false;
-
-        // Nonce is only valid if it hasn't expired
-        return expires > System.currentTimeMillis();
+        // Remove nonce, verifying whether it was present and unexpired
+        return nonces.remove(nonce);
 
     }
 
@@ -20,26 +20,28 @@
 package org.apache.guacamole.auth.openid.token;
 
 import com.google.inject.Inject;
+import com.google.inject.Singleton;
 import java.util.Collections;
 import java.util.HashSet;
 import java.util.List;
 import java.util.Set;
 import org.apache.guacamole.auth.openid.conf.ConfigurationService;
 import org.apache.guacamole.GuacamoleException;
-import org.jose4j.jwk.HttpsJwks;
 import org.jose4j.jwt.JwtClaims;
 import org.jose4j.jwt.MalformedClaimException;
 import org.jose4j.jwt.consumer.InvalidJwtException;
 import org.jose4j.jwt.consumer.JwtConsumer;
 import org.jose4j.jwt.consumer.JwtConsumerBuilder;
-import org.jose4j.keys.resolvers.HttpsJwksVerificationKeyResolver;
 import org.slf4j.Logger;
 import org.slf4j.LoggerFactory;
 
 /**
  * Service for validating ID tokens forwarded to us by the client, verifying
- * that they did indeed come from the OpenID service.
+ * that they did indeed come from the OpenID service. The keys published by
+ * the OpenID service and the JWT consumer which verifies tokens against those
+ * keys are created once and shared by all validations.
  */
+@Singleton
 public class TokenValidationService {
 
     /**
@@ -59,6 +61,66 @@ public class TokenValidationService {
     @Inject
     private NonceService nonceService;
 
+    /**
+     * Resolver which caches the keys published at the JWKS endpoint of the
+     * OpenID service. This will be null until the first token is validated.
+     */
+    private CachedJWKSKeyResolver resolver;
+
+    /**
+     * JWT consumer which verifies received tokens against the cached keys of
+     * the OpenID service. This will be null until the first token is
+     * validated.
+     */
+    private volatile JwtConsumer jwtConsumer;
+
+    /**
+     * Returns the JWT consumer which should be used to validate received
+     * tokens, creating that consumer (and its associated JWKS cache) if it
+     * has not yet been created.
+     *
+     * @return
+     *     The JWT consumer which should be used to validate received tokens.
+     *
+     * @throws GuacamoleException
+     *     If guacamole.properties could not be parsed.
+     */
+    private JwtConsumer getJwtConsumer() throws GuacamoleException {
+
+        JwtConsumer consumer = jwtConsumer;
+        if (consumer != null)
+            return consumer;
+
+        synchronized (this) {
+
+            // Another thread may have created the consumer while this thread
+            // was waiting
+            if (jwtConsumer != null)
+                return jwtConsumer;
+
+            // Validating the token requires a JWKS key resolver
+            resolver = new CachedJWKSKeyResolver(
+                    confService.getJWKSEndpoint().toString(),
+                    confService.getJWKSCacheDuration(),
+                    confService.getJWKSMinRefreshInterval() * 1000L);
+
+            // Create JWT consumer for validating received tokens
+            jwtConsumer = new JwtConsumerBuilder()
+                    .setRequireExpirationTime()
+                    .setMaxFutureValidityInMinutes(confService.getMaxTokenValidity())
+                    .setAllowedClockSkewInSeconds(confService.getAllowedClockSkew())
+                    .setRequireSubject()
+                    .setExpectedIssuer(confService.getIssuer())
+                    .setExpectedAudience(confService.getClientID())
+                    .setVerificationKeyResolver(resolver)
+                    .build();
+
+            return jwtConsumer;
+
+        }
+
+    }
+
     /**
      * Validates the given ID token, returning the JwtClaims contained therein.
      * If the ID token is invalid, null is returned.
@@ -74,24 +136,12 @@ public class TokenValidationService {
      *     If guacamole.properties could not be parsed.
      */
     public JwtClaims validateToken(String token) throws GuacamoleException {
-        // Validating the token requires a JWKS key resolver
-        HttpsJwks jwks = new HttpsJwks(confService.getJWKSEndpoint().toString());
-        HttpsJwksVerificationKeyResolver resolver = new HttpsJwksVerificationKeyResolver(jwks);
-
-        // Create JWT consumer for validating received token
-        JwtConsumer jwtConsumer = new JwtConsumerBuilder()
-                .setRequireExpirationTime()
-                .setMaxFutureValidityInMinutes(confService.getMaxTokenValidity())
-                .setAllowedClockSkewInSeconds(confService.getAllowedClockSkew())
-                .setRequireSubject()
-                .setExpectedIssuer(confService.getIssuer())
-                .setExpectedAudience(confService.getClientID())
-                .setVerificationKeyResolver(resolver)
-                .build();
+
+        JwtConsumer consumer = getJwtConsumer();
 
         try {
             // Validate JWT
-            JwtClaims claims = jwtConsumer.processToClaims(token);
+            JwtClaims claims = consumer.processToClaims(token);
 
             // Verify a nonce is present
             String nonce = claims.getStringClaimValue("nonce");
@@ -201,4 +251,15 @@ public class TokenValidationService {
         // Could not retrieve groups from JWT
         return Collections.emptySet();
     }
+
+    /**
+     * Stops any background refreshes of the cached keys of the OpenID
+     * service. This function should be invoked when the OpenID extension is
+     * being unloaded.
+     */
+    public synchronized void shutdown() {
+        if (resolver != null)
+            resolver.shutdown();
+    }
+
 }
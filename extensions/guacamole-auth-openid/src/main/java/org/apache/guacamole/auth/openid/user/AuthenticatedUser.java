@@ -24,6 +24,7 @@ import java.util.Set;
 import org.apache.guacamole.net.auth.AbstractAuthenticatedUser;
 import org.apache.guacamole.net.auth.AuthenticationProvider;
 import org.apache.guacamole.net.auth.Credentials;
+import org.apache.guacamole.net.auth.IdentityFingerprint;
 
 /**
  * An openid-specific implementation of AuthenticatedUser, associating a
@@ -82,4 +83,10 @@ public class AuthenticatedUser extends AbstractAuthenticatedUser {
     public Set<String> getEffectiveUserGroups() {
         return effectiveGroups;
     }
+
+    @Override
+    public String getIdentityFingerprint() {
+        return IdentityFingerprint.generate(this);
+    }
+
 }
@@ -0,0 +1,204 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+package org.apache.guacamole.auth.openid.token;
+
+import com.sun.net.httpserver.HttpExchange;
+import com.sun.net.httpserver.HttpHandler;
+import com.sun.net.httpserver.HttpServer;
+import java.io.IOException;
+import java.io.OutputStream;
+import java.net.InetAddress;
+import java.net.InetSocketAddress;
+import java.nio.charset.StandardCharsets;
+import java.util.Collections;
+import java.util.concurrent.atomic.AtomicInteger;
+import org.jose4j.jwk.JsonWebKeySet;
+import org.jose4j.jwk.RsaJsonWebKey;
+import org.jose4j.jwk.RsaJwkGenerator;
+import org.jose4j.jws.AlgorithmIdentifiers;
+import org.jose4j.jws.JsonWebSignature;
+import org.jose4j.lang.JoseException;
+import org.jose4j.lang.UnresolvableKeyException;
+import org.junit.After;
+import org.junit.Before;
+import org.junit.Test;
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.fail;
+
+/**
+ * Test which verifies that CachedJWKSKeyResolver resolves keys from its cache
+ * without contacting the JWKS endpoint, and that refreshes triggered by
+ * unknown keys are rate limited. A local stub JWKS endpoint is used in place
+ * of an actual OpenID service.
+ */
+public class CachedJWKSKeyResolverTest {
+
+    /**
+     * The key published by the stub JWKS endpoint.
+     */
+    private RsaJsonWebKey publishedKey;
+
+    /**
+     * The stub JWKS endpoint.
+     */
+    private HttpServer server;
+
+    /**
+     * The number of requests received by the stub JWKS endpoint.
+     */
+    private final AtomicInteger requests = new AtomicInteger();
+
+    /**
+     * The resolver under test.
+     */
+    private CachedJWKSKeyResolver resolver;
+
+    /**
+     * Generates the published key and starts the stub JWKS endpoint.
+     *
+     * @throws Exception
+     *     If the key cannot be generated or the stub endpoint cannot be
+     *     started.
+     */
+    @Before
+    public void setUp() throws Exception {
+
+        publishedKey = RsaJwkGenerator.generateJwk(2048);
+        publishedKey.setKeyId("known");
+
+        final byte[] body = new JsonWebKeySet(publishedKey).toJson()
+                .getBytes(StandardCharsets.UTF_8);
+
+        server = HttpServer.create(new InetSocketAddress(InetAddress.getLoopbackAddress(), 0), 0);
+        server.createContext("/jwks", new HttpHandler() {
+
+            @Override
+            public void handle(HttpExchange exchange) throws IOException {
+                requests.incrementAndGet();
+                exchange.getResponseHeaders().add("Content-Type", "application/json");
+                exchange.getResponseHeaders().add("Cache-Control", "public, max-age=3600");
+                exchange.sendResponseHeaders(200, body.length);
+                try (OutputStream out = exchange.getResponseBody()) {
+                    out.write(body);
+                }
+            }
+
+        });
+        server.start();
+
+        resolver = new CachedJWKSKeyResolver("http://"
+                + server.getAddress().getHostString() + ":"
+                + server.getAddress().getPort() + "/jwks", 3600, 60000);
+
+    }
+
+    /**
+     * Stops the resolver and the stub JWKS endpoint.
+     */
+    @After
+    public void tearDown() {
+        resolver.shutdown();
+        server.stop(0);
+    }
+
+    /**
+     * Returns a parsed JWS signed with the given key and having the given
+     * key ID.
+     *
+     * @param key
+     *     The key to sign the JWS with.
+     *
+     * @param keyId
+     *     The key ID to include in the header of the JWS.
+     *
+     * @return
+     *     A parsed JWS, as would be provided to the resolver during token
+     *     validation.
+     *
+     * @throws JoseException
+     *     If the JWS cannot be signed or parsed.
+     */
+    private JsonWebSignature sign(RsaJsonWebKey key, String keyId)
+            throws JoseException {
+
+        JsonWebSignature jws = new JsonWebSignature();
+        jws.setPayload("{\"sub\":\"test\"}");
+        jws.setAlgorithmHeaderValue(AlgorithmIdentifiers.RSA_USING_SHA256);
+        jws.setKeyIdHeaderValue(keyId);
+        jws.setKey(key.getPrivateKey());
+
+        JsonWebSignature parsed = new JsonWebSignature();
+        parsed.setCompactSerialization(jws.getCompactSerialization());
+        return parsed;
+
+    }
+
+    /**
+     * Verifies that repeatedly resolving a published key contacts the JWKS
+     * endpoint only once.
+     *
+     * @throws Exception
+     *     If the key cannot be resolved.
+     */
+    @Test
+    public void testCachedResolution() throws Exception {
+
+        JsonWebSignature jws = sign(publishedKey, "known");
+
+        for (int i = 0; i < 10; i++)
+            assertEquals(publishedKey.getPublicKey(),
+                    resolver.resolveKey(jws, Collections.emptyList()));
+
+        assertEquals(1, requests.get());
+
+    }
+
+    /**
+     * Verifies that a token signed with an unknown key triggers at most one
+     * refresh of the JWKS within the minimum refresh interval.
+     *
+     * @throws Exception
+     *     If the published key cannot be resolved, or the unknown key cannot
+     *     be generated.
+     */
+    @Test
+    public void testUnknownKeyRefreshRateLimited() throws Exception {
+
+        resolver.resolveKey(sign(publishedKey, "known"), Collections.emptyList());
+        assertEquals(1, requests.get());
+
+        RsaJsonWebKey unknownKey = RsaJwkGenerator.generateJwk(2048);
+        JsonWebSignature jws = sign(unknownKey, "unknown");
+
+        for (int i = 0; i < 10; i++) {
+            try {
+                resolver.resolveKey(jws, Collections.emptyList());
+                fail("Key not published at the JWKS endpoint was resolved.");
+            }
+            catch (UnresolvableKeyException e) {
+                // Expected
+            }
+        }
+
+        assertEquals(2, requests.get());
+
+    }
+
+}
@@ -20,21 +20,34 @@
 package org.apache.guacamole.auth.quickconnect;
 
 import com.google.inject.Inject;
+import java.util.ArrayList;
+import java.util.HashMap;
+import java.util.Iterator;
+import java.util.LinkedHashMap;
+import java.util.List;
 import java.util.concurrent.ConcurrentHashMap;
 import java.util.Map;
+import java.util.concurrent.atomic.AtomicBoolean;
 import java.util.concurrent.atomic.AtomicInteger;
+import org.apache.guacamole.GuacamoleClientException;
 import org.apache.guacamole.GuacamoleException;
 import org.apache.guacamole.auth.quickconnect.utility.QCParser;
 import org.apache.guacamole.auth.quickconnect.conf.ConfigurationService;
+import org.apache.guacamole.net.DelegatingGuacamoleTunnel;
+import org.apache.guacamole.net.GuacamoleTunnel;
 import org.apache.guacamole.net.auth.ConnectionGroup;
 import org.apache.guacamole.net.auth.simple.SimpleConnection;
 import org.apache.guacamole.net.auth.simple.SimpleDirectory;
 import org.apache.guacamole.net.auth.Connection;
+import org.apache.guacamole.protocol.GuacamoleClientInformation;
 import org.apache.guacamole.protocol.GuacamoleConfiguration;
 
 /**
  * Implementation of a directory to store Connection objects
- * completely in memory.
+ * completely in memory. Connections created from identical URIs are stored
+ * only once, and the least-recently-used connections which are not currently
+ * in use are removed once the configured maximum number of connections would
+ * be exceeded.
  */
 public class QuickConnectDirectory extends SimpleDirectory<Connection> {
     
@@ -50,6 +63,15 @@ public class QuickConnectDirectory extends SimpleDirectory<Connection> {
     private final Map<String, Connection> connections =
             new ConcurrentHashMap<>();
 
+    /**
+     * The identifiers of all connections created from URIs, indexed by the
+     * URI each connection was created from. This map is ordered by access,
+     * with the least-recently-used connection first. Access to this map must
+     * be synchronized on this directory.
+     */
+    private final LinkedHashMap<String, String> identifiersByURI =
+            new LinkedHashMap<>(16, 0.75f, true);
+
     /**
      * The root connection group for this directory.
      */
@@ -60,6 +82,87 @@ public class QuickConnectDirectory extends SimpleDirectory<Connection> {
      */
     private AtomicInteger connectionId;
 
+    /**
+     * The parser which converts URIs into GuacamoleConfigurations, or null if
+     * no URI has yet been parsed.
+     */
+    private QCParser parser;
+
+    /**
+     * SimpleConnection which records each use of the connection and tracks
+     * the number of tunnels currently open through it, such that recently
+     * used connections are the last to be removed from the directory, and
+     * connections which are still in use are not removed at all.
+     */
+    private class QuickConnection extends SimpleConnection {
+
+        /**
+         * The URI that this connection was created from.
+         */
+        private final String uri;
+
+        /**
+         * The number of tunnels currently open through this connection.
+         */
+        private final AtomicInteger activeTunnels = new AtomicInteger();
+
+        /**
+         * Creates a new QuickConnection having the given name, identifier,
+         * and configuration, which was created from the given URI.
+         *
+         * @param name
+         *     The name to associate with this connection.
+         *
+         * @param identifier
+         *     The identifier to associate with this connection.
+         *
+         * @param config
+         *     The configuration describing how to connect to this connection.
+         *
+         * @param uri
+         *     The URI that this connection was created from.
+         */
+        public QuickConnection(String name, String identifier,
+                GuacamoleConfiguration config, String uri) {
+            super(name, identifier, config, true);
+            this.uri = uri;
+        }
+
+        @Override
+        public GuacamoleTunnel connect(GuacamoleClientInformation info,
+                Map<String, String> tokens) throws GuacamoleException {
+
+            touch(uri);
+
+            GuacamoleTunnel tunnel = super.connect(info, tokens);
+            activeTunnels.incrementAndGet();
+
+            // Stop counting the tunnel as active once it is closed
+            return new DelegatingGuacamoleTunnel(tunnel) {
+
+                /**
+                 * Whether this tunnel has already been closed.
+                 */
+                private final AtomicBoolean closed = new AtomicBoolean();
+
+                @Override
+                public void close() throws GuacamoleException {
+                    if (closed.compareAndSet(false, true))
+                        activeTunnels.decrementAndGet();
+                    super.close();
+                }
+
+            };
+
+        }
+
+        @Override
+        public int getActiveConnections() {
+            return activeTunnels.get();
+        }
+
+    }
+
     /**
      * Initialize the QuickConnectDirectory with the default empty Map for
      * Connection objects, and the specified ConnectionGroup at the root of
@@ -86,6 +189,77 @@ public class QuickConnectDirectory extends SimpleDirectory<Connection> {
         return connectionId.getAndIncrement();
     }
 
+    /**
+     * Returns the parser which should be used to convert URIs into
+     * GuacamoleConfigurations, creating that parser if it has not yet been
+     * created.
+     *
+     * @return
+     *     The parser which should be used to convert URIs into
+     *     GuacamoleConfigurations.
+     *
+     * @throws GuacamoleException
+     *     If guacamole.properties cannot be parsed.
+     */
+    private synchronized QCParser getParser() throws GuacamoleException {
+
+        if (parser == null)
+            parser = new QCParser(confService.getAllowedParameters(),
+                                  confService.getDeniedParameters());
+
+        return parser;
+
+    }
+
+    /**
+     * Records that the connection created from the given URI has just been
+     * used, such that it is the last connection to be removed if the maximum
+     * number of connections is exceeded.
+     *
+     * @param uri
+     *     The URI that the used connection was created from.
+     */
+    private synchronized void touch(String uri) {
+        identifiersByURI.get(uri);
+    }
+
+    /**
+     * Removes the least-recently-used connections from this directory until
+     * there is room for the given number of additional connections.
+     * Connections which are currently in use are never removed, thus the
+     * maximum number of connections may be exceeded if those connections
+     * alone would exceed it.
+     *
+     * @param count
+     *     The number of additional connections which must fit within the
+     *     maximum number of connections.
+     *
+     * @throws GuacamoleException
+     *     If guacamole.properties cannot be parsed.
+     */
+    private synchronized void evict(int count) throws GuacamoleException {
+
+        int maxConnections = confService.getMaxConnections();
+
+        Iterator<String> identifiers = identifiersByURI.values().iterator();
+        while (identifiersByURI.size() + count > maxConnections
+                && identifiers.hasNext()) {
+
+            // Skip any connections which are currently in use
+            String identifier = identifiers.next();
+            Connection connection = connections.get(identifier);
+            if (connection != null && connection.getActiveConnections() > 0)
+                continue;
+
+            identifiers.remove();
+
+            rootGroup.removeConnectionIdentifier(identifier);
+            connections.remove(identifier);
+
+        }
+
+    }
+
     @Override
     public void add(Connection connection) throws GuacamoleException {
         connections.put(connection.getIdentifier(), connection);
@@ -95,7 +269,9 @@ public class QuickConnectDirectory extends SimpleDirectory<Connection> {
      * Taking a URI, parse the URI into a GuacamoleConfiguration object and
      * then use the configuration to create a SimpleConnection object, obtain
      * an identifier, and place it on the tree, returning the identifier value
-     * of the new connection.
+     * of the new connection. If a connection has already been created from
+     * an identical URI, the identifier of that connection is returned
+     * instead, and no new connection is created.
      *
      * @param uri
      *     The URI to parse into a GuacamoleConfiguration, which will then be
@@ -107,32 +283,124 @@ public class QuickConnectDirectory extends SimpleDirectory<Connection> {
      * @throws GuacamoleException
      *     If an error occurs adding the object to the tree.
      */
-    public String create(String uri) throws GuacamoleException {
+    public synchronized String create(String uri) throws GuacamoleException {
 
-        // Get the next available connection identifier.
-        String newConnectionId = Integer.toString(getNextConnectionID());
+        // Reuse any connection already created from the same URI
+        String existingConnectionId = identifiersByURI.get(uri);
+        if (existingConnectionId != null)
+            return existingConnectionId;
 
-        // Get a new QCParser
-        QCParser parser = new QCParser(confService.getAllowedParameters(),
-                                        confService.getDeniedParameters());
-        
         // Parse the URI into a configuration
-        GuacamoleConfiguration config = parser.getConfiguration(uri);
+        return create(uri, getParser().getConfiguration(uri));
+
+    }
+
+    /**
+     * Creates a new connection using the given configuration, which was
+     * parsed from the given URI, placing that connection on the tree and
+     * returning its identifier.
+     *
+     * @param uri
+     *     The URI that the given configuration was parsed from.
+     *
+     * @param config
+     *     The configuration to use for the new connection.
+     *
+     * @return
+     *     The identifier of the connection created in the directory.
+     *
+     * @throws GuacamoleException
+     *     If an error occurs adding the object to the tree.
+     */
+    private synchronized String create(String uri, GuacamoleConfiguration config)
+            throws GuacamoleException {
 
         // Generate a name for the configuration.
-        String name = parser.getName(config);
+        String name = getParser().getName(config);
+
+        // Make room for the new connection
+        evict(1);
+
+        // Get the next available connection identifier.
+        String newConnectionId = Integer.toString(getNextConnectionID());
 
         // Create a new connection and set the parent identifier.
-        Connection connection = new SimpleConnection(name, newConnectionId, config, true);
+        Connection connection = new QuickConnection(name, newConnectionId, config, uri);
         connection.setParentIdentifier(QuickConnectUserContext.ROOT_IDENTIFIER);
 
         // Place the object in this directory.
         add(connection);
+        identifiersByURI.put(uri, newConnectionId);
 
         // Add connection to the tree.
         rootGroup.addConnectionIdentifier(newConnectionId);
 
         return newConnectionId;
+
+    }
+
+    /**
+     * Creates connections for each of the given URIs as would be done by
+     * {@link #create(java.lang.String)}, returning the identifiers of those
+     * connections in the same order as the given URIs. Either all connections
+     * are created, or none are.
+     *
+     * @param uris
+     *     The URIs to parse into connections.
+     *
+     * @return
+     *     The identifiers of the connections created for each of the given
+     *     URIs, in the same order as those URIs.
+     *
+     * @throws GuacamoleException
+     *     If any of the given URIs cannot be parsed, if the number of URIs
+     *     given exceeds the maximum number of connections, or if
+     *     guacamole.properties cannot be parsed.
+     */
+    public synchronized List<String> create(List<String> uris)
+            throws GuacamoleException {
+
+        // Refuse to create more connections than can be stored at once, as
+        // earlier connections in the batch would be removed by later ones
+        if (uris.size() > confService.getMaxConnections())
+            throw new GuacamoleClientException("Too many connections "
+                    + "requested at once.");
+
+        // Parse all new URIs before creating any connections, marking any
+        // existing connections for the other URIs as recently used such that
+        // they are not removed to make room for the new connections
+        QCParser parser = getParser();
+        Map<String, GuacamoleConfiguration> configs = new HashMap<>();
+        for (String uri : uris) {
+            if (identifiersByURI.get(uri) == null && !configs.containsKey(uri))
+                configs.put(uri, parser.getConfiguration(uri));
+        }
+
+        // Create connections only for URIs not already seen, including URIs
+        // which occur more than once within the batch
+        List<String> identifiers = new ArrayList<>(uris.size());
+        for (String uri : uris) {
+
+            String identifier = identifiersByURI.get(uri);
+            if (identifier == null) {
+
+                // Parse any URI whose existing connection was nonetheless
+                // removed (possible only if connections in use exceed the
+                // maximum)
+                GuacamoleConfiguration config = configs.get(uri);
+                if (config == null)
+                    config = parser.getConfiguration(uri);
+
+                identifier = create(uri, config);
+
+            }
+
+            identifiers.add(identifier);
+
+        }
+
+        return identifiers;
+
     }
 
 }
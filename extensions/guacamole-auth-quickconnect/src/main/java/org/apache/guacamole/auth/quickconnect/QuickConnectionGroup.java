@@ -20,9 +20,9 @@
 package org.apache.guacamole.auth.quickconnect;
 
 import java.util.Collections;
-import java.util.HashSet;
 import java.util.Map;
 import java.util.Set;
+import java.util.concurrent.ConcurrentHashMap;
 import org.apache.guacamole.GuacamoleException;
 import org.apache.guacamole.GuacamoleSecurityException;
 import org.apache.guacamole.net.GuacamoleTunnel;
@@ -40,7 +40,7 @@ public class QuickConnectionGroup extends AbstractConnectionGroup {
      * A set that will store the Connection identifiers for this group.
      */
     private final Set<String> connectionIdentifiers =
-            new HashSet<String>(Collections.<String>emptyList());
+            ConcurrentHashMap.newKeySet();
 
     /**
      * Set up a QuickConnectionGroup with the provided name and
@@ -79,6 +79,21 @@ public class QuickConnectionGroup extends AbstractConnectionGroup {
         return null;
     }
 
+    /**
+     * Remove a connection identifier from this connection group, returning
+     * whether the identifier was present.
+     *
+     * @param identifier
+     *     The identifier of the connection to remove from the group.
+     *
+     * @return
+     *     true if the identifier was present and has been removed, false
+     *     otherwise.
+     */
+    public boolean removeConnectionIdentifier(String identifier) {
+        return connectionIdentifiers.remove(identifier);
+    }
+
     @Override
     public int getActiveConnections() {
         // This group does not track active connections.
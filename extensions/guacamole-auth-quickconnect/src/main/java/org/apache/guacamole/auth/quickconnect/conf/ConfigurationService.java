@@ -23,6 +23,7 @@ import com.google.inject.Inject;
 import java.util.List;
 import org.apache.guacamole.GuacamoleException;
 import org.apache.guacamole.environment.Environment;
+import org.apache.guacamole.properties.IntegerGuacamoleProperty;
 import org.apache.guacamole.properties.StringListProperty;
 
 /**
@@ -62,6 +63,18 @@ public class ConfigurationService {
         
     };
     
+    /**
+     * The maximum number of connections that may be stored for a single user
+     * session. If this number would be exceeded, the least-recently-used
+     * connections are removed.  Defaults to 256.
+     */
+    public static final IntegerGuacamoleProperty QUICKCONNECT_MAX_CONNECTIONS = new IntegerGuacamoleProperty() {
+
+        @Override
+        public String getName() { return "quickconnect-max-connections"; }
+
+    };
+
     /**
      * Return the list of allowed parameters to be set by connections created
      * using the QuickConnect module, or null if none are defined (thereby
@@ -93,5 +106,21 @@ public class ConfigurationService {
     public List<String> getDeniedParameters() throws GuacamoleException {
         return environment.getProperty(QUICKCONNECT_DENIED_PARAMETERS);
     }
-    
+
+    /**
+     * Return the maximum number of connections that may be stored for a
+     * single user session, after which the least-recently-used connections
+     * are removed. By default, this will be 256.
+     *
+     * @return
+     *     The maximum number of connections that may be stored for a single
+     *     user session.
+     *
+     * @throws GuacamoleException
+     *     If guacamole.properties cannot be parsed.
+     */
+    public int getMaxConnections() throws GuacamoleException {
+        return environment.getProperty(QUICKCONNECT_MAX_CONNECTIONS, 256);
+    }
+
 }
@@ -20,6 +20,7 @@
 package org.apache.guacamole.auth.quickconnect.rest;
 
 import java.util.Collections;
+import java.util.List;
 import java.util.Map;
 import javax.ws.rs.FormParam;
 import javax.ws.rs.Path;
@@ -28,7 +29,6 @@ import javax.ws.rs.Produces;
 import javax.ws.rs.core.MediaType;
 import org.apache.guacamole.GuacamoleException;
 import org.apache.guacamole.auth.quickconnect.QuickConnectDirectory;
-import org.apache.guacamole.auth.quickconnect.utility.QCParser;
 
 /**
  * A class that implements REST endpoints for the QuickConnect
@@ -78,4 +78,30 @@ public class QuickConnectREST {
  
     }
 
+    /**
+     * Parse each of the URIs read from the POST input, add the corresponding
+     * connections to the directory, and return a Map containing a single key,
+     * identifiers, and the identifiers of the connections, in the same order
+     * as the given URIs. Identical URIs share the same connection.
+     *
+     * @param uris
+     *     The URIs to parse into connections.
+     *
+     * @return
+     *     A Map containing a single key, identifiers, and the identifiers of
+     *     the connections.
+     *
+     * @throws GuacamoleException
+     *     If an error is encountered parsing any of the URIs, or if too many
+     *     URIs are given.
+     */
+    @POST
+    @Path("create-batch")
+    public Map<String, List<String>> createBatch(@FormParam("uri") List<String> uris)
+            throws GuacamoleException {
+
+        return Collections.singletonMap("identifiers", directory.create(uris));
+
+    }
+
 }
@@ -65,5 +65,44 @@ angular.module('guacQuickConnect').factory('quickConnectService', ['$injector',
 
     };
     
+    /**
+     * Makes a request to the REST API to create a connection for each of the
+     * given URIs in a single request, returning a promise that can be used
+     * for processing the results of the call. Identical URIs will share the
+     * same connection.
+     *
+     * @param {String[]} uris
+     *     The URIs of the connections to create.
+     *
+     * @returns {Promise.<String[]>}
+     *     A promise which will resolve with the identifiers of the created
+     *     connections, in the same order as the given URIs, and which will
+     *     succeed if and only if all connections are successfully created.
+     */
+    service.createConnections = function createConnections(uris) {
+
+        // Build HTTP parameters set
+        var httpParameters = {
+            token : authenticationService.getCurrentToken()
+        };
+
+        return requestService({
+            method  : 'POST',
+            url     : 'api/session/ext/quickconnect/create-batch',
+            params  : httpParameters,
+            data    : $.param({uri: uris}, true),
+            headers : {'Content-Type': 'application/x-www-form-urlencoded'}
+        })
+        .then(function connectionsCreated(result) {
+            // Clear connections and users from cache.
+            cacheService.connections.removeAll();
+            cacheService.users.removeAll();
+
+            // Pass on the connection identifiers
+            return result.identifiers;
+        });
+
+    };
+
     return service;
 }]);
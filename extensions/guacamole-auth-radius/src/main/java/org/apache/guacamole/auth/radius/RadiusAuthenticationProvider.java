@@ -70,4 +70,9 @@ public class RadiusAuthenticationProvider extends AbstractAuthenticationProvider
 
     }
 
+    @Override
+    public void shutdown() {
+        injector.getInstance(RadiusConnectionService.class).shutdown();
+    }
+
 }
@@ -19,16 +19,21 @@
 
 package org.apache.guacamole.auth.radius;
 
+import com.google.common.io.BaseEncoding;
 import com.google.inject.Inject;
+import com.google.inject.Singleton;
 import java.io.File;
-import java.io.IOException;
 import java.net.InetAddress;
 import java.net.UnknownHostException;
 import java.security.NoSuchAlgorithmException;
+import java.util.ArrayList;
+import java.util.Collections;
+import java.util.List;
+import java.util.concurrent.atomic.AtomicInteger;
 import org.apache.guacamole.GuacamoleException;
-import org.apache.guacamole.GuacamoleServerException;
 import org.apache.guacamole.auth.radius.conf.ConfigurationService;
 import org.apache.guacamole.auth.radius.conf.RadiusAuthenticationProtocol;
+import org.apache.guacamole.cache.ExpiringMap;
 import org.slf4j.Logger;
 import org.slf4j.LoggerFactory;
 import net.jradius.client.RadiusClient;
@@ -41,9 +46,11 @@ import net.jradius.dictionary.Attr_State;
 import net.jradius.dictionary.Attr_UserName;
 import net.jradius.dictionary.Attr_UserPassword;
 import net.jradius.exception.RadiusException;
+import net.jradius.exception.TimeoutException;
 import net.jradius.packet.RadiusPacket;
 import net.jradius.packet.AccessRequest;
 import net.jradius.packet.attribute.AttributeList;
+import net.jradius.packet.attribute.RadiusAttribute;
 import net.jradius.client.auth.EAPTLSAuthenticator;
 import net.jradius.client.auth.EAPTTLSAuthenticator;
 import net.jradius.client.auth.RadiusAuthenticator;
@@ -52,8 +59,12 @@ import net.jradius.packet.AccessChallenge;
 import net.jradius.packet.RadiusResponse;
 
 /**
- * Service for creating and managing connections to RADIUS servers.
+ * Service for creating and managing connections to RADIUS servers. Requests
+ * are distributed round-robin among all configured RADIUS servers, failing
+ * over to other servers if a server does not respond, with the RadiusClient
+ * instances used for each server being reused across requests.
  */
+@Singleton
 public class RadiusConnectionService {
 
     /**
@@ -61,43 +72,134 @@ public class RadiusConnectionService {
      */
     private final Logger logger = LoggerFactory.getLogger(RadiusConnectionService.class);
 
+    /**
+     * The maximum amount of time that the server which issued a challenge
+     * should be remembered, in milliseconds. Responses to a challenge must be
+     * sent to the same server that issued that challenge.
+     */
+    private static final long MAX_CHALLENGE_AGE = 300000;
+
+    /**
+     * The maximum number of outstanding challenges whose issuing server
+     * should be remembered.
+     */
+    private static final int MAX_CHALLENGES = 10000;
+
     /**
      * Service for retrieving RADIUS server configuration information.
      */
     @Inject
     private ConfigurationService confService;
-    
+
     /**
-     * Creates a new instance of RadiusClient, configured with parameters
-     * from guacamole.properties.
+     * All configured RADIUS servers, or null if the configuration has not yet
+     * been read.
+     */
+    private volatile List<RadiusServer> servers;
+
+    /**
+     * The index of the server which should be tried first for the next
+     * request, modulo the number of servers.
+     */
+    private final AtomicInteger nextServer = new AtomicInteger();
+
+    /**
+     * The servers which issued each outstanding challenge, stored by the
+     * hex-encoded value of the state attribute of that challenge.
+     */
+    private final ExpiringMap<String, RadiusServer> challengeServers =
+            new ExpiringMap<>(MAX_CHALLENGES);
+
+    /**
+     * Creates a new RadiusConnectionService, loading the JRadius attribute
+     * dictionary required by all RADIUS requests.
+     */
+    public RadiusConnectionService() {
+        AttributeFactory.loadAttributeDictionary("net.jradius.dictionary.AttributeDictionaryImpl");
+    }
+
+    /**
+     * Returns all configured RADIUS servers, reading the list of servers from
+     * guacamole.properties if it has not yet been read.
      *
      * @return
-     *     A RadiusClient instance, configured with server, shared secret,
-     *     ports, and timeout, as configured in guacamole.properties.
+     *     All configured RADIUS servers.
      *
      * @throws GuacamoleException
-     *     If an error occurs while parsing guacamole.properties, or if the
-     *     configuration of RadiusClient fails.
+     *     If guacamole.properties cannot be parsed, or if a configured server
+     *     is not valid.
      */
-    private RadiusClient createRadiusConnection() throws GuacamoleException {
-
-        // Create the RADIUS client with the configuration parameters
-        try {
-            return new RadiusClient(InetAddress.getByName(confService.getRadiusServer()),
-                                            confService.getRadiusSharedSecret(),
-                                            confService.getRadiusAuthPort(),
-                                            confService.getRadiusAcctPort(),
-                                            confService.getRadiusTimeout());
+    private List<RadiusServer> getServers() throws GuacamoleException {
+
+        List<RadiusServer> current = servers;
+        if (current != null)
+            return current;
+
+        synchronized (this) {
+
+            if (servers != null)
+                return servers;
+
+            List<RadiusServer> parsed = new ArrayList<>();
+            for (String spec : confService.getRadiusServers()) {
+                if (!spec.trim().isEmpty())
+                    parsed.add(RadiusServer.parse(spec,
+                            confService.getRadiusAuthPort(),
+                            confService.getRadiusAcctPort()));
+            }
+
+            servers = Collections.unmodifiableList(parsed);
+            return servers;
+
         }
-        catch (UnknownHostException e) {
-            logger.debug("Failed to resolve host.", e);
-            throw new GuacamoleServerException("Unable to resolve RADIUS server host.", e);
+
+    }
+
+    /**
+     * Returns the RADIUS servers which should be tried for a request, in the
+     * order they should be tried. A request continuing a challenge is only
+     * sent to the server which issued that challenge, if known. Otherwise,
+     * servers are tried round-robin, with servers which have recently failed
+     * being tried only after all other servers.
+     *
+     * @param state
+     *     The state of the challenge being responded to, or null if the
+     *     request is not a response to a challenge.
+     *
+     * @return
+     *     The RADIUS servers which should be tried, in order.
+     *
+     * @throws GuacamoleException
+     *     If guacamole.properties cannot be parsed, or if a configured server
+     *     is not valid.
+     */
+    private List<RadiusServer> getCandidateServers(byte[] state)
+            throws GuacamoleException {
+
+        // Challenge responses must go to the server that issued the challenge
+        if (state != null && state.length > 0) {
+            RadiusServer issuer = challengeServers.get(BaseEncoding.base16().encode(state));
+            if (issuer != null)
+                return Collections.singletonList(issuer);
         }
-        catch (IOException e) {
-            logger.debug("Failed to communicate with host.", e);
-            throw new GuacamoleServerException("Failed to communicate with RADIUS server.", e);
+
+        List<RadiusServer> allServers = getServers();
+        int count = allServers.size();
+        int start = Math.floorMod(nextServer.getAndIncrement(), Math.max(count, 1));
+
+        List<RadiusServer> available = new ArrayList<>(count);
+        List<RadiusServer> failed = new ArrayList<>(count);
+        for (int i = 0; i < count; i++) {
+            RadiusServer server = allServers.get((start + i) % count);
+            if (server.isAvailable())
+                available.add(server);
+            else
+                failed.add(server);
         }
 
+        available.addAll(failed);
+        return available;
+
     }
 
     /**
@@ -197,71 +299,192 @@ public class RadiusConnectionService {
             return null;
         }
 
-        // Create the RADIUS connection and set up the dictionary
-        RadiusClient radiusClient = createRadiusConnection();
-        AttributeFactory.loadAttributeDictionary("net.jradius.dictionary.AttributeDictionaryImpl");
+        long deadline = System.currentTimeMillis()
+                + confService.getRadiusRequestDeadline() * 1000L;
+
+        int timeout = confService.getRadiusTimeout();
+        int maxRetries = confService.getRadiusMaxRetries();
+
+        // Try each candidate server in turn until one responds
+        List<RadiusServer> candidates = getCandidateServers(state);
+        for (int i = 0; i < candidates.size(); i++) {
+
+            RadiusServer server = candidates.get(i);
+
+            // Do not start any further attempts past the deadline
+            long remaining = deadline - System.currentTimeMillis();
+            if (remaining <= 0) {
+                logger.warn("RADIUS request deadline exceeded before "
+                        + "contacting server \"{}\".", server);
+                break;
+            }
+
+            // Divide the remaining time evenly among the servers not yet
+            // tried, reducing the timeout and retries of each request to fit
+            // within that share (each request may be sent up to one more
+            // time than the number of retries)
+            long budget = remaining / (candidates.size() - i);
+            int attemptTimeout = (int) Math.max(1, Math.min(timeout, budget / 1000));
+            int attemptRetries = (int) Math.max(0, Math.min(maxRetries,
+                    budget / (attemptTimeout * 1000L) - 1));
+
+            RadiusClient radiusClient;
+            try {
+                radiusClient = server.acquireClient(
+                        confService.getRadiusSharedSecret(), attemptTimeout);
+            }
+            catch (GuacamoleException e) {
+                logger.warn("Unable to contact RADIUS server \"{}\": {}", server, e.getMessage());
+                logger.debug("Creation of RADIUS client failed.", e);
+                server.markFailed();
+                continue;
+            }
+
+            boolean reusable = false;
+            try {
+
+                RadiusResponse reply = sendReceive(radiusClient, username,
+                        secret, clientAddress, state, attemptRetries);
+                server.markSucceeded();
+                reusable = true;
+
+                // Remember which server issued any challenge which requires
+                // a response from the user
+                if (reply instanceof AccessChallenge) {
+                    RadiusAttribute stateAttr = reply.findAttribute(Attr_State.TYPE);
+                    if (stateAttr != null)
+                        challengeServers.putIfAbsent(
+                                BaseEncoding.base16().encode(stateAttr.getValue().getBytes()),
+                                server, System.currentTimeMillis() + MAX_CHALLENGE_AGE);
+                }
+
+                return reply;
+
+            }
+            catch (TimeoutException e) {
+                logger.warn("RADIUS server \"{}\" did not respond.", server);
+                logger.debug("RADIUS request timed out.", e);
+                server.markFailed();
+            }
+            catch (RadiusException e) {
+                logger.error("Unable to complete authentication.", e.getMessage());
+                logger.debug("Authentication with RADIUS failed.", e);
+                return null;
+            }
+            catch (NoSuchAlgorithmException e) {
+                logger.error("No such RADIUS algorithm: {}", e.getMessage());
+                logger.debug("Unknown RADIUS algorithm.", e);
+                return null;
+            }
+            catch (UnknownHostException e) {
+                logger.error("Could not resolve address: {}", e.getMessage());
+                logger.debug("Exception resolving host address.", e);
+                return null;
+            }
+            finally {
+
+                // Clients whose requests did not complete normally may have
+                // late responses pending and must not be reused
+                if (reusable)
+                    server.releaseClient(radiusClient, attemptTimeout);
+                else
+                    server.discardClient(radiusClient);
+
+            }
+
+        }
+
+        logger.error("No RADIUS server could be contacted.");
+        return null;
+
+    }
+
+    /**
+     * Sends an authentication request to the RADIUS server associated with
+     * the given RadiusClient, silently processing any challenges which do not
+     * require user input, and returns the final response.
+     *
+     * @param radiusClient
+     *     The RadiusClient to use to communicate with the RADIUS server.
+     *
+     * @param username
+     *     The username for the authentication.
+     *
+     * @param secret
+     *     The secret, usually a password or challenge response, to send
+     *     to authenticate to the RADIUS server.
+     *
+     * @param clientAddress
+     *     The IP address of the client, if known, which will be set in as
+     *     the RADIUS client address.
+     *
+     * @param state
+     *     The previous state of the RADIUS connection, if any.
+     *
+     * @param retries
+     *     The number of times each request may be retried if the RADIUS
+     *     server does not respond within the timeout of the given client.
+     *
+     * @return
+     *     The final response of the RADIUS server.
+     *
+     * @throws GuacamoleException
+     *     If the RADIUS configuration cannot be read.
+     *
+     * @throws RadiusException
+     *     If the RADIUS server cannot be reached or its response is invalid.
+     *
+     * @throws NoSuchAlgorithmException
+     *     If the configured authentication protocol requires an unsupported
+     *     algorithm.
+     *
+     * @throws UnknownHostException
+     *     If the client address cannot be parsed.
+     */
+    private RadiusResponse sendReceive(RadiusClient radiusClient,
+            String username, String secret, String clientAddress, byte[] state,
+            int retries) throws GuacamoleException, RadiusException,
+            NoSuchAlgorithmException, UnknownHostException {
 
         // Set up the RadiusAuthenticator
         RadiusAuthenticator radAuth = getRadiusAuthenticator();
 
         // Add attributes to the connection and send the packet
-        try {
-            AttributeList radAttrs = new AttributeList();
-            radAttrs.add(new Attr_UserName(username));
-            radAttrs.add(new Attr_ClientIPAddress(InetAddress.getByName(clientAddress)));
-            radAttrs.add(new Attr_NASIPAddress(confService.getRadiusNasIp()));
-            radAttrs.add(new Attr_NASPortType(Attr_NASPortType.Virtual));
-            if (state != null && state.length > 0)
-                radAttrs.add(new Attr_State(state));
-            radAttrs.add(new Attr_UserPassword(secret));
-            radAttrs.add(new Attr_CleartextPassword(secret));
-
-            AccessRequest radAcc = new AccessRequest(radiusClient);
-
-            // EAP-TTLS tunnels protected attributes inside the TLS layer
-            if (radAuth instanceof EAPTTLSAuthenticator) {
-                radAuth.setUsername(new Attr_UserName(username));
-                ((EAPTTLSAuthenticator)radAuth).setTunneledAttributes(radAttrs);
-            }
-            else
-                radAcc.addAttributes(radAttrs);
-
-            radAuth.setupRequest(radiusClient, radAcc);
-            radAuth.processRequest(radAcc);
-            RadiusResponse reply = radiusClient.sendReceive(radAcc,
-                    confService.getRadiusMaxRetries());
-
-            // We receive a Challenge not asking for user input, so silently process the challenge
-            while((reply instanceof AccessChallenge) 
-                    && (reply.findAttribute(Attr_ReplyMessage.TYPE) == null)) {
-                
-                radAuth.processChallenge(radAcc, reply);
-                reply = radiusClient.sendReceive(radAcc,
-                        confService.getRadiusMaxRetries());
-                
-            }
+        AttributeList radAttrs = new AttributeList();
+        radAttrs.add(new Attr_UserName(username));
+        radAttrs.add(new Attr_ClientIPAddress(InetAddress.getByName(clientAddress)));
+        radAttrs.add(new Attr_NASIPAddress(confService.getRadiusNasIp()));
+        radAttrs.add(new Attr_NASPortType(Attr_NASPortType.Virtual));
+        if (state != null && state.length > 0)
+            radAttrs.add(new Attr_State(state));
+        radAttrs.add(new Attr_UserPassword(secret));
+        radAttrs.add(new Attr_CleartextPassword(secret));
+
+        AccessRequest radAcc = new AccessRequest(radiusClient);
+
+        // EAP-TTLS tunnels protected attributes inside the TLS layer
+        if (radAuth instanceof EAPTTLSAuthenticator) {
+            radAuth.setUsername(new Attr_UserName(username));
+            ((EAPTTLSAuthenticator)radAuth).setTunneledAttributes(radAttrs);
+        }
+        else
+            radAcc.addAttributes(radAttrs);
+
+        radAuth.setupRequest(radiusClient, radAcc);
+        radAuth.processRequest(radAcc);
+        RadiusResponse reply = radiusClient.sendReceive(radAcc, retries);
+
+        // We receive a Challenge not asking for user input, so silently process the challenge
+        while((reply instanceof AccessChallenge) 
+                && (reply.findAttribute(Attr_ReplyMessage.TYPE) == null)) {
             
-            return reply;
+            radAuth.processChallenge(radAcc, reply);
+            reply = radiusClient.sendReceive(radAcc, retries);
             
         }
-        catch (RadiusException e) {
-            logger.error("Unable to complete authentication.", e.getMessage());
-            logger.debug("Authentication with RADIUS failed.", e);
-            return null;
-        }
-        catch (NoSuchAlgorithmException e) {
-            logger.error("No such RADIUS algorithm: {}", e.getMessage());
-            logger.debug("Unknown RADIUS algorithm.", e);
-            return null;
-        }
-        catch (UnknownHostException e) {
-            logger.error("Could not resolve address: {}", e.getMessage());
-            logger.debug("Exception resolving host address.", e);
-            return null;
-        }
-        finally {
-            radiusClient.close();
-        }
+        
+        return reply;
+
     }
 
     /**
@@ -312,4 +535,16 @@ public class RadiusConnectionService {
 
     }
 
+    /**
+     * Closes all idle RadiusClient instances held for reuse. This must be
+     * invoked during webapp shutdown in order to avoid resource leaks.
+     */
+    public void shutdown() {
+        List<RadiusServer> current = servers;
+        if (current != null) {
+            for (RadiusServer server : current)
+                server.close();
+        }
+    }
+
 }
@@ -0,0 +1,365 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+package org.apache.guacamole.auth.radius;
+
+import java.io.IOException;
+import java.net.InetAddress;
+import java.util.Queue;
+import java.util.concurrent.ConcurrentHashMap;
+import java.util.concurrent.ConcurrentLinkedQueue;
+import java.util.concurrent.ConcurrentMap;
+import java.util.concurrent.atomic.AtomicInteger;
+import net.jradius.client.RadiusClient;
+import org.apache.guacamole.GuacamoleException;
+import org.apache.guacamole.GuacamoleServerException;
+
+/**
+ * A single RADIUS server, tracking the health of that server and maintaining
+ * a pool of long-lived RadiusClient instances (and thus UDP sockets) which
+ * are reused across authentication attempts. As the timeout of a RadiusClient
+ * is fixed when that client is created, idle clients are pooled separately
+ * for each timeout.
+ */
+public class RadiusServer {
+
+    /**
+     * The maximum number of idle RadiusClient instances to retain for reuse,
+     * across all timeouts.
+     */
+    private static final int MAX_IDLE_CLIENTS = 16;
+
+    /**
+     * The amount of time that a server is avoided after its first
+     * consecutive failure, in milliseconds. This doubles with each further
+     * consecutive failure, up to MAX_HOLD_DOWN.
+     */
+    private static final long MIN_HOLD_DOWN = 5000;
+
+    /**
+     * The maximum amount of time that a server which has failed is avoided,
+     * in milliseconds.
+     */
+    private static final long MAX_HOLD_DOWN = 300000;
+
+    /**
+     * The hostname or IP address of this RADIUS server.
+     */
+    private final String hostname;
+
+    /**
+     * The UDP port to use for authentication requests.
+     */
+    private final int authPort;
+
+    /**
+     * The UDP port to use for accounting requests.
+     */
+    private final int acctPort;
+
+    /**
+     * Idle RadiusClient instances which may be reused, stored by the timeout
+     * of each client, in seconds.
+     */
+    private final ConcurrentMap<Integer, Queue<RadiusClient>> idleClients =
+            new ConcurrentHashMap<>();
+
+    /**
+     * The total number of RadiusClient instances within idleClients.
+     */
+    private final AtomicInteger idleCount = new AtomicInteger();
+
+    /**
+     * The number of consecutive failed requests to this server.
+     */
+    private int failures = 0;
+
+    /**
+     * The time before which this server should be avoided due to failures,
+     * as a UNIX-style epoch timestamp in milliseconds.
+     */
+    private long retryAfter = 0;
+
+    /**
+     * Creates a new RadiusServer representing the server at the given
+     * hostname and ports.
+     *
+     * @param hostname
+     *     The hostname or IP address of the RADIUS server.
+     *
+     * @param authPort
+     *     The UDP port to use for authentication requests.
+     *
+     * @param acctPort
+     *     The UDP port to use for accounting requests.
+     */
+    public RadiusServer(String hostname, int authPort, int acctPort) {
+        this.hostname = hostname;
+        this.authPort = authPort;
+        this.acctPort = acctPort;
+    }
+
+    /**
+     * Parses the given server specification, which is a hostname or IP
+     * address optionally followed by a colon and an authentication port.
+     * IPv6 addresses which are followed by a port must be enclosed in
+     * brackets.
+     *
+     * @param spec
+     *     The server specification to parse.
+     *
+     * @param defaultAuthPort
+     *     The authentication port to use if the specification does not
+     *     include a port.
+     *
+     * @param acctPort
+     *     The UDP port to use for accounting requests.
+     *
+     * @return
+     *     A new RadiusServer representing the specified server.
+     *
+     * @throws GuacamoleException
+     *     If the specification is not valid.
+     */
+    public static RadiusServer parse(String spec, int defaultAuthPort,
+            int acctPort) throws GuacamoleException {
+
+        String hostname = spec.trim();
+        int authPort = defaultAuthPort;
+
+        // Bracketed IPv6 address, optionally followed by a port
+        if (hostname.startsWith("[")) {
+            int end = hostname.indexOf(']');
+            if (end == -1)
+                throw new GuacamoleServerException("Invalid RADIUS server "
+                        + "\"" + spec + "\": Missing \"]\".");
+
+            String remainder = hostname.substring(end + 1);
+            hostname = hostname.substring(1, end);
+            if (remainder.startsWith(":"))
+                authPort = parsePort(spec, remainder.substring(1));
+            else if (!remainder.isEmpty())
+                throw new GuacamoleServerException("Invalid RADIUS server "
+                        + "\"" + spec + "\".");
+        }
+
+        // Hostname or IPv4 address, optionally followed by a port (a
+        // hostname containing multiple colons is an unbracketed IPv6 address
+        // without a port)
+        else {
+            int colon = hostname.indexOf(':');
+            if (colon != -1 && colon == hostname.lastIndexOf(':')) {
+                authPort = parsePort(spec, hostname.substring(colon + 1));
+                hostname = hostname.substring(0, colon);
+            }
+        }
+
+        return new RadiusServer(hostname, authPort, acctPort);
+
+    }
+
+    /**
+     * Parses the given port number from a server specification.
+     *
+     * @param spec
+     *     The full server specification, for the sake of error messages.
+     *
+     * @param port
+     *     The port number to parse.
+     *
+     * @return
+     *     The parsed port number.
+     *
+     * @throws GuacamoleException
+     *     If the port number is not valid.
+     */
+    private static int parsePort(String spec, String port)
+            throws GuacamoleException {
+        try {
+            return Integer.parseInt(port);
+        }
+        catch (NumberFormatException e) {
+            throw new GuacamoleServerException("Invalid port within RADIUS "
+                    + "server \"" + spec + "\".", e);
+        }
+    }
+
+    /**
+     * Returns the queue of idle RadiusClient instances having the given
+     * timeout, creating that queue if it does not yet exist.
+     *
+     * @param timeout
+     *     The timeout of the clients within the queue, in seconds.
+     *
+     * @return
+     *     The queue of idle RadiusClient instances having the given timeout.
+     */
+    private Queue<RadiusClient> getIdleClients(int timeout) {
+        return idleClients.computeIfAbsent(timeout, (key) -> new ConcurrentLinkedQueue<>());
+    }
+
+    /**
+     * Returns an idle RadiusClient connected to this server and having the
+     * given timeout, creating a new RadiusClient if no such idle RadiusClient
+     * is available. The returned client must later be passed to either
+     * releaseClient() (along with the same timeout) or discardClient().
+     *
+     * @param sharedSecret
+     *     The shared secret to use when communicating with this server.
+     *
+     * @param timeout
+     *     The timeout for each request to this server, in seconds.
+     *
+     * @return
+     *     A RadiusClient connected to this server.
+     *
+     * @throws GuacamoleException
+     *     If the hostname of this server cannot be resolved, or the client
+     *     cannot be created.
+     */
+    public RadiusClient acquireClient(String sharedSecret, int timeout)
+            throws GuacamoleException {
+
+        RadiusClient client = getIdleClients(timeout).poll();
+        if (client != null) {
+            idleCount.decrementAndGet();
+            return client;
+        }
+
+        return createClient(sharedSecret, timeout);
+
+    }
+
+    /**
+     * Creates a new RadiusClient connected to this server.
+     *
+     * @param sharedSecret
+     *     The shared secret to use when communicating with this server.
+     *
+     * @param timeout
+     *     The timeout for each request to this server, in seconds.
+     *
+     * @return
+     *     A new RadiusClient connected to this server.
+     *
+     * @throws GuacamoleException
+     *     If the hostname of this server cannot be resolved, or the client
+     *     cannot be created.
+     */
+    private RadiusClient createClient(String sharedSecret, int timeout)
+            throws GuacamoleException {
+
+        try {
+            return new RadiusClient(InetAddress.getByName(hostname),
+                    sharedSecret, authPort, acctPort, timeout);
+        }
+        catch (IOException e) {
+            throw new GuacamoleServerException("Failed to communicate with "
+                    + "RADIUS server \"" + this + "\".", e);
+        }
+
+    }
+
+    /**
+     * Returns the given RadiusClient, which must have been obtained through
+     * acquireClient() and must have completed its last request normally, to
+     * the pool of idle clients for reuse.
+     *
+     * @param client
+     *     The RadiusClient to release.
+     *
+     * @param timeout
+     *     The timeout that was given to acquireClient() when the client was
+     *     obtained, in seconds.
+     */
+    public void releaseClient(RadiusClient client, int timeout) {
+
+        if (idleCount.incrementAndGet() <= MAX_IDLE_CLIENTS)
+            getIdleClients(timeout).add(client);
+
+        else {
+            idleCount.decrementAndGet();
+            client.close();
+        }
+
+    }
+
+    /**
+     * Closes the given RadiusClient, which must have been obtained through
+     * acquireClient(), such that it will not be reused. This must be used
+     * for any client whose socket may have unread data, such as a client
+     * whose last request timed out.
+     *
+     * @param client
+     *     The RadiusClient to discard.
+     */
+    public void discardClient(RadiusClient client) {
+        client.close();
+    }
+
+    /**
+     * Returns whether this server is currently believed to be healthy, and
+     * thus should be tried before servers which have recently failed.
+     *
+     * @return
+     *     true if this server has not failed recently, false otherwise.
+     */
+    public synchronized boolean isAvailable() {
+        return System.currentTimeMillis() >= retryAfter;
+    }
+
+    /**
+     * Records that a request to this server has succeeded, marking this
+     * server as healthy.
+     */
+    public synchronized void markSucceeded() {
+        failures = 0;
+        retryAfter = 0;
+    }
+
+    /**
+     * Records that a request to this server has failed, causing this server
+     * to be avoided for an amount of time which increases with the number of
+     * consecutive failures.
+     */
+    public synchronized void markFailed() {
+        failures++;
+        long holdDown = MIN_HOLD_DOWN << Math.min(failures - 1, 16);
+        retryAfter = System.currentTimeMillis() + Math.min(holdDown, MAX_HOLD_DOWN);
+    }
+
+    /**
+     * Closes all idle RadiusClient instances.
+     */
+    public void close() {
+        for (Queue<RadiusClient> clients : idleClients.values()) {
+            RadiusClient client;
+            while ((client = clients.poll()) != null) {
+                idleCount.decrementAndGet();
+                client.close();
+            }
+        }
+    }
+
+    @Override
+    public String toString() {
+        return hostname + ":" + authPort;
+    }
+
+}
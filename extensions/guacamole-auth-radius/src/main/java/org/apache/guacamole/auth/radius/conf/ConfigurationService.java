@@ -23,6 +23,8 @@ import com.google.inject.Inject;
 import java.io.File;
 import java.net.InetAddress;
 import java.net.UnknownHostException;
+import java.util.Collections;
+import java.util.List;
 import org.apache.guacamole.GuacamoleException;
 import org.apache.guacamole.GuacamoleServerException;
 import org.apache.guacamole.environment.Environment;
@@ -39,20 +41,22 @@ public class ConfigurationService {
     private Environment environment;
 
     /**
-     * Returns the hostname of the RADIUS server as configured with
-     * guacamole.properties. By default, this will be "localhost".
+     * Returns the hostnames of the RADIUS servers as configured with
+     * guacamole.properties, each optionally followed by a colon and the
+     * authentication port of that server. By default, this will be a list
+     * containing only "localhost".
      *
      * @return
-     *     The hostname of the RADIUS server, as configured with
+     *     The hostnames of the RADIUS servers, as configured with
      *     guacamole.properties.
      *
      * @throws GuacamoleException
      *     If guacamole.properties cannot be parsed.
      */
-    public String getRadiusServer() throws GuacamoleException {
+    public List<String> getRadiusServers() throws GuacamoleException {
         return environment.getProperty(
             RadiusGuacamoleProperties.RADIUS_HOSTNAME,
-            "localhost"
+            Collections.singletonList("localhost")
         );
     }
 
@@ -169,6 +173,28 @@ public class ConfigurationService {
         );
     }
 
+    /**
+     * Returns the maximum amount of time, in seconds, to spend on a single
+     * RADIUS authentication attempt across all retries and servers, as
+     * configured in guacamole.properties. By default, this will be the time
+     * needed for a single server to exhaust all retries (the timeout
+     * multiplied by one more than the number of retries), such that a single
+     * server is given as long as it would have been without a deadline.
+     *
+     * @return
+     *     The maximum amount of time, in seconds, to spend on a single RADIUS
+     *     authentication attempt.
+     *
+     * @throws GuacamoleException
+     *     If guacamole.properties cannot be parsed.
+     */
+    public int getRadiusRequestDeadline() throws GuacamoleException {
+        return environment.getProperty(
+            RadiusGuacamoleProperties.RADIUS_REQUEST_DEADLINE,
+            getRadiusTimeout() * (getRadiusMaxRetries() + 1)
+        );
+    }
+
     /**
      * Returns the CA file for validating certificates for encrypted
      * connections to the RADIUS server, as configured in
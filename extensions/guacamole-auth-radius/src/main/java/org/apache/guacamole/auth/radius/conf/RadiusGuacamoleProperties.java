@@ -24,6 +24,7 @@ import org.apache.guacamole.properties.EnumGuacamoleProperty;
 import org.apache.guacamole.properties.FileGuacamoleProperty;
 import org.apache.guacamole.properties.IntegerGuacamoleProperty;
 import org.apache.guacamole.properties.StringGuacamoleProperty;
+import org.apache.guacamole.properties.StringListProperty;
 
 
 /**
@@ -61,8 +62,13 @@ public class RadiusGuacamoleProperties {
 
     /**
      * The hostname or IP address of the RADIUS server to connect to when authenticating users.
+     * Multiple servers may be specified as a comma-separated list, in which
+     * case requests are distributed among the servers round-robin, failing
+     * over to other servers if a server does not respond. Each server may
+     * optionally specify its own authentication port using "host:port"
+     * notation (with IPv6 addresses enclosed in brackets).
      */
-    public static final StringGuacamoleProperty RADIUS_HOSTNAME = new StringGuacamoleProperty() {
+    public static final StringListProperty RADIUS_HOSTNAME = new StringListProperty() {
 
         @Override
         public String getName() { return "radius-hostname"; }
@@ -170,6 +176,19 @@ public class RadiusGuacamoleProperties {
 
     };
 
+    /**
+     * The maximum amount of time to spend on a single RADIUS authentication
+     * attempt, in seconds, across all retries and servers. The remaining time
+     * is divided evenly among the servers not yet tried, with the timeout and
+     * number of retries used for each server reduced as necessary to fit.
+     */
+    public static final IntegerGuacamoleProperty RADIUS_REQUEST_DEADLINE = new IntegerGuacamoleProperty() {
+
+        @Override
+        public String getName() { return "radius-request-deadline"; }
+
+    };
+
     /**
      * Whether or not to trust all RADIUS server certificates.
      */
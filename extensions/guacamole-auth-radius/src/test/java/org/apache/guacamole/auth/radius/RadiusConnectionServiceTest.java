@@ -0,0 +1,409 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+package org.apache.guacamole.auth.radius;
+
+import com.google.inject.AbstractModule;
+import com.google.inject.Guice;
+import java.io.IOException;
+import java.net.DatagramPacket;
+import java.net.DatagramSocket;
+import java.net.InetAddress;
+import java.net.InetSocketAddress;
+import java.nio.charset.StandardCharsets;
+import java.security.MessageDigest;
+import java.security.NoSuchAlgorithmException;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.HashMap;
+import java.util.HashSet;
+import java.util.List;
+import java.util.Map;
+import net.jradius.packet.AccessAccept;
+import org.apache.guacamole.GuacamoleException;
+import org.apache.guacamole.GuacamoleServerException;
+import org.apache.guacamole.environment.DelegatingEnvironment;
+import org.apache.guacamole.environment.Environment;
+import org.apache.guacamole.properties.GuacamoleProperty;
+import org.junit.After;
+import org.junit.Test;
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertTrue;
+
+/**
+ * Test which verifies that RadiusConnectionService reuses its RADIUS clients
+ * across authentication attempts and fails over between RADIUS servers.
+ * Local stub RADIUS servers, which either accept every request or never
+ * respond, are used in place of actual RADIUS servers.
+ */
+public class RadiusConnectionServiceTest {
+
+    /**
+     * The shared secret used by the stub RADIUS servers.
+     */
+    private static final String SHARED_SECRET = "testing123";
+
+    /**
+     * Environment which defines only the properties explicitly set through
+     * setProperty(), leaving all other properties undefined.
+     */
+    private static class TestEnvironment extends DelegatingEnvironment {
+
+        /**
+         * The values of all defined properties, by property name.
+         */
+        private final Map<String, String> properties = new HashMap<>();
+
+        /**
+         * Creates a new TestEnvironment. No other Environment is actually
+         * delegated to.
+         */
+        public TestEnvironment() {
+            super(null);
+        }
+
+        /**
+         * Defines the property having the given name.
+         *
+         * @param name
+         *     The name of the property to define.
+         *
+         * @param value
+         *     The value to assign to the property.
+         */
+        public void setProperty(String name, String value) {
+            properties.put(name, value);
+        }
+
+        @Override
+        public <Type> Type getProperty(GuacamoleProperty<Type> property)
+                throws GuacamoleException {
+            return getProperty(property, null);
+        }
+
+        @Override
+        public <Type> Type getProperty(GuacamoleProperty<Type> property,
+                Type defaultValue) throws GuacamoleException {
+
+            Type value = property.parseValue(properties.get(property.getName()));
+            if (value == null)
+                return defaultValue;
+
+            return value;
+
+        }
+
+        @Override
+        public <Type> Type getRequiredProperty(GuacamoleProperty<Type> property)
+                throws GuacamoleException {
+
+            Type value = getProperty(property);
+            if (value == null)
+                throw new GuacamoleServerException("Property "
+                        + property.getName() + " is required.");
+
+            return value;
+
+        }
+
+    }
+
+    /**
+     * Stub RADIUS server which either accepts every Access-Request or never
+     * responds at all, recording the source port of each request received.
+     */
+    private static class RadiusStub implements Runnable {
+
+        /**
+         * The socket on which requests are received.
+         */
+        private final DatagramSocket socket;
+
+        /**
+         * Whether requests should be accepted. If false, requests are
+         * silently ignored.
+         */
+        private final boolean respond;
+
+        /**
+         * The source port of each request received, in order of receipt.
+         */
+        private final List<Integer> sourcePorts = new ArrayList<>();
+
+        /**
+         * Creates and starts a new RadiusStub listening on an arbitrary
+         * loopback port.
+         *
+         * @param respond
+         *     Whether requests should be accepted. If false, requests are
+         *     silently ignored.
+         *
+         * @throws IOException
+         *     If the socket cannot be created.
+         */
+        public RadiusStub(boolean respond) throws IOException {
+            this.socket = new DatagramSocket(new InetSocketAddress(InetAddress.getLoopbackAddress(), 0));
+            this.respond = respond;
+            new Thread(this, "radius-stub").start();
+        }
+
+        /**
+         * Returns the server specification which refers to this stub, as
+         * would be provided within the "radius-hostname" property.
+         *
+         * @return
+         *     The server specification which refers to this stub.
+         */
+        public String getSpec() {
+            return "127.0.0.1:" + socket.getLocalPort();
+        }
+
+        /**
+         * Returns the source port of each request received so far, in order
+         * of receipt.
+         *
+         * @return
+         *     The source port of each request received.
+         */
+        public synchronized List<Integer> getSourcePorts() {
+            return new ArrayList<>(sourcePorts);
+        }
+
+        /**
+         * Returns an Access-Accept response to the request having the given
+         * identifier and request authenticator, containing no attributes.
+         *
+         * @param identifier
+         *     The identifier of the request.
+         *
+         * @param requestAuthenticator
+         *     The 16-byte request authenticator of the request.
+         *
+         * @return
+         *     The Access-Accept response.
+         *
+         * @throws NoSuchAlgorithmException
+         *     If MD5 is not supported.
+         */
+        private static byte[] accept(byte identifier,
+                byte[] requestAuthenticator) throws NoSuchAlgorithmException {
+
+            byte[] response = new byte[20];
+            response[0] = 2; // Access-Accept
+            response[1] = identifier;
+            response[3] = 20; // Length
+
+            // Response authenticator is the MD5 of the response, using the
+            // request authenticator, followed by the shared secret (RFC 2865)
+            MessageDigest md5 = MessageDigest.getInstance("MD5");
+            md5.update(response, 0, 4);
+            md5.update(requestAuthenticator);
+            md5.update(SHARED_SECRET.getBytes(StandardCharsets.UTF_8));
+            System.arraycopy(md5.digest(), 0, response, 4, 16);
+
+            return response;
+
+        }
+
+        @Override
+        public void run() {
+
+            byte[] buffer = new byte[4096];
+            try {
+                while (true) {
+
+                    DatagramPacket request = new DatagramPacket(buffer, buffer.length);
+                    socket.receive(request);
+
+                    synchronized (this) {
+                        sourcePorts.add(request.getPort());
+                    }
+
+                    if (!respond || request.getLength() < 20)
+                        continue;
+
+                    byte[] response = accept(buffer[1], Arrays.copyOfRange(buffer, 4, 20));
+                    socket.send(new DatagramPacket(response, response.length,
+                            request.getSocketAddress()));
+
+                }
+            }
+            catch (IOException | NoSuchAlgorithmException e) {
+                // Socket closed
+            }
+
+        }
+
+        /**
+         * Stops this stub, closing its socket.
+         */
+        public void close() {
+            socket.close();
+        }
+
+    }
+
+    /**
+     * The environment providing the configuration of the service under test.
+     */
+    private final TestEnvironment environment = new TestEnvironment();
+
+    /**
+     * All stub RADIUS servers started by the current test.
+     */
+    private final List<RadiusStub> stubs = new ArrayList<>();
+
+    /**
+     * The service under test, if created.
+     */
+    private RadiusConnectionService service;
+
+    /**
+     * Stops the service under test and all stub RADIUS servers.
+     */
+    @After
+    public void tearDown() {
+
+        if (service != null)
+            service.shutdown();
+
+        for (RadiusStub stub : stubs)
+            stub.close();
+
+    }
+
+    /**
+     * Starts a new stub RADIUS server.
+     *
+     * @param respond
+     *     Whether the stub should accept requests. If false, requests are
+     *     silently ignored.
+     *
+     * @return
+     *     The new stub RADIUS server.
+     *
+     * @throws IOException
+     *     If the stub cannot be started.
+     */
+    private RadiusStub startStub(boolean respond) throws IOException {
+        RadiusStub stub = new RadiusStub(respond);
+        stubs.add(stub);
+        return stub;
+    }
+
+    /**
+     * Creates the service under test, configured to use the given stub
+     * RADIUS servers with PAP and the given timing.
+     *
+     * @param timeout
+     *     The value of the "radius-timeout" property, in seconds.
+     *
+     * @param deadline
+     *     The value of the "radius-request-deadline" property, in seconds.
+     *
+     * @param servers
+     *     The stub RADIUS servers to use, in order.
+     */
+    private void createService(int timeout, int deadline, RadiusStub... servers) {
+
+        StringBuilder hostnames = new StringBuilder();
+        for (RadiusStub server : servers) {
+            if (hostnames.length() > 0)
+                hostnames.append(',');
+            hostnames.append(server.getSpec());
+        }
+
+        environment.setProperty("radius-hostname", hostnames.toString());
+        environment.setProperty("radius-shared-secret", SHARED_SECRET);
+        environment.setProperty("radius-auth-protocol", "pap");
+        environment.setProperty("radius-nas-ip", "127.0.0.1");
+        environment.setProperty("radius-max-retries", "0");
+        environment.setProperty("radius-timeout", Integer.toString(timeout));
+        environment.setProperty("radius-request-deadline", Integer.toString(deadline));
+
+        service = Guice.createInjector(new AbstractModule() {
+
+            @Override
+            protected void configure() {
+                bind(Environment.class).toInstance(environment);
+            }
+
+        }).getInstance(RadiusConnectionService.class);
+
+    }
+
+    /**
+     * Verifies that the RADIUS client used for an authentication attempt is
+     * reused by later attempts to the same server, even if its timeout has
+     * been reduced to fit within the request deadline.
+     *
+     * @throws Exception
+     *     If the stub RADIUS servers cannot be started or authentication
+     *     fails.
+     */
+    @Test
+    public void testClientReused() throws Exception {
+
+        RadiusStub first = startStub(true);
+        RadiusStub second = startStub(true);
+
+        // Each server is given half of the request deadline, which is less
+        // than the configured timeout
+        createService(3, 5, first, second);
+
+        for (int i = 0; i < 4; i++)
+            assertTrue(service.authenticate("user", "password", "127.0.0.1", null) instanceof AccessAccept);
+
+        // Requests alternate between servers, each server receiving all of
+        // its requests from the same client
+        for (RadiusStub stub : stubs) {
+            List<Integer> ports = stub.getSourcePorts();
+            assertEquals(2, ports.size());
+            assertEquals(1, new HashSet<>(ports).size());
+        }
+
+    }
+
+    /**
+     * Verifies that a server which does not respond is failed over to the
+     * next server, and is then avoided by later attempts.
+     *
+     * @throws Exception
+     *     If the stub RADIUS servers cannot be started or authentication
+     *     fails.
+     */
+    @Test
+    public void testFailover() throws Exception {
+
+        RadiusStub silent = startStub(false);
+        RadiusStub responding = startStub(true);
+        createService(1, 5, silent, responding);
+
+        for (int i = 0; i < 3; i++)
+            assertTrue(service.authenticate("user", "password", "127.0.0.1", null) instanceof AccessAccept);
+
+        assertEquals(1, silent.getSourcePorts().size());
+
+        List<Integer> ports = responding.getSourcePorts();
+        assertEquals(3, ports.size());
+        assertEquals(1, new HashSet<>(ports).size());
+
+    }
+
+}
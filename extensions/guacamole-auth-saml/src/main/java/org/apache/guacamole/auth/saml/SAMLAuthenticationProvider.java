@@ -22,6 +22,7 @@ package org.apache.guacamole.auth.saml;
 import com.google.inject.Guice;
 import com.google.inject.Injector;
 import org.apache.guacamole.GuacamoleException;
+import org.apache.guacamole.auth.saml.conf.ConfigurationService;
 import org.apache.guacamole.net.auth.AuthenticatedUser;
 import org.apache.guacamole.net.auth.AbstractAuthenticationProvider;
 import org.apache.guacamole.net.auth.Credentials;
@@ -77,10 +78,17 @@ public class SAMLAuthenticationProvider extends AbstractAuthenticationProvider {
         return authProviderService.authenticateUser(credentials);
 
     }
+
+    @Override
+    public boolean isUserContextReusable() {
+        // No UserContexts are provided, and no decoration is applied
+        return true;
+    }
     
     @Override
     public void shutdown() {
         injector.getInstance(SAMLResponseMap.class).shutdown();
+        injector.getInstance(ConfigurationService.class).shutdown();
     }
 
 }
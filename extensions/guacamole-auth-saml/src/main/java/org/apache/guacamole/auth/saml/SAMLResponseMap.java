@@ -21,14 +21,17 @@ package org.apache.guacamole.auth.saml;
 
 import com.google.inject.Singleton;
 import com.onelogin.saml2.authn.SamlResponse;
-import com.onelogin.saml2.exception.ValidationError;
-import java.util.Collection;
-import java.util.Iterator;
-import java.util.concurrent.ConcurrentHashMap;
-import java.util.concurrent.ConcurrentMap;
+import com.onelogin.saml2.util.Constants;
 import java.util.concurrent.Executors;
 import java.util.concurrent.ScheduledExecutorService;
+import java.util.concurrent.ThreadFactory;
 import java.util.concurrent.TimeUnit;
+import javax.xml.bind.DatatypeConverter;
+import org.apache.guacamole.cache.ExpiringMap;
+import org.slf4j.Logger;
+import org.slf4j.LoggerFactory;
+import org.w3c.dom.Element;
+import org.w3c.dom.NodeList;
 
 /**
  * A class that handles mapping of hashes to SAMLResponse objects.
@@ -36,18 +39,50 @@ import java.util.concurrent.TimeUnit;
 @Singleton
 public class SAMLResponseMap {
     
+    /**
+     * Logger for this class.
+     */
+    private static final Logger logger = LoggerFactory.getLogger(SAMLResponseMap.class);
+
+    /**
+     * The maximum amount of time that a SAML response may remain unclaimed
+     * within the map, in milliseconds, regardless of the validity period of
+     * its assertions.
+     */
+    private static final long MAX_RESPONSE_AGE = 300000;
+
+    /**
+     * The maximum number of unclaimed SAML responses which may be stored
+     * within the map at any one time. Once this limit is reached, storing a
+     * new response discards the unclaimed response which would otherwise
+     * expire soonest, such that posting large numbers of responses cannot
+     * prevent new logins.
+     */
+    private static final int MAX_RESPONSES = 10000;
+
     /**
      * The internal data structure that holds a map of SHA-256 hashes to
-     * SAML responses.
+     * SAML responses, each of which is automatically removed if unclaimed
+     * once its assertions are no longer valid or after MAX_RESPONSE_AGE
+     * milliseconds, whichever is sooner.
      */
-    private final ConcurrentMap<String, SamlResponse> samlResponseMap =
-        new ConcurrentHashMap<>();
+    private final ExpiringMap<String, SamlResponse> samlResponseMap =
+        new ExpiringMap<>(MAX_RESPONSES);
     
     /**
      * Executor service which runs the periodic cleanup task
      */
     private final ScheduledExecutorService executor =
-            Executors.newScheduledThreadPool(1);
+            Executors.newSingleThreadScheduledExecutor(new ThreadFactory() {
+
+        @Override
+        public Thread newThread(Runnable runnable) {
+            Thread thread = new Thread(runnable, "saml-response-cleanup");
+            thread.setDaemon(true);
+            return thread;
+        }
+
+    });
 
     /**
      * Create a new instance of this response map and kick off the executor
@@ -58,6 +93,49 @@ public class SAMLResponseMap {
         executor.scheduleAtFixedRate(new SAMLResponseCleanupTask(), 5, 5, TimeUnit.MINUTES);
     }
     
+    /**
+     * Returns the time after which the given SAML response should be removed
+     * from the map if unclaimed. This is the earliest NotOnOrAfter timestamp
+     * of the conditions of its assertions, limited to MAX_RESPONSE_AGE
+     * milliseconds from now.
+     *
+     * @param samlResponse
+     *     The SamlResponse to determine the expiration time of.
+     *
+     * @return
+     *     The time after which the given SAML response should be removed, as
+     *     a UNIX-style epoch timestamp in milliseconds.
+     */
+    private static long getExpiration(SamlResponse samlResponse) {
+
+        long expires = System.currentTimeMillis() + MAX_RESPONSE_AGE;
+
+        NodeList conditions = samlResponse.getSAMLResponseDocument()
+                .getElementsByTagNameNS(Constants.NS_SAML, "Conditions");
+
+        for (int i = 0; i < conditions.getLength(); i++) {
+
+            String notOnOrAfter = ((Element) conditions.item(i)).getAttribute("NotOnOrAfter");
+            if (notOnOrAfter.isEmpty())
+                continue;
+
+            // NotOnOrAfter is itself the first instant that the assertion is
+            // invalid, while entries remain valid through their expiration
+            try {
+                long invalid = DatatypeConverter.parseDateTime(notOnOrAfter).getTimeInMillis();
+                expires = Math.min(expires, invalid - 1);
+            }
+            catch (IllegalArgumentException e) {
+                logger.debug("Ignoring invalid NotOnOrAfter timestamp "
+                        + "\"{}\" of SAML response.", notOnOrAfter, e);
+            }
+
+        }
+
+        return expires;
+
+    }
+
     /**
      * Retrieve the SamlResponse from the map that is represented by the
      * provided hash, or null if no such object exists.
@@ -73,7 +151,8 @@ public class SAMLResponseMap {
     }
     
     /**
-     * Place the provided mapping of hash to SamlResponse into the map.
+     * Place the provided mapping of hash to SamlResponse into the map,
+     * replacing any unclaimed response having the same hash.
      * 
      * @param hash
      *     The hash that will be the lookup key for this SamlResponse.
@@ -82,7 +161,7 @@ public class SAMLResponseMap {
      *     The SamlResponse object.
      */
     protected void putSamlResponse(String hash, SamlResponse samlResponse) {
-        samlResponseMap.put(hash, samlResponse);
+        samlResponseMap.put(hash, samlResponse, getExpiration(samlResponse));
     }
     
     /**
@@ -100,24 +179,15 @@ public class SAMLResponseMap {
     
     /**
      * Task which runs every five minutes and cleans up any expired SAML
-     * responses that haven't been claimed and removed from the map.
+     * responses that haven't been claimed and removed from the map. Expired
+     * responses are also removed automatically as new responses are added;
+     * this task only releases memory while no new responses arrive.
      */
     private class SAMLResponseCleanupTask implements Runnable {
         
         @Override
         public void run() {
-
-            // Loop through responses in map and remove ones that are no longer valid.
-            Iterator<SamlResponse> responseIterator = samlResponseMap.values().iterator();
-            while (responseIterator.hasNext()) {
-                try {
-                    responseIterator.next().validateTimestamps();
-                }
-                catch (ValidationError e) {
-                    responseIterator.remove();
-                }
-            }
-
+            samlResponseMap.removeExpired();
         }
     
     }
@@ -20,27 +20,68 @@
 package org.apache.guacamole.auth.saml.conf;
 
 import com.google.inject.Inject;
+import com.google.inject.Singleton;
 import com.onelogin.saml2.settings.IdPMetadataParser;
 import com.onelogin.saml2.settings.Saml2Settings;
 import com.onelogin.saml2.settings.SettingsBuilder;
 import com.onelogin.saml2.util.Constants;
+import java.io.File;
+import java.io.InputStream;
 import java.net.URI;
+import java.net.URLConnection;
 import java.util.HashMap;
 import java.util.Map;
+import java.util.concurrent.Executors;
+import java.util.concurrent.ScheduledExecutorService;
+import java.util.concurrent.ThreadFactory;
+import java.util.concurrent.TimeUnit;
 import javax.ws.rs.core.UriBuilder;
+import javax.xml.XMLConstants;
+import javax.xml.parsers.DocumentBuilderFactory;
 import org.apache.guacamole.GuacamoleException;
 import org.apache.guacamole.GuacamoleServerException;
 import org.apache.guacamole.environment.Environment;
 import org.apache.guacamole.properties.BooleanGuacamoleProperty;
+import org.apache.guacamole.properties.IntegerGuacamoleProperty;
 import org.apache.guacamole.properties.StringGuacamoleProperty;
 import org.apache.guacamole.properties.URIGuacamoleProperty;
+import org.slf4j.Logger;
+import org.slf4j.LoggerFactory;
+import org.w3c.dom.Document;
 
 /**
  * Service for retrieving configuration information regarding the SAML
- * authentication module.
+ * authentication module. The SAML settings, including any IdP metadata, are
+ * parsed once and cached, being reloaded in the background only when the
+ * metadata file changes or the remote metadata expires.
  */
+@Singleton
 public class ConfigurationService {
 
+    /**
+     * Logger for this class.
+     */
+    private static final Logger logger = LoggerFactory.getLogger(ConfigurationService.class);
+
+    /**
+     * The default number of minutes that remote IdP metadata should be cached
+     * if the server providing that metadata does not specify an expiration
+     * time.
+     */
+    private static final int DEFAULT_IDP_METADATA_REFRESH_INTERVAL = 60;
+
+    /**
+     * The number of seconds between background checks for whether the cached
+     * SAML settings are stale.
+     */
+    private static final long METADATA_CHECK_INTERVAL = 30;
+
+    /**
+     * The maximum number of milliseconds to wait while connecting to or
+     * reading from a remote server providing IdP metadata.
+     */
+    private static final int METADATA_TIMEOUT = 10000;
+
     /**
      * The URI of the file containing the XML Metadata associated with the
      * SAML IdP.
@@ -145,12 +186,117 @@ public class ConfigurationService {
                 
     };
 
+    /**
+     * The number of minutes that IdP metadata retrieved from a remote server
+     * should be cached if that server does not specify an expiration time.
+     */
+    private static final IntegerGuacamoleProperty SAML_IDP_METADATA_REFRESH_INTERVAL =
+            new IntegerGuacamoleProperty() {
+
+        @Override
+        public String getName() { return "saml-idp-metadata-refresh-interval"; }
+
+    };
+
     /**
      * The Guacamole server environment.
      */
     @Inject
     private Environment environment;
 
+    /**
+     * Parsed SAML settings, along with the information necessary to determine
+     * whether those settings are stale.
+     */
+    private static class CachedSettings {
+
+        /**
+         * The parsed SAML settings.
+         */
+        private final Saml2Settings settings;
+
+        /**
+         * The last modification timestamp of the local IdP metadata file that
+         * the settings were parsed from, or zero if the metadata was not read
+         * from a local file.
+         */
+        private final long lastModified;
+
+        /**
+         * The timestamp after which the settings must be reloaded, or
+         * Long.MAX_VALUE if the settings do not expire.
+         */
+        private final long expires;
+
+        /**
+         * Creates a new CachedSettings wrapping the given parsed settings.
+         *
+         * @param settings
+         *     The parsed SAML settings.
+         *
+         * @param lastModified
+         *     The last modification timestamp of the local IdP metadata file
+         *     that the settings were parsed from, or zero if the metadata was
+         *     not read from a local file.
+         *
+         * @param expires
+         *     The timestamp after which the settings must be reloaded, or
+         *     Long.MAX_VALUE if the settings do not expire.
+         */
+        public CachedSettings(Saml2Settings settings, long lastModified,
+                long expires) {
+            this.settings = settings;
+            this.lastModified = lastModified;
+            this.expires = expires;
+        }
+
+    }
+
+    /**
+     * The most recently parsed SAML settings, or null if the settings have
+     * not yet been parsed.
+     */
+    private volatile CachedSettings cachedSettings;
+
+    /**
+     * Executor which periodically reloads the SAML settings in the background
+     * if they have become stale.
+     */
+    private final ScheduledExecutorService executor =
+            Executors.newSingleThreadScheduledExecutor(new ThreadFactory() {
+
+        @Override
+        public Thread newThread(Runnable runnable) {
+            Thread thread = new Thread(runnable, "saml-metadata-refresh");
+            thread.setDaemon(true);
+            return thread;
+        }
+
+    });
+
+    /**
+     * Creates a new ConfigurationService and schedules the periodic
+     * background check for stale SAML settings.
+     */
+    public ConfigurationService() {
+        executor.scheduleWithFixedDelay(new Runnable() {
+
+            @Override
+            public void run() {
+                try {
+                    refreshSamlSettings();
+                }
+                catch (GuacamoleException e) {
+                    logger.warn("Unable to reload SAML settings. The previously "
+                            + "loaded settings will continue to be used: {}",
+                            e.getMessage());
+                    logger.debug("Reload of SAML settings failed.", e);
+                }
+            }
+
+        }, METADATA_CHECK_INTERVAL, METADATA_CHECK_INTERVAL, TimeUnit.SECONDS);
+    }
+
     /**
      * Returns the URL to be submitted as the client ID to the SAML IdP, as
      * configured in guacamole.properties.
@@ -295,8 +441,158 @@ public class ConfigurationService {
         return environment.getProperty(SAML_GROUP_ATTRIBUTE, "groups");
     }
 
+    /**
+     * Returns the number of minutes that IdP metadata retrieved from a remote
+     * server should be cached if that server does not specify an expiration
+     * time, as configured in guacamole.properties. By default, this will be
+     * 60.
+     *
+     * @return
+     *     The number of minutes that remote IdP metadata should be cached by
+     *     default.
+     *
+     * @throws GuacamoleException
+     *     If guacamole.properties cannot be parsed.
+     */
+    private int getIdpMetadataRefreshInterval() throws GuacamoleException {
+        return environment.getProperty(SAML_IDP_METADATA_REFRESH_INTERVAL,
+                DEFAULT_IDP_METADATA_REFRESH_INTERVAL);
+    }
+
+    /**
+     * Returns the local file referenced by the given IdP metadata URI, or null
+     * if the URI does not refer to a local file.
+     *
+     * @param idpMetadata
+     *     The URI of the IdP metadata.
+     *
+     * @return
+     *     The local file referenced by the given URI, or null if the URI does
+     *     not refer to a local file.
+     */
+    private static File getLocalFile(URI idpMetadata) {
+
+        if (idpMetadata == null || !"file".equalsIgnoreCase(idpMetadata.getScheme()))
+            return null;
+
+        return new File(idpMetadata);
+
+    }
+
+    /**
+     * Returns the number of milliseconds that the given response from a
+     * remote server providing IdP metadata may be cached, as specified by the
+     * "Cache-Control" or "Expires" headers of that response. If the response
+     * does not specify an expiration time, -1 is returned.
+     *
+     * @param connection
+     *     The connection whose response should be inspected.
+     *
+     * @return
+     *     The number of milliseconds that the response may be cached, or -1
+     *     if the response does not specify an expiration time.
+     */
+    private static long getCacheLifetime(URLConnection connection) {
+
+        String cacheControl = connection.getHeaderField("Cache-Control");
+        if (cacheControl != null) {
+            for (String directive : cacheControl.split(",")) {
+
+                directive = directive.trim().toLowerCase();
+                if (directive.equals("no-cache") || directive.equals("no-store"))
+                    return 0;
+
+                if (directive.startsWith("max-age=")) {
+                    try {
+                        return Long.parseLong(directive.substring(8).trim()) * 1000;
+                    }
+                    catch (NumberFormatException e) {
+                        logger.debug("Ignoring invalid IdP metadata max-age: \"{}\"", directive);
+                    }
+                }
+
+            }
+        }
+
+        long expiration = connection.getExpiration();
+        if (expiration > 0)
+            return Math.max(0, expiration - System.currentTimeMillis());
+
+        return -1;
+
+    }
+
+    /**
+     * Returns whether the given cached SAML settings are stale and must be
+     * reloaded, either because the local IdP metadata file has been modified
+     * or because the remote IdP metadata has expired.
+     *
+     * @param cached
+     *     The cached SAML settings to test.
+     *
+     * @return
+     *     true if the given settings must be reloaded, false otherwise.
+     *
+     * @throws GuacamoleException
+     *     If guacamole.properties cannot be parsed.
+     */
+    private boolean isStale(CachedSettings cached) throws GuacamoleException {
+
+        File metadataFile = getLocalFile(getIdpMetadata());
+        if (metadataFile != null)
+            return metadataFile.lastModified() != cached.lastModified;
+
+        return System.currentTimeMillis() >= cached.expires;
+
+    }
+
+    /**
+     * Reloads the SAML settings if they have already been parsed and have
+     * since become stale. This function is invoked periodically in the
+     * background.
+     *
+     * @throws GuacamoleException
+     *     If guacamole.properties cannot be parsed, if required parameters
+     *     are missing, or if the IdP metadata cannot be read or parsed.
+     */
+    void refreshSamlSettings() throws GuacamoleException {
+        CachedSettings cached = cachedSettings;
+        if (cached != null && isStale(cached))
+            reloadSamlSettings();
+    }
+
+    /**
+     * Parses the given XML document, which may declare its own character
+     * encoding. Document type declarations are refused, preventing
+     * resolution of external entities.
+     *
+     * @param input
+     *     The stream containing the raw bytes of the XML document.
+     *
+     * @return
+     *     The parsed XML document.
+     *
+     * @throws Exception
+     *     If the document cannot be read or is not valid XML.
+     */
+    private static Document parseXML(InputStream input) throws Exception {
+
+        DocumentBuilderFactory factory = DocumentBuilderFactory.newInstance();
+        factory.setNamespaceAware(true);
+        factory.setFeature(XMLConstants.FEATURE_SECURE_PROCESSING, true);
+        factory.setFeature("http://apache.org/xml/features/disallow-doctype-decl", true);
+        factory.setXIncludeAware(false);
+        factory.setExpandEntityReferences(false);
+
+        return factory.newDocumentBuilder().parse(input);
+
+    }
+
     /**
      * Returns the collection of SAML settings used to initialize the client.
+     * The settings are parsed only once, with any IdP metadata being reloaded
+     * in the background when the metadata file changes or the remote metadata
+     * expires. The returned settings are shared and must not be modified.
      *
      * @return
      *     The collection of SAML settings used to initialize the SAML client.
@@ -307,12 +603,74 @@ public class ConfigurationService {
      */
     public Saml2Settings getSamlSettings() throws GuacamoleException {
 
+        CachedSettings cached = cachedSettings;
+        if (cached != null)
+            return cached.settings;
+
+        synchronized (this) {
+
+            // Settings may have been loaded while this thread was waiting
+            if (cachedSettings != null)
+                return cachedSettings.settings;
+
+            return reloadSamlSettings().settings;
+
+        }
+
+    }
+
+    /**
+     * Parses the SAML settings, including any IdP metadata, replacing the
+     * cached settings with the result.
+     *
+     * @return
+     *     The newly-parsed SAML settings.
+     *
+     * @throws GuacamoleException
+     *     If guacamole.properties cannot be parsed, if required parameters
+     *     are missing, or if the IdP metadata cannot be read or parsed.
+     */
+    private synchronized CachedSettings reloadSamlSettings()
+            throws GuacamoleException {
+
+        long lastModified = 0;
+        long expires = Long.MAX_VALUE;
+
         // Try to get the XML file, first.
         URI idpMetadata = getIdpMetadata();
         Map<String, Object> samlMap;
         if (idpMetadata != null) {
+
+            File metadataFile = getLocalFile(idpMetadata);
+            if (metadataFile != null)
+                lastModified = metadataFile.lastModified();
+
             try {
-                samlMap = IdPMetadataParser.parseRemoteXML(idpMetadata.toURL());
+
+                URLConnection connection = idpMetadata.toURL().openConnection();
+                connection.setConnectTimeout(METADATA_TIMEOUT);
+                connection.setReadTimeout(METADATA_TIMEOUT);
+
+                // Parse the raw metadata, honoring any encoding declared
+                // within the XML itself
+                Document document;
+                try (InputStream input = connection.getInputStream()) {
+                    document = parseXML(input);
+                }
+
+                // Note the lifetime of remote metadata
+                if (metadataFile == null) {
+                    long lifetime = getCacheLifetime(connection);
+                    if (lifetime < 0)
+                        lifetime = getIdpMetadataRefreshInterval() * 60000L;
+                    expires = System.currentTimeMillis() + lifetime;
+                }
+
+                samlMap = IdPMetadataParser.parseXML(document);
+
+            }
+            catch (GuacamoleException e) {
+                throw e;
             }
             catch (Exception e) {
                 throw new GuacamoleServerException(
@@ -346,15 +704,27 @@ public class ConfigurationService {
                     UriBuilder.fromUri(getCallbackUrl()).path("api/ext/saml/callback").build().toString());
         }
 
+        // Building the settings also decodes the IdP signing certificate,
+        // such that only assertion verification remains for each response
         SettingsBuilder samlBuilder = new SettingsBuilder();
         Saml2Settings samlSettings = samlBuilder.fromValues(samlMap).build();
         samlSettings.setStrict(getStrict());
         samlSettings.setDebug(getDebug());
         samlSettings.setCompressRequest(getCompressRequest());
         samlSettings.setCompressResponse(getCompressResponse());
-    
-        return samlSettings;
+
+        CachedSettings cached = new CachedSettings(samlSettings, lastModified, expires);
+        cachedSettings = cached;
+        return cached;
+
     }
 
+    /**
+     * Stops the background reloading of SAML settings. This must be invoked
+     * during webapp shutdown in order to avoid resource leaks.
+     */
+    public void shutdown() {
+        executor.shutdownNow();
+    }
 
 }
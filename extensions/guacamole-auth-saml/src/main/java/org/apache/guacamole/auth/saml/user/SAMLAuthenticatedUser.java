@@ -25,6 +25,7 @@ import java.util.Set;
 import org.apache.guacamole.net.auth.AbstractAuthenticatedUser;
 import org.apache.guacamole.net.auth.AuthenticationProvider;
 import org.apache.guacamole.net.auth.Credentials;
+import org.apache.guacamole.net.auth.IdentityFingerprint;
 
 /**
  * An SAML-specific implementation of AuthenticatedUser, associating a
@@ -104,4 +105,10 @@ public class SAMLAuthenticatedUser extends AbstractAuthenticatedUser {
         return effectiveGroups;
     }
 
+    @Override
+    public String getIdentityFingerprint() {
+        return IdentityFingerprint.generate(getIdentifier(),
+                getEffectiveUserGroups(), getCredentials(), getTokens());
+    }
+
 }
@@ -0,0 +1,380 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+package org.apache.guacamole.auth.saml.conf;
+
+import com.google.inject.AbstractModule;
+import com.google.inject.Guice;
+import com.onelogin.saml2.settings.Saml2Settings;
+import com.sun.net.httpserver.HttpExchange;
+import com.sun.net.httpserver.HttpHandler;
+import com.sun.net.httpserver.HttpServer;
+import java.io.File;
+import java.io.IOException;
+import java.io.OutputStream;
+import java.net.InetAddress;
+import java.net.InetSocketAddress;
+import java.nio.charset.Charset;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Files;
+import java.util.HashMap;
+import java.util.Map;
+import java.util.concurrent.atomic.AtomicInteger;
+import org.apache.guacamole.GuacamoleException;
+import org.apache.guacamole.GuacamoleServerException;
+import org.apache.guacamole.environment.DelegatingEnvironment;
+import org.apache.guacamole.environment.Environment;
+import org.apache.guacamole.properties.GuacamoleProperty;
+import org.junit.After;
+import org.junit.Rule;
+import org.junit.Test;
+import org.junit.rules.TemporaryFolder;
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertNotSame;
+import static org.junit.Assert.assertSame;
+
+/**
+ * Test which verifies that ConfigurationService caches the SAML settings
+ * parsed from IdP metadata, reloading that metadata only once it has been
+ * modified (for local files) or has expired (for remote metadata).
+ */
+public class ConfigurationServiceTest {
+
+    /**
+     * Environment which defines only the properties explicitly set through
+     * setProperty(), leaving all other properties undefined.
+     */
+    private static class TestEnvironment extends DelegatingEnvironment {
+
+        /**
+         * The values of all defined properties, by property name.
+         */
+        private final Map<String, String> properties = new HashMap<>();
+
+        /**
+         * Creates a new TestEnvironment. No other Environment is actually
+         * delegated to.
+         */
+        public TestEnvironment() {
+            super(null);
+        }
+
+        /**
+         * Defines the property having the given name.
+         *
+         * @param name
+         *     The name of the property to define.
+         *
+         * @param value
+         *     The value to assign to the property.
+         */
+        public void setProperty(String name, String value) {
+            properties.put(name, value);
+        }
+
+        @Override
+        public <Type> Type getProperty(GuacamoleProperty<Type> property)
+                throws GuacamoleException {
+            return getProperty(property, null);
+        }
+
+        @Override
+        public <Type> Type getProperty(GuacamoleProperty<Type> property,
+                Type defaultValue) throws GuacamoleException {
+
+            Type value = property.parseValue(properties.get(property.getName()));
+            if (value == null)
+                return defaultValue;
+
+            return value;
+
+        }
+
+        @Override
+        public <Type> Type getRequiredProperty(GuacamoleProperty<Type> property)
+                throws GuacamoleException {
+
+            Type value = getProperty(property);
+            if (value == null)
+                throw new GuacamoleServerException("Property "
+                        + property.getName() + " is required.");
+
+            return value;
+
+        }
+
+    }
+
+    /**
+     * Temporary directory for local IdP metadata files.
+     */
+    @Rule
+    public final TemporaryFolder folder = new TemporaryFolder();
+
+    /**
+     * The environment providing the configuration of the service under test.
+     */
+    private final TestEnvironment environment = new TestEnvironment();
+
+    /**
+     * The service under test, if any.
+     */
+    private ConfigurationService service;
+
+    /**
+     * The stub IdP metadata endpoint, if any.
+     */
+    private HttpServer server;
+
+    /**
+     * Stops the service under test and the stub metadata endpoint, if
+     * started.
+     */
+    @After
+    public void tearDown() {
+
+        if (service != null)
+            service.shutdown();
+
+        if (server != null)
+            server.stop(0);
+
+    }
+
+    /**
+     * Returns minimal IdP metadata for an IdP having the given entity ID,
+     * with the given encoding declared within its XML prolog.
+     *
+     * @param entityId
+     *     The entity ID of the IdP.
+     *
+     * @param encoding
+     *     The name of the character encoding to declare.
+     *
+     * @return
+     *     The IdP metadata, as XML.
+     */
+    private static String getMetadata(String entityId, String encoding) {
+        return "<?xml version=\"1.0\" encoding=\"" + encoding + "\"?>"
+            + "<md:EntityDescriptor xmlns:md=\"urn:oasis:names:tc:SAML:2.0:metadata\""
+            + "        entityID=\"" + entityId + "\">"
+            + "  <md:IDPSSODescriptor protocolSupportEnumeration=\"urn:oasis:names:tc:SAML:2.0:protocol\">"
+            + "    <md:SingleSignOnService"
+            + "        Binding=\"urn:oasis:names:tc:SAML:2.0:bindings:HTTP-Redirect\""
+            + "        Location=\"https://idp.example.net/sso\"/>"
+            + "  </md:IDPSSODescriptor>"
+            + "</md:EntityDescriptor>";
+    }
+
+    /**
+     * Writes minimal IdP metadata for an IdP having the given entity ID to
+     * the given file, encoded using the given character encoding.
+     *
+     * @param file
+     *     The file to write.
+     *
+     * @param entityId
+     *     The entity ID of the IdP.
+     *
+     * @param charset
+     *     The character encoding to use, which is also declared within the
+     *     XML prolog of the metadata.
+     *
+     * @throws IOException
+     *     If the file cannot be written.
+     */
+    private static void writeMetadata(File file, String entityId,
+            Charset charset) throws IOException {
+        Files.write(file.toPath(), getMetadata(entityId, charset.name()).getBytes(charset));
+    }
+
+    /**
+     * Creates the service under test, configured to read IdP metadata from
+     * the given URI.
+     *
+     * @param metadataUrl
+     *     The URI of the IdP metadata.
+     */
+    private void createService(String metadataUrl) {
+
+        environment.setProperty("saml-idp-metadata-url", metadataUrl);
+        environment.setProperty("saml-entity-id", "https://guacamole.example.net/");
+        environment.setProperty("saml-callback-url", "https://guacamole.example.net/");
+
+        service = Guice.createInjector(new AbstractModule() {
+
+            @Override
+            protected void configure() {
+                bind(Environment.class).toInstance(environment);
+            }
+
+        }).getInstance(ConfigurationService.class);
+
+    }
+
+    /**
+     * Verifies that settings parsed from a local metadata file are reused
+     * until that file is modified.
+     *
+     * @throws Exception
+     *     If the metadata cannot be written or parsed.
+     */
+    @Test
+    public void testLocalMetadataRefresh() throws Exception {
+
+        File metadata = folder.newFile("metadata.xml");
+        writeMetadata(metadata, "https://idp.example.net/first", StandardCharsets.UTF_8);
+        metadata.setLastModified(1000000000000L);
+
+        createService(metadata.toURI().toString());
+
+        Saml2Settings settings = service.getSamlSettings();
+        assertEquals("https://idp.example.net/first", settings.getIdpEntityId());
+
+        // Unmodified metadata is not reparsed
+        service.refreshSamlSettings();
+        assertSame(settings, service.getSamlSettings());
+
+        writeMetadata(metadata, "https://idp.example.net/second", StandardCharsets.UTF_8);
+        metadata.setLastModified(1000000060000L);
+
+        // Modified metadata is reparsed
+        service.refreshSamlSettings();
+        settings = service.getSamlSettings();
+        assertEquals("https://idp.example.net/second", settings.getIdpEntityId());
+
+    }
+
+    /**
+     * Verifies that metadata is decoded using the character encoding
+     * declared within its XML prolog.
+     *
+     * @throws Exception
+     *     If the metadata cannot be written or parsed.
+     */
+    @Test
+    public void testDeclaredEncoding() throws Exception {
+
+        File metadata = folder.newFile("metadata.xml");
+        writeMetadata(metadata, "https://idp.example.net/caf\u00e9", StandardCharsets.ISO_8859_1);
+
+        createService(metadata.toURI().toString());
+        assertEquals("https://idp.example.net/caf\u00e9",
+                service.getSamlSettings().getIdpEntityId());
+
+    }
+
+    /**
+     * Starts a stub IdP metadata endpoint which serves metadata having the
+     * given Cache-Control header, and creates the service under test,
+     * configured to read metadata from that endpoint.
+     *
+     * @param cacheControl
+     *     The value of the Cache-Control header to include in each response.
+     *
+     * @param requests
+     *     The counter to increment for each request received by the stub
+     *     metadata endpoint.
+     *
+     * @throws IOException
+     *     If the stub metadata endpoint cannot be started.
+     */
+    private void createRemoteService(final String cacheControl,
+            final AtomicInteger requests) throws IOException {
+
+        final byte[] body = getMetadata("https://idp.example.net/remote", "UTF-8")
+                .getBytes(StandardCharsets.UTF_8);
+
+        server = HttpServer.create(new InetSocketAddress(InetAddress.getLoopbackAddress(), 0), 0);
+        server.createContext("/metadata", new HttpHandler() {
+
+            @Override
+            public void handle(HttpExchange exchange) throws IOException {
+                requests.incrementAndGet();
+                exchange.getResponseHeaders().add("Content-Type", "application/samlmetadata+xml");
+                exchange.getResponseHeaders().add("Cache-Control", cacheControl);
+                exchange.sendResponseHeaders(200, body.length);
+                try (OutputStream out = exchange.getResponseBody()) {
+                    out.write(body);
+                }
+            }
+
+        });
+        server.start();
+
+        createService("http://" + server.getAddress().getHostString() + ":"
+                + server.getAddress().getPort() + "/metadata");
+
+    }
+
+    /**
+     * Verifies that remote metadata is not requested again while it remains
+     * fresh according to the headers of the response providing it.
+     *
+     * @throws Exception
+     *     If the stub metadata endpoint cannot be started or the metadata
+     *     cannot be parsed.
+     */
+    @Test
+    public void testRemoteMetadataCached() throws Exception {
+
+        AtomicInteger requests = new AtomicInteger();
+        createRemoteService("public, max-age=3600", requests);
+
+        Saml2Settings settings = service.getSamlSettings();
+        assertEquals("https://idp.example.net/remote", settings.getIdpEntityId());
+
+        for (int i = 0; i < 10; i++) {
+            service.refreshSamlSettings();
+            assertSame(settings, service.getSamlSettings());
+        }
+
+        assertEquals(1, requests.get());
+
+    }
+
+    /**
+     * Verifies that remote metadata is requested again once it has expired
+     * according to the headers of the response providing it.
+     *
+     * @throws Exception
+     *     If the stub metadata endpoint cannot be started or the metadata
+     *     cannot be parsed.
+     */
+    @Test
+    public void testRemoteMetadataExpired() throws Exception {
+
+        AtomicInteger requests = new AtomicInteger();
+        createRemoteService("no-cache", requests);
+
+        Saml2Settings settings = service.getSamlSettings();
+        assertEquals(1, requests.get());
+
+        // Settings are retrieved from the cache regardless of expiration,
+        // with expired metadata reloaded only in the background
+        assertSame(settings, service.getSamlSettings());
+        assertEquals(1, requests.get());
+
+        service.refreshSamlSettings();
+        assertNotSame(settings, service.getSamlSettings());
+        assertEquals(2, requests.get());
+
+    }
+
+}
@@ -0,0 +1,43 @@
+--
+-- Licensed to the Apache Software Foundation (ASF) under one
+-- or more contributor license agreements.  See the NOTICE file
+-- distributed with this work for additional information
+-- regarding copyright ownership.  The ASF licenses this file
+-- to you under the Apache License, Version 2.0 (the
+-- "License"); you may not use this file except in compliance
+-- with the License.  You may obtain a copy of the License at
+--
+--   http://www.apache.org/licenses/LICENSE-2.0
+--
+-- Unless required by applicable law or agreed to in writing,
+-- software distributed under the License is distributed on an
+-- "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+-- KIND, either express or implied.  See the License for the
+-- specific language governing permissions and limitations
+-- under the License.
+--
+
+--
+-- Table of TOTP codes which have already been used, required only if
+-- "totp-used-code-store" is set to "jdbc". Each code is recorded along with
+-- the user that used it and the time after which it may be used again (a
+-- UNIX-style epoch timestamp in milliseconds). The primary key ensures that
+-- each code is accepted only once, even across multiple Guacamole servers
+-- sharing this database. Expired records are removed automatically.
+--
+-- This script uses only standard SQL types and may be used with any database
+-- supported by the configured JDBC driver.
+--
+
+CREATE TABLE guacamole_totp_used_code (
+
+  username      VARCHAR(128) NOT NULL,
+  code          VARCHAR(8)   NOT NULL,
+  invalid_until BIGINT       NOT NULL,
+
+  PRIMARY KEY (username, code)
+
+);
+
+CREATE INDEX guacamole_totp_used_code_invalid_until
+    ON guacamole_totp_used_code(invalid_until);
@@ -89,6 +89,69 @@ public class ConfigurationService {
 
     };
 
+    /**
+     * The mechanism which should be used to store TOTP codes which have
+     * already been used.
+     */
+    private static final EnumGuacamoleProperty<UsedCodeStoreType> TOTP_USED_CODE_STORE =
+            new EnumGuacamoleProperty<UsedCodeStoreType>(UsedCodeStoreType.class) {
+
+        @Override
+        public String getName() { return "totp-used-code-store"; }
+
+    };
+
+    /**
+     * The fully-qualified class name of the JDBC driver for the database
+     * which should be used to store TOTP codes which have already been used,
+     * if the "jdbc" used code store is selected.
+     */
+    private static final StringGuacamoleProperty TOTP_USED_CODE_JDBC_DRIVER =
+            new StringGuacamoleProperty() {
+
+        @Override
+        public String getName() { return "totp-used-code-jdbc-driver"; }
+
+    };
+
+    /**
+     * The JDBC URL of the database which should be used to store TOTP codes
+     * which have already been used, if the "jdbc" used code store is
+     * selected. The database must contain the table created by
+     * "schema/001-create-used-code-table.sql".
+     */
+    private static final StringGuacamoleProperty TOTP_USED_CODE_JDBC_URL =
+            new StringGuacamoleProperty() {
+
+        @Override
+        public String getName() { return "totp-used-code-jdbc-url"; }
+
+    };
+
+    /**
+     * The username to use when connecting to the database which stores TOTP
+     * codes which have already been used.
+     */
+    private static final StringGuacamoleProperty TOTP_USED_CODE_JDBC_USERNAME =
+            new StringGuacamoleProperty() {
+
+        @Override
+        public String getName() { return "totp-used-code-jdbc-username"; }
+
+    };
+
+    /**
+     * The password to use when connecting to the database which stores TOTP
+     * codes which have already been used.
+     */
+    private static final StringGuacamoleProperty TOTP_USED_CODE_JDBC_PASSWORD =
+            new StringGuacamoleProperty() {
+
+        @Override
+        public String getName() { return "totp-used-code-jdbc-password"; }
+
+    };
+
     /**
      * Returns the human-readable name of the entity issuing user accounts. If
      * not specified, "Apache Guacamole" will be used by default.
@@ -159,4 +222,87 @@ public class ConfigurationService {
         return environment.getProperty(TOTP_MODE, TOTPGenerator.Mode.SHA1);
     }
 
+    /**
+     * Returns the mechanism which should be used to store TOTP codes which
+     * have already been used. If not specified, used codes will be stored in
+     * memory.
+     *
+     * @return
+     *     The mechanism which should be used to store used TOTP codes.
+     *
+     * @throws GuacamoleException
+     *     If the "totp-used-code-store" property cannot be read from
+     *     guacamole.properties.
+     */
+    public UsedCodeStoreType getUsedCodeStore() throws GuacamoleException {
+        return environment.getProperty(TOTP_USED_CODE_STORE, UsedCodeStoreType.MEMORY);
+    }
+
+    /**
+     * Returns the fully-qualified class name of the JDBC driver for the
+     * database which should be used to store TOTP codes which have already
+     * been used. This property is required if the "jdbc" used code store is
+     * selected, and the driver must be available to the web application.
+     *
+     * @return
+     *     The class name of the JDBC driver for the database storing used TOTP
+     *     codes.
+     *
+     * @throws GuacamoleException
+     *     If the "totp-used-code-jdbc-driver" property is missing or cannot be
+     *     read from guacamole.properties.
+     */
+    public String getUsedCodeJDBCDriver() throws GuacamoleException {
+        return environment.getRequiredProperty(TOTP_USED_CODE_JDBC_DRIVER);
+    }
+
+    /**
+     * Returns the JDBC URL of the database which should be used to store TOTP
+     * codes which have already been used. This property is required if the
+     * "jdbc" used code store is selected, and the database must contain the
+     * table created by "schema/001-create-used-code-table.sql".
+     *
+     * @return
+     *     The JDBC URL of the database storing used TOTP codes.
+     *
+     * @throws GuacamoleException
+     *     If the "totp-used-code-jdbc-url" property is missing or cannot be
+     *     read from guacamole.properties.
+     */
+    public String getUsedCodeJDBCURL() throws GuacamoleException {
+        return environment.getRequiredProperty(TOTP_USED_CODE_JDBC_URL);
+    }
+
+    /**
+     * Returns the username to use when connecting to the database storing
+     * TOTP codes which have already been used, if any.
+     *
+     * @return
+     *     The username to use when connecting to the database storing used
+     *     TOTP codes, or null if no username should be provided.
+     *
+     * @throws GuacamoleException
+     *     If the "totp-used-code-jdbc-username" property cannot be read from
+     *     guacamole.properties.
+     */
+    public String getUsedCodeJDBCUsername() throws GuacamoleException {
+        return environment.getProperty(TOTP_USED_CODE_JDBC_USERNAME);
+    }
+
+    /**
+     * Returns the password to use when connecting to the database storing
+     * TOTP codes which have already been used, if any.
+     *
+     * @return
+     *     The password to use when connecting to the database storing used
+     *     TOTP codes, or null if no password should be provided.
+     *
+     * @throws GuacamoleException
+     *     If the "totp-used-code-jdbc-password" property cannot be read from
+     *     guacamole.properties.
+     */
+    public String getUsedCodeJDBCPassword() throws GuacamoleException {
+        return environment.getProperty(TOTP_USED_CODE_JDBC_PASSWORD);
+    }
+
 }
@@ -0,0 +1,44 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+package org.apache.guacamole.auth.totp.conf;
+
+import org.apache.guacamole.properties.EnumGuacamoleProperty.PropertyValue;
+
+/**
+ * All supported mechanisms for storing the TOTP codes which have already been
+ * used, and thus must not be accepted again until they expire.
+ */
+public enum UsedCodeStoreType {
+
+    /**
+     * Used codes are stored in memory. Codes used against one Guacamole
+     * server are not known to other Guacamole servers.
+     */
+    @PropertyValue("memory")
+    MEMORY,
+
+    /**
+     * Used codes are stored within a database accessed via JDBC, and are thus
+     * shared by all Guacamole servers using that same database.
+     */
+    @PropertyValue("jdbc")
+    JDBC
+
+}
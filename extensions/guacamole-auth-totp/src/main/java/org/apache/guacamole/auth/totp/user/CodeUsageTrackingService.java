@@ -21,23 +21,15 @@ package org.apache.guacamole.auth.totp.user;
 
 import com.google.inject.Inject;
 import com.google.inject.Singleton;
-import java.util.Iterator;
-import java.util.Map;
-import java.util.concurrent.ConcurrentHashMap;
-import java.util.concurrent.ConcurrentMap;
-import java.util.concurrent.Executors;
-import java.util.concurrent.ScheduledExecutorService;
-import java.util.concurrent.TimeUnit;
 import org.apache.guacamole.GuacamoleException;
 import org.apache.guacamole.auth.totp.conf.ConfigurationService;
-import org.slf4j.Logger;
-import org.slf4j.LoggerFactory;
 
 /**
- * Service for tracking past valid uses of TOTP codes. An internal thread
- * periodically walks through records of past codes, removing records which
- * should be invalid by their own nature (no longer matching codes generated by
- * the secret key).
+ * Service for tracking past valid uses of TOTP codes. Used codes are recorded
+ * within a UsedCodeStore, which may be local to this Guacamole server or
+ * shared by several servers, depending on configuration. Records of past codes
+ * are removed once they would be invalid by their own nature (no longer
+ * matching codes generated by the secret key).
  */
 @Singleton
 public class CodeUsageTrackingService {
@@ -49,16 +41,6 @@ public class CodeUsageTrackingService {
      */
     private static final int INVALID_INTERVAL = 2;
 
-    /**
-     * Logger for this class.
-     */
-    private final Logger logger = LoggerFactory.getLogger(CodeUsageTrackingService.class);
-
-    /**
-     * Executor service which runs the cleanup task.
-     */
-    private final ScheduledExecutorService executor = Executors.newScheduledThreadPool(1);
-
     /**
      * Service for retrieving configuration information.
      */
@@ -66,131 +48,43 @@ public class CodeUsageTrackingService {
     private ConfigurationService confService;
 
     /**
-     * Map of previously-used codes to the timestamp after which the code can
-     * be used again, providing the TOTP key legitimately generates that code.
+     * The store containing all previously-used codes, or null if the store
+     * has not yet been created.
      */
-    private final ConcurrentMap<UsedCode, Long> invalidCodes =
-            new ConcurrentHashMap<UsedCode, Long>();
+    private UsedCodeStore store;
 
     /**
-     * Creates a new CodeUsageTrackingService which tracks past valid uses of
-     * TOTP codes on a per-user basis.
-     */
-    public CodeUsageTrackingService() {
-        executor.scheduleAtFixedRate(new CodeEvictionTask(), 1, 1, TimeUnit.MINUTES);
-    }
-
-    /**
-     * Task which iterates through all explicitly-invalidated codes, evicting
-     * those codes which are old enough that they would fail validation against
-     * the secret key anyway.
+     * Returns the store which should contain all previously-used codes,
+     * creating that store according to guacamole.properties if it has not
+     * yet been created.
+     *
+     * @return
+     *     The store which should contain all previously-used codes.
+     *
+     * @throws GuacamoleException
+     *     If the configuration of the store cannot be read from
+     *     guacamole.properties.
      */
-    private class CodeEvictionTask implements Runnable {
+    private synchronized UsedCodeStore getStore() throws GuacamoleException {
 
-        @Override
-        public void run() {
+        if (store == null) {
+            switch (confService.getUsedCodeStore()) {
 
-            // Get start time of cleanup check
-            long checkStart = System.currentTimeMillis();
+                case JDBC:
+                    store = new JDBCUsedCodeStore(
+                            confService.getUsedCodeJDBCDriver(),
+                            confService.getUsedCodeJDBCURL(),
+                            confService.getUsedCodeJDBCUsername(),
+                            confService.getUsedCodeJDBCPassword());
+                    break;
 
-            // For each code still being tracked, remove those which are old
-            // enough that they would fail validation against the secret key
-            Iterator<Map.Entry<UsedCode, Long>> entries = invalidCodes.entrySet().iterator();
-            while (entries.hasNext()) {
-
-                Map.Entry<UsedCode, Long> entry = entries.next();
-                long invalidUntil = entry.getValue();
-
-                // If code is sufficiently old, evict it and check the next one
-                if (checkStart >= invalidUntil)
-                    entries.remove();
+                default:
+                    store = new InMemoryUsedCodeStore();
 
             }
-
-            // Log completion and duration
-            logger.debug("TOTP tracking cleanup check completed in {} ms.",
-                    System.currentTimeMillis() - checkStart);
-
-        }
-
-    }
-
-    /**
-     * A valid TOTP code which was previously used by a particular user.
-     */
-    private class UsedCode {
-
-        /**
-         * The username of the user which previously used this code.
-         */
-        private final String username;
-
-        /**
-         * The valid code given by the user.
-         */
-        private final String code;
-
-        /**
-         * Creates a new UsedCode which records the given code as having been
-         * used by the given user.
-         *
-         * @param username
-         *     The username of the user which previously used the given code.
-         *
-         * @param code
-         *     The valid code given by the user.
-         */
-        public UsedCode(String username, String code) {
-            this.username = username;
-            this.code = code;
-        }
-
-        /**
-         * Returns the username of the user which previously used the code
-         * associated with this UsedCode.
-         *
-         * @return
-         *     The username of the user which previously used this code.
-         */
-        public String getUsername() {
-            return username;
-        }
-
-        /**
-         * Returns the valid code given by the user when this UsedCode was
-         * created.
-         *
-         * @return
-         *     The valid code given by the user.
-         */
-        public String getCode() {
-            return code;
         }
 
-        @Override
-        public int hashCode() {
-            int hash = 7;
-            hash = 79 * hash + this.username.hashCode();
-            hash = 79 * hash + this.code.hashCode();
-            return hash;
-        }
-
-        @Override
-        public boolean equals(Object obj) {
-
-            if (this == obj)
-                return true;
-
-            if (obj == null)
-                return false;
-
-            if (getClass() != obj.getClass())
-                return false;
-
-            final UsedCode other = (UsedCode) obj;
-            return username.equals(other.username) && code.equals(other.code);
-
-        }
+        return store;
 
     }
 
@@ -220,35 +114,12 @@ public class CodeUsageTrackingService {
     public boolean useCode(String username, String code)
             throws GuacamoleException {
 
-        // Repeatedly attempt to use the given code until an explicit success
-        // or failure has occurred
-        UsedCode usedCode = new UsedCode(username, code);
-        for (;;) {
-
-            // Explicitly invalidate each used code for two periods after its
-            // first successful use
-            long current = System.currentTimeMillis();
-            long invalidUntil = current + confService.getPeriod() * 1000 * INVALID_INTERVAL;
+        // Explicitly invalidate each used code for two periods after its
+        // first successful use
+        long invalidUntil = System.currentTimeMillis()
+                + confService.getPeriod() * 1000L * INVALID_INTERVAL;
 
-            // Try to use the given code, marking it as used within the map of
-            // now-invalidated codes
-            Long expires = invalidCodes.putIfAbsent(usedCode, invalidUntil);
-            if (expires == null)
-                return true;
-
-            // If the code was already used, fail to use the code if
-            // insufficient time has elapsed since it was last used
-            // successfully
-            if (expires > current)
-                return false;
-
-
-            // Otherwise, the code is actually valid - remove the invalidated
-            // code only if it still has the expected expiration time, and
-            // retry using the code
-            invalidCodes.remove(usedCode, expires);
-
-        }
+        return getStore().markUsed(username, code, invalidUntil);
 
     }
 
@@ -257,8 +128,9 @@ public class CodeUsageTrackingService {
      * background, such as other threads. This function MUST be invoked during
      * webapp shutdown to avoid leaking these resources.
      */
-    public void shutdown() {
-        executor.shutdownNow();
+    public synchronized void shutdown() {
+        if (store != null)
+            store.shutdown();
     }
 
 }
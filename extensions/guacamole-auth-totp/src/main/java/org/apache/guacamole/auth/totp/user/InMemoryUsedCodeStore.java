@@ -0,0 +1,46 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+package org.apache.guacamole.auth.totp.user;
+
+import org.apache.guacamole.cache.ExpiringSet;
+
+/**
+ * UsedCodeStore implementation which stores used codes in memory. Used codes
+ * are visible only to the Guacamole server which recorded them.
+ */
+public class InMemoryUsedCodeStore implements UsedCodeStore {
+
+    /**
+     * All previously-used codes, each of which is automatically removed once
+     * it may be used again.
+     */
+    private final ExpiringSet<UsedCode> usedCodes = new ExpiringSet<>();
+
+    @Override
+    public boolean markUsed(String username, String code, long invalidUntil) {
+        return usedCodes.add(new UsedCode(username, code), invalidUntil);
+    }
+
+    @Override
+    public void shutdown() {
+        // Nothing to clean up
+    }
+
+}
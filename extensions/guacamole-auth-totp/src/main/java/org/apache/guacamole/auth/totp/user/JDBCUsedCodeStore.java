@@ -0,0 +1,215 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+package org.apache.guacamole.auth.totp.user;
+
+import java.sql.Connection;
+import java.sql.PreparedStatement;
+import java.sql.SQLException;
+import java.sql.SQLIntegrityConstraintViolationException;
+import java.util.concurrent.Executors;
+import java.util.concurrent.ScheduledExecutorService;
+import java.util.concurrent.ThreadFactory;
+import java.util.concurrent.TimeUnit;
+import org.apache.guacamole.GuacamoleException;
+import org.apache.guacamole.GuacamoleServerException;
+import org.apache.ibatis.datasource.pooled.PooledDataSource;
+import org.slf4j.Logger;
+import org.slf4j.LoggerFactory;
+
+/**
+ * UsedCodeStore implementation which stores used codes within a database
+ * accessed via JDBC, such that codes used against any Guacamole server
+ * sharing that database are rejected by all others. The JDBC driver for the
+ * database must be available to the web application. The database must
+ * contain the "guacamole_totp_used_code" table created by the
+ * "schema/001-create-used-code-table.sql" script included with this
+ * extension. Connections to the database are pooled.
+ */
+public class JDBCUsedCodeStore implements UsedCodeStore {
+
+    /**
+     * Logger for this class.
+     */
+    private final Logger logger = LoggerFactory.getLogger(JDBCUsedCodeStore.class);
+
+    /**
+     * Query which removes the record of a specific code having been used, if
+     * that record has expired.
+     */
+    private static final String DELETE_EXPIRED_CODE =
+            "DELETE FROM guacamole_totp_used_code"
+            + " WHERE username = ? AND code = ? AND invalid_until < ?";
+
+    /**
+     * Query which records a specific code as having been used. This will
+     * fail with an integrity constraint violation if the code is already
+     * recorded as used.
+     */
+    private static final String INSERT_CODE =
+            "INSERT INTO guacamole_totp_used_code"
+            + " (username, code, invalid_until) VALUES (?, ?, ?)";
+
+    /**
+     * Query which removes all expired records of used codes.
+     */
+    private static final String DELETE_ALL_EXPIRED_CODES =
+            "DELETE FROM guacamole_totp_used_code WHERE invalid_until < ?";
+
+    /**
+     * Pool of connections to the database.
+     */
+    private final PooledDataSource dataSource;
+
+    /**
+     * Executor service which periodically removes expired records.
+     */
+    private final ScheduledExecutorService executor =
+            Executors.newSingleThreadScheduledExecutor(new ThreadFactory() {
+
+        @Override
+        public Thread newThread(Runnable runnable) {
+            Thread thread = new Thread(runnable, "totp-used-code-cleanup");
+            thread.setDaemon(true);
+            return thread;
+        }
+
+    });
+
+    /**
+     * Creates a new JDBCUsedCodeStore which stores used codes within the
+     * database at the given JDBC URL.
+     *
+     * @param driver
+     *     The fully-qualified class name of the JDBC driver for the database.
+     *
+     * @param url
+     *     The JDBC URL of the database.
+     *
+     * @param username
+     *     The username to provide when connecting to the database, or null if
+     *     no username should be provided.
+     *
+     * @param password
+     *     The password to provide when connecting to the database, or null if
+     *     no password should be provided.
+     */
+    public JDBCUsedCodeStore(String driver, String url, String username,
+            String password) {
+
+        this.dataSource = new PooledDataSource(driver, url, username, password);
+
+        executor.scheduleAtFixedRate(new Runnable() {
+
+            @Override
+            public void run() {
+                try {
+                    removeExpired();
+                }
+                catch (SQLException e) {
+                    logger.warn("Unable to remove expired TOTP codes from "
+                            + "database: {}", e.getMessage());
+                    logger.debug("Removal of expired TOTP codes failed.", e);
+                }
+            }
+
+        }, 1, 1, TimeUnit.MINUTES);
+
+    }
+
+    /**
+     * Removes all expired records of used codes from the database. This
+     * function is invoked periodically in the background.
+     *
+     * @return
+     *     The number of records removed.
+     *
+     * @throws SQLException
+     *     If the records cannot be removed.
+     */
+    int removeExpired() throws SQLException {
+        try (Connection connection = dataSource.getConnection();
+                PreparedStatement statement = connection.prepareStatement(DELETE_ALL_EXPIRED_CODES)) {
+            statement.setLong(1, System.currentTimeMillis());
+            return statement.executeUpdate();
+        }
+    }
+
+    /**
+     * Returns whether the given SQLException represents a violation of an
+     * integrity constraint, such as the primary key of the used code table.
+     *
+     * @param e
+     *     The SQLException to test.
+     *
+     * @return
+     *     true if the given SQLException represents a violation of an
+     *     integrity constraint, false otherwise.
+     */
+    private static boolean isConstraintViolation(SQLException e) {
+        String state = e.getSQLState();
+        return e instanceof SQLIntegrityConstraintViolationException
+                || (state != null && state.startsWith("23"));
+    }
+
+    @Override
+    public boolean markUsed(String username, String code, long invalidUntil)
+            throws GuacamoleException {
+
+        try (Connection connection = dataSource.getConnection()) {
+
+            // Allow reuse of codes whose invalidation has expired
+            try (PreparedStatement statement = connection.prepareStatement(DELETE_EXPIRED_CODE)) {
+                statement.setString(1, username);
+                statement.setString(2, code);
+                statement.setLong(3, System.currentTimeMillis());
+                statement.executeUpdate();
+            }
+
+            // Record code as used, failing if already recorded (including
+            // by another Guacamole server)
+            try (PreparedStatement statement = connection.prepareStatement(INSERT_CODE)) {
+                statement.setString(1, username);
+                statement.setString(2, code);
+                statement.setLong(3, invalidUntil);
+                statement.executeUpdate();
+            }
+
+            return true;
+
+        }
+        catch (SQLException e) {
+
+            if (isConstraintViolation(e))
+                return false;
+
+            throw new GuacamoleServerException("Unable to record use of "
+                    + "TOTP code within database.", e);
+
+        }
+
+    }
+
+    @Override
+    public void shutdown() {
+        executor.shutdownNow();
+        dataSource.forceCloseAll();
+    }
+
+}
@@ -0,0 +1,99 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+package org.apache.guacamole.auth.totp.user;
+
+/**
+ * A valid TOTP code which was previously used by a particular user.
+ */
+public class UsedCode {
+
+    /**
+     * The username of the user which previously used this code.
+     */
+    private final String username;
+
+    /**
+     * The valid code given by the user.
+     */
+    private final String code;
+
+    /**
+     * Creates a new UsedCode which records the given code as having been
+     * used by the given user.
+     *
+     * @param username
+     *     The username of the user which previously used the given code.
+     *
+     * @param code
+     *     The valid code given by the user.
+     */
+    public UsedCode(String username, String code) {
+        this.username = username;
+        this.code = code;
+    }
+
+    /**
+     * Returns the username of the user which previously used the code
+     * associated with this UsedCode.
+     *
+     * @return
+     *     The username of the user which previously used this code.
+     */
+    public String getUsername() {
+        return username;
+    }
+
+    /**
+     * Returns the valid code given by the user when this UsedCode was
+     * created.
+     *
+     * @return
+     *     The valid code given by the user.
+     */
+    public String getCode() {
+        return code;
+    }
+
+    @Override
+    public int hashCode() {
+        int hash = 7;
+        hash = 79 * hash + this.username.hashCode();
+        hash = 79 * hash + this.code.hashCode();
+        return hash;
+    }
+
+    @Override
+    public boolean equals(Object obj) {
+
+        if (this == obj)
+            return true;
+
+        if (obj == null)
+            return false;
+
+        if (getClass() != obj.getClass())
+            return false;
+
+        final UsedCode other = (UsedCode) obj;
+        return username.equals(other.username) && code.equals(other.code);
+
+    }
+
+}
@@ -0,0 +1,61 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+package org.apache.guacamole.auth.totp.user;
+
+import org.apache.guacamole.GuacamoleException;
+
+/**
+ * Storage for TOTP codes which have already been used, and thus must not be
+ * accepted again until they would fail validation against the secret key
+ * anyway.
+ */
+public interface UsedCodeStore {
+
+    /**
+     * Atomically marks the given code as used by the given user, if it is not
+     * already marked as used. A code which was marked as used previously, but
+     * whose invalidation timestamp has since passed, is considered unused.
+     *
+     * @param username
+     *     The username of the user who has attempted to use the given code.
+     *
+     * @param code
+     *     The code given by the user.
+     *
+     * @param invalidUntil
+     *     The time after which the code may be used again, as a UNIX-style
+     *     epoch timestamp in milliseconds.
+     *
+     * @return
+     *     true if the code was not already marked as used and has now been
+     *     marked as used, false otherwise.
+     *
+     * @throws GuacamoleException
+     *     If the store cannot be read or updated.
+     */
+    boolean markUsed(String username, String code, long invalidUntil)
+            throws GuacamoleException;
+
+    /**
+     * Releases any resources held by this store, such as background threads.
+     */
+    void shutdown();
+
+}
@@ -25,6 +25,7 @@ import com.google.inject.Provider;
 import java.security.InvalidKeyException;
 import java.util.Collections;
 import java.util.HashMap;
+import java.util.List;
 import java.util.Map;
 import javax.servlet.http.HttpServletRequest;
 import org.apache.guacamole.GuacamoleException;
@@ -87,6 +88,10 @@ public class UserVerificationService {
      * @param context
      *     The UserContext of the user whose TOTP key should be retrieved.
      *
+     * @param self
+     *     The User object of the user whose TOTP key should be retrieved, as
+     *     returned by the given UserContext.
+     *
      * @param username
      *     The username of the user associated with the given UserContext.
      *
@@ -99,12 +104,11 @@ public class UserVerificationService {
      *     If a new key is generated, but the extension storing the associated
      *     user fails while updating the user account.
      */
-    private UserTOTPKey getKey(UserContext context,
+    private UserTOTPKey getKey(UserContext context, User self,
             String username) throws GuacamoleException {
 
         // Retrieve attributes from current user
-        User self = context.self();
-        Map<String, String> attributes = context.self().getAttributes();
+        Map<String, String> attributes = self.getAttributes();
 
         // If no key is defined, attempt to generate a new key
         String secret = attributes.get(TOTPUser.TOTP_KEY_SECRET_ATTRIBUTE_NAME);
@@ -113,7 +117,7 @@ public class UserVerificationService {
             // Generate random key for user
             TOTPGenerator.Mode mode = confService.getMode();
             UserTOTPKey generated = new UserTOTPKey(username,mode.getRecommendedKeyLength());
-            if (setKey(context, generated))
+            if (setKey(context, self, generated))
                 return generated;
 
             // Fail if key cannot be set
@@ -150,6 +154,10 @@ public class UserVerificationService {
      *     The UserContext associated with the user whose TOTP key is to be
      *     stored.
      *
+     * @param self
+     *     The User object of the user whose TOTP key is to be stored, as
+     *     returned by the given UserContext.
+     *
      * @param key
      *     The TOTP key to store.
      *
@@ -161,11 +169,10 @@ public class UserVerificationService {
      *     If the extension handling storage fails internally while attempting
      *     to update the user.
      */
-    private boolean setKey(UserContext context, UserTOTPKey key)
+    private boolean setKey(UserContext context, User self, UserTOTPKey key)
             throws GuacamoleException {
 
         // Get mutable set of attributes
-        User self = context.self();
         Map<String, String> attributes = new HashMap<String, String>();
 
         // Set/overwrite current TOTP key state
@@ -231,7 +238,8 @@ public class UserVerificationService {
             return;
 
         // Ignore users which do not have an associated key
-        UserTOTPKey key = getKey(context, username);
+        User self = context.self();
+        UserTOTPKey key = getKey(context, self, username);
         if (key == null)
             return;
 
@@ -274,14 +282,15 @@ public class UserVerificationService {
                     confService.getMode(), confService.getDigits(),
                     TOTPGenerator.DEFAULT_START_TIME, confService.getPeriod());
 
-            // Verify provided TOTP against value produced by generator
-            if ((code.equals(totp.generate()) || code.equals(totp.previous()))
-                    && codeService.useCode(username, code)) {
+            // Verify provided TOTP against the codes accepted at the
+            // current time
+            List<String> window = totp.window(System.currentTimeMillis() / 1000);
+            if (window.contains(code) && codeService.useCode(username, code)) {
 
                 // Record key as confirmed, if it hasn't already been so recorded
                 if (!key.isConfirmed()) {
                     key.setConfirmed(true);
-                    setKey(context, key);
+                    setKey(context, self, key);
                 }
 
                 // User has been verified
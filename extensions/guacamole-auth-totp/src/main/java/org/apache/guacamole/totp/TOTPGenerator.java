@@ -23,6 +23,8 @@ import com.google.common.primitives.Longs;
 import java.security.InvalidKeyException;
 import java.security.Key;
 import java.security.NoSuchAlgorithmException;
+import java.util.Arrays;
+import java.util.List;
 import javax.crypto.Mac;
 import javax.crypto.spec.SecretKeySpec;
 import org.apache.guacamole.properties.EnumGuacamoleProperty.PropertyValue;
@@ -457,4 +459,25 @@ public class TOTPGenerator {
         return previous(System.currentTimeMillis() / 1000);
     }
 
+    /**
+     * Returns all TOTP codes which should be accepted at the given timestamp,
+     * allowing for the code to have been entered just before the end of its
+     * time step. The window consists of the code returned by generate() for
+     * the given timestamp, followed by the code returned by previous(). As
+     * both codes are derived from the same timestamp, the window is
+     * consistent even if a time step boundary is crossed while it is being
+     * computed.
+     *
+     * @param time
+     *     The absolute timestamp to use to generate the TOTP codes, in seconds
+     *     since midnight, 1970-01-01, UTC (UNIX epoch).
+     *
+     * @return
+     *     The TOTP codes which should be accepted at the given timestamp,
+     *     most recent first.
+     */
+    public List<String> window(long time) {
+        return Arrays.asList(generate(time), previous(time));
+    }
+
 }
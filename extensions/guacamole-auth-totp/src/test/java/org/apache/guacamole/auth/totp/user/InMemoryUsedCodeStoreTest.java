@@ -0,0 +1,71 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+package org.apache.guacamole.auth.totp.user;
+
+import org.junit.Test;
+import static org.junit.Assert.assertFalse;
+import static org.junit.Assert.assertTrue;
+
+/**
+ * Test which verifies that InMemoryUsedCodeStore accepts each code only once
+ * until its invalidation expires.
+ */
+public class InMemoryUsedCodeStoreTest {
+
+    /**
+     * Verifies that a code is accepted only once, while codes of other users
+     * and other codes of the same user are unaffected.
+     */
+    @Test
+    public void testMarkUsed() {
+
+        InMemoryUsedCodeStore store = new InMemoryUsedCodeStore();
+        long invalidUntil = System.currentTimeMillis() + 60000;
+
+        assertTrue(store.markUsed("alice", "123456", invalidUntil));
+        assertFalse(store.markUsed("alice", "123456", invalidUntil));
+        assertTrue(store.markUsed("bob", "123456", invalidUntil));
+        assertTrue(store.markUsed("alice", "654321", invalidUntil));
+
+    }
+
+    /**
+     * Verifies that a code may be used again once its invalidation has
+     * expired.
+     *
+     * @throws InterruptedException
+     *     If the test is interrupted while waiting for the invalidation to
+     *     expire.
+     */
+    @Test
+    public void testExpiration() throws InterruptedException {
+
+        InMemoryUsedCodeStore store = new InMemoryUsedCodeStore();
+
+        assertTrue(store.markUsed("alice", "123456", System.currentTimeMillis() + 50));
+        assertFalse(store.markUsed("alice", "123456", System.currentTimeMillis() + 60000));
+
+        Thread.sleep(100);
+        assertTrue(store.markUsed("alice", "123456", System.currentTimeMillis() + 60000));
+        assertFalse(store.markUsed("alice", "123456", System.currentTimeMillis() + 60000));
+
+    }
+
+}
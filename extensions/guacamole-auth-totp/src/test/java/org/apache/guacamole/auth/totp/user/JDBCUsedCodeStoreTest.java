@@ -0,0 +1,168 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+package org.apache.guacamole.auth.totp.user;
+
+import java.io.File;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Files;
+import java.sql.Connection;
+import java.sql.DriverManager;
+import java.sql.SQLException;
+import java.sql.Statement;
+import org.junit.After;
+import org.junit.Before;
+import org.junit.Test;
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertFalse;
+import static org.junit.Assert.assertTrue;
+
+/**
+ * Test which verifies that JDBCUsedCodeStore accepts each code only once
+ * until its invalidation expires, including across multiple stores sharing
+ * the same database. An in-memory H2 database, initialized with the schema
+ * script included with this extension, is used in place of an actual
+ * database server.
+ */
+public class JDBCUsedCodeStoreTest {
+
+    /**
+     * The class name of the H2 JDBC driver.
+     */
+    private static final String DRIVER = "org.h2.Driver";
+
+    /**
+     * The JDBC URL of the in-memory database used by each test. The database
+     * persists until explicitly dropped, regardless of whether any
+     * connections remain open.
+     */
+    private static final String URL = "jdbc:h2:mem:totp;DB_CLOSE_DELAY=-1";
+
+    /**
+     * The schema script which creates the used code table.
+     */
+    private static final File SCHEMA = new File("schema/001-create-used-code-table.sql");
+
+    /**
+     * The first of two stores sharing the same database.
+     */
+    private JDBCUsedCodeStore store;
+
+    /**
+     * The second of two stores sharing the same database, representing a
+     * different Guacamole server.
+     */
+    private JDBCUsedCodeStore otherStore;
+
+    /**
+     * Creates the used code table using the schema script included with
+     * this extension, and creates the stores under test.
+     *
+     * @throws Exception
+     *     If the schema script cannot be read or executed.
+     */
+    @Before
+    public void setUp() throws Exception {
+
+        // Strip comments, leaving only the statements of the script
+        StringBuilder script = new StringBuilder();
+        for (String line : Files.readAllLines(SCHEMA.toPath(), StandardCharsets.UTF_8)) {
+            if (!line.trim().startsWith("--"))
+                script.append(line).append('\n');
+        }
+
+        try (Connection connection = DriverManager.getConnection(URL);
+                Statement statement = connection.createStatement()) {
+            for (String sql : script.toString().split(";")) {
+                if (!sql.trim().isEmpty())
+                    statement.execute(sql);
+            }
+        }
+
+        store = new JDBCUsedCodeStore(DRIVER, URL, null, null);
+        otherStore = new JDBCUsedCodeStore(DRIVER, URL, null, null);
+
+    }
+
+    /**
+     * Shuts down the stores under test and drops the in-memory database.
+     *
+     * @throws SQLException
+     *     If the database cannot be dropped.
+     */
+    @After
+    public void tearDown() throws SQLException {
+
+        store.shutdown();
+        otherStore.shutdown();
+
+        try (Connection connection = DriverManager.getConnection(URL);
+                Statement statement = connection.createStatement()) {
+            statement.execute("DROP ALL OBJECTS");
+        }
+
+    }
+
+    /**
+     * Verifies that a code is accepted only once, even by a different store
+     * sharing the same database, while codes of other users and other codes
+     * of the same user are unaffected.
+     *
+     * @throws Exception
+     *     If the database cannot be read or updated.
+     */
+    @Test
+    public void testMarkUsed() throws Exception {
+
+        long invalidUntil = System.currentTimeMillis() + 60000;
+
+        assertTrue(store.markUsed("alice", "123456", invalidUntil));
+        assertFalse(store.markUsed("alice", "123456", invalidUntil));
+        assertFalse(otherStore.markUsed("alice", "123456", invalidUntil));
+
+        assertTrue(otherStore.markUsed("bob", "123456", invalidUntil));
+        assertTrue(otherStore.markUsed("alice", "654321", invalidUntil));
+
+    }
+
+    /**
+     * Verifies that a code may be used again once its invalidation has
+     * expired, and that expired records are removed by the periodic cleanup.
+     *
+     * @throws Exception
+     *     If the database cannot be read or updated.
+     */
+    @Test
+    public void testExpiration() throws Exception {
+
+        long expired = System.currentTimeMillis() - 1;
+        long invalidUntil = System.currentTimeMillis() + 60000;
+
+        assertTrue(store.markUsed("alice", "123456", expired));
+        assertTrue(otherStore.markUsed("alice", "123456", invalidUntil));
+        assertFalse(store.markUsed("alice", "123456", invalidUntil));
+
+        assertTrue(store.markUsed("bob", "123456", expired));
+        assertTrue(store.markUsed("carol", "123456", expired));
+        assertEquals(2, store.removeExpired());
+        assertEquals(0, otherStore.removeExpired());
+
+    }
+
+}
@@ -20,6 +20,7 @@
 package org.apache.guacamole.totp;
 
 import java.security.InvalidKeyException;
+import java.util.Arrays;
 import org.junit.Test;
 import static org.junit.Assert.*;
 
@@ -165,4 +166,31 @@ public class TOTPGeneratorTest {
 
     }
 
+    /**
+     * Verifies that the window of accepted codes consists of the current and
+     * previous codes for the given timestamp, including across time step
+     * boundaries.
+     */
+    @Test
+    public void testWindow() {
+
+        // 160-bit key consisting of the bytes "12345678901234567890" repeated
+        // as necessary
+        final byte[] key = {
+            '1', '2', '3', '4', '5', '6', '7', '8', '9', '0',
+            '1', '2', '3', '4', '5', '6', '7', '8', '9', '0'
+        };
+
+        try {
+            final TOTPGenerator totp = new TOTPGenerator(key, TOTPGenerator.Mode.SHA1, 8);
+            assertEquals(Arrays.asList("14050471", "07081804"), totp.window(1111111111));
+            assertEquals(Arrays.asList("94287082", totp.generate(29)), totp.window(59));
+            assertEquals(Arrays.asList(totp.generate(60), "94287082"), totp.window(60));
+        }
+        catch (InvalidKeyException e) {
+            fail("SHA1 test key is invalid.");
+        }
+
+    }
+
 }
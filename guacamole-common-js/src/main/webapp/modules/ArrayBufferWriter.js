@@ -49,16 +49,7 @@ Guacamole.ArrayBufferWriter = function(stream) {
      * @param {Uint8Array} bytes The data to send.
      */
     function __send_blob(bytes) {
-
-        var binary = "";
-
-        // Produce binary string from bytes in buffer
-        for (var i=0; i<bytes.byteLength; i++)
-            binary += String.fromCharCode(bytes[i]);
-
-        // Send as base64
-        stream.sendBlob(window.btoa(binary));
-
+        stream.sendBlob(Guacamole.Base64.encode(bytes));
     }
 
     /**
@@ -110,6 +110,13 @@ Guacamole.AudioPlayer.getInstance = function getInstance(stream, mimetype) {
  * audio. This player relies only on the Web Audio API and does not require any
  * browser-level support for its audio formats.
  *
+ * Where AudioWorklet is supported, received audio packets are passed directly
+ * to an AudioWorkletProcessor, which converts and resamples the audio and
+ * plays it from an adaptive jitter buffer entirely on the audio rendering
+ * thread, unaffected by activity on the main thread. Otherwise, each packet
+ * is converted on the main thread and scheduled as its own
+ * AudioBufferSourceNode.
+ *
  * @constructor
  * @augments Guacamole.AudioPlayer
  * @param {Guacamole.InputStream} stream
@@ -213,6 +220,78 @@ Guacamole.RawAudioPlayer = function RawAudioPlayer(stream, mimetype) {
      */
     var packetQueue = [];
 
+    /**
+     * Reference to this Guacamole.RawAudioPlayer.
+     *
+     * @private
+     * @type {Guacamole.RawAudioPlayer}
+     */
+    var player = this;
+
+    /**
+     * The AudioWorkletNode playing received audio, or null if the
+     * AudioWorklet playback path is not (or not yet) in use.
+     *
+     * @private
+     * @type {AudioWorkletNode}
+     */
+    var node = null;
+
+    /**
+     * Received audio packets which are awaiting the loading of the
+     * AudioWorklet processor module, or null if no such loading is in
+     * progress.
+     *
+     * @private
+     * @type {ArrayBuffer[]}
+     */
+    var pendingPackets = null;
+
+    /**
+     * Whether the end of the audio stream has been reached.
+     *
+     * @private
+     * @type {Boolean}
+     */
+    var ended = false;
+
+    /**
+     * The number of times playback via AudioWorklet has run out of buffered
+     * audio, forcing silence to be played while the jitter buffer refills.
+     * This value is updated asynchronously and is always zero if the
+     * AudioWorklet playback path is not in use.
+     *
+     * @type {Number}
+     */
+    this.underruns = 0;
+
+    /**
+     * The number of times playback via AudioWorklet has accumulated more
+     * than the maximum allowed latency of buffered audio, forcing the oldest
+     * audio to be dropped. This value is updated asynchronously and is always
+     * zero if the AudioWorklet playback path is not in use.
+     *
+     * @type {Number}
+     */
+    this.overruns = 0;
+
+    /**
+     * The amount of audio currently buffered for playback via AudioWorklet,
+     * in seconds, as most recently reported by the AudioWorklet processor.
+     *
+     * @type {Number}
+     */
+    this.latency = 0;
+
+    /**
+     * The amount of audio that the jitter buffer of the AudioWorklet
+     * processor currently aims to keep buffered, in seconds. This is derived
+     * from the observed variance in packet arrival times.
+     *
+     * @type {Number}
+     */
+    this.targetLatency = 0;
+
     /**
      * Given an array of audio packets, returns a single audio packet
      * containing the concatenation of those packets.
@@ -406,8 +485,16 @@ Guacamole.RawAudioPlayer = function RawAudioPlayer(stream, mimetype) {
 
     };
 
-    // Defer playback of received audio packets slightly
-    reader.ondata = function playReceivedAudio(data) {
+    /**
+     * Plays the given packet of audio data by converting it on the main
+     * thread and scheduling it as its own AudioBufferSourceNode. This is the
+     * playback path used if AudioWorklet is not supported.
+     *
+     * @private
+     * @param {ArrayBuffer} data
+     *     The raw packet of audio data to play.
+     */
+    var playReceivedAudio = function playReceivedAudio(data) {
 
         // Push received samples onto queue
         pushAudioPacket(new SampleArray(data));
@@ -440,6 +527,104 @@ Guacamole.RawAudioPlayer = function RawAudioPlayer(stream, mimetype) {
 
     };
 
+    /**
+     * Creates the AudioWorkletNode which will play all received audio,
+     * passing along any packets received while the AudioWorklet processor
+     * module was loading.
+     *
+     * @private
+     */
+    var createNode = function createNode() {
+
+        node = new AudioWorkletNode(context, Guacamole.RawAudioPlayer.PROCESSOR_NAME, {
+            'numberOfInputs'     : 0,
+            'outputChannelCount' : [ format.channels ],
+            'processorOptions'   : {
+                'channels'       : format.channels,
+                'bytesPerSample' : format.bytesPerSample,
+                'rate'           : format.rate,
+                'maxLatency'     : maxLatency
+            }
+        });
+
+        // Track jitter buffer state, releasing the node once all audio has
+        // been played
+        node.port.onmessage = function processorMessage(e) {
+
+            var message = e.data;
+
+            player.underruns     = message.underruns;
+            player.overruns      = message.overruns;
+            player.latency       = message.latency;
+            player.targetLatency = message.targetLatency;
+
+            if (message.ended) {
+                node.port.onmessage = null;
+                node.disconnect();
+            }
+
+        };
+
+        node.connect(context.destination);
+
+        pendingPackets.forEach(sendPacket);
+        pendingPackets = null;
+
+        if (ended)
+            node.port.postMessage(null);
+
+    };
+
+    /**
+     * Passes the given packet of audio data to the AudioWorklet processor,
+     * transferring ownership of its underlying ArrayBuffer.
+     *
+     * @private
+     * @param {ArrayBuffer} data
+     *     The raw packet of audio data to play.
+     */
+    var sendPacket = function sendPacket(data) {
+        node.port.postMessage(data, [ data ]);
+    };
+
+    // Load AudioWorklet processor if supported, falling back to playback on
+    // the main thread if the processor cannot be loaded
+    if (Guacamole.RawAudioPlayer.isWorkletSupported(context)) {
+
+        pendingPackets = [];
+
+        Guacamole.RawAudioPlayer.loadProcessor(context).then(createNode, function processorFailed() {
+            var packets = pendingPackets;
+            pendingPackets = null;
+            packets.forEach(playReceivedAudio);
+        });
+
+    }
+
+    // Play received audio via AudioWorklet if possible
+    reader.ondata = function audioReceived(data) {
+
+        if (node)
+            sendPacket(data);
+
+        else if (pendingPackets)
+            pendingPackets.push(data);
+
+        else
+            playReceivedAudio(data);
+
+    };
+
+    // Allow AudioWorklet processor to finish once all audio has been played
+    reader.onend = function audioEnded() {
+
+        ended = true;
+
+        if (node)
+            node.port.postMessage(null);
+
+    };
+
     /** @override */
     this.sync = function sync() {
 
@@ -503,3 +688,352 @@ Guacamole.RawAudioPlayer.getSupportedTypes = function getSupportedTypes() {
     ];
 
 };
+
+/**
+ * The name under which the AudioWorkletProcessor used by
+ * Guacamole.RawAudioPlayer is registered.
+ *
+ * @constant
+ * @type {String}
+ */
+Guacamole.RawAudioPlayer.PROCESSOR_NAME = 'guacamole-raw-audio-player';
+
+/**
+ * Returns whether the given AudioContext supports AudioWorklet, and thus
+ * whether Guacamole.RawAudioPlayer may play audio using an
+ * AudioWorkletProcessor.
+ *
+ * @param {AudioContext} context
+ *     The AudioContext to test.
+ *
+ * @returns {Boolean}
+ *     true if AudioWorklet is supported, false otherwise.
+ */
+Guacamole.RawAudioPlayer.isWorkletSupported = function isWorkletSupported(context) {
+    return !!(context.audioWorklet && window.AudioWorkletNode
+            && window.Blob && window.URL);
+};
+
+/**
+ * Loads the AudioWorkletProcessor used by Guacamole.RawAudioPlayer into the
+ * given AudioContext. The processor is loaded only once per AudioContext.
+ *
+ * @param {AudioContext} context
+ *     The AudioContext to load the processor into.
+ *
+ * @returns {Promise}
+ *     A Promise which resolves once the processor has been loaded, or
+ *     rejects if the processor cannot be loaded (due to a
+ *     Content-Security-Policy, for example).
+ */
+Guacamole.RawAudioPlayer.loadProcessor = function loadProcessor(context) {
+
+    if (!context.__guac_raw_audio_processor) {
+        var source = new Blob([
+            '(' + Guacamole.RawAudioPlayer.processor + ')('
+                + JSON.stringify(Guacamole.RawAudioPlayer.PROCESSOR_NAME) + ');'
+        ], { 'type' : 'application/javascript' });
+        context.__guac_raw_audio_processor = context.audioWorklet.addModule(URL.createObjectURL(source));
+    }
+
+    return context.__guac_raw_audio_processor;
+
+};
+
+/**
+ * The body of the AudioWorklet module which registers the
+ * AudioWorkletProcessor used by Guacamole.RawAudioPlayer. This function is
+ * never invoked directly. It is converted to source and loaded into the
+ * AudioWorkletGlobalScope, and thus may not reference anything outside of its
+ * own body.
+ *
+ * Each packet of raw PCM received by the processor is converted to floating
+ * point samples and resampled to the rate of the AudioContext, then queued
+ * within a jitter buffer. Playback begins (or resumes after an underrun) only
+ * once the jitter buffer holds its target amount of audio, which is derived
+ * from a running estimate of the variance in packet arrival times. If the
+ * buffered audio exceeds the maximum allowed latency, the oldest audio is
+ * dropped.
+ *
+ * @private
+ * @param {String} name
+ *     The name to register the AudioWorkletProcessor under.
+ */
+Guacamole.RawAudioPlayer.processor = function processor(name) {
+
+    /**
+     * The minimum amount of audio to buffer before playback begins, in
+     * seconds, regardless of observed jitter.
+     *
+     * @constant
+     * @type {Number}
+     */
+    var MIN_LATENCY = 0.02;
+
+    /**
+     * The number of seconds of output between reports of jitter buffer state
+     * to the main thread.
+     *
+     * @constant
+     * @type {Number}
+     */
+    var REPORT_INTERVAL = 0.5;
+
+    /**
+     * @constructor
+     * @augments AudioWorkletProcessor
+     * @param {Object} options
+     *     The options provided when the AudioWorkletNode was created.
+     */
+    var RawAudioProcessor = function RawAudioProcessor(options) {
+
+        var self = Reflect.construct(AudioWorkletProcessor, [ options ], RawAudioProcessor);
+        var format = options.processorOptions;
+
+        var channels = format.channels;
+        var rate = format.rate;
+        var maxSampleValue = (format.bytesPerSample === 1) ? 128 : 32768;
+        var SampleArray = (format.bytesPerSample === 1) ? Int8Array : Int16Array;
+        var maxLatency = format.maxLatency;
+
+        // Number of input frames per output frame
+        var step = rate / sampleRate;
+
+        // Position of the next output frame relative to the first frame of
+        // the next packet, in input frames, and the final frame of the
+        // previous packet (for interpolation across packet boundaries)
+        var phase = 0;
+        var previous = new Float32Array(channels);
+
+        // Queue of interleaved, resampled packets awaiting playback
+        var queue = [];
+        var queueOffset = 0;
+        var buffered = 0;
+
+        // Jitter buffer state
+        var playing = false;
+        var ended = false;
+        var jitter = 0;
+        var lastArrival = null;
+        var lastDuration = 0;
+        var targetLatency = MIN_LATENCY;
+        var underruns = 0;
+        var overruns = 0;
+        var framesSinceReport = 0;
+
+        /**
+         * Converts and resamples the given packet of raw PCM, returning the
+         * corresponding interleaved floating point samples at the output
+         * sample rate.
+         */
+        var resample = function resample(data) {
+
+            var samples = new SampleArray(data);
+            var frames = Math.floor(samples.length / channels);
+            if (!frames)
+                return new Float32Array(0);
+
+            // Convert directly if no resampling is needed
+            if (step === 1) {
+                var converted = new Float32Array(frames * channels);
+                for (var i = 0; i < converted.length; i++)
+                    converted[i] = samples[i] / maxSampleValue;
+                return converted;
+            }
+
+            var count = phase <= frames - 1 ? Math.floor((frames - 1 - phase) / step) + 1 : 0;
+            var output = new Float32Array(count * channels);
+
+            // Interpolate linearly between adjacent input frames, where input
+            // frame -1 is the final frame of the previous packet. An output
+            // frame falling exactly on (or, due to rounding, just past) the
+            // final input frame uses that frame alone, as the following frame
+            // has not yet been received.
+            var out = 0;
+            for (var n = 0; n < count; n++) {
+
+                var position = phase + n * step;
+                var index = Math.floor(position);
+                var fraction = position - index;
+                var exact = fraction === 0 || index + 1 >= frames;
+
+                for (var channel = 0; channel < channels; channel++) {
+                    var a = index < 0 ? previous[channel] : samples[index * channels + channel] / maxSampleValue;
+                    if (exact)
+                        output[out++] = a;
+                    else {
+                        var b = samples[(index + 1) * channels + channel] / maxSampleValue;
+                        output[out++] = a + (b - a) * fraction;
+                    }
+                }
+
+            }
+
+            phase += count * step - frames;
+            for (var c = 0; c < channels; c++)
+                previous[c] = samples[(frames - 1) * channels + c] / maxSampleValue;
+
+            return output;
+
+        };
+
+        /**
+         * Updates the jitter estimate and target latency based on the
+         * arrival of a packet of the given duration, in seconds.
+         */
+        var packetArrived = function packetArrived(duration) {
+
+            // Estimate jitter as the smoothed deviation between actual and
+            // expected packet interarrival time (as in RFC 3550)
+            if (lastArrival !== null) {
+                var deviation = (currentTime - lastArrival) - lastDuration;
+                jitter += (Math.abs(deviation) - jitter) / 16;
+            }
+
+            lastArrival = currentTime;
+            lastDuration = duration;
+
+            targetLatency = Math.min(maxLatency / 2, Math.max(MIN_LATENCY, jitter * 3));
+
+        };
+
+        /**
+         * Drops the given number of frames from the start of the queue.
+         */
+        var drop = function drop(frames) {
+
+            buffered -= frames;
+
+            var remaining = frames * channels;
+            while (remaining > 0) {
+                var available = queue[0].length - queueOffset;
+                if (available > remaining) {
+                    queueOffset += remaining;
+                    break;
+                }
+                remaining -= available;
+                queue.shift();
+                queueOffset = 0;
+            }
+
+        };
+
+        /**
+         * Reports the state of the jitter buffer to the main thread.
+         */
+        var report = function report(done) {
+            framesSinceReport = 0;
+            self.port.postMessage({
+                'underruns'     : underruns,
+                'overruns'      : overruns,
+                'latency'       : buffered / sampleRate,
+                'targetLatency' : targetLatency,
+                'ended'         : done
+            });
+        };
+
+        self.port.onmessage = function packetReceived(e) {
+
+            // A null message denotes the end of the stream
+            if (e.data === null) {
+                ended = true;
+                return;
+            }
+
+            var packet = resample(e.data);
+            var frames = packet.length / channels;
+            if (!frames)
+                return;
+
+            packetArrived(frames / sampleRate);
+            queue.push(packet);
+            buffered += frames;
+
+            // Drop oldest audio if too far behind
+            if (buffered > maxLatency * sampleRate) {
+                drop(buffered - Math.ceil(targetLatency * sampleRate));
+                overruns++;
+                report(false);
+            }
+
+        };
+
+        self.render = function render(outputs) {
+
+            var output = outputs[0];
+            var length = output[0].length;
+
+            // Begin playback only once enough audio is buffered, or once no
+            // further audio will be received
+            if (!playing && buffered && (ended || buffered >= targetLatency * sampleRate))
+                playing = true;
+
+            if (playing) {
+
+                var written = 0;
+                while (written < length && queue.length) {
+
+                    var packet = queue[0];
+                    var available = (packet.length - queueOffset) / channels;
+                    var frames = Math.min(available, length - written);
+
+                    // Deinterleave samples into output channels
+                    for (var channel = 0; channel < channels && channel < output.length; channel++) {
+                        var data = output[channel];
+                        var offset = queueOffset + channel;
+                        for (var i = 0; i < frames; i++) {
+                            data[written + i] = packet[offset];
+                            offset += channels;
+                        }
+                    }
+
+                    written += frames;
+                    buffered -= frames;
+                    queueOffset += frames * channels;
+
+                    if (queueOffset === packet.length) {
+                        queue.shift();
+                        queueOffset = 0;
+                    }
+
+                }
+
+                // Stop and rebuffer if audio ran out before stream end
+                if (written < length) {
+                    playing = false;
+                    if (!ended) {
+                        underruns++;
+                        report(false);
+                    }
+                }
+
+            }
+
+            // Release processor once all audio has been played
+            if (ended && !buffered) {
+                report(true);
+                return false;
+            }
+
+            framesSinceReport += length;
+            if (framesSinceReport >= REPORT_INTERVAL * sampleRate)
+                report(false);
+
+            return true;
+
+        };
+
+        return self;
+
+    };
+
+    Object.setPrototypeOf(RawAudioProcessor.prototype, AudioWorkletProcessor.prototype);
+    Object.setPrototypeOf(RawAudioProcessor, AudioWorkletProcessor);
+
+    RawAudioProcessor.prototype.process = function process(inputs, outputs) {
+        return this.render(outputs);
+    };
+
+    registerProcessor(name, RawAudioProcessor);
+
+};
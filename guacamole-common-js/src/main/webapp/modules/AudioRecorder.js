@@ -121,6 +121,12 @@ Guacamole.AudioRecorder.getInstance = function getInstance(stream, mimetype) {
  * format audio. This recorder relies only on the Web Audio API and does not
  * require any browser-level support for its audio formats.
  *
+ * Where AudioWorklet is supported, captured audio is resampled, converted to
+ * PCM and batched into blob-sized packets by an AudioWorkletProcessor on the
+ * audio rendering thread, leaving only the sending of finished packets to the
+ * main thread. Otherwise, audio is captured and processed on the main thread
+ * using a ScriptProcessorNode.
+ *
  * @constructor
  * @augments Guacamole.AudioRecorder
  * @param {Guacamole.OutputStream} stream
@@ -260,11 +266,12 @@ Guacamole.RawAudioRecorder = function RawAudioRecorder(stream, mimetype) {
     var source = null;
 
     /**
-     * The script processing node which receives audio input from the media
-     * stream source node as individual audio buffers.
+     * The processing node which receives audio input from the media stream
+     * source node. This will be an AudioWorkletNode if AudioWorklet is
+     * supported, or a ScriptProcessorNode otherwise.
      *
      * @private
-     * @type {ScriptProcessorNode}
+     * @type {AudioNode}
      */
     var processor = null;
 
@@ -422,6 +429,79 @@ Guacamole.RawAudioRecorder = function RawAudioRecorder(stream, mimetype) {
      */
     var streamReceived = function streamReceived(stream) {
 
+        // Save stream for later cleanup
+        mediaStream = stream;
+
+        // Create source node providing access to user's audio input
+        source = context.createMediaStreamSource(stream);
+
+        // Process audio via AudioWorklet if possible, falling back to a
+        // ScriptProcessorNode if the processor cannot be loaded
+        if (Guacamole.RawAudioRecorder.isWorkletSupported(context))
+            Guacamole.RawAudioRecorder.loadProcessor(context).then(
+                    connectWorkletProcessor, connectScriptProcessor);
+        else
+            connectScriptProcessor();
+
+        // Attempt to explicitly resume AudioContext, as it may be paused
+        // by default
+        if (context.state === 'suspended')
+            context.resume();
+
+    };
+
+    /**
+     * Connects the media stream source node to a new AudioWorkletNode which
+     * resamples, converts and batches audio on the audio rendering thread,
+     * sending each finished packet along the underlying stream. If capture
+     * has since been stopped, this function has no effect.
+     *
+     * @private
+     */
+    var connectWorkletProcessor = function connectWorkletProcessor() {
+
+        if (!source)
+            return;
+
+        processor = new AudioWorkletNode(context, Guacamole.RawAudioRecorder.PROCESSOR_NAME, {
+            'numberOfInputs'        : 1,
+            'numberOfOutputs'       : 1,
+            'channelCount'          : format.channels,
+            'channelCountMode'      : 'explicit',
+            'outputChannelCount'    : [ 1 ],
+            'processorOptions'      : {
+                'channels'       : format.channels,
+                'bytesPerSample' : format.bytesPerSample,
+                'rate'           : format.rate,
+                'blobLength'     : writer.blobLength
+            }
+        });
+
+        // Send each finished packet as a single blob
+        processor.port.onmessage = function packetReady(e) {
+            writer.sendData(e.data);
+        };
+
+        // The (silent) output is connected only to ensure the node is
+        // processed by all browsers
+        processor.connect(context.destination);
+        source.connect(processor);
+
+    };
+
+    /**
+     * Connects the media stream source node to a new ScriptProcessorNode
+     * which resamples and converts audio on the main thread, sending each
+     * resulting packet along the underlying stream. If capture has since been
+     * stopped, this function has no effect.
+     *
+     * @private
+     */
+    var connectScriptProcessor = function connectScriptProcessor() {
+
+        if (!source)
+            return;
+
         // Create processing node which receives appropriately-sized audio buffers
         processor = context.createScriptProcessor(BUFFER_SIZE, format.channels, format.channels);
         processor.connect(context.destination);
@@ -432,17 +512,8 @@ Guacamole.RawAudioRecorder = function RawAudioRecorder(stream, mimetype) {
         };
 
         // Connect processing node to user's audio input source
-        source = context.createMediaStreamSource(stream);
         source.connect(processor);
 
-        // Attempt to explicitly resume AudioContext, as it may be paused
-        // by default
-        if (context.state === 'suspended')
-            context.resume();
-
-        // Save stream for later cleanup
-        mediaStream = stream;
-
     };
 
     /**
@@ -499,9 +570,12 @@ Guacamole.RawAudioRecorder = function RawAudioRecorder(stream, mimetype) {
         if (source)
             source.disconnect();
 
-        // Disconnect associated script processor node
-        if (processor)
+        // Disconnect associated processor node
+        if (processor) {
             processor.disconnect();
+            if (processor.port)
+                processor.port.onmessage = null;
+        }
 
         // Stop capture
         if (mediaStream) {
@@ -601,3 +675,258 @@ Guacamole.RawAudioRecorder.getSupportedTypes = function getSupportedTypes() {
     ];
 
 };
+
+/**
+ * The name under which the AudioWorkletProcessor used by
+ * Guacamole.RawAudioRecorder is registered.
+ *
+ * @constant
+ * @type {String}
+ */
+Guacamole.RawAudioRecorder.PROCESSOR_NAME = 'guacamole-raw-audio-recorder';
+
+/**
+ * Returns whether the given AudioContext supports AudioWorklet, and thus
+ * whether Guacamole.RawAudioRecorder may process audio using an
+ * AudioWorkletProcessor.
+ *
+ * @param {AudioContext} context
+ *     The AudioContext to test.
+ *
+ * @returns {Boolean}
+ *     true if AudioWorklet is supported, false otherwise.
+ */
+Guacamole.RawAudioRecorder.isWorkletSupported = function isWorkletSupported(context) {
+    return !!(context.audioWorklet && window.AudioWorkletNode
+            && window.Blob && window.URL);
+};
+
+/**
+ * Loads the AudioWorkletProcessor used by Guacamole.RawAudioRecorder into the
+ * given AudioContext. The processor is loaded only once per AudioContext.
+ *
+ * @param {AudioContext} context
+ *     The AudioContext to load the processor into.
+ *
+ * @returns {Promise}
+ *     A Promise which resolves once the processor has been loaded, or
+ *     rejects if the processor cannot be loaded (due to a
+ *     Content-Security-Policy, for example).
+ */
+Guacamole.RawAudioRecorder.loadProcessor = function loadProcessor(context) {
+
+    if (!context.__guac_raw_audio_recorder) {
+        var source = new Blob([
+            '(' + Guacamole.RawAudioRecorder.processor + ')('
+                + JSON.stringify(Guacamole.RawAudioRecorder.PROCESSOR_NAME) + ');'
+        ], { 'type' : 'application/javascript' });
+        context.__guac_raw_audio_recorder = context.audioWorklet.addModule(URL.createObjectURL(source));
+    }
+
+    return context.__guac_raw_audio_recorder;
+
+};
+
+/**
+ * The body of the AudioWorklet module which registers the
+ * AudioWorkletProcessor used by Guacamole.RawAudioRecorder. This function is
+ * never invoked directly. It is converted to source and loaded into the
+ * AudioWorkletGlobalScope, and thus may not reference anything outside of its
+ * own body.
+ *
+ * Captured audio is resampled to the rate of the raw audio format using
+ * Lanczos interpolation against a precomputed table of kernel values,
+ * carrying enough input history across render quanta that no discontinuity
+ * occurs between them. Resampled audio is converted to PCM and accumulated
+ * until a full blob worth of data is available, at which point the packet is
+ * transferred to the main thread.
+ *
+ * @private
+ * @param {String} name
+ *     The name to register the AudioWorkletProcessor under.
+ */
+Guacamole.RawAudioRecorder.processor = function processor(name) {
+
+    /**
+     * The window size to use when applying Lanczos interpolation, commonly
+     * denoted by the variable "a".
+     *
+     * @constant
+     * @type {Number}
+     */
+    var LANCZOS_WINDOW_SIZE = 3;
+
+    /**
+     * The number of entries in the table of Lanczos kernel values per unit of
+     * distance between samples.
+     *
+     * @constant
+     * @type {Number}
+     */
+    var KERNEL_RESOLUTION = 512;
+
+    /**
+     * The value of the Lanczos kernel at every 1/KERNEL_RESOLUTION interval
+     * from 0 to LANCZOS_WINDOW_SIZE. The kernel is symmetric, and thus only
+     * its positive half is stored.
+     *
+     * @type {Float32Array}
+     */
+    var kernel = new Float32Array(LANCZOS_WINDOW_SIZE * KERNEL_RESOLUTION + 1);
+    for (var k = 1; k < kernel.length - 1; k++) {
+        var x = k / KERNEL_RESOLUTION;
+        var piX = Math.PI * x;
+        kernel[k] = LANCZOS_WINDOW_SIZE * Math.sin(piX) * Math.sin(piX / LANCZOS_WINDOW_SIZE) / (piX * piX);
+    }
+    kernel[0] = 1;
+
+    /**
+     * @constructor
+     * @augments AudioWorkletProcessor
+     * @param {Object} options
+     *     The options provided when the AudioWorkletNode was created.
+     */
+    var RawAudioRecorderProcessor = function RawAudioRecorderProcessor(options) {
+
+        var self = Reflect.construct(AudioWorkletProcessor, [ options ], RawAudioRecorderProcessor);
+        var format = options.processorOptions;
+
+        var channels = format.channels;
+        var maxSampleValue = (format.bytesPerSample === 1) ? 128 : 32768;
+        var SampleArray = (format.bytesPerSample === 1) ? Int8Array : Int16Array;
+
+        // Number of input frames per output frame
+        var step = sampleRate / format.rate;
+
+        // Number of samples (across all channels) per finished packet
+        var packetSamples = Math.max(1, Math.floor(format.blobLength / format.bytesPerSample / channels)) * channels;
+
+        // Input history for each channel, covering the Lanczos window around
+        // the next output position. The first element of each history
+        // corresponds to absolute input frame historyStart.
+        var historyLength = 128 + 2 * LANCZOS_WINDOW_SIZE + Math.ceil(step) + 1;
+        var history = [];
+        for (var c = 0; c < channels; c++)
+            history.push(new Float32Array(historyLength * 2));
+        var historyStart = -LANCZOS_WINDOW_SIZE;
+        var historyFrames = LANCZOS_WINDOW_SIZE;
+
+        // Absolute input position of the next output frame
+        var position = 0;
+
+        // Packet currently being filled
+        var packet = new SampleArray(packetSamples);
+        var packetOffset = 0;
+
+        /**
+         * Appends the given render quantum of input to the history of each
+         * channel, discarding history which is no longer needed.
+         */
+        var append = function append(input, length) {
+
+            // Discard frames preceding the Lanczos window of the next output
+            var discard = Math.floor(position) - LANCZOS_WINDOW_SIZE + 1 - historyStart;
+            if (discard > 0) {
+                for (var c = 0; c < channels; c++)
+                    history[c].copyWithin(0, discard, historyFrames);
+                historyStart += discard;
+                historyFrames -= discard;
+            }
+
+            for (var channel = 0; channel < channels; channel++) {
+
+                var data = history[channel];
+                if (historyFrames + length > data.length) {
+                    var grown = new Float32Array((historyFrames + length) * 2);
+                    grown.set(data.subarray(0, historyFrames));
+                    history[channel] = data = grown;
+                }
+
+                // Missing input channels (no input connected) are silent
+                if (input[channel])
+                    data.set(input[channel], historyFrames);
+                else
+                    data.fill(0, historyFrames, historyFrames + length);
+
+            }
+
+            historyFrames += length;
+
+        };
+
+        /**
+         * Produces as many output frames as the available history allows,
+         * appending their PCM samples to the current packet and sending each
+         * packet once full.
+         */
+        var resample = function resample() {
+
+            // Output requires input up to LANCZOS_WINDOW_SIZE frames ahead
+            var available = historyStart + historyFrames - LANCZOS_WINDOW_SIZE;
+            while (position < available) {
+
+                var index = Math.floor(position);
+                var fraction = position - index;
+                var base = index - LANCZOS_WINDOW_SIZE + 1 - historyStart;
+
+                for (var channel = 0; channel < channels; channel++) {
+
+                    var data = history[channel];
+                    var sum = 0;
+
+                    // Sum over window, looking up kernel by distance
+                    for (var tap = 0; tap < 2 * LANCZOS_WINDOW_SIZE; tap++) {
+                        var distance = Math.abs(fraction + LANCZOS_WINDOW_SIZE - 1 - tap);
+                        sum += data[base + tap] * kernel[Math.round(distance * KERNEL_RESOLUTION)];
+                    }
+
+                    // Clamp and convert to PCM
+                    var value = Math.round(sum * maxSampleValue);
+                    if (value >= maxSampleValue)
+                        value = maxSampleValue - 1;
+                    else if (value < -maxSampleValue)
+                        value = -maxSampleValue;
+
+                    packet[packetOffset++] = value;
+
+                }
+
+                // Send packet once full
+                if (packetOffset === packetSamples) {
+                    self.port.postMessage(packet.buffer, [ packet.buffer ]);
+                    packet = new SampleArray(packetSamples);
+                    packetOffset = 0;
+                }
+
+                position += step;
+
+            }
+
+        };
+
+        self.render = function render(inputs) {
+
+            var input = inputs[0];
+            if (input && input.length) {
+                append(input, input[0].length);
+                resample();
+            }
+
+            return true;
+
+        };
+
+        return self;
+
+    };
+
+    Object.setPrototypeOf(RawAudioRecorderProcessor.prototype, AudioWorkletProcessor.prototype);
+    Object.setPrototypeOf(RawAudioRecorderProcessor, AudioWorkletProcessor);
+
+    RawAudioRecorderProcessor.prototype.process = function process(inputs) {
+        return this.render(inputs);
+    };
+
+    registerProcessor(name, RawAudioRecorderProcessor);
+
+};
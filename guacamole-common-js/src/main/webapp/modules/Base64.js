@@ -0,0 +1,330 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+var Guacamole = Guacamole || {};
+
+/**
+ * Conversion between binary data and the base64 encoding used by the
+ * contents of Guacamole "blob" instructions. Unlike window.btoa() and
+ * window.atob(), these functions operate directly on Uint8Arrays, without
+ * first building an intermediate "binary string" one character at a time.
+ * Where the browser natively supports Uint8Array.prototype.toBase64() and
+ * Uint8Array.fromBase64(), those are used instead.
+ *
+ * @namespace
+ */
+Guacamole.Base64 = (function() {
+
+    /**
+     * The characters of the base64 alphabet, in order of the 6-bit values
+     * they represent.
+     *
+     * @private
+     * @constant
+     * @type {String}
+     */
+    var ALPHABET = 'ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/';
+
+    /**
+     * The character code of "=", the padding character of base64.
+     *
+     * @private
+     * @constant
+     * @type {Number}
+     */
+    var PAD = 0x3D;
+
+    /**
+     * The maximum number of characters to pass to a single invocation of
+     * String.fromCharCode() when TextDecoder is not available. Passing too
+     * many arguments at once would exceed the call stack.
+     *
+     * @private
+     * @constant
+     * @type {Number}
+     */
+    var MAX_CHAR_CODES = 32768;
+
+    /**
+     * Lookup table of the character code of the base64 character
+     * representing each possible 6-bit value.
+     *
+     * @private
+     * @type {Uint8Array}
+     */
+    var encodeTable = new Uint8Array(64);
+
+    /**
+     * Lookup table of the 6-bit value represented by each possible ASCII
+     * character code. Character codes which are not part of the base64
+     * alphabet map to 0xFF, which can be detected after decoding by checking
+     * the high bit of the bitwise OR of all values looked up.
+     *
+     * @private
+     * @type {Uint8Array}
+     */
+    var decodeTable = new Uint8Array(128);
+
+    for (var i = 0; i < decodeTable.length; i++)
+        decodeTable[i] = 0xFF;
+
+    for (var value = 0; value < ALPHABET.length; value++) {
+        var code = ALPHABET.charCodeAt(value);
+        encodeTable[value] = code;
+        decodeTable[code] = value;
+    }
+
+    /**
+     * Buffer reused by every call to encode() to hold the character codes
+     * of the encoded result, grown as necessary.
+     *
+     * @private
+     * @type {Uint8Array}
+     */
+    var encodeBuffer = new Uint8Array(8192);
+
+    /**
+     * Decoder which converts the character codes within encodeBuffer into a
+     * string, or null if TextDecoder is not supported. As base64 consists
+     * entirely of ASCII, any single-byte encoding will do.
+     *
+     * @private
+     * @type {TextDecoder}
+     */
+    var asciiDecoder = typeof TextDecoder !== 'undefined' ? new TextDecoder('latin1') : null;
+
+    /**
+     * Buffer reused by every call to decode() to hold the character codes
+     * of the string being decoded, grown as necessary.
+     *
+     * @private
+     * @type {Uint8Array}
+     */
+    var decodeBuffer = new Uint8Array(8192);
+
+    /**
+     * Encoder which copies the character codes of a string being decoded
+     * into decodeBuffer, or null if TextEncoder is not supported. As base64
+     * consists entirely of ASCII, which UTF-8 represents as single bytes
+     * with the same values, this is a direct copy for valid base64.
+     *
+     * @private
+     * @type {TextEncoder}
+     */
+    var asciiEncoder = typeof TextEncoder !== 'undefined'
+            && TextEncoder.prototype.encodeInto ? new TextEncoder() : null;
+
+    /**
+     * Converts the given array of 8-bit character codes into a string.
+     *
+     * @private
+     * @param {Uint8Array} codes
+     *     The character codes to convert.
+     *
+     * @returns {String}
+     *     A string containing the given characters.
+     */
+    var toString = function toString(codes) {
+
+        if (asciiDecoder)
+            return asciiDecoder.decode(codes);
+
+        var string = '';
+        for (var offset = 0; offset < codes.length; offset += MAX_CHAR_CODES)
+            string += String.fromCharCode.apply(String,
+                    codes.subarray(offset, offset + MAX_CHAR_CODES));
+
+        return string;
+
+    };
+
+    /**
+     * Decodes the given base64 string using window.atob(). This handles
+     * input that the table-driven decoder does not, such as embedded
+     * whitespace, as well as browsers lacking TextEncoder. An exception is
+     * thrown if the input is not valid base64.
+     *
+     * @private
+     * @param {String} data
+     *     The base64 string to decode.
+     *
+     * @returns {Uint8Array}
+     *     The decoded data.
+     */
+    var decodeBinaryString = function decodeBinaryString(data) {
+
+        var binary = window.atob(data);
+        var bytes = new Uint8Array(binary.length);
+
+        for (var i = 0; i < binary.length; i++)
+            bytes[i] = binary.charCodeAt(i);
+
+        return bytes;
+
+    };
+
+    return {
+
+        /**
+         * Encodes the given binary data as base64.
+         *
+         * @param {Uint8Array} bytes
+         *     The data to encode.
+         *
+         * @returns {String}
+         *     The base64 encoding of the given data, including padding.
+         */
+        encode : function encode(bytes) {
+
+            // Use native encoding if available
+            if (bytes.toBase64)
+                return bytes.toBase64();
+
+            var length = bytes.length;
+            var remainder = length % 3;
+            var end = length - remainder;
+
+            // Grow output buffer if necessary
+            var encodedLength = Math.ceil(length / 3) * 4;
+            if (encodeBuffer.length < encodedLength)
+                encodeBuffer = new Uint8Array(encodedLength);
+
+            var output = encodeBuffer;
+            var table = encodeTable;
+            var offset = 0;
+            var bits;
+
+            // Encode each complete group of three bytes as four characters
+            for (var i = 0; i < end; i += 3) {
+                bits = (bytes[i] << 16) | (bytes[i+1] << 8) | bytes[i+2];
+                output[offset++] = table[bits >>> 18];
+                output[offset++] = table[(bits >>> 12) & 0x3F];
+                output[offset++] = table[(bits >>> 6) & 0x3F];
+                output[offset++] = table[bits & 0x3F];
+            }
+
+            // Encode any remaining one or two bytes, padding with "="
+            if (remainder) {
+                bits = (bytes[end] << 16) | (remainder === 2 ? bytes[end+1] << 8 : 0);
+                output[offset++] = table[bits >>> 18];
+                output[offset++] = table[(bits >>> 12) & 0x3F];
+                output[offset++] = remainder === 2 ? table[(bits >>> 6) & 0x3F] : PAD;
+                output[offset++] = PAD;
+            }
+
+            return toString(output.subarray(0, offset));
+
+        },
+
+        /**
+         * Decodes the given base64 string. Padding is optional. An exception
+         * is thrown if the string is not valid base64.
+         *
+         * @param {String} data
+         *     The base64 string to decode.
+         *
+         * @returns {Uint8Array}
+         *     The decoded data, backed by an ArrayBuffer of exactly the same
+         *     length.
+         */
+        decode : function decode(data) {
+
+            // Use native decoding if available
+            if (Uint8Array.fromBase64)
+                return Uint8Array.fromBase64(data);
+
+            // Without TextEncoder, the characters of the string cannot be
+            // read in bulk
+            if (!asciiEncoder)
+                return decodeBinaryString(data);
+
+            // Grow input buffer if necessary
+            var length = data.length;
+            if (decodeBuffer.length < length)
+                decodeBuffer = new Uint8Array(length);
+
+            // Copy character codes into input buffer, deferring to atob() if
+            // any character is outside ASCII (and thus would be encoded as
+            // multiple bytes)
+            var input = decodeBuffer;
+            if (asciiEncoder.encodeInto(data, input).written !== length)
+                return decodeBinaryString(data);
+
+            // Ignore trailing padding
+            if (length && input[length - 1] === PAD) length--;
+            if (length && input[length - 1] === PAD) length--;
+
+            var remainder = length % 4;
+            var end = length - remainder;
+
+            // A single trailing character cannot encode a whole byte
+            if (remainder === 1)
+                return decodeBinaryString(data);
+
+            var bytes = new Uint8Array((length * 3) >>> 2);
+            var table = decodeTable;
+            var offset = 0;
+            var invalid = 0;
+            var bits;
+
+            // Decode each complete group of four characters as three bytes,
+            // noting any characters outside the base64 alphabet
+            for (var i = 0; i < end; i += 4) {
+
+                var a = table[input[i]];
+                var b = table[input[i+1]];
+                var c = table[input[i+2]];
+                var d = table[input[i+3]];
+                invalid |= a | b | c | d;
+
+                bits = (a << 18) | (b << 12) | (c << 6) | d;
+                bytes[offset++] = bits >>> 16;
+                bytes[offset++] = (bits >>> 8) & 0xFF;
+                bytes[offset++] = bits & 0xFF;
+
+            }
+
+            // Decode any remaining two or three characters as one or two
+            // bytes
+            if (remainder) {
+
+                var e = table[input[end]];
+                var f = table[input[end+1]];
+                var g = remainder === 3 ? table[input[end+2]] : 0;
+                invalid |= e | f | g;
+
+                bits = (e << 18) | (f << 12) | (g << 6);
+                bytes[offset++] = bits >>> 16;
+                if (remainder === 3)
+                    bytes[offset++] = (bits >>> 8) & 0xFF;
+
+            }
+
+            // Defer to atob() for anything unusual, such as whitespace or
+            // invalid data
+            if (invalid & 0x80)
+                return decodeBinaryString(data);
+
+            return bytes;
+
+        }
+
+    };
+
+})();
@@ -72,6 +72,18 @@ Guacamole.Client = function(tunnel) {
      */
     var display = new Guacamole.Display();
 
+    // Close the connection if the display can no longer draw, rather than
+    // continuing with a display which silently stops updating
+    display.onerror = function displayFailed(message) {
+
+        if (guac_client.onerror)
+            guac_client.onerror(new Guacamole.Status(
+                Guacamole.Status.Code.SERVER_ERROR, message));
+
+        guac_client.disconnect();
+
+    };
+
     /**
      * All available layers and buffers
      *
@@ -119,6 +131,51 @@ Guacamole.Client = function(tunnel) {
     // Array of allocated output streams by index
     var output_streams = [];
 
+    /**
+     * The most recent motion-only mouse event which has not yet been sent,
+     * as an object containing the "x" and "y" coordinates and "buttonMask" of
+     * the event, or null if no such event is pending.
+     *
+     * @private
+     * @type {Object}
+     */
+    var pendingMouseMotion = null;
+
+    /**
+     * The button mask of the last mouse event sent.
+     *
+     * @private
+     * @type {Number}
+     */
+    var lastButtonMask = 0;
+
+    /**
+     * The time that the last mouse event was sent, in milliseconds, as
+     * returned by Date.now().
+     *
+     * @private
+     * @type {Number}
+     */
+    var lastMouseTimestamp = 0;
+
+    /**
+     * The ID of the animation frame request or timeout which will send the
+     * pending motion-only mouse event, or null if no such send is scheduled.
+     *
+     * @private
+     * @type {Number}
+     */
+    var mouseFlushHandle = null;
+
+    /**
+     * Whether the scheduled send of the pending motion-only mouse event was
+     * requested using requestAnimationFrame(), rather than setTimeout().
+     *
+     * @private
+     * @type {Boolean}
+     */
+    var mouseFlushAnimated = false;
+
     function setState(state) {
         if (state != currentState) {
             currentState = state;
@@ -132,6 +189,113 @@ Guacamole.Client = function(tunnel) {
             || currentState == STATE_WAITING;
     }
 
+    /**
+     * Immediately sends any messages queued within the tunnel if
+     * flushPriorityMessages is set. This should be invoked after sending
+     * messages whose latency directly affects the server, such as "sync" and
+     * "ack", which would otherwise wait for the tunnel to send all other
+     * messages queued within the current task.
+     *
+     * @private
+     */
+    function sentPriorityMessage() {
+        if (guac_client.flushPriorityMessages && tunnel.flush)
+            tunnel.flush();
+    }
+
+    /**
+     * Sends a mouse event having the given coordinates and button mask.
+     *
+     * @private
+     * @param {Number} x
+     *     The X coordinate of the mouse pointer, in remote display units.
+     *
+     * @param {Number} y
+     *     The Y coordinate of the mouse pointer, in remote display units.
+     *
+     * @param {Number} buttonMask
+     *     The mask of all currently-pressed mouse buttons.
+     */
+    function sendMouseEvent(x, y, buttonMask) {
+        tunnel.sendMessage("mouse", x, y, buttonMask);
+        lastButtonMask = buttonMask;
+        lastMouseTimestamp = Date.now();
+        guac_client.sentMouseStates++;
+    }
+
+    /**
+     * Cancels any scheduled send of the pending motion-only mouse event.
+     *
+     * @private
+     */
+    function cancelMouseFlush() {
+
+        if (mouseFlushHandle === null)
+            return;
+
+        if (mouseFlushAnimated)
+            window.cancelAnimationFrame(mouseFlushHandle);
+        else
+            window.clearTimeout(mouseFlushHandle);
+
+        mouseFlushHandle = null;
+
+    }
+
+    /**
+     * Immediately sends the pending motion-only mouse event, if any,
+     * cancelling any scheduled send of that event.
+     *
+     * @private
+     */
+    function flushMouseMotion() {
+
+        cancelMouseFlush();
+
+        var motion = pendingMouseMotion;
+        if (!motion)
+            return;
+
+        pendingMouseMotion = null;
+        if (isConnected())
+            sendMouseEvent(motion.x, motion.y, motion.buttonMask);
+
+    }
+
+    /**
+     * Schedules the pending motion-only mouse event to be sent in
+     * accordance with mouseMotionRate, sending that event immediately if
+     * the rate allows.
+     *
+     * @private
+     */
+    function scheduleMouseFlush() {
+
+        if (mouseFlushHandle !== null)
+            return;
+
+        var rate = guac_client.mouseMotionRate;
+
+        // Send at most once per animation frame by default
+        if (!rate && window.requestAnimationFrame) {
+            mouseFlushAnimated = true;
+            mouseFlushHandle = window.requestAnimationFrame(flushMouseMotion);
+            return;
+        }
+
+        // Otherwise, send at most at the given rate (assuming 60 Hz if
+        // animation frames are unavailable)
+        var delay = lastMouseTimestamp + 1000 / (rate || 60) - Date.now();
+        if (delay <= 0) {
+            flushMouseMotion();
+            return;
+        }
+
+        mouseFlushAnimated = false;
+        mouseFlushHandle = window.setTimeout(flushMouseMotion, delay);
+
+    }
+
     /**
      * Produces an opaque representation of Guacamole.Client state which can be
      * later imported through a call to importState(). This object is
@@ -143,8 +307,15 @@ Guacamole.Client = function(tunnel) {
      *     state object will be passed to the callback as the sole parameter.
      *     This callback may be invoked immediately, or later as the display
      *     finishes rendering and becomes ready.
+     *
+     * @param {Boolean} [imageBitmaps=false]
+     *     Whether the image data of each layer should be stored as an
+     *     ImageBitmap, if supported by the browser, rather than as a PNG data
+     *     URL. Such state objects are far cheaper to produce and import, but
+     *     cannot be serialized, and should be released with releaseState()
+     *     once no longer needed.
      */
-    this.exportState = function exportState(callback) {
+    this.exportState = function exportState(callback, imageBitmaps) {
 
         // Start with empty state
         var state = {
@@ -163,40 +334,75 @@ Guacamole.Client = function(tunnel) {
         // Populate layers once data is available (display state, requires flush)
         display.flush(function populateLayers() {
 
-            // Export each defined layer/buffer
-            for (var key in layersSnapshot) {
+            // The number of layers/buffers not yet exported, plus one until
+            // all exports have been started
+            var remaining = 1;
 
-                var index = parseInt(key);
-                var layer = layersSnapshot[key];
-                var canvas = layer.toCanvas();
+            // Invoke callback once the state is ready
+            var layerExported = function layerExported() {
+                if (--remaining === 0)
+                    callback(state);
+            };
 
-                // Store layer/buffer dimensions
-                var exportLayer = {
-                    'width'  : layer.width,
-                    'height' : layer.height
-                };
+            // Exports the given layer/buffer once its image data is available
+            var exportLayerState = function exportLayerState(key, layer) {
 
-                // Store layer/buffer image data, if it can be generated
-                if (layer.width && layer.height)
+                var index = parseInt(key);
+                remaining++;
+
+                display.toCanvas(layer, function layerImageAvailable(canvas) {
+
+                    // Store layer/buffer dimensions
+                    var exportLayer = {
+                        'width'  : canvas.width,
+                        'height' : canvas.height
+                    };
+
+                    // Add layer properties if not a buffer nor the default layer
+                    if (index > 0) {
+                        exportLayer.x = layer.x;
+                        exportLayer.y = layer.y;
+                        exportLayer.z = layer.z;
+                        exportLayer.alpha = layer.alpha;
+                        exportLayer.matrix = layer.matrix;
+                        exportLayer.parent = getLayerIndex(layer.parent);
+                    }
+
+                    // Store exported layer
+                    state.layers[key] = exportLayer;
+
+                    // Layer/buffer image data cannot be generated if empty
+                    if (!canvas.width || !canvas.height) {
+                        layerExported();
+                        return;
+                    }
+
+                    // Store image data as an ImageBitmap if requested and
+                    // possible, avoiding PNG encoding entirely
+                    if (imageBitmaps && window.createImageBitmap) {
+                        window.createImageBitmap(canvas).then(function bitmapCreated(bitmap) {
+                            exportLayer.bitmap = bitmap;
+                            layerExported();
+                        }, function bitmapFailed() {
+                            exportLayer.url = canvas.toDataURL('image/png');
+                            layerExported();
+                        });
+                        return;
+                    }
+
+                    // Otherwise, store image data as a PNG
                     exportLayer.url = canvas.toDataURL('image/png');
+                    layerExported();
 
-                // Add layer properties if not a buffer nor the default layer
-                if (index > 0) {
-                    exportLayer.x = layer.x;
-                    exportLayer.y = layer.y;
-                    exportLayer.z = layer.z;
-                    exportLayer.alpha = layer.alpha;
-                    exportLayer.matrix = layer.matrix;
-                    exportLayer.parent = getLayerIndex(layer.parent);
-                }
+                });
 
-                // Store exported layer
-                state.layers[key] = exportLayer;
+            };
 
-            }
+            // Export each defined layer/buffer
+            for (var key in layersSnapshot)
+                exportLayerState(key, layersSnapshot[key]);
 
-            // Invoke callback now that the state is ready
-            callback(state);
+            layerExported();
 
         });
 
@@ -244,8 +450,14 @@ Guacamole.Client = function(tunnel) {
             // Reset layer size
             display.resize(layer, importLayer.width, importLayer.height);
 
-            // Initialize new layer if it has associated data
-            if (importLayer.url) {
+            // Initialize new layer if it has associated data, drawing
+            // ImageBitmaps directly as they need not be decoded
+            if (importLayer.bitmap) {
+                display.setChannelMask(layer, Guacamole.Layer.SRC);
+                display.drawImage(layer, 0, 0, importLayer.bitmap);
+            }
+
+            else if (importLayer.url) {
                 display.setChannelMask(layer, Guacamole.Layer.SRC);
                 display.draw(layer, 0, 0, importLayer.url);
             }
@@ -275,6 +487,23 @@ Guacamole.Client = function(tunnel) {
 
     };
 
+    /**
+     * Releases any resources held by the given opaque object from a prior
+     * call to exportState(), such as the ImageBitmaps created if requested.
+     * The object must not be imported after it has been released.
+     *
+     * @param {Object} state
+     *     An opaque representation of Guacamole.Client state from a prior call
+     *     to exportState().
+     */
+    this.releaseState = function releaseState(state) {
+        for (var key in state.layers) {
+            var bitmap = state.layers[key].bitmap;
+            if (bitmap)
+                bitmap.close();
+        }
+    };
+
     /**
      * Returns the underlying display of this Guacamole.Client. The display
      * contains an Element which can be added to the DOM, causing the
@@ -300,6 +529,7 @@ Guacamole.Client = function(tunnel) {
             return;
 
         tunnel.sendMessage("size", width, height);
+        sentPriorityMessage();
 
     };
 
@@ -316,12 +546,59 @@ Guacamole.Client = function(tunnel) {
         if (!isConnected())
             return;
 
+        // Preserve order relative to any pending mouse motion
+        flushMouseMotion();
+
         tunnel.sendMessage("key", keysym, pressed);
     };
 
+    /**
+     * The maximum number of motion-only mouse events to send per second.
+     * Mouse events which change the state of any button are always sent
+     * immediately, but mouse events which only move the pointer are
+     * coalesced such that only the most recent position is sent once this
+     * rate allows. If zero, motion is sent at most once per animation frame.
+     * If Infinity, motion is never coalesced.
+     *
+     * @type {Number}
+     * @default 0
+     */
+    this.mouseMotionRate = 0;
+
+    /**
+     * Whether the "size", "sync", and "ack" messages should be sent
+     * immediately, rather than batched by the tunnel together with any other
+     * messages sent within the same task. These messages govern how quickly
+     * the server may continue sending data, and flushing them early avoids
+     * delaying the server while the remainder of a large batch of received
+     * instructions is handled.
+     *
+     * @type {Boolean}
+     * @default true
+     */
+    this.flushPriorityMessages = true;
+
+    /**
+     * The total number of mouse events sent to the server.
+     *
+     * @type {Number}
+     */
+    this.sentMouseStates = 0;
+
+    /**
+     * The total number of motion-only mouse events which were not sent to
+     * the server, having been superseded by a later mouse event before they
+     * could be sent.
+     *
+     * @type {Number}
+     */
+    this.droppedMouseStates = 0;
+
     /**
      * Sends a mouse event having the properties provided by the given mouse
-     * state.
+     * state. Mouse events which change the state of any button are sent
+     * immediately, while events which only move the pointer are coalesced
+     * in accordance with mouseMotionRate.
      * 
      * @param {Guacamole.Mouse.State} mouseState
      *     The state of the mouse to send in the mouse event.
@@ -360,8 +637,27 @@ Guacamole.Client = function(tunnel) {
         if (mouseState.up)     buttonMask |= 8;
         if (mouseState.down)   buttonMask |= 16;
 
-        // Send message
-        tunnel.sendMessage("mouse", Math.floor(x), Math.floor(y), buttonMask);
+        // Any pending motion is superseded by this event
+        if (pendingMouseMotion)
+            guac_client.droppedMouseStates++;
+
+        // Send button changes immediately, preserving their exact position
+        if (buttonMask !== lastButtonMask) {
+            pendingMouseMotion = null;
+            cancelMouseFlush();
+            sendMouseEvent(Math.floor(x), Math.floor(y), buttonMask);
+            return;
+        }
+
+        // Coalesce motion, sending only the most recent position
+        pendingMouseMotion = {
+            'x'          : Math.floor(x),
+            'y'          : Math.floor(y),
+            'buttonMask' : buttonMask
+        };
+
+        scheduleMouseFlush();
+
     };
 
     /**
@@ -382,6 +678,9 @@ Guacamole.Client = function(tunnel) {
         if (!isConnected())
             return;
 
+        // Preserve order relative to any pending mouse motion
+        flushMouseMotion();
+
         var x = touchState.x;
         var y = touchState.y;
 
@@ -584,6 +883,7 @@ Guacamole.Client = function(tunnel) {
             return;
 
         tunnel.sendMessage("ack", index, message, code);
+        sentPriorityMessage();
     };
 
     /**
@@ -1161,9 +1461,12 @@ Guacamole.Client = function(tunnel) {
 
             }
 
-            // If buffer, just delete reference
-            else if (layer_index < 0)
+            // If buffer, release any resources held by the display and
+            // delete reference
+            else if (layer_index < 0 && layers[layer_index]) {
+                display.dispose(layers[layer_index]);
                 delete layers[layer_index];
+            }
 
             // Attempting to dispose the root layer currently has no effect.
 
@@ -1495,6 +1798,7 @@ Guacamole.Client = function(tunnel) {
                 // Send sync response to server
                 if (timestamp !== currentTimestamp) {
                     tunnel.sendMessage("sync", timestamp);
+                    sentPriorityMessage();
                     currentTimestamp = timestamp;
                 }
 
@@ -1616,6 +1920,10 @@ Guacamole.Client = function(tunnel) {
             if (pingInterval)
                 window.clearInterval(pingInterval);
 
+            // Discard any pending mouse motion
+            cancelMouseFlush();
+            pendingMouseMotion = null;
+
             // Send disconnect message and disconnect
             tunnel.sendMessage("disconnect");
             tunnel.disconnect();
@@ -1770,3 +2078,168 @@ Guacamole.Client.DefaultTransferFunction = {
     }
 
 };
+
+/**
+ * Creates a new map of all Guacamole binary raster operations to transfer
+ * kernels, as stored within {@link Guacamole.Client.DefaultTransferKernel}.
+ * This function references nothing outside its own body, such that its source
+ * may be used to create identical kernels within a Web Worker.
+ *
+ * @private
+ * @returns {Object.<Number, function>}
+ *     A new map of all Guacamole binary raster operations to their
+ *     corresponding transfer kernels.
+ */
+Guacamole.Client.createTransferKernels = function createTransferKernels() {
+
+    /**
+     * Mask which selects only the alpha component of a 32-bit RGBA pixel,
+     * taking into account the byte order of the current platform.
+     *
+     * @private
+     * @type {Number}
+     */
+    var A = new Uint32Array(new Uint8Array([0x00, 0x00, 0x00, 0xFF]).buffer)[0];
+
+    /**
+     * Mask which selects only the color (red, green, and blue) components of
+     * a 32-bit RGBA pixel.
+     *
+     * @private
+     * @type {Number}
+     */
+    var C = ~A;
+
+    return {
+
+        /* BLACK */
+        0x0: function (src, dst, length) {
+            for (var i = 0; i < length; i++)
+                dst[i] = dst[i] & A;
+        },
+
+        /* WHITE */
+        0xF: function (src, dst, length) {
+            for (var i = 0; i < length; i++)
+                dst[i] = dst[i] | C;
+        },
+
+        /* SRC */
+        0x3: function (src, dst, length) {
+            dst.set(src.subarray(0, length));
+        },
+
+        /* DEST (no-op) */
+        0x5: function (src, dst, length) {
+            // Do nothing
+        },
+
+        /* Invert SRC */
+        0xC: function (src, dst, length) {
+            for (var i = 0; i < length; i++)
+                dst[i] = src[i] ^ C;
+        },
+
+        /* Invert DEST */
+        0xA: function (src, dst, length) {
+            for (var i = 0; i < length; i++)
+                dst[i] = dst[i] ^ C;
+        },
+
+        /* AND */
+        0x1: function (src, dst, length) {
+            for (var i = 0; i < length; i++)
+                dst[i] = dst[i] & (src[i] | A);
+        },
+
+        /* NAND */
+        0xE: function (src, dst, length) {
+            for (var i = 0; i < length; i++) {
+                var d = dst[i];
+                dst[i] = (~(src[i] & d) & C) | (d & A);
+            }
+        },
+
+        /* OR */
+        0x7: function (src, dst, length) {
+            for (var i = 0; i < length; i++)
+                dst[i] = dst[i] | (src[i] & C);
+        },
+
+        /* NOR */
+        0x8: function (src, dst, length) {
+            for (var i = 0; i < length; i++) {
+                var d = dst[i];
+                dst[i] = (~(src[i] | d) & C) | (d & A);
+            }
+        },
+
+        /* XOR */
+        0x6: function (src, dst, length) {
+            for (var i = 0; i < length; i++)
+                dst[i] = dst[i] ^ (src[i] & C);
+        },
+
+        /* XNOR */
+        0x9: function (src, dst, length) {
+            for (var i = 0; i < length; i++)
+                dst[i] = dst[i] ^ (~src[i] & C);
+        },
+
+        /* AND inverted source */
+        0x4: function (src, dst, length) {
+            for (var i = 0; i < length; i++)
+                dst[i] = dst[i] & (~src[i] | A);
+        },
+
+        /* OR inverted source */
+        0xD: function (src, dst, length) {
+            for (var i = 0; i < length; i++)
+                dst[i] = dst[i] | (~src[i] & C);
+        },
+
+        /* AND inverted destination */
+        0x2: function (src, dst, length) {
+            for (var i = 0; i < length; i++) {
+                var d = dst[i];
+                dst[i] = (src[i] & ~d & C) | (d & A);
+            }
+        },
+
+        /* OR inverted destination */
+        0xB: function (src, dst, length) {
+            for (var i = 0; i < length; i++) {
+                var d = dst[i];
+                dst[i] = ((src[i] | ~d) & C) | (d & A);
+            }
+        }
+
+    };
+
+};
+
+/**
+ * Map of all Guacamole binary raster operations to transfer kernels. Each
+ * kernel applies the same operation as the corresponding function within
+ * {@link Guacamole.Client.DefaultTransferFunction}, but to every pixel of an
+ * image at once, operating directly on 32-bit views of the source and
+ * destination pixel data. As binary raster operations are bitwise, the
+ * order of the color components within each 32-bit pixel does not matter,
+ * with the exception of the alpha component, which is located using a mask
+ * determined at runtime to account for platform byte order.
+ *
+ * Each kernel is also exposed as the "kernel" property of the corresponding
+ * transfer function, allowing {@link Guacamole.Layer#transfer} to use the
+ * kernel in place of the per-pixel function.
+ *
+ * @private
+ * @type {Object.<Number, function>}
+ */
+Guacamole.Client.DefaultTransferKernel = Guacamole.Client.createTransferKernels();
+
+// Expose each transfer kernel via its corresponding transfer function
+(function attachTransferKernels() {
+    for (var index in Guacamole.Client.DefaultTransferKernel)
+        Guacamole.Client.DefaultTransferFunction[index].kernel =
+                Guacamole.Client.DefaultTransferKernel[index];
+})();
@@ -54,8 +54,34 @@ Guacamole.Display = function() {
     display.style.msTransformOrigin =
         "0 0";
 
+    /**
+     * The renderer performing all drawing operations within a Web Worker, or
+     * null if drawing operations are performed on the main thread.
+     *
+     * @private
+     * @type {Guacamole.OffscreenRenderer}
+     */
+    var renderer = null;
+
+    // Render within a Web Worker only if explicitly enabled
+    if (Guacamole.OffscreenRenderer.enabled && Guacamole.OffscreenRenderer.isSupported()) {
+        try {
+            renderer = new Guacamole.OffscreenRenderer();
+            renderer.onerror = function rendererFailed(message) {
+                if (guac_display.onerror)
+                    guac_display.onerror(message);
+            };
+        }
+
+        // Worker creation may be prohibited (by a Content-Security-Policy,
+        // for example), in which case rendering remains on the main thread
+        catch (e) {
+            renderer = null;
+        }
+    }
+
     // Create default layer
-    var default_layer = new Guacamole.Display.VisibleLayer(displayWidth, displayHeight);
+    var default_layer = new Guacamole.Display.VisibleLayer(displayWidth, displayHeight, renderer);
 
     // Create cursor layer
     var cursor = new Guacamole.Display.VisibleLayer(0, 0);
@@ -153,11 +179,88 @@ Guacamole.Display = function() {
     var frames = [];
 
     /**
-     * Flushes all pending frames.
+     * Fired once each time pending frames are rendered. When supported by the
+     * browser, ready frames are rendered together once per animation frame,
+     * such that several frames received between display refreshes are
+     * painted only once.
+     *
+     * @event
+     * @param {Number} frames The number of frames rendered.
+     * @param {Number} duration The number of milliseconds spent executing the
+     *                          tasks of those frames.
+     */
+    this.onrender = null;
+
+    /**
+     * Fired if the display can no longer draw, such as if the Web Worker
+     * performing drawing operations fails. Once fired, the contents of the
+     * display will no longer change.
+     *
+     * @event
+     * @param {String} message A human-readable description of the failure.
+     */
+    this.onerror = null;
+
+    /**
+     * The maximum number of milliseconds to wait for an animation frame
+     * before rendering pending frames regardless. Animation frames are not
+     * delivered at all while the display is hidden (within a background tab,
+     * for example), yet frames must still be rendered for their callbacks to
+     * be invoked.
+     *
      * @private
+     * @constant
+     * @type {Number}
      */
-    function __flush_frames() {
+    var RENDER_TIMEOUT = 250;
+
+    /**
+     * The ID of the animation frame request for the next render of pending
+     * frames, or null if no render is currently scheduled.
+     *
+     * @private
+     * @type {Number}
+     */
+    var renderRequest = null;
+
+    /**
+     * The ID of the timeout which will render pending frames if no animation
+     * frame is delivered in time, or null if no render is currently scheduled.
+     *
+     * @private
+     * @type {Number}
+     */
+    var renderTimeout = null;
+
+    /**
+     * Returns the current time in milliseconds, using the high-resolution
+     * clock if available.
+     *
+     * @private
+     * @returns {Number} The current time, in milliseconds.
+     */
+    var now = (typeof performance !== 'undefined' && performance.now)
+        ? function now() { return performance.now(); }
+        : function now() { return new Date().getTime(); };
+
+    /**
+     * Renders all pending frames which are ready, cancelling any scheduled
+     * render.
+     * @private
+     */
+    function __render_frames() {
+
+        if (renderRequest !== null) {
+            window.cancelAnimationFrame(renderRequest);
+            renderRequest = null;
+        }
 
+        if (renderTimeout !== null) {
+            window.clearTimeout(renderTimeout);
+            renderTimeout = null;
+        }
+
+        var start = now();
         var rendered_frames = 0;
 
         // Draw all pending frames, if ready
@@ -175,8 +278,427 @@ Guacamole.Display = function() {
         // Remove rendered frames from array
         frames.splice(0, rendered_frames);
 
+        if (rendered_frames && guac_display.onrender)
+            guac_display.onrender(rendered_frames, now() - start);
+
+    }
+
+    /**
+     * Flushes all pending frames. If supported by the browser, rendering is
+     * deferred until the next animation frame, such that all frames which
+     * become ready before then are rendered together.
+     * @private
+     */
+    function __flush_frames() {
+
+        // Render immediately if animation frames are unsupported
+        if (!window.requestAnimationFrame) {
+            __render_frames();
+            return;
+        }
+
+        // Render is already scheduled
+        if (renderRequest !== null)
+            return;
+
+        renderRequest = window.requestAnimationFrame(__render_frames);
+        renderTimeout = window.setTimeout(__render_frames, RENDER_TIMEOUT);
+
     }
 
+    /**
+     * Canvas containing the entire display, with all child layers
+     * composited within, as of the last update of the composite. Only the
+     * damaged portions of this canvas are redrawn when it is updated.
+     *
+     * @private
+     * @type {HTMLCanvasElement}
+     */
+    var composite = document.createElement("canvas");
+
+    /**
+     * The bounding rectangle of all portions of the display which have
+     * changed since the composite was last updated, as an object containing
+     * the left, top, right and bottom edges ("x1", "y1", "x2" and "y2"),
+     * or null if nothing has changed.
+     *
+     * @private
+     * @type {Object}
+     */
+    var damaged = null;
+
+    /**
+     * The number of times the contents of the display have changed.
+     *
+     * @private
+     * @type {Number}
+     */
+    var revision = 0;
+
+    /**
+     * The number of updates of the composite which are waiting for layer
+     * contents to be read from the worker.
+     *
+     * @private
+     * @type {Number}
+     */
+    var pendingCompositeUpdates = 0;
+
+    /**
+     * Callbacks awaiting the completion of all pending updates of the
+     * composite.
+     *
+     * @private
+     * @type {function[]}
+     */
+    var compositeCallbacks = [];
+
+    /**
+     * Marks the given rectangle of the display as changed.
+     *
+     * @private
+     * @param {Number} x The X coordinate of the upper-left corner.
+     * @param {Number} y The Y coordinate of the upper-left corner.
+     * @param {Number} width The width of the rectangle.
+     * @param {Number} height The height of the rectangle.
+     */
+    var damage = function damage(x, y, width, height) {
+
+        revision++;
+
+        if (!damaged) {
+            damaged = { 'x1' : x, 'y1' : y, 'x2' : x + width, 'y2' : y + height };
+            return;
+        }
+
+        damaged.x1 = Math.min(damaged.x1, x);
+        damaged.y1 = Math.min(damaged.y1, y);
+        damaged.x2 = Math.max(damaged.x2, x + width);
+        damaged.y2 = Math.max(damaged.y2, y + height);
+
+    };
+
+    /**
+     * Returns the location of the given layer within the display, or null
+     * if the layer is not part of the display (a buffer, for example).
+     *
+     * @private
+     * @param {Guacamole.Display.VisibleLayer|Guacamole.Layer} layer
+     *     The layer to locate.
+     *
+     * @returns {Object}
+     *     An object containing the X and Y coordinates of the upper-left
+     *     corner of the layer within the display ("x" and "y"), or null if
+     *     the layer is not part of the display.
+     */
+    var getDisplayOffset = function getDisplayOffset(layer) {
+
+        var x = 0;
+        var y = 0;
+
+        while (layer !== default_layer) {
+
+            if (!layer.parent)
+                return null;
+
+            x += layer.x;
+            y += layer.y;
+            layer = layer.parent;
+
+        }
+
+        return { 'x' : x, 'y' : y };
+
+    };
+
+    /**
+     * All channel masks whose composite operations affect the destination
+     * outside the area being drawn, clearing the remainder of the layer.
+     *
+     * @private
+     * @type {Object.<Number, Boolean>}
+     */
+    var unboundedMasks = {};
+    unboundedMasks[Guacamole.Layer.RIN]   = true;
+    unboundedMasks[Guacamole.Layer.IN]    = true;
+    unboundedMasks[Guacamole.Layer.OUT]   = true;
+    unboundedMasks[Guacamole.Layer.RATOP] = true;
+    unboundedMasks[Guacamole.Layer.SRC]   = true;
+
+    /**
+     * Marks the given rectangle of the given layer as changed. If no
+     * rectangle is given, if the layer has been transformed such that the
+     * affected area cannot be determined, or if the current channel mask of
+     * the layer affects the layer outside the area drawn, the entire layer is
+     * marked as changed. Changes to layers which are not part of the display
+     * have no effect.
+     *
+     * @private
+     * @param {Guacamole.Display.VisibleLayer|Guacamole.Layer} layer
+     *     The layer which changed.
+     *
+     * @param {Number} [x] The X coordinate of the upper-left corner.
+     * @param {Number} [y] The Y coordinate of the upper-left corner.
+     * @param {Number} [width] The width of the rectangle.
+     * @param {Number} [height] The height of the rectangle.
+     */
+    var damageLayer = function damageLayer(layer, x, y, width, height) {
+
+        var offset = getDisplayOffset(layer);
+        if (!offset)
+            return;
+
+        if (x === undefined || layer.__transformed || layer.__unbounded) {
+            x = y = 0;
+            width = layer.width;
+            height = layer.height;
+        }
+
+        damage(offset.x + x, offset.y + y, width, height);
+
+    };
+
+    /**
+     * Marks the entire display as changed if the given layer is part of the
+     * display. This must be used for changes which may affect the layer's
+     * children, or the location of the layer itself.
+     *
+     * @private
+     * @param {Guacamole.Display.VisibleLayer|Guacamole.Layer} layer
+     *     The layer which changed.
+     */
+    var damageTree = function damageTree(layer) {
+        if (getDisplayOffset(layer))
+            damage(0, 0, displayWidth, displayHeight);
+    };
+
+    /**
+     * Invokes the given function for the given layer and each of its
+     * descendants, in the order they are drawn, stopping at any layer having
+     * no area. Descendants are visited while the given function is being
+     * invoked for their parent, such that the parent may wrap their drawing.
+     *
+     * @private
+     * @param {Guacamole.Display.VisibleLayer} layer
+     *     The layer to visit.
+     *
+     * @param {Number} x
+     *     The X coordinate of the layer within the display.
+     *
+     * @param {Number} y
+     *     The Y coordinate of the layer within the display.
+     *
+     * @param {function} visit
+     *     The function to invoke for each layer, receiving that layer, its
+     *     coordinates within the display, and a function which visits its
+     *     children.
+     */
+    var visitLayers = function visitLayers(layer, x, y, visit) {
+
+        if (layer.width <= 0 || layer.height <= 0)
+            return;
+
+        visit(layer, x, y, function visitChildren() {
+
+            // Build array of children
+            var children = [];
+            for (var index in layer.children)
+                children.push(layer.children[index]);
+
+            // Sort
+            children.sort(function children_comparator(a, b) {
+
+                // Compare based on Z order
+                var diff = a.z - b.z;
+                if (diff !== 0)
+                    return diff;
+
+                // If Z order identical, use document order
+                var a_element = a.getElement();
+                var b_element = b.getElement();
+                var position = b_element.compareDocumentPosition(a_element);
+
+                if (position & Node.DOCUMENT_POSITION_PRECEDING) return -1;
+                if (position & Node.DOCUMENT_POSITION_FOLLOWING) return  1;
+
+                // Otherwise, assume same
+                return 0;
+
+            });
+
+            for (var i = 0; i < children.length; i++) {
+                var child = children[i];
+                visitLayers(child, x + child.x, y + child.y, visit);
+            }
+
+        });
+
+    };
+
+    /**
+     * Brings the composite up to date with the current contents of the
+     * display, redrawing only the damaged portion. If drawing operations are
+     * performed within a Web Worker, only the damaged portion of each layer
+     * is read from the worker, and the composite is updated asynchronously.
+     *
+     * @private
+     * @param {function} callback
+     *     The function to invoke with the updated composite as its sole
+     *     parameter. This function will be invoked immediately unless
+     *     drawing operations are performed within a Web Worker.
+     */
+    var updateComposite = function updateComposite(callback) {
+
+        // Resizing the composite clears it, requiring a full redraw
+        if (composite.width !== displayWidth || composite.height !== displayHeight) {
+            composite.width = displayWidth;
+            composite.height = displayHeight;
+            damage(0, 0, displayWidth, displayHeight);
+        }
+
+        // Redraw only the damaged portion of the display
+        var region = damaged;
+        damaged = null;
+
+        if (region) {
+            region = {
+                'x1' : Math.max(0, region.x1),
+                'y1' : Math.max(0, region.y1),
+                'x2' : Math.min(displayWidth, region.x2),
+                'y2' : Math.min(displayHeight, region.y2)
+            };
+        }
+
+        // If nothing has changed, the composite is already up to date once
+        // all pending updates complete
+        if (!region || region.x1 >= region.x2 || region.y1 >= region.y2) {
+            if (pendingCompositeUpdates)
+                compositeCallbacks.push(callback);
+            else
+                callback(composite);
+            return;
+        }
+
+        // Returns the intersection of the damaged region with the given
+        // layer, or null if there is no intersection
+        var clip = function clip(layer, x, y) {
+
+            var x1 = Math.max(region.x1, x);
+            var y1 = Math.max(region.y1, y);
+            var x2 = Math.min(region.x2, x + layer.width);
+            var y2 = Math.min(region.y2, y + layer.height);
+
+            if (x1 >= x2 || y1 >= y2)
+                return null;
+
+            return { 'x' : x1, 'y' : y1, 'width' : x2 - x1, 'height' : y2 - y1 };
+
+        };
+
+        // Images of the damaged portion of each layer read from the worker,
+        // if any, stored by the unique ID of each layer
+        var images = {};
+
+        var draw = function draw() {
+
+            var context = composite.getContext("2d");
+            context.save();
+
+            // Restrict drawing to the damaged region
+            context.beginPath();
+            context.rect(region.x1, region.y1, region.x2 - region.x1, region.y2 - region.y1);
+            context.clip();
+            context.clearRect(region.x1, region.y1, region.x2 - region.x1, region.y2 - region.y1);
+
+            visitLayers(default_layer, 0, 0, function drawLayer(layer, x, y, drawChildren) {
+
+                // Save and update alpha
+                var initial_alpha = context.globalAlpha;
+                context.globalAlpha *= layer.alpha / 255.0;
+
+                // Copy only the damaged portion of the layer
+                var rect = clip(layer, x, y);
+                if (rect) {
+
+                    if (renderer) {
+                        if (images[layer.__unique_id])
+                            context.drawImage(images[layer.__unique_id], rect.x, rect.y);
+                    }
+
+                    else
+                        context.drawImage(layer.getCanvas(),
+                            rect.x - x, rect.y - y, rect.width, rect.height,
+                            rect.x, rect.y, rect.width, rect.height);
+
+                }
+
+                // Draw all children
+                drawChildren();
+
+                // Restore alpha
+                context.globalAlpha = initial_alpha;
+
+            });
+
+            context.restore();
+
+        };
+
+        // Draw immediately if rendered on the main thread
+        if (!renderer) {
+            draw();
+            callback(composite);
+            return;
+        }
+
+        // Otherwise, read the damaged portion of all layers from the worker
+        // before drawing
+        var remaining = 1;
+        pendingCompositeUpdates++;
+
+        var layerRead = function layerRead() {
+
+            if (--remaining !== 0)
+                return;
+
+            draw();
+
+            // Free all images read from the worker
+            for (var id in images)
+                images[id].close();
+
+            callback(composite);
+
+            // Notify any callbacks which were waiting for this update
+            if (--pendingCompositeUpdates === 0) {
+                var callbacks = compositeCallbacks;
+                compositeCallbacks = [];
+                for (var i = 0; i < callbacks.length; i++)
+                    callbacks[i](composite);
+            }
+
+        };
+
+        visitLayers(default_layer, 0, 0, function readLayer(layer, x, y, readChildren) {
+
+            var rect = clip(layer, x, y);
+            if (rect) {
+                remaining++;
+                renderer.read(layer, function imageRead(bitmap) {
+                    if (bitmap)
+                        images[layer.__unique_id] = bitmap;
+                    layerRead();
+                }, rect.x - x, rect.y - y, rect.width, rect.height);
+            }
+
+            readChildren();
+
+        });
+
+        layerRead();
+
+    };
+
     /**
      * An ordered list of tasks which must be executed atomically. Once
      * executed, an associated (and optional) callback will be called.
@@ -349,22 +871,30 @@ Guacamole.Display = function() {
      * @return {!Guacamole.Display.VisibleLayer} The newly-created layer.
      */
     this.createLayer = function() {
-        var layer = new Guacamole.Display.VisibleLayer(displayWidth, displayHeight);
+        var layer = new Guacamole.Display.VisibleLayer(displayWidth, displayHeight, renderer);
         layer.move(default_layer, 0, 0, 0);
         return layer;
     };
 
     /**
      * Creates a new buffer. Buffers are invisible, off-screen surfaces. They
-     * are implemented in the same manner as layers, but do not provide the
-     * same nesting semantics.
+     * provide the same drawing operations as layers, but do not provide the
+     * same nesting semantics. If {@link Guacamole.TiledLayer.enabled} is set,
+     * buffers are stored as tiles which are allocated only when drawn to.
      * 
-     * @return {!Guacamole.Layer} The newly-created buffer.
+     * @return {!(Guacamole.Layer|Guacamole.TiledLayer)} The newly-created buffer.
      */
     this.createBuffer = function() {
-        var buffer = new Guacamole.Layer(0, 0);
+
+        var tiled = Guacamole.TiledLayer.enabled;
+
+        var buffer = renderer
+            ? new Guacamole.OffscreenRenderer.Layer(renderer, 0, 0, false, tiled)
+            : tiled ? new Guacamole.TiledLayer(0, 0) : new Guacamole.Layer(0, 0);
+
         buffer.autosize = 1;
         return buffer;
+
     };
 
     /**
@@ -373,8 +903,9 @@ Guacamole.Display = function() {
      * unblocked.
      * 
      * @param {function} callback The function to call when this frame is
-     *                            flushed. This may happen immediately, or
-     *                            later when blocked tasks become unblocked.
+     *                            flushed. This may happen at the next
+     *                            animation frame, or later when blocked tasks
+     *                            become unblocked.
      */
     this.flush = function(callback) {
 
@@ -410,24 +941,78 @@ Guacamole.Display = function() {
     this.setCursor = function(hotspotX, hotspotY, layer, srcx, srcy, srcw, srch) {
         scheduleTask(function __display_set_cursor() {
 
-            // Set hotspot
-            guac_display.cursorHotspotX = hotspotX;
-            guac_display.cursorHotspotY = hotspotY;
+            // The cursor layer is always rendered on the main thread, thus
+            // the cursor image must first be read from the worker, if any
+            if (renderer) {
+
+                var request = ++cursorRequest;
+                renderer.read(layer, function cursorImageRead(bitmap) {
+
+                    // Ignore cursor images which have since been replaced
+                    if (request === cursorRequest) {
+                        updateCursor(hotspotX, hotspotY, srcw, srch, function drawCursorImage() {
+                            if (bitmap)
+                                cursor.drawImage(0, 0, bitmap);
+                        });
+                    }
 
-            // Reset cursor size
-            cursor.resize(srcw, srch);
+                    if (bitmap)
+                        bitmap.close();
 
-            // Draw cursor to cursor layer
-            cursor.copy(layer, srcx, srcy, srcw, srch, 0, 0);
-            guac_display.moveCursor(guac_display.cursorX, guac_display.cursorY);
+                }, srcx, srcy, srcw, srch);
 
-            // Fire cursor change event
-            if (guac_display.oncursor)
-                guac_display.oncursor(cursor.toCanvas(), hotspotX, hotspotY);
+            }
+
+            // Otherwise, draw cursor directly from source layer
+            else {
+                updateCursor(hotspotX, hotspotY, srcw, srch, function copyCursorImage() {
+                    cursor.copy(layer, srcx, srcy, srcw, srch, 0, 0);
+                });
+            }
 
         });
     };
 
+    /**
+     * The number of cursor images requested from the worker thus far. Cursor
+     * images which arrive after a later cursor image has been requested are
+     * ignored.
+     *
+     * @private
+     * @type {Number}
+     */
+    var cursorRequest = 0;
+
+    /**
+     * Replaces the image and hotspot of the cursor layer, firing oncursor.
+     *
+     * @private
+     * @param {Number} hotspotX The X coordinate of the cursor hotspot.
+     * @param {Number} hotspotY The Y coordinate of the cursor hotspot.
+     * @param {Number} width The width of the cursor image.
+     * @param {Number} height The height of the cursor image.
+     * @param {function} draw The function to invoke to draw the cursor image
+     *                        onto the resized cursor layer.
+     */
+    var updateCursor = function updateCursor(hotspotX, hotspotY, width, height, draw) {
+
+        // Set hotspot
+        guac_display.cursorHotspotX = hotspotX;
+        guac_display.cursorHotspotY = hotspotY;
+
+        // Reset cursor size
+        cursor.resize(width, height);
+
+        // Draw cursor to cursor layer
+        draw();
+        guac_display.moveCursor(guac_display.cursorX, guac_display.cursorY);
+
+        // Fire cursor change event
+        if (guac_display.oncursor)
+            guac_display.oncursor(cursor.toCanvas(), hotspotX, hotspotY);
+
+    };
+
     /**
      * Sets whether the software-rendered cursor is shown. This cursor differs
      * from the hardware cursor in that it is built into the Guacamole.Display,
@@ -485,6 +1070,7 @@ Guacamole.Display = function() {
         scheduleTask(function __display_resize() {
 
             layer.resize(width, height);
+            damageTree(layer);
 
             // Resize display if default layer is resized
             if (layer === default_layer) {
@@ -522,11 +1108,25 @@ Guacamole.Display = function() {
      *     The destination Y coordinate.
      *
      * @param {CanvasImageSource} image
-     *     The image to draw. Note that this not a URL.
+     *     The image to draw. Note that this not a URL. The image remains
+     *     owned by the caller and may be drawn again later, even if it is an
+     *     ImageBitmap.
      */
     this.drawImage = function(layer, x, y, image) {
         scheduleTask(function __display_drawImage() {
-            layer.drawImage(x, y, image);
+
+            // ImageBitmaps are transferred to the worker renderer, and thus
+            // must be copied if they are to remain usable by the caller
+            if (renderer && image instanceof ImageBitmap) {
+                var copy = new OffscreenCanvas(image.width, image.height);
+                copy.getContext('2d').drawImage(image, 0, 0);
+                layer.drawImage(x, y, copy.transferToImageBitmap());
+            }
+            else
+                layer.drawImage(x, y, image);
+
+            damageLayer(layer, x, y, image.width, image.height);
+
         });
     };
 
@@ -559,6 +1159,7 @@ Guacamole.Display = function() {
             // Draw image once loaded
             task = scheduleTask(function drawImageBitmap() {
                 layer.drawImage(x, y, bitmap);
+                damageLayer(layer, x, y, bitmap.width, bitmap.height);
             }, true);
 
             // Load image from provided blob
@@ -580,8 +1181,10 @@ Guacamole.Display = function() {
             task = scheduleTask(function __display_drawBlob() {
 
                 // Draw the image only if it loaded without errors
-                if (image.width && image.height)
+                if (image.width && image.height) {
                     layer.drawImage(x, y, image);
+                    damageLayer(layer, x, y, image.width, image.height);
+                }
 
                 // Blob URL no longer needed
                 URL.revokeObjectURL(url);
@@ -623,10 +1226,49 @@ Guacamole.Display = function() {
      */
     this.drawStream = function drawStream(layer, x, y, stream, mimetype) {
 
+        var reader;
+
+        // Prefer decoding images entirely off the main thread, within a Web
+        // Worker, if possible
+        if (Guacamole.ImageBitmapReader.isSupported()) {
+
+            var bitmap = null;
+            var task;
+
+            reader = new Guacamole.ImageBitmapReader(stream, mimetype);
+
+            // Reserve the image's place in the task queue once the stream
+            // ends, exactly as would occur for blobs
+            reader.onend = function scheduleImageBitmap() {
+                task = scheduleTask(function __display_drawImageBitmap() {
+                    if (bitmap) {
+
+                        damageLayer(layer, x, y, bitmap.width, bitmap.height);
+                        layer.drawImage(x, y, bitmap);
+
+                        // The worker renderer takes ownership of any
+                        // ImageBitmap drawn, transferring it once the current
+                        // batch of commands is sent, thus the ImageBitmap may
+                        // only be released here if drawn directly
+                        if (!renderer)
+                            bitmap.close();
+
+                    }
+                }, true);
+            };
+
+            // Draw image once decoded
+            reader.onload = function imageBitmapDecoded(decoded) {
+                bitmap = decoded;
+                task.unblock();
+            };
+
+        }
+
         // If createImageBitmap() is available, load the image as a blob so
         // that function can be used
-        if (window.createImageBitmap) {
-            var reader = new Guacamole.BlobReader(stream, mimetype);
+        else if (window.createImageBitmap) {
+            reader = new Guacamole.BlobReader(stream, mimetype);
             reader.onend = function drawImageBlob() {
                 guac_display.drawBlob(layer, x, y, reader.getBlob());
             };
@@ -635,7 +1277,7 @@ Guacamole.Display = function() {
         // Lacking createImageBitmap(), fall back to data URIs and the Image
         // object
         else {
-            var reader = new Guacamole.DataURIReader(stream, mimetype);
+            reader = new Guacamole.DataURIReader(stream, mimetype);
             reader.onend = function drawImageDataURI() {
                 guac_display.draw(layer, x, y, reader.getURI());
             };
@@ -658,8 +1300,10 @@ Guacamole.Display = function() {
         var task = scheduleTask(function __display_draw() {
 
             // Draw the image only if it loaded without errors
-            if (image.width && image.height)
+            if (image.width && image.height) {
                 layer.drawImage(x, y, image);
+                damageLayer(layer, x, y, image.width, image.height);
+            }
 
         }, true);
 
@@ -693,6 +1337,7 @@ Guacamole.Display = function() {
             
             function render_callback() {
                 layer.drawImage(0, 0, video);
+                damageLayer(layer);
                 if (!video.ended)
                     window.setTimeout(render_callback, 20);
             }
@@ -730,6 +1375,7 @@ Guacamole.Display = function() {
     this.transfer = function(srcLayer, srcx, srcy, srcw, srch, dstLayer, x, y, transferFunction) {
         scheduleTask(function __display_transfer() {
             dstLayer.transfer(srcLayer, srcx, srcy, srcw, srch, x, y, transferFunction);
+            damageLayer(dstLayer, x, y, srcw, srch);
         });
     };
 
@@ -755,6 +1401,7 @@ Guacamole.Display = function() {
     this.put = function(srcLayer, srcx, srcy, srcw, srch, dstLayer, x, y) {
         scheduleTask(function __display_put() {
             dstLayer.put(srcLayer, srcx, srcy, srcw, srch, x, y);
+            damageLayer(dstLayer, x, y, srcw, srch);
         });
     };
 
@@ -783,6 +1430,7 @@ Guacamole.Display = function() {
     this.copy = function(srcLayer, srcx, srcy, srcw, srch, dstLayer, x, y) {
         scheduleTask(function __display_copy() {
             dstLayer.copy(srcLayer, srcx, srcy, srcw, srch, x, y);
+            damageLayer(dstLayer, x, y, srcw, srch);
         });
     };
 
@@ -912,6 +1560,7 @@ Guacamole.Display = function() {
     this.strokeColor = function(layer, cap, join, thickness, r, g, b, a) {
         scheduleTask(function __display_strokeColor() {
             layer.strokeColor(cap, join, thickness, r, g, b, a);
+            damageLayer(layer);
         });
     };
 
@@ -930,6 +1579,7 @@ Guacamole.Display = function() {
     this.fillColor = function(layer, r, g, b, a) {
         scheduleTask(function __display_fillColor() {
             layer.fillColor(r, g, b, a);
+            damageLayer(layer);
         });
     };
 
@@ -952,6 +1602,7 @@ Guacamole.Display = function() {
     this.strokeLayer = function(layer, cap, join, thickness, srcLayer) {
         scheduleTask(function __display_strokeLayer() {
             layer.strokeLayer(cap, join, thickness, srcLayer);
+            damageLayer(layer);
         });
     };
 
@@ -969,6 +1620,7 @@ Guacamole.Display = function() {
     this.fillLayer = function(layer, srcLayer) {
         scheduleTask(function __display_fillLayer() {
             layer.fillLayer(srcLayer);
+            damageLayer(layer);
         });
     };
 
@@ -979,7 +1631,14 @@ Guacamole.Display = function() {
      */
     this.push = function(layer) {
         scheduleTask(function __display_push() {
+
             layer.push();
+
+            // Track whether the channel mask restored by pop() is unbounded
+            if (!layer.__unboundedStack)
+                layer.__unboundedStack = [];
+            layer.__unboundedStack.push(!!layer.__unbounded);
+
         });
     };
 
@@ -990,7 +1649,12 @@ Guacamole.Display = function() {
      */
     this.pop = function(layer) {
         scheduleTask(function __display_pop() {
+
             layer.pop();
+
+            if (layer.__unboundedStack && layer.__unboundedStack.length)
+                layer.__unbounded = layer.__unboundedStack.pop();
+
         });
     };
 
@@ -1003,6 +1667,9 @@ Guacamole.Display = function() {
     this.reset = function(layer) {
         scheduleTask(function __display_reset() {
             layer.reset();
+            layer.__transformed = false;
+            layer.__unbounded = false;
+            layer.__unboundedStack = [];
         });
     };
 
@@ -1020,7 +1687,12 @@ Guacamole.Display = function() {
      */
     this.setTransform = function(layer, a, b, c, d, e, f) {
         scheduleTask(function __display_setTransform() {
+
             layer.setTransform(a, b, c, d, e, f);
+
+            // Areas affected by drawing can no longer be determined exactly
+            layer.__transformed = true;
+
         });
     };
 
@@ -1038,7 +1710,12 @@ Guacamole.Display = function() {
      */
     this.transform = function(layer, a, b, c, d, e, f) {
         scheduleTask(function __display_transform() {
+
             layer.transform(a, b, c, d, e, f);
+
+            // Areas affected by drawing can no longer be determined exactly
+            layer.__transformed = true;
+
         });
     };
 
@@ -1057,7 +1734,12 @@ Guacamole.Display = function() {
      */
     this.setChannelMask = function(layer, mask) {
         scheduleTask(function __display_setChannelMask() {
+
             layer.setChannelMask(mask);
+
+            // Operations using this mask affect the entire layer
+            layer.__unbounded = !!unboundedMasks[mask];
+
         });
     };
 
@@ -1079,14 +1761,26 @@ Guacamole.Display = function() {
 
     /**
      * Removes the given layer container entirely, such that it is no longer
-     * contained within its parent layer, if any.
+     * contained within its parent layer, if any. If drawing operations are
+     * performed within a Web Worker, the resources associated with the layer
+     * within that worker are released. Buffers may also be disposed with this
+     * function, releasing any tiles they have allocated.
      *
-     * @param {Guacamole.Display.VisibleLayer} layer
+     * @param {Guacamole.Display.VisibleLayer|Guacamole.TiledLayer} layer
      *     The layer being removed from its parent.
      */
     this.dispose = function dispose(layer) {
         scheduleTask(function disposeLayer() {
-            layer.dispose();
+
+            damageTree(layer);
+
+            if (layer.dispose)
+                layer.dispose();
+
+            // Release the layer's resources within the worker, if any
+            if (layer.free)
+                layer.free();
+
         });
     };
 
@@ -1118,6 +1812,7 @@ Guacamole.Display = function() {
     this.distort = function distort(layer, a, b, c, d, e, f) {
         scheduleTask(function distortLayer() {
             layer.distort(a, b, c, d, e, f);
+            damageTree(layer);
         });
     };
 
@@ -1143,7 +1838,9 @@ Guacamole.Display = function() {
      */
     this.move = function move(layer, parent, x, y, z) {
         scheduleTask(function moveLayer() {
+            damageTree(layer);
             layer.move(parent, x, y, z);
+            damageTree(layer);
         });
     };
 
@@ -1160,6 +1857,7 @@ Guacamole.Display = function() {
     this.shade = function shade(layer, alpha) {
         scheduleTask(function shadeLayer() {
             layer.shade(alpha);
+            damageTree(layer);
         });
     };
 
@@ -1199,88 +1897,165 @@ Guacamole.Display = function() {
     };
 
     /**
-     * Returns a canvas element containing the entire display, with all child
-     * layers composited within.
+     * Provides a new canvas element containing a copy of the given layer, as
+     * would be returned by {@link Guacamole.Layer#toCanvas}. The copy reflects
+     * all drawing operations which have been applied to the layer thus far.
+     * If drawing operations are performed within a Web Worker, the contents
+     * of the layer must first be read from that worker, and the given
+     * callback will be invoked asynchronously. Otherwise, the callback is
+     * invoked immediately.
+     *
+     * @param {Guacamole.Layer} layer
+     *     The layer to copy.
      *
-     * @return {!HTMLCanvasElement} A new canvas element containing a copy of
-     *                             the display.
+     * @param {function} callback
+     *     The function to invoke with the new canvas element as its sole
+     *     parameter.
      */
-    this.flatten = function() {
-       
-        // Get destination canvas
-        var canvas = document.createElement("canvas");
-        canvas.width = default_layer.width;
-        canvas.height = default_layer.height;
+    this.toCanvas = function toCanvas(layer, callback) {
 
-        var context = canvas.getContext("2d");
+        // Read directly from layer if rendered on the main thread
+        if (!renderer) {
+            callback(layer.toCanvas());
+            return;
+        }
 
-        // Returns sorted array of children
-        function get_children(layer) {
+        renderer.read(layer, function layerRead(bitmap, width, height) {
 
-            // Build array of children
-            var children = [];
-            for (var index in layer.children)
-                children.push(layer.children[index]);
+            var canvas = document.createElement('canvas');
+            canvas.width = width;
+            canvas.height = height;
 
-            // Sort
-            children.sort(function children_comparator(a, b) {
+            if (bitmap) {
+                canvas.getContext('2d').drawImage(bitmap, 0, 0);
+                bitmap.close();
+            }
 
-                // Compare based on Z order
-                var diff = a.z - b.z;
-                if (diff !== 0)
-                    return diff;
+            callback(canvas);
 
-                // If Z order identical, use document order
-                var a_element = a.getElement();
-                var b_element = b.getElement();
-                var position = b_element.compareDocumentPosition(a_element);
+        });
 
-                if (position & Node.DOCUMENT_POSITION_PRECEDING) return -1;
-                if (position & Node.DOCUMENT_POSITION_FOLLOWING) return  1;
+    };
 
-                // Otherwise, assume same
-                return 0;
+    /**
+     * Returns a canvas element containing the entire display, with all child
+     * layers composited within. If drawing operations are performed within a
+     * Web Worker, the contents of each layer must first be read from that
+     * worker, and the canvas is available only through the given callback.
+     *
+     * The display maintains its own composite of all layers, redrawing only
+     * the portions which have changed since the composite was last updated.
+     * The canvas provided is a copy of that composite.
+     *
+     * @param {function} [callback]
+     *     The function to invoke with the canvas element containing the
+     *     entire display as its sole parameter. This function will be invoked
+     *     immediately unless drawing operations are performed within a Web
+     *     Worker.
+     *
+     * @return {HTMLCanvasElement} A new canvas element containing a copy of
+     *                             the display, or null if drawing operations
+     *                             are performed within a Web Worker.
+     */
+    this.flatten = function(callback) {
 
-            });
+        var canvas = null;
 
-            // Done
-            return children;
+        updateComposite(function compositeUpdated(composite) {
 
-        }
+            // Copy composite to new canvas
+            canvas = document.createElement("canvas");
+            canvas.width = composite.width;
+            canvas.height = composite.height;
+            canvas.getContext("2d").drawImage(composite, 0, 0);
 
-        // Draws the contents of the given layer at the given coordinates
-        function draw_layer(layer, x, y) {
+            if (callback)
+                callback(canvas);
 
-            // Draw layer
-            if (layer.width > 0 && layer.height > 0) {
+        });
 
-                // Save and update alpha
-                var initial_alpha = context.globalAlpha;
-                context.globalAlpha *= layer.alpha / 255.0;
+        return canvas;
 
-                // Copy data
-                context.drawImage(layer.getCanvas(), x, y);
+    };
 
-                // Draw all children
-                var children = get_children(layer);
-                for (var i=0; i<children.length; i++) {
-                    var child = children[i];
-                    draw_layer(child, x + child.x, y + child.y);
-                }
+    /**
+     * Returns a number which changes whenever the contents of the display
+     * change. Comparing the values returned by separate calls allows work
+     * such as regenerating thumbnails to be skipped if the display has not
+     * changed.
+     *
+     * @return {Number}
+     *     The current revision of the contents of this display.
+     */
+    this.getRevision = function getRevision() {
+        return revision;
+    };
 
-                // Restore alpha
-                context.globalAlpha = initial_alpha;
+    /**
+     * Produces a thumbnail of the entire display, scaled down to fit within
+     * the given dimensions without changing its aspect ratio. The display is
+     * never scaled up. Where supported, scaling is performed by the browser
+     * asynchronously via createImageBitmap(), and the thumbnail is always
+     * provided through the given callback.
+     *
+     * @param {Number} maxWidth
+     *     The maximum width of the thumbnail, in pixels.
+     *
+     * @param {Number} maxHeight
+     *     The maximum height of the thumbnail, in pixels.
+     *
+     * @param {function} callback
+     *     The function to invoke with a new canvas element containing the
+     *     thumbnail as its sole parameter, or null if the display has no
+     *     area.
+     */
+    this.createThumbnail = function createThumbnail(maxWidth, maxHeight, callback) {
+
+        updateComposite(function compositeUpdated(composite) {
 
+            if (!composite.width || !composite.height) {
+                callback(null);
+                return;
             }
 
-        }
+            // Calculate dimensions of thumbnail
+            var scale = Math.min(maxWidth / composite.width, maxHeight / composite.height, 1);
+            var width  = Math.max(1, Math.round(composite.width  * scale));
+            var height = Math.max(1, Math.round(composite.height * scale));
+
+            var thumbnail = document.createElement("canvas");
+            thumbnail.width = width;
+            thumbnail.height = height;
+
+            // Draws the given image scaled to the thumbnail. The image may
+            // already be scaled, or may be at full size if the browser
+            // ignored the requested dimensions.
+            var drawThumbnail = function drawThumbnail(image) {
+                thumbnail.getContext("2d").drawImage(image, 0, 0, width, height);
+                callback(thumbnail);
+            };
 
-        // Draw default layer and all children
-        draw_layer(default_layer, 0, 0);
+            // Scale synchronously if the browser cannot do so itself
+            if (!window.createImageBitmap) {
+                drawThumbnail(composite);
+                return;
+            }
+
+            // The composite is captured as createImageBitmap() is invoked,
+            // and thus may change while the image is being scaled
+            window.createImageBitmap(composite, {
+                'resizeWidth'   : width,
+                'resizeHeight'  : height,
+                'resizeQuality' : 'medium'
+            }).then(function thumbnailScaled(bitmap) {
+                drawThumbnail(bitmap);
+                bitmap.close();
+            }, function scaleFailed() {
+                drawThumbnail(composite);
+            });
+
+        });
 
-        // Return new canvas copy
-        return canvas;
-        
     };
 
 };
@@ -1296,10 +2071,19 @@ Guacamole.Display = function() {
  *                       backing this Layer will be given this width.
  * @param {Number} height The height of the Layer, in pixels. The canvas element
  *                        backing this Layer will be given this height.
+ * @param {Guacamole.OffscreenRenderer} [renderer] The renderer which should
+ *                                                 perform all drawing
+ *                                                 operations for this layer
+ *                                                 within a Web Worker, if
+ *                                                 any.
  */
-Guacamole.Display.VisibleLayer = function(width, height) {
+Guacamole.Display.VisibleLayer = function(width, height, renderer) {
 
-    Guacamole.Layer.apply(this, [width, height]);
+    // Draw within the given worker, if any, or on the main thread otherwise
+    if (renderer)
+        Guacamole.OffscreenRenderer.Layer.apply(this, [renderer, width, height, true]);
+    else
+        Guacamole.Layer.apply(this, [width, height]);
 
     /**
      * Reference to this layer.
@@ -0,0 +1,468 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+var Guacamole = Guacamole || {};
+
+/**
+ * A reader which automatically handles the given input stream, decoding the
+ * image received along that stream as an ImageBitmap. Received base64 data is
+ * passed as-is to a shared Web Worker, which decodes that data, assembles the
+ * image and decodes the image, such that none of this work is performed on
+ * the main thread unless the worker fails, in which case any images not yet
+ * decoded are decoded on the main thread instead. Note that this object will
+ * overwrite any installed event handlers on the given Guacamole.InputStream.
+ *
+ * This reader may only be used if
+ * {@link Guacamole.ImageBitmapReader.isSupported} returns true.
+ *
+ * @constructor
+ * @param {Guacamole.InputStream} stream
+ *     The stream that image data will be read from.
+ *
+ * @param {String} mimetype
+ *     The mimetype of the image being received.
+ */
+Guacamole.ImageBitmapReader = (function() {
+
+    /**
+     * The body of the Web Worker which decodes images on behalf of all
+     * Guacamole.ImageBitmapReader instances. This function is never invoked
+     * directly. Its source is used to create the worker and thus it must not
+     * reference anything outside its own body.
+     *
+     * @private
+     */
+    var decodeWorker = function decodeWorker() {
+
+        /**
+         * All images which are still being received, stored by the ID of
+         * the reader receiving that image. Each image is an object containing
+         * its mimetype ("mimetype") and the decoded contents of each blob
+         * received thus far ("chunks").
+         *
+         * @type {Object.<Number, Object>}
+         */
+        var images = {};
+
+        /**
+         * Sends the result of decoding the image having the given ID back to
+         * the main thread.
+         *
+         * @param {Number} id
+         *     The ID of the reader which received the image.
+         *
+         * @param {ImageBitmap} bitmap
+         *     The decoded image, or null if the image could not be decoded.
+         *
+         * @param {Blob} [blob]
+         *     The assembled, undecoded image, if images cannot be decoded
+         *     within workers and must instead be decoded by the main thread.
+         */
+        var sendResult = function sendResult(id, bitmap, blob) {
+            self.postMessage({ 'id' : id, 'bitmap' : bitmap, 'blob' : blob },
+                bitmap ? [ bitmap ] : []);
+        };
+
+        self.onmessage = function messageReceived(e) {
+
+            var message = e.data;
+            var image = images[message.id];
+
+            switch (message.type) {
+
+                // Begin a new image
+                case 'begin':
+                    images[message.id] = {
+                        'mimetype' : message.mimetype,
+                        'chunks'   : []
+                    };
+                    break;
+
+                // Decode and store received base64 data
+                case 'blob':
+
+                    if (!image)
+                        return;
+
+                    var binary = atob(message.data);
+                    var bytes = new Uint8Array(binary.length);
+                    for (var i = 0; i < binary.length; i++)
+                        bytes[i] = binary.charCodeAt(i);
+
+                    image.chunks.push(bytes);
+                    break;
+
+                // Decode the completed image
+                case 'end':
+
+                    if (!image)
+                        return;
+
+                    delete images[message.id];
+                    var blob = new Blob(image.chunks, { 'type' : image.mimetype });
+
+                    // Defer to the main thread if images cannot be decoded
+                    // within workers
+                    if (typeof createImageBitmap === 'undefined') {
+                        sendResult(message.id, null, blob);
+                        return;
+                    }
+
+                    createImageBitmap(blob).then(function imageDecoded(bitmap) {
+                        sendResult(message.id, bitmap);
+                    }, function imageDecodeFailed() {
+                        sendResult(message.id, null);
+                    });
+
+                    break;
+
+            }
+
+        };
+
+    };
+
+    /**
+     * The Web Worker shared by all Guacamole.ImageBitmapReader instances, or
+     * null if that worker has not yet been created or has failed.
+     *
+     * @private
+     * @type {Worker}
+     */
+    var worker = null;
+
+    /**
+     * Whether the shared Web Worker could not be created or has failed. Once
+     * the worker has failed, Guacamole.ImageBitmapReader is no longer
+     * supported.
+     *
+     * @private
+     * @type {Boolean}
+     */
+    var workerFailed = false;
+
+    /**
+     * The ID to assign to the next Guacamole.ImageBitmapReader.
+     *
+     * @private
+     * @type {Number}
+     */
+    var nextID = 0;
+
+    /**
+     * All images which have not yet been decoded, stored by the ID of the
+     * reader receiving that image. Each image is an object containing the
+     * callback which should be invoked with the result of decoding the image
+     * ("complete") and the function which should be invoked if the image must
+     * instead be decoded on the main thread due to failure of the shared Web
+     * Worker ("fallback").
+     *
+     * @private
+     * @type {Object.<Number, Object>}
+     */
+    var pending = {};
+
+    /**
+     * Invokes the callback associated with the image having the given ID, if
+     * any, removing that callback from the set of pending callbacks.
+     *
+     * @private
+     * @param {Number} id
+     *     The ID of the reader which received the image.
+     *
+     * @param {ImageBitmap} bitmap
+     *     The decoded image, or null if the image could not be decoded.
+     */
+    var complete = function complete(id, bitmap) {
+
+        var image = pending[id];
+        if (!image)
+            return;
+
+        delete pending[id];
+        image.complete(bitmap);
+
+    };
+
+    /**
+     * Marks the shared Web Worker as failed, such that no further images will
+     * be decoded by that worker, and falls back to decoding all pending
+     * images on the main thread. The worker may fail only after images have
+     * been passed to it, for example if its creation is blocked by a
+     * Content-Security-Policy, which is reported asynchronously.
+     *
+     * @private
+     */
+    var fail = function fail() {
+
+        workerFailed = true;
+
+        if (worker) {
+            worker.terminate();
+            worker = null;
+        }
+
+        for (var id in pending)
+            pending[id].fallback();
+
+    };
+
+    /**
+     * Returns the shared Web Worker, creating that worker if it has not yet
+     * been created.
+     *
+     * @private
+     * @returns {Worker}
+     *     The shared Web Worker, or null if the worker cannot be created or
+     *     has failed.
+     */
+    var getWorker = function getWorker() {
+
+        if (worker || workerFailed)
+            return worker;
+
+        // Web Workers and ImageBitmap are both required
+        if (!window.Worker || !window.createImageBitmap || !window.Blob || !window.URL) {
+            workerFailed = true;
+            return null;
+        }
+
+        try {
+            var source = new Blob([ '(' + decodeWorker + ')();' ], { 'type' : 'application/javascript' });
+            worker = new Worker(URL.createObjectURL(source));
+        }
+
+        // Worker creation may be prohibited (by a Content-Security-Policy, for
+        // example)
+        catch (e) {
+            workerFailed = true;
+            return null;
+        }
+
+        worker.onmessage = function resultReceived(e) {
+
+            var result = e.data;
+
+            // Decode on the main thread if the worker cannot decode images
+            if (result.blob) {
+                window.createImageBitmap(result.blob).then(function imageDecoded(bitmap) {
+                    complete(result.id, bitmap);
+                }, function imageDecodeFailed() {
+                    complete(result.id, null);
+                });
+            }
+
+            else
+                complete(result.id, result.bitmap);
+
+        };
+
+        worker.onerror = fail;
+
+        return worker;
+
+    };
+
+    var ImageBitmapReader = function ImageBitmapReader(stream, mimetype) {
+
+        /**
+         * Reference to this Guacamole.ImageBitmapReader.
+         *
+         * @private
+         * @type {Guacamole.ImageBitmapReader}
+         */
+        var guac_reader = this;
+
+        /**
+         * The ID uniquely identifying this reader to the shared Web Worker.
+         *
+         * @private
+         * @type {Number}
+         */
+        var id = nextID++;
+
+        /**
+         * Whether the end of the stream has been received.
+         *
+         * @private
+         * @type {Boolean}
+         */
+        var ended = false;
+
+        /**
+         * Whether decoding of the image has completed, successfully or not.
+         *
+         * @private
+         * @type {Boolean}
+         */
+        var decoded = false;
+
+        /**
+         * The decoded image, or null if the image has not been decoded or
+         * could not be decoded.
+         *
+         * @private
+         * @type {ImageBitmap}
+         */
+        var bitmap = null;
+
+        /**
+         * All base64 data received thus far. This data is retained until the
+         * image has been decoded such that the image can still be decoded on
+         * the main thread if the shared Web Worker fails.
+         *
+         * @private
+         * @type {String[]}
+         */
+        var chunks = [];
+
+        /**
+         * Decodes the received image on the main thread, without the shared
+         * Web Worker. The image is not decoded until the end of the stream
+         * has been received.
+         *
+         * @private
+         */
+        var decodeLocally = function decodeLocally() {
+
+            if (!ended)
+                return;
+
+            var blob;
+            try {
+                blob = new Blob(chunks.map(Guacamole.Base64.decode), { 'type' : mimetype });
+            }
+
+            // Fail if the received data is not valid base64
+            catch (e) {
+                complete(id, null);
+                return;
+            }
+
+            if (!window.createImageBitmap) {
+                complete(id, null);
+                return;
+            }
+
+            window.createImageBitmap(blob).then(function imageDecoded(bitmap) {
+                complete(id, bitmap);
+            }, function imageDecodeFailed() {
+                complete(id, null);
+            });
+
+        };
+
+        /**
+         * Fires the onload event if both the end of the stream has been
+         * received and decoding has completed.
+         *
+         * @private
+         */
+        var fireLoad = function fireLoad() {
+            if (ended && decoded && guac_reader.onload)
+                guac_reader.onload(bitmap);
+        };
+
+        pending[id] = {
+
+            'complete' : function imageDecoded(decodedBitmap) {
+                decoded = true;
+                bitmap = decodedBitmap;
+                chunks = null;
+                fireLoad();
+            },
+
+            'fallback' : decodeLocally
+
+        };
+
+        var decoder = getWorker();
+        if (decoder)
+            decoder.postMessage({ 'type' : 'begin', 'id' : id, 'mimetype' : mimetype });
+
+        // Forward received base64 data to the worker for decoding
+        stream.onblob = function imageBitmapReaderBlob(data) {
+
+            if (chunks)
+                chunks.push(data);
+
+            if (worker)
+                worker.postMessage({ 'type' : 'blob', 'id' : id, 'data' : data });
+
+            // Send success response
+            stream.sendAck("OK", 0x0000);
+
+        };
+
+        // Decode the image once all data has been received
+        stream.onend = function imageBitmapReaderEnd() {
+
+            ended = true;
+
+            if (guac_reader.onend)
+                guac_reader.onend();
+
+            if (decoded)
+                fireLoad();
+            else if (worker)
+                worker.postMessage({ 'type' : 'end', 'id' : id });
+            else
+                decodeLocally();
+
+        };
+
+        /**
+         * Fired once this stream is finished and no further data will be
+         * written. The image will not yet have been decoded.
+         *
+         * @event
+         */
+        this.onend = null;
+
+        /**
+         * Fired once the image received along the stream has been decoded.
+         * This event is always fired after onend. The ImageBitmap provided is
+         * owned by the recipient, which should close() that ImageBitmap once
+         * it is no longer needed.
+         *
+         * @event
+         * @param {ImageBitmap} bitmap
+         *     The decoded image, or null if the image could not be decoded.
+         */
+        this.onload = null;
+
+    };
+
+    /**
+     * Returns whether Guacamole.ImageBitmapReader may be used within the
+     * current browser. This will be false if the browser lacks support for
+     * Web Workers or ImageBitmap, or if the Web Worker used for decoding
+     * cannot be created or has failed.
+     *
+     * @returns {Boolean}
+     *     true if Guacamole.ImageBitmapReader may be used, false otherwise.
+     */
+    ImageBitmapReader.isSupported = function isSupported() {
+        return !!getWorker();
+    };
+
+    return ImageBitmapReader;
+
+})();
@@ -302,6 +302,52 @@ Guacamole.Layer = function(width, height) {
 
     };
 
+    /**
+     * Returns a canvas containing the given rectangle of this Layer, along
+     * with the location of that rectangle within the returned canvas. The
+     * rectangle is first clipped to the bounds of the canvas backing this
+     * Layer. The returned canvas must not be modified, and is valid only
+     * until the next operation on this Layer. This function is used by other
+     * layers to read image data from this Layer.
+     *
+     * @param {Number} x The X coordinate of the upper-left corner of the
+     *                   rectangle.
+     * @param {Number} y The Y coordinate of the upper-left corner of the
+     *                   rectangle.
+     * @param {Number} w The width of the rectangle.
+     * @param {Number} h The height of the rectangle.
+     *
+     * @returns {Object}
+     *     An object containing the canvas ("canvas"), the location of the
+     *     clipped rectangle within that canvas ("x" and "y"), and the
+     *     dimensions of the clipped rectangle ("width" and "height"), or null
+     *     if the clipped rectangle is empty.
+     */
+    this.getRegion = function getRegion(x, y, w, h) {
+
+        // If entire rectangle outside canvas, stop
+        if (x >= canvas.width || y >= canvas.height) return null;
+
+        // Otherwise, clip rectangle to area
+        if (x + w > canvas.width)
+            w = canvas.width - x;
+
+        if (y + h > canvas.height)
+            h = canvas.height - y;
+
+        // Stop if nothing to read
+        if (w === 0 || h === 0) return null;
+
+        return {
+            'canvas' : canvas,
+            'x'      : x,
+            'y'      : y,
+            'width'  : w,
+            'height' : h
+        };
+
+    };
+
     /**
      * Changes the size of this Layer to the given width and height. Resizing
      * is only attempted if the new size provided is actually different from
@@ -353,32 +399,43 @@ Guacamole.Layer = function(width, height) {
      * @param {Number} y The destination Y coordinate.
      * @param {Function} transferFunction The transfer function to use to
      *                                    transfer data from source to
-     *                                    destination.
+     *                                    destination. If this function has
+     *                                    a "kernel" property, that kernel
+     *                                    will be invoked once with 32-bit
+     *                                    views of the source and
+     *                                    destination pixel data and the
+     *                                    number of pixels, rather than
+     *                                    invoking the transfer function for
+     *                                    each pixel.
      */
     this.transfer = function(srcLayer, srcx, srcy, srcw, srch, x, y, transferFunction) {
 
-        var srcCanvas = srcLayer.getCanvas();
+        // Stop if nothing to draw
+        var region = srcLayer.getRegion(srcx, srcy, srcw, srch);
+        if (!region) return;
 
-        // If entire rectangle outside source canvas, stop
-        if (srcx >= srcCanvas.width || srcy >= srcCanvas.height) return;
-
-        // Otherwise, clip rectangle to area
-        if (srcx + srcw > srcCanvas.width)
-            srcw = srcCanvas.width - srcx;
-
-        if (srcy + srch > srcCanvas.height)
-            srch = srcCanvas.height - srcy;
-
-        // Stop if nothing to draw.
-        if (srcw === 0 || srch === 0) return;
+        srcw = region.width;
+        srch = region.height;
 
         if (layer.autosize) fitRect(x, y, srcw, srch);
 
         // Get image data from src and dst
-        var src = srcLayer.getCanvas().getContext("2d").getImageData(srcx, srcy, srcw, srch);
+        var src = region.canvas.getContext("2d").getImageData(region.x, region.y, srcw, srch);
         var dst = context.getImageData(x , y, srcw, srch);
 
-        // Apply transfer for each pixel
+        // Apply transfer to all pixels at once if a kernel is available
+        if (transferFunction.kernel) {
+            transferFunction.kernel(
+                new Uint32Array(src.data.buffer),
+                new Uint32Array(dst.data.buffer),
+                srcw * srch
+            );
+            context.putImageData(dst, x, y);
+            empty = false;
+            return;
+        }
+
+        // Otherwise, apply transfer for each pixel
         for (var i=0; i<srcw*srch*4; i+=4) {
 
             // Get source pixel environment
@@ -434,25 +491,17 @@ Guacamole.Layer = function(width, height) {
      */
     this.put = function(srcLayer, srcx, srcy, srcw, srch, x, y) {
 
-        var srcCanvas = srcLayer.getCanvas();
+        // Stop if nothing to draw
+        var region = srcLayer.getRegion(srcx, srcy, srcw, srch);
+        if (!region) return;
 
-        // If entire rectangle outside source canvas, stop
-        if (srcx >= srcCanvas.width || srcy >= srcCanvas.height) return;
-
-        // Otherwise, clip rectangle to area
-        if (srcx + srcw > srcCanvas.width)
-            srcw = srcCanvas.width - srcx;
-
-        if (srcy + srch > srcCanvas.height)
-            srch = srcCanvas.height - srcy;
-
-        // Stop if nothing to draw.
-        if (srcw === 0 || srch === 0) return;
+        srcw = region.width;
+        srch = region.height;
 
         if (layer.autosize) fitRect(x, y, srcw, srch);
 
         // Get image data from src and dst
-        var src = srcLayer.getCanvas().getContext("2d").getImageData(srcx, srcy, srcw, srch);
+        var src = region.canvas.getContext("2d").getImageData(region.x, region.y, srcw, srch);
         context.putImageData(src, x, y);
         empty = false;
 
@@ -481,23 +530,15 @@ Guacamole.Layer = function(width, height) {
      */
     this.copy = function(srcLayer, srcx, srcy, srcw, srch, x, y) {
 
-        var srcCanvas = srcLayer.getCanvas();
-
-        // If entire rectangle outside source canvas, stop
-        if (srcx >= srcCanvas.width || srcy >= srcCanvas.height) return;
-
-        // Otherwise, clip rectangle to area
-        if (srcx + srcw > srcCanvas.width)
-            srcw = srcCanvas.width - srcx;
-
-        if (srcy + srch > srcCanvas.height)
-            srch = srcCanvas.height - srcy;
+        // Stop if nothing to draw
+        var region = srcLayer.getRegion(srcx, srcy, srcw, srch);
+        if (!region) return;
 
-        // Stop if nothing to draw.
-        if (srcw === 0 || srch === 0) return;
+        srcw = region.width;
+        srch = region.height;
 
         if (layer.autosize) fitRect(x, y, srcw, srch);
-        context.drawImage(srcCanvas, srcx, srcy, srcw, srch, x, y, srcw, srch);
+        context.drawImage(region.canvas, region.x, region.y, srcw, srch, x, y, srcw, srch);
         empty = false;
 
     };
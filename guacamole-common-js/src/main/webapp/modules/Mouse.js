@@ -105,6 +105,17 @@ Guacamole.Mouse = function Mouse(element) {
      */
     var scroll_delta = 0;
 
+    /**
+     * Whether the browser supports pointer events, in which case pointer
+     * movement is tracked through "pointermove" events (which may provide
+     * the intermediate positions coalesced into each event) rather than
+     * "mousemove" events.
+     *
+     * @private
+     * @type {Boolean}
+     */
+    var POINTER_EVENTS_SUPPORTED = !!window.PointerEvent;
+
     // Block context menu so right-click gets sent properly
     element.addEventListener("contextmenu", function(e) {
         Guacamole.Event.DOMEvent.cancelEvent(e);
@@ -119,10 +130,45 @@ Guacamole.Mouse = function Mouse(element) {
             return;
         }
 
-        guac_mouse.move(Guacamole.Position.fromClientPosition(element, e.clientX, e.clientY), e);
+        // Movement is otherwise handled via pointermove, if supported
+        if (!POINTER_EVENTS_SUPPORTED)
+            guac_mouse.move(Guacamole.Position.fromClientPosition(element, e.clientX, e.clientY), e);
 
     }, false);
 
+    // Track movement via pointer events, if supported
+    if (POINTER_EVENTS_SUPPORTED) {
+
+        element.addEventListener("pointermove", function(e) {
+
+            // Touch is handled separately, and mouse events may be ignored
+            // following touch
+            if (e.pointerType === 'touch' || ignore_mouse)
+                return;
+
+            var position = Guacamole.Position.fromClientPosition(element, e.clientX, e.clientY);
+
+            // Include all positions coalesced into this event, translating each
+            // relative to the final position rather than recalculating the
+            // offset of the element
+            var positions = [];
+            var coalesced = e.getCoalescedEvents ? e.getCoalescedEvents() : [];
+            for (var i = 0; i < coalesced.length; i++) {
+                positions.push(new Guacamole.Position({
+                    x : position.x + coalesced[i].clientX - e.clientX,
+                    y : position.y + coalesced[i].clientY - e.clientY
+                }));
+            }
+
+            if (!positions.length)
+                positions.push(position);
+
+            guac_mouse.move(position, e, positions);
+
+        }, false);
+
+    }
+
     element.addEventListener("mousedown", function(e) {
 
         // Do not handle if ignoring events
@@ -498,8 +544,12 @@ Guacamole.Mouse.State.Buttons = {
  *     
  * @param {Event|Event[]} [events=[]]
  *     The DOM events that are related to this event, if any.
+ *
+ * @param {Guacamole.Position[]} [positions]
+ *     Every position of the mouse pointer represented by this event, in
+ *     order. By default, this is only the position of the given state.
  */
-Guacamole.Mouse.Event = function MouseEvent(type, state, events) {
+Guacamole.Mouse.Event = function MouseEvent(type, state, events, positions) {
 
     Guacamole.Event.DOMEvent.call(this, type, events);
 
@@ -520,6 +570,19 @@ Guacamole.Mouse.Event = function MouseEvent(type, state, events) {
      */
     this.state = state;
 
+    /**
+     * Every position of the mouse pointer represented by this event, in
+     * order, ending with the current position. Where the browser coalesces
+     * several pointer movements into a single DOM event (see
+     * PointerEvent.getCoalescedEvents()), this includes each of those
+     * intermediate positions, and may be used where more precision than a
+     * single position per event is needed. Otherwise, this contains only the
+     * current position.
+     *
+     * @type {Guacamole.Position[]}
+     */
+    this.positions = positions || [ new Guacamole.Position(state) ];
+
     /**
      * @inheritdoc
      */
@@ -695,13 +758,18 @@ Guacamole.Mouse.Event.Target = function MouseEventTarget() {
      *
      * @param {Event|Event[]} [events=[]]
      *     The DOM events related to the mouse movement, if any.
+     *
+     * @param {Guacamole.Position[]} [positions]
+     *     Every position of the mouse pointer since the previous movement,
+     *     ending with the new coordinates, if known. By default, only the new
+     *     coordinates are assumed.
      */
-    this.move = function move(position, events) {
+    this.move = function move(position, events, positions) {
 
         if (this.currentState.x !== position.x || this.currentState.y !== position.y) {
             this.currentState.x = position.x;
             this.currentState.y = position.y;
-            this.dispatch(new Guacamole.Mouse.Event('mousemove', this.currentState, events));
+            this.dispatch(new Guacamole.Mouse.Event('mousemove', this.currentState, events, positions));
         }
 
     };
@@ -0,0 +1,829 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+var Guacamole = Guacamole || {};
+
+/**
+ * Renderer which performs all drawing operations of a Guacamole.Display
+ * within a dedicated Web Worker, using OffscreenCanvas. Drawing operations
+ * invoked on the main thread are serialized as compact commands and sent to
+ * the worker in batches, with a single batch sent for all operations
+ * performed within the same task. Visible layers are backed by canvas
+ * elements whose rendering has been transferred to the worker via
+ * transferControlToOffscreen(), while buffers exist only within the worker.
+ *
+ * The worker draws using the same Guacamole.Layer and Guacamole.TiledLayer
+ * implementations as the main thread, built from those implementations' own
+ * source.
+ *
+ * @constructor
+ */
+Guacamole.OffscreenRenderer = function OffscreenRenderer() {
+
+    /**
+     * Reference to this Guacamole.OffscreenRenderer.
+     *
+     * @private
+     * @type {Guacamole.OffscreenRenderer}
+     */
+    var renderer = this;
+
+    /**
+     * All commands which have not yet been sent to the worker, in order.
+     *
+     * @private
+     * @type {Array[]}
+     */
+    var commands = [];
+
+    /**
+     * All objects which must be transferred to the worker along with the
+     * pending commands.
+     *
+     * @private
+     * @type {Transferable[]}
+     */
+    var transfer = [];
+
+    /**
+     * Whether a batch of commands is already scheduled to be sent to the
+     * worker.
+     *
+     * @private
+     * @type {Boolean}
+     */
+    var sendScheduled = false;
+
+    /**
+     * The ID to assign to the next layer created.
+     *
+     * @private
+     * @type {Number}
+     */
+    var nextLayerID = 0;
+
+    /**
+     * The ID to assign to the next read request.
+     *
+     * @private
+     * @type {Number}
+     */
+    var nextReadID = 0;
+
+    /**
+     * Callbacks awaiting the results of read requests, stored by the ID of
+     * the corresponding request.
+     *
+     * @private
+     * @type {Object.<Number, function>}
+     */
+    var pendingReads = {};
+
+    var source = new Blob([
+        'var Guacamole = {};\n',
+        'Guacamole.Layer = ' + Guacamole.Layer + ';\n',
+        'Guacamole.Layer.Pixel = ' + Guacamole.Layer.Pixel + ';\n',
+        'Guacamole.TiledLayer = ' + Guacamole.TiledLayer + ';\n',
+        'var createTransferKernels = ' + Guacamole.Client.createTransferKernels + ';\n',
+        '(' + Guacamole.OffscreenRenderer.worker + ')();\n'
+    ], { 'type' : 'application/javascript' });
+
+    /**
+     * The Web Worker performing all drawing operations.
+     *
+     * @private
+     * @type {Worker}
+     */
+    var worker = new Worker(URL.createObjectURL(source));
+
+    // Dispatch the results of read requests
+    worker.onmessage = function resultsReceived(e) {
+
+        var results = e.data.results;
+        for (var i = 0; i < results.length; i++) {
+
+            var result = results[i];
+            var callback = pendingReads[result.id];
+            delete pendingReads[result.id];
+
+            if (callback)
+                callback(result.bitmap, result.width, result.height);
+
+        }
+
+    };
+
+    // Abandon any pending reads and report the failure if the worker fails.
+    // Visible layers cannot be returned to the main thread once their
+    // rendering has been transferred to the worker, thus nothing further can
+    // be drawn.
+    worker.onerror = function workerFailed(e) {
+
+        var callbacks = pendingReads;
+        pendingReads = {};
+
+        for (var id in callbacks)
+            callbacks[id](null, 0, 0);
+
+        if (renderer.onerror)
+            renderer.onerror(e && e.message ? e.message : 'Rendering worker failed.');
+
+    };
+
+    /**
+     * Fired if the worker performing all drawing operations fails, after
+     * which nothing further can be drawn.
+     *
+     * @event
+     * @param {String} message
+     *     A human-readable description of the failure.
+     */
+    this.onerror = null;
+
+    /**
+     * Sends all pending commands to the worker as a single batch.
+     *
+     * @private
+     */
+    var sendCommands = function sendCommands() {
+
+        sendScheduled = false;
+        if (!commands.length)
+            return;
+
+        // Begin a new batch before sending, such that a batch which cannot be
+        // sent (due to a detached ImageBitmap, for example) is dropped rather
+        // than preventing all later batches from being sent
+        var batch = commands;
+        var batchTransfer = transfer;
+        commands = [];
+        transfer = [];
+
+        worker.postMessage({ 'commands' : batch }, batchTransfer);
+
+    };
+
+    /**
+     * Queues the given command for sending to the worker. All commands queued
+     * within the same task are sent together once that task completes.
+     *
+     * @param {Array} command
+     *     The command to send, where the first element is the name of the
+     *     operation and the second element is the ID of the layer affected.
+     *
+     * @param {Transferable} [transferable]
+     *     An object within the command which should be transferred to the
+     *     worker rather than copied, if any.
+     */
+    this.send = function send(command, transferable) {
+
+        commands.push(command);
+        if (transferable)
+            transfer.push(transferable);
+
+        if (!sendScheduled) {
+            sendScheduled = true;
+            Promise.resolve().then(sendCommands);
+        }
+
+    };
+
+    /**
+     * Allocates a new ID for a layer rendered by this renderer.
+     *
+     * @returns {Number}
+     *     A new layer ID, unique within this renderer.
+     */
+    this.createLayerID = function createLayerID() {
+        return nextLayerID++;
+    };
+
+    /**
+     * Reads the current contents of the given layer, including the effects of
+     * all operations performed on that layer thus far. If no rectangle is
+     * specified, the entire layer is read.
+     *
+     * @param {Guacamole.OffscreenRenderer.Layer} layer
+     *     The layer to read.
+     *
+     * @param {function} callback
+     *     The function to invoke with an ImageBitmap containing the contents
+     *     read (or null if the layer is empty or could not be read), followed
+     *     by the actual width and height of the layer. The recipient owns the
+     *     ImageBitmap and should close() it once it is no longer needed.
+     *
+     * @param {Number} [x] The X coordinate of the rectangle to read.
+     * @param {Number} [y] The Y coordinate of the rectangle to read.
+     * @param {Number} [width] The width of the rectangle to read.
+     * @param {Number} [height] The height of the rectangle to read.
+     */
+    this.read = function read(layer, callback, x, y, width, height) {
+
+        var id = nextReadID++;
+        pendingReads[id] = callback;
+
+        if (width && height)
+            renderer.send(['read', layer.__offscreen_id, id, x, y, width, height]);
+        else
+            renderer.send(['read', layer.__offscreen_id, id]);
+
+    };
+
+};
+
+/**
+ * The body of the Web Worker used by Guacamole.OffscreenRenderer. This
+ * function is never invoked directly. Its source is used to create the worker
+ * and thus it must not reference anything outside its own body other than
+ * Guacamole.Layer and createTransferKernels(), which are defined within the
+ * worker from their own sources.
+ *
+ * @private
+ */
+Guacamole.OffscreenRenderer.worker = function worker() {
+
+    /**
+     * All layers, stored by ID.
+     *
+     * @type {Object.<Number, Guacamole.Layer>}
+     */
+    var layers = {};
+
+    /**
+     * The canvas which should be used by the next layer created, if that layer
+     * is visible and thus backed by a canvas provided by the main thread.
+     *
+     * @type {OffscreenCanvas}
+     */
+    var providedCanvas = null;
+
+    /**
+     * The transfer functions usable within the worker, stored by the index
+     * of the Guacamole binary raster operation they implement.
+     *
+     * @type {Object.<Number, Object>}
+     */
+    var transferFunctions = {};
+
+    var kernels = createTransferKernels();
+    for (var index in kernels)
+        transferFunctions[index] = { 'kernel' : kernels[index] };
+
+    // Guacamole.Layer creates its canvases through the document, which
+    // workers lack
+    self.document = {
+        createElement : function createElement() {
+
+            var canvas = providedCanvas || new OffscreenCanvas(0, 0);
+            providedCanvas = null;
+
+            canvas.style = {};
+            return canvas;
+
+        }
+    };
+
+    /**
+     * Returns an ImageBitmap containing the current contents of the given
+     * rectangle of the given layer. If no rectangle is given, the entire
+     * layer is read.
+     *
+     * @param {Guacamole.Layer} layer
+     *     The layer to read.
+     *
+     * @param {Number} [x] The X coordinate of the rectangle to read.
+     * @param {Number} [y] The Y coordinate of the rectangle to read.
+     * @param {Number} [width] The width of the rectangle to read.
+     * @param {Number} [height] The height of the rectangle to read.
+     *
+     * @returns {ImageBitmap}
+     *     The contents of the layer, or null if there is nothing to read.
+     */
+    var read = function read(layer, x, y, width, height) {
+
+        if (!layer)
+            return null;
+
+        // Default to entire layer
+        if (!width || !height) {
+            x = y = 0;
+            width = layer.width;
+            height = layer.height;
+        }
+
+        if (!width || !height)
+            return null;
+
+        var canvas = new OffscreenCanvas(width, height);
+        var region = layer.getRegion(x, y, width, height);
+        if (region)
+            canvas.getContext('2d').drawImage(region.canvas,
+                region.x, region.y, region.width, region.height,
+                0, 0, region.width, region.height);
+
+        return canvas.transferToImageBitmap();
+
+    };
+
+    self.onmessage = function commandsReceived(e) {
+
+        var commands = e.data.commands;
+        var results = [];
+        var transfer = [];
+
+        for (var i = 0; i < commands.length; i++) {
+
+            var command = commands[i];
+            var layer = layers[command[1]];
+
+            switch (command[0]) {
+
+                // Buffers, which have no provided canvas, may be tiled
+                case 'create':
+                    providedCanvas = command[4] || null;
+                    layers[command[1]] = !providedCanvas && command[5]
+                        ? new Guacamole.TiledLayer(command[2], command[3])
+                        : new Guacamole.Layer(command[2], command[3]);
+                    break;
+
+                case 'dispose':
+                    if (layer && layer.dispose)
+                        layer.dispose();
+                    delete layers[command[1]];
+                    break;
+
+                case 'autosize':
+                    layer.autosize = command[2];
+                    break;
+
+                case 'read':
+                    var bitmap = read(layer, command[3], command[4], command[5], command[6]);
+                    results.push({
+                        'id'     : command[2],
+                        'bitmap' : bitmap,
+                        'width'  : layer ? layer.width  : 0,
+                        'height' : layer ? layer.height : 0
+                    });
+                    if (bitmap)
+                        transfer.push(bitmap);
+                    break;
+
+                case 'drawImage':
+                    layer.drawImage(command[2], command[3], command[4]);
+                    command[4].close();
+                    break;
+
+                case 'transfer':
+                    layer.transfer(layers[command[2]],
+                        command[3], command[4], command[5], command[6],
+                        command[7], command[8],
+                        transferFunctions[command[9]]);
+                    break;
+
+                case 'put':
+                case 'copy':
+                    layer[command[0]](layers[command[2]],
+                        command[3], command[4], command[5], command[6],
+                        command[7], command[8]);
+                    break;
+
+                case 'strokeLayer':
+                    layer.strokeLayer(command[2], command[3], command[4],
+                        layers[command[5]]);
+                    break;
+
+                case 'fillLayer':
+                    layer.fillLayer(layers[command[2]]);
+                    break;
+
+                // All other operations take only primitive arguments
+                default:
+                    layer[command[0]].apply(layer, command.slice(2));
+
+            }
+
+        }
+
+        if (results.length)
+            self.postMessage({ 'results' : results }, transfer);
+
+    };
+
+};
+
+/**
+ * Whether Guacamole.Display should render within a Web Worker using
+ * Guacamole.OffscreenRenderer, if supported by the browser. This is disabled
+ * by default and affects only displays created after it is set.
+ *
+ * @type {Boolean}
+ */
+Guacamole.OffscreenRenderer.enabled = false;
+
+/**
+ * Returns whether Guacamole.OffscreenRenderer may be used within the current
+ * browser.
+ *
+ * @returns {Boolean}
+ *     true if Guacamole.OffscreenRenderer may be used, false otherwise.
+ */
+Guacamole.OffscreenRenderer.isSupported = function isSupported() {
+    return !!(window.Worker
+        && window.OffscreenCanvas
+        && window.HTMLCanvasElement
+        && HTMLCanvasElement.prototype.transferControlToOffscreen
+        && window.Blob
+        && window.URL
+        && window.Promise);
+};
+
+/**
+ * Layer whose contents are rendered within the Web Worker of a
+ * Guacamole.OffscreenRenderer. This layer provides the same drawing
+ * operations as Guacamole.Layer, each of which is forwarded to the worker.
+ * As the contents of the layer are not available on the main thread,
+ * toCanvas() is not provided and getCanvas() returns only the placeholder
+ * canvas element of visible layers. The contents of the layer may instead be
+ * read asynchronously with {@link Guacamole.OffscreenRenderer#read}.
+ *
+ * ImageBitmaps drawn using drawImage() are transferred to the worker and are
+ * no longer usable by the caller. Only the transfer functions within
+ * {@link Guacamole.Client.DefaultTransferFunction} are supported by
+ * transfer().
+ *
+ * @constructor
+ * @param {Guacamole.OffscreenRenderer} renderer
+ *     The renderer which will render the contents of this layer.
+ *
+ * @param {Number} width
+ *     The width of the layer, in pixels.
+ *
+ * @param {Number} height
+ *     The height of the layer, in pixels.
+ *
+ * @param {Boolean} visible
+ *     Whether the layer should be backed by a canvas element which can be
+ *     added to the DOM. If false, the layer exists only within the worker.
+ *
+ * @param {Boolean} [tiled=false]
+ *     Whether the layer should be stored within the worker as a
+ *     Guacamole.TiledLayer. This applies only to layers which are not
+ *     visible.
+ */
+Guacamole.OffscreenRenderer.Layer = function OffscreenLayer(renderer, width, height, visible, tiled) {
+
+    /**
+     * Reference to this layer.
+     *
+     * @private
+     * @type {Guacamole.OffscreenRenderer.Layer}
+     */
+    var layer = this;
+
+    /**
+     * The ID of this layer within the worker.
+     *
+     * @private
+     * @type {Number}
+     */
+    var id = this.__offscreen_id = renderer.createLayerID();
+
+    /**
+     * The placeholder canvas element displaying the contents of this layer,
+     * or null if this layer is not visible.
+     *
+     * @private
+     * @type {HTMLCanvasElement}
+     */
+    var canvas = null;
+
+    /**
+     * Whether this layer automatically resizes to fit drawing operations.
+     *
+     * @private
+     * @type {Boolean}
+     */
+    var autosize = false;
+
+    // Hand rendering of visible layers to the worker
+    if (visible) {
+
+        canvas = document.createElement('canvas');
+
+        // Render canvas below child layers (see Guacamole.Layer)
+        canvas.style.zIndex = -1;
+
+        var offscreen = canvas.transferControlToOffscreen();
+        renderer.send(['create', id, width, height, offscreen], offscreen);
+
+    }
+    else
+        renderer.send(['create', id, width, height, null, !!tiled]);
+
+    /**
+     * Returns the ID of the given layer within the worker, which must be
+     * rendered by the same renderer as this layer.
+     *
+     * @private
+     * @param {Guacamole.OffscreenRenderer.Layer} srcLayer
+     *     The layer whose ID should be returned.
+     *
+     * @returns {Number}
+     *     The ID of the given layer.
+     */
+    var getID = function getID(srcLayer) {
+        return srcLayer.__offscreen_id;
+    };
+
+    /**
+     * Returns the index of the given transfer function within
+     * {@link Guacamole.Client.DefaultTransferFunction}.
+     *
+     * @private
+     * @param {function} transferFunction
+     *     The transfer function to locate.
+     *
+     * @returns {Number}
+     *     The index of the given transfer function, or -1 if it is not one of
+     *     the default transfer functions.
+     */
+    var getTransferFunctionIndex = function getTransferFunctionIndex(transferFunction) {
+
+        var functions = Guacamole.Client.DefaultTransferFunction;
+        for (var index in functions) {
+            if (functions[index] === transferFunction)
+                return parseInt(index);
+        }
+
+        return -1;
+
+    };
+
+    /**
+     * Returns an ImageBitmap containing the given image, creating that
+     * ImageBitmap synchronously if necessary.
+     *
+     * @private
+     * @param {CanvasImageSource} image
+     *     The image to convert.
+     *
+     * @returns {ImageBitmap}
+     *     An ImageBitmap containing the given image, or null if the image is
+     *     empty.
+     */
+    var toImageBitmap = function toImageBitmap(image) {
+
+        if (image instanceof ImageBitmap)
+            return image;
+
+        var imageWidth  = image.naturalWidth  || image.videoWidth  || image.width;
+        var imageHeight = image.naturalHeight || image.videoHeight || image.height;
+        if (!imageWidth || !imageHeight)
+            return null;
+
+        var imageCanvas = new OffscreenCanvas(imageWidth, imageHeight);
+        imageCanvas.getContext('2d').drawImage(image, 0, 0);
+        return imageCanvas.transferToImageBitmap();
+
+    };
+
+    /**
+     * Set to true if this layer should resize itself to accommodate the
+     * dimensions of any drawing operation, and false (the default) otherwise.
+     * Note that the width and height of this layer do not reflect any such
+     * automatic resizing, which occurs only within the worker.
+     *
+     * @name Guacamole.OffscreenRenderer.Layer#autosize
+     * @type {Boolean}
+     */
+    Object.defineProperty(this, 'autosize', {
+        get : function getAutosize() {
+            return autosize;
+        },
+        set : function setAutosize(value) {
+            autosize = !!value;
+            renderer.send(['autosize', id, autosize]);
+        }
+    });
+
+    /**
+     * The current width of this layer.
+     *
+     * @type {Number}
+     */
+    this.width = width;
+
+    /**
+     * The current height of this layer.
+     *
+     * @type {Number}
+     */
+    this.height = height;
+
+    /**
+     * Returns the placeholder canvas element displaying the contents of this
+     * layer. The contents of this canvas cannot be read.
+     *
+     * @returns {HTMLCanvasElement}
+     *     The placeholder canvas element of this layer, or null if this layer
+     *     is not visible.
+     */
+    this.getCanvas = function getCanvas() {
+        return canvas;
+    };
+
+    /**
+     * Releases all resources associated with this layer within the worker.
+     * The layer must not be used after this function is invoked.
+     */
+    this.free = function free() {
+        renderer.send(['dispose', id]);
+    };
+
+    /**
+     * @see Guacamole.Layer#resize
+     */
+    this.resize = function resize(newWidth, newHeight) {
+        if (newWidth !== layer.width || newHeight !== layer.height) {
+            layer.width = newWidth;
+            layer.height = newHeight;
+            renderer.send(['resize', id, newWidth, newHeight]);
+        }
+    };
+
+    /**
+     * @see Guacamole.Layer#drawImage
+     */
+    this.drawImage = function drawImage(x, y, image) {
+        var bitmap = toImageBitmap(image);
+        if (bitmap)
+            renderer.send(['drawImage', id, x, y, bitmap], bitmap);
+    };
+
+    /**
+     * @see Guacamole.Layer#transfer
+     */
+    this.transfer = function transfer(srcLayer, srcx, srcy, srcw, srch, x, y, transferFunction) {
+        var index = getTransferFunctionIndex(transferFunction);
+        if (index !== -1)
+            renderer.send(['transfer', id, getID(srcLayer), srcx, srcy, srcw, srch, x, y, index]);
+    };
+
+    /**
+     * @see Guacamole.Layer#put
+     */
+    this.put = function put(srcLayer, srcx, srcy, srcw, srch, x, y) {
+        renderer.send(['put', id, getID(srcLayer), srcx, srcy, srcw, srch, x, y]);
+    };
+
+    /**
+     * @see Guacamole.Layer#copy
+     */
+    this.copy = function copy(srcLayer, srcx, srcy, srcw, srch, x, y) {
+        renderer.send(['copy', id, getID(srcLayer), srcx, srcy, srcw, srch, x, y]);
+    };
+
+    /**
+     * @see Guacamole.Layer#moveTo
+     */
+    this.moveTo = function moveTo(x, y) {
+        renderer.send(['moveTo', id, x, y]);
+    };
+
+    /**
+     * @see Guacamole.Layer#lineTo
+     */
+    this.lineTo = function lineTo(x, y) {
+        renderer.send(['lineTo', id, x, y]);
+    };
+
+    /**
+     * @see Guacamole.Layer#arc
+     */
+    this.arc = function arc(x, y, radius, startAngle, endAngle, negative) {
+        renderer.send(['arc', id, x, y, radius, startAngle, endAngle, negative]);
+    };
+
+    /**
+     * @see Guacamole.Layer#curveTo
+     */
+    this.curveTo = function curveTo(cp1x, cp1y, cp2x, cp2y, x, y) {
+        renderer.send(['curveTo', id, cp1x, cp1y, cp2x, cp2y, x, y]);
+    };
+
+    /**
+     * @see Guacamole.Layer#close
+     */
+    this.close = function close() {
+        renderer.send(['close', id]);
+    };
+
+    /**
+     * @see Guacamole.Layer#rect
+     */
+    this.rect = function rect(x, y, w, h) {
+        renderer.send(['rect', id, x, y, w, h]);
+    };
+
+    /**
+     * @see Guacamole.Layer#clip
+     */
+    this.clip = function clip() {
+        renderer.send(['clip', id]);
+    };
+
+    /**
+     * @see Guacamole.Layer#strokeColor
+     */
+    this.strokeColor = function strokeColor(cap, join, thickness, r, g, b, a) {
+        renderer.send(['strokeColor', id, cap, join, thickness, r, g, b, a]);
+    };
+
+    /**
+     * @see Guacamole.Layer#fillColor
+     */
+    this.fillColor = function fillColor(r, g, b, a) {
+        renderer.send(['fillColor', id, r, g, b, a]);
+    };
+
+    /**
+     * @see Guacamole.Layer#strokeLayer
+     */
+    this.strokeLayer = function strokeLayer(cap, join, thickness, srcLayer) {
+        renderer.send(['strokeLayer', id, cap, join, thickness, getID(srcLayer)]);
+    };
+
+    /**
+     * @see Guacamole.Layer#fillLayer
+     */
+    this.fillLayer = function fillLayer(srcLayer) {
+        renderer.send(['fillLayer', id, getID(srcLayer)]);
+    };
+
+    /**
+     * @see Guacamole.Layer#push
+     */
+    this.push = function push() {
+        renderer.send(['push', id]);
+    };
+
+    /**
+     * @see Guacamole.Layer#pop
+     */
+    this.pop = function pop() {
+        renderer.send(['pop', id]);
+    };
+
+    /**
+     * @see Guacamole.Layer#reset
+     */
+    this.reset = function reset() {
+        renderer.send(['reset', id]);
+    };
+
+    /**
+     * @see Guacamole.Layer#setTransform
+     */
+    this.setTransform = function setTransform(a, b, c, d, e, f) {
+        renderer.send(['setTransform', id, a, b, c, d, e, f]);
+    };
+
+    /**
+     * @see Guacamole.Layer#transform
+     */
+    this.transform = function transform(a, b, c, d, e, f) {
+        renderer.send(['transform', id, a, b, c, d, e, f]);
+    };
+
+    /**
+     * @see Guacamole.Layer#setChannelMask
+     */
+    this.setChannelMask = function setChannelMask(mask) {
+        renderer.send(['setChannelMask', id, mask]);
+    };
+
+    /**
+     * @see Guacamole.Layer#setMiterLimit
+     */
+    this.setMiterLimit = function setMiterLimit(limit) {
+        renderer.send(['setMiterLimit', id, limit]);
+    };
+
+};
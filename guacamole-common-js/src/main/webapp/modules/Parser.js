@@ -22,7 +22,15 @@ var Guacamole = Guacamole || {};
 /**
  * Simple Guacamole protocol parser that invokes an oninstruction event when
  * full instructions are available from data received via receive().
- * 
+ *
+ * Received data is parsed incrementally as it arrives. Element lengths are
+ * accumulated digit by digit, element values are extracted directly from the
+ * received data, and only the portion of an element which spans multiple
+ * calls to receive() is ever buffered, such that previously-parsed data is
+ * never copied or rescanned. The array of parameters provided to
+ * oninstruction is reused for every instruction, and must not be retained by
+ * the handler beyond the duration of the call.
+ *
  * @constructor
  */
 Guacamole.Parser = function() {
@@ -34,117 +42,293 @@ Guacamole.Parser = function() {
     var parser = this;
 
     /**
-     * Current buffer of received data. This buffer grows until a full
-     * element is available. After a full element is available, that element
-     * is flushed into the element buffer.
-     * 
+     * Parse state in which the decimal length prefix of an element is being
+     * read.
+     *
      * @private
+     * @constant
+     * @type {Number}
      */
-    var buffer = "";
+    var STATE_LENGTH = 0;
 
     /**
-     * Buffer of all received, complete elements. After an entire instruction
-     * is read, this buffer is flushed, and a new instruction begins.
-     * 
+     * Parse state in which the value of an element is being read.
+     *
      * @private
+     * @constant
+     * @type {Number}
      */
-    var element_buffer = [];
+    var STATE_VALUE = 1;
 
-    // The location of the last element's terminator
-    var element_end = -1;
+    /**
+     * Parse state in which the terminator following an element is expected.
+     *
+     * @private
+     * @constant
+     * @type {Number}
+     */
+    var STATE_TERMINATOR = 2;
 
-    // Where to start the next length search or the next element
-    var start_index = 0;
+    /**
+     * The character code of the period which separates the length prefix of
+     * an element from its value.
+     *
+     * @private
+     * @constant
+     * @type {Number}
+     */
+    var PERIOD = 0x2E;
 
     /**
-     * Appends the given instruction data packet to the internal buffer of
-     * this Guacamole.Parser, executing all completed instructions at
-     * the beginning of this buffer, if any.
+     * The character code of the comma which terminates each element other
+     * than the last element of an instruction.
      *
-     * @param {String} packet The instruction data to receive.
+     * @private
+     * @constant
+     * @type {Number}
      */
-    this.receive = function(packet) {
+    var COMMA = 0x2C;
+
+    /**
+     * The character code of the semicolon which terminates the last element
+     * of an instruction.
+     *
+     * @private
+     * @constant
+     * @type {Number}
+     */
+    var SEMICOLON = 0x3B;
+
+    /**
+     * The character code of the digit "0".
+     *
+     * @private
+     * @constant
+     * @type {Number}
+     */
+    var DIGIT_ZERO = 0x30;
 
-        // Truncate buffer as necessary
-        if (start_index > 4096 && element_end >= start_index) {
+    /**
+     * The current parse state.
+     *
+     * @private
+     * @type {Number}
+     */
+    var state = STATE_LENGTH;
 
-            buffer = buffer.substring(start_index);
+    /**
+     * The length of the current element, as accumulated so far from its
+     * length prefix.
+     *
+     * @private
+     * @type {Number}
+     */
+    var elementLength = 0;
 
-            // Reset parse relative to truncation
-            element_end -= start_index;
-            start_index = 0;
+    /**
+     * Whether at least one digit of the length prefix of the current element
+     * has been read.
+     *
+     * @private
+     * @type {Boolean}
+     */
+    var lengthDigits = false;
 
-        }
+    /**
+     * The portion of the current element value received by previous calls
+     * to receive(), if the value spans multiple calls. Values which are
+     * received in their entirety in a single call are never buffered here.
+     *
+     * @private
+     * @type {String}
+     */
+    var partialValue = "";
+
+    /**
+     * The opcode of the instruction currently being parsed, or null if the
+     * opcode has not yet been read.
+     *
+     * @private
+     * @type {String}
+     */
+    var opcode = null;
+
+    /**
+     * All parameters of the instruction currently being parsed which have
+     * been read so far. This array is reused for every instruction.
+     *
+     * @private
+     * @type {String[]}
+     */
+    var parameters = [];
 
-        // Append data to buffer
-        buffer += packet;
+    /**
+     * The decoder used to convert received binary data into text, or null if
+     * no binary data has yet been received.
+     *
+     * @private
+     * @type {TextDecoder}
+     */
+    var decoder = null;
 
-        // While search is within currently received data
-        while (element_end < buffer.length) {
+    /**
+     * Stores the given fully-read element value as the opcode or next
+     * parameter of the current instruction.
+     *
+     * @private
+     * @param {String} value
+     *     The value of the element.
+     */
+    var completeElement = function completeElement(value) {
 
-            // If we are waiting for element data
-            if (element_end >= start_index) {
+        if (opcode === null)
+            opcode = value;
+        else
+            parameters.push(value);
 
-                // We now have enough data for the element. Parse.
-                var element = buffer.substring(start_index, element_end);
-                var terminator = buffer.substring(element_end, element_end+1);
+        state = STATE_TERMINATOR;
 
-                // Add element to array
-                element_buffer.push(element);
+    };
 
-                // If last element, handle instruction
-                if (terminator == ";") {
+    /**
+     * Parses the given text, which must immediately follow any text
+     * previously parsed, invoking oninstruction for each instruction which is
+     * completed.
+     *
+     * @private
+     * @param {String} packet
+     *     The text to parse.
+     */
+    var parse = function parse(packet) {
 
-                    // Get opcode
-                    var opcode = element_buffer.shift();
+        var length = packet.length;
+        var index = 0;
 
-                    // Call instruction handler.
-                    if (parser.oninstruction != null)
-                        parser.oninstruction(opcode, element_buffer);
+        while (index < length) {
 
-                    // Clear elements
-                    element_buffer.length = 0;
+            switch (state) {
 
-                }
-                else if (terminator != ',')
-                    throw new Error("Illegal terminator.");
+                // Accumulate length prefix until period
+                case STATE_LENGTH:
 
-                // Start searching for length at character after
-                // element terminator
-                start_index = element_end + 1;
+                    var c = packet.charCodeAt(index++);
+                    if (c === PERIOD) {
 
-            }
+                        if (!lengthDigits)
+                            throw new Error("Element length is missing.");
 
-            // Search for end of length
-            var length_end = buffer.indexOf(".", start_index);
-            if (length_end != -1) {
+                        state = STATE_VALUE;
 
-                // Parse length
-                var length = parseInt(buffer.substring(element_end+1, length_end));
-                if (isNaN(length))
-                    throw new Error("Non-numeric character in element length.");
+                        // Zero-length elements need no further data
+                        if (elementLength === 0)
+                            completeElement("");
 
-                // Calculate start of element
-                start_index = length_end + 1;
+                    }
+                    else {
 
-                // Calculate location of element terminator
-                element_end = start_index + length;
+                        var digit = c - DIGIT_ZERO;
+                        if (digit < 0 || digit > 9)
+                            throw new Error("Non-numeric character in element length.");
+
+                        elementLength = elementLength * 10 + digit;
+                        lengthDigits = true;
+
+                    }
+
+                    break;
+
+                // Read element value, buffering only if incomplete
+                case STATE_VALUE:
+
+                    var remaining = elementLength - partialValue.length;
+                    var available = length - index;
+
+                    // Entire value (or remainder of value) is available
+                    if (available >= remaining) {
+                        var end = index + remaining;
+                        if (partialValue.length)
+                            completeElement(partialValue + packet.substring(index, end));
+                        else
+                            completeElement(packet.substring(index, end));
+                        partialValue = "";
+                        index = end;
+                    }
+
+                    // Otherwise, wait for more data
+                    else {
+                        partialValue += packet.substring(index);
+                        index = length;
+                    }
+
+                    break;
+
+                // Handle end of element
+                case STATE_TERMINATOR:
+
+                    var terminator = packet.charCodeAt(index++);
+
+                    // Reset for next element
+                    state = STATE_LENGTH;
+                    elementLength = 0;
+                    lengthDigits = false;
+
+                    // If last element, handle instruction
+                    if (terminator === SEMICOLON) {
+
+                        var instructionOpcode = opcode;
+                        opcode = null;
+
+                        try {
+                            if (parser.oninstruction)
+                                parser.oninstruction(instructionOpcode, parameters);
+                        }
+
+                        // Clear parameters for next instruction
+                        finally {
+                            parameters.length = 0;
+                        }
+
+                    }
+                    else if (terminator !== COMMA)
+                        throw new Error("Illegal terminator.");
+
+                    break;
 
-            }
-            
-            // If no period yet, continue search when more data
-            // is received
-            else {
-                start_index = buffer.length;
-                break;
             }
 
-        } // end parse loop
+        }
+
+    };
+
+    /**
+     * Appends the given instruction data packet to the internal buffer of
+     * this Guacamole.Parser, executing all completed instructions at
+     * the beginning of this buffer, if any.
+     *
+     * Binary data, provided as an ArrayBuffer or Uint8Array, is decoded as
+     * UTF-8 using a streaming TextDecoder, such that multibyte characters
+     * split across packets are decoded correctly. Binary data may only be
+     * provided if TextDecoder is supported by the browser (see
+     * {@link Guacamole.Parser.isBinarySupported}).
+     *
+     * @param {String|ArrayBuffer|Uint8Array} packet The instruction data to receive.
+     */
+    this.receive = function(packet) {
+
+        // Decode binary data as UTF-8, retaining incomplete characters
+        if (typeof packet !== 'string') {
+            decoder = decoder || new TextDecoder('utf-8');
+            packet = decoder.decode(packet, { stream : true });
+        }
+
+        parse(packet);
 
     };
 
     /**
      * Fired once for every complete Guacamole instruction received, in order.
+     * The array of parameters is reused for subsequent instructions and must
+     * be copied if needed beyond the duration of this call.
      * 
      * @event
      * @param {String} opcode The Guacamole instruction opcode.
@@ -154,3 +338,16 @@ Guacamole.Parser = function() {
     this.oninstruction = null;
 
 };
+
+/**
+ * Returns whether binary data (ArrayBuffer or Uint8Array) may be provided to
+ * {@link Guacamole.Parser#receive}. This requires browser support for
+ * TextDecoder.
+ *
+ * @returns {Boolean}
+ *     true if binary data may be provided to Guacamole.Parser, false
+ *     otherwise.
+ */
+Guacamole.Parser.isBinarySupported = function isBinarySupported() {
+    return typeof TextDecoder !== 'undefined';
+};
@@ -26,12 +26,24 @@ var Guacamole = Guacamole || {};
  * controlled through function calls to the Guacamole.SessionRecording, even
  * while the recording has not yet finished being created or downloaded.
  *
+ * If the tunnel provides a readRange() function, as with
+ * {@link Guacamole.StaticHTTPTunnel}, and the server is found to support
+ * reading ranges of the recording, only a bounded window of parsed frames is
+ * kept in memory, and frames outside that window are read again on demand
+ * using their byte offsets within the recording. If an index of the recording
+ * is also provided, the recording is not downloaded in full at all.
+ *
  * @constructor
  * @param {Guacamole.Tunnel} tunnel
  *     The Guacamole.Tunnel from which the instructions of the recording should
  *     be read.
+ *
+ * @param {Guacamole.SessionRecording.Index|Object} [index]
+ *     A previously-generated index of the recording, as returned by
+ *     getIndex(), or an equivalent object parsed from JSON. The index is used
+ *     only if the tunnel provides a readRange() function.
  */
-Guacamole.SessionRecording = function SessionRecording(tunnel) {
+Guacamole.SessionRecording = function SessionRecording(tunnel, index) {
 
     /**
      * Reference to this Guacamole.SessionRecording.
@@ -42,34 +54,79 @@ Guacamole.SessionRecording = function SessionRecording(tunnel) {
     var recording = this;
 
     /**
-     * The minimum number of characters which must have been read between
-     * keyframes.
+     * The maximum amount of time to spend in any particular seek operation
+     * before returning control to the main thread, in milliseconds. Seek
+     * operations exceeding this amount of time will proceed asynchronously.
      *
      * @private
      * @constant
      * @type {Number}
      */
-    var KEYFRAME_CHAR_INTERVAL = 16384;
+    var MAXIMUM_SEEK_TIME = 5;
 
     /**
-     * The minimum number of milliseconds which must elapse between keyframes.
+     * The maximum number of bytes to read in any single range request when
+     * reading frames on demand. At least one frame is always read,
+     * regardless of its size.
      *
      * @private
      * @constant
      * @type {Number}
      */
-    var KEYFRAME_TIME_INTERVAL = 5000;
+    var MAXIMUM_RANGE_SIZE = 1048576;
 
     /**
-     * The maximum amount of time to spend in any particular seek operation
-     * before returning control to the main thread, in milliseconds. Seek
-     * operations exceeding this amount of time will proceed asynchronously.
+     * Whether frames may be read from the tunnel on demand using their byte
+     * offsets. Whether doing so is efficient depends on whether the server
+     * supports range requests, as determined by isRangeSupported().
      *
      * @private
-     * @constant
-     * @type {Number}
+     * @type {Boolean}
      */
-    var MAXIMUM_SEEK_TIME = 5;
+    var rangeReadable = typeof tunnel.readRange === 'function'
+                     && Guacamole.Parser.isBinarySupported();
+
+    /**
+     * Whether all frames are known from the provided index, such that the
+     * recording need not be downloaded in full.
+     *
+     * @private
+     * @type {Boolean}
+     */
+    var indexed = rangeReadable && !!index;
+
+    /**
+     * Whether a range request has already been made solely to test whether
+     * the server supports range requests. Such a request is made at most
+     * once.
+     *
+     * @private
+     * @type {Boolean}
+     */
+    var rangeProbed = false;
+
+    /**
+     * Returns whether frames may be read again from the tunnel on demand
+     * without downloading the entire recording, and thus need not all be
+     * kept in memory. Tunnels which provide readRange() but do not report
+     * whether ranges are supported are assumed to support them.
+     *
+     * @private
+     * @returns {Boolean}
+     *     true if ranges of the recording can be read efficiently, false if
+     *     they cannot, or null if this is not yet known.
+     */
+    var isRangeSupported = function isRangeSupported() {
+
+        if (!rangeReadable)
+            return false;
+
+        if (typeof tunnel.isRangeSupported !== 'function')
+            return true;
+
+        return tunnel.isRangeSupported();
+
+    };
 
     /**
      * All frames parsed from the provided tunnel.
@@ -89,22 +146,91 @@ Guacamole.SessionRecording = function SessionRecording(tunnel) {
     var instructions = [];
 
     /**
-     * The approximate number of characters which have been read from the
-     * provided tunnel since the last frame was flagged for use as a keyframe.
+     * The byte offset within the recording of the first instruction which has
+     * been read since the last frame was added to the frames array.
      *
      * @private
      * @type {Number}
      */
-    var charactersSinceLastKeyframe = 0;
+    var frameStart = 0;
+
+    /**
+     * The byte offset within the recording immediately following the last
+     * instruction read.
+     *
+     * @private
+     * @type {Number}
+     */
+    var position = 0;
+
+    /**
+     * All frames whose instructions are currently held in memory, in the
+     * order they were parsed. This is maintained only if frames may be read
+     * again on demand.
+     *
+     * @private
+     * @type {Guacamole.SessionRecording._Frame[]}
+     */
+    var loadedFrames = [];
+
+    /**
+     * The number of bytes of the recording represented by the instructions
+     * of all frames within the loadedFrames array.
+     *
+     * @private
+     * @type {Number}
+     */
+    var frameMemory = 0;
+
+    /**
+     * The object representing the range request currently being awaited by
+     * the in-progress seek operation, if any. Range requests which complete
+     * after their seek has been aborted are not acted upon.
+     *
+     * @private
+     * @type {Object}
+     */
+    var pendingRead = null;
+
+    /**
+     * The number of milliseconds spent replaying and rendering frames since
+     * the playback client was last at the state of a keyframe. Once this
+     * exceeds keyframeInterval, the frame being replayed is flagged for use
+     * as a keyframe.
+     *
+     * @private
+     * @type {Number}
+     */
+    var replayCost = 0;
+
+    /**
+     * All frames having stored client state, in order of least-recent use.
+     * The client state of the first frame of the recording is never evicted
+     * and is thus not included.
+     *
+     * @private
+     * @type {Guacamole.SessionRecording._Frame[]}
+     */
+    var keyframes = [];
 
     /**
-     * The timestamp of the last frame which was flagged for use as a keyframe.
-     * If no timestamp has yet been flagged, this will be 0.
+     * The frame whose client state was most recently imported into the
+     * playback client, if any. The client state of this frame may still be in
+     * use by pending drawing operations, and is thus never evicted.
+     *
+     * @private
+     * @type {Guacamole.SessionRecording._Frame}
+     */
+    var restoredKeyframe = null;
+
+    /**
+     * The approximate number of bytes of image data currently held by the
+     * client state of all frames within the keyframes array.
      *
      * @private
      * @type {Number}
      */
-    var lastKeyframeTimestamp = 0;
+    var keyframeMemory = 0;
 
     /**
      * Tunnel which feeds arbitrary instructions to the client used by this
@@ -167,13 +293,180 @@ Guacamole.SessionRecording = function SessionRecording(tunnel) {
     // Hide cursor unless mouse position is received
     playbackClient.getDisplay().showCursor(false);
 
+    // Include time spent rendering replayed frames in the cost of reaching
+    // the current frame from the last keyframe
+    playbackClient.getDisplay().onrender = function frameRendered(count, duration) {
+        replayCost += duration;
+    };
+
+    /**
+     * Discards the instructions of the oldest loaded frames as necessary to
+     * remain within frameMemoryLimit. Frames are discarded only if the server
+     * is known to support range requests. If this is not yet known, a range
+     * request for the first frame is made to find out, and frames are
+     * retained until the result is known. If the result is never known, all
+     * frames are retained.
+     *
+     * @private
+     */
+    var trimFrames = function trimFrames() {
+
+        if (frameMemory <= recording.frameMemoryLimit)
+            return;
+
+        var supported = isRangeSupported();
+
+        // Test whether ranges are supported if not yet known, trimming again
+        // once the result is known
+        if (supported === null) {
+            if (!rangeProbed && frames.length) {
+                rangeProbed = true;
+                tunnel.readRange(frames[0].start, frames[0].end, function probeComplete() {
+                    if (isRangeSupported() !== null)
+                        trimFrames();
+                });
+            }
+            return;
+        }
+
+        // Retain all frames if they cannot be read again efficiently
+        if (!supported) {
+            loadedFrames = [];
+            frameMemory = 0;
+            return;
+        }
+
+        // Discard oldest frames until within budget, always retaining the
+        // most recently loaded frame
+        while (frameMemory > recording.frameMemoryLimit && loadedFrames.length > 1) {
+            var discarded = loadedFrames.shift();
+            frameMemory -= discarded.end - discarded.start;
+            discarded.instructions = null;
+        }
+
+    };
+
+    /**
+     * Records that the instructions of the given frame are now held in
+     * memory, discarding the instructions of the oldest loaded frames as
+     * necessary to remain within frameMemoryLimit. If frames cannot be read
+     * again on demand without downloading the entire recording, all frames
+     * are retained and this function has no effect.
+     *
+     * @private
+     * @param {Guacamole.SessionRecording._Frame} frame
+     *     The frame whose instructions were just parsed.
+     */
+    var frameLoaded = function frameLoaded(frame) {
+
+        if (isRangeSupported() === false)
+            return;
+
+        loadedFrames.push(frame);
+        frameMemory += frame.end - frame.start;
+        trimFrames();
+
+    };
+
+    /**
+     * Reads the instructions of the given frame, and of as many unloaded
+     * frames following it as fit within MAXIMUM_RANGE_SIZE, from the tunnel
+     * using a single range request. If the server is known not to support
+     * range requests, every following unloaded frame is read, as the entire
+     * recording is downloaded regardless. The callback is invoked once those
+     * frames are loaded, unless the in-progress seek operation has been
+     * aborted in the meantime.
+     *
+     * @private
+     * @param {Number} index
+     *     The index of the first frame to read.
+     *
+     * @param {function} callback
+     *     The callback to invoke once the frames have been read.
+     */
+    var readFrames = function readFrames(index, callback) {
+
+        var start = frames[index].start;
+        var limit = isRangeSupported() === false ? Infinity : MAXIMUM_RANGE_SIZE;
+
+        // Extend range over following unloaded frames while within limit
+        var last = index;
+        while (last + 1 < frames.length && !frames[last + 1].instructions
+                && frames[last + 1].end - start <= limit)
+            last++;
+
+        var request = pendingRead = {};
+        tunnel.readRange(start, frames[last].end, function rangeRead(data) {
+
+            // Abort seek if frames could not be read
+            if (!data) {
+                if (pendingRead === request)
+                    recording.pause();
+                return;
+            }
+
+            // Parse instructions of each frame within range
+            var parser = new Guacamole.Parser();
+            var frameIndex = index;
+            var parsed = [];
+
+            parser.oninstruction = function instructionRead(opcode, args) {
+
+                parsed.push(new Guacamole.SessionRecording._Frame.Instruction(opcode, args.slice()));
+
+                // Each sync instruction terminates the current frame
+                if (opcode === 'sync') {
+                    var frame = frames[frameIndex++];
+                    if (frame && !frame.instructions) {
+                        frame.instructions = parsed;
+                        frameLoaded(frame);
+                    }
+                    parsed = [];
+                }
+
+            };
+
+            parser.receive(data);
+
+            // Continue seek only if it is still in progress
+            if (pendingRead === request) {
+                pendingRead = null;
+                callback();
+            }
+
+        });
+
+    };
+
+    // Populate frames from index, if provided, such that their instructions
+    // are read only on demand
+    if (indexed) {
+
+        index = new Guacamole.SessionRecording.Index(index);
+
+        for (var i = 0; i < index.timestamps.length; i++) {
+            var indexedFrame = new Guacamole.SessionRecording._Frame(index.timestamps[i],
+                    null, index.offsets[i], index.offsets[i + 1]);
+            frames.push(indexedFrame);
+        }
+
+        for (var j = 0; j < index.keyframes.length; j++) {
+            if (frames[index.keyframes[j]])
+                frames[index.keyframes[j]].keyframe = true;
+        }
+
+        if (frames.length)
+            frames[0].keyframe = true;
+
+    }
+
     // Read instructions from provided tunnel, extracting each frame
     tunnel.oninstruction = function handleInstruction(opcode, args) {
 
         // Store opcode and arguments for received instruction
         var instruction = new Guacamole.SessionRecording._Frame.Instruction(opcode, args.slice());
         instructions.push(instruction);
-        charactersSinceLastKeyframe += instruction.getSize();
+        position += instruction.getSize();
 
         // Once a sync is received, store all instructions since the last
         // frame as a new frame
@@ -183,18 +476,16 @@ Guacamole.SessionRecording = function SessionRecording(tunnel) {
             var timestamp = parseInt(args[0]);
 
             // Add a new frame containing the instructions read since last frame
-            var frame = new Guacamole.SessionRecording._Frame(timestamp, instructions);
+            var frame = new Guacamole.SessionRecording._Frame(timestamp, instructions,
+                    frameStart, position);
             frames.push(frame);
+            frameStart = position;
+            frameLoaded(frame);
 
-            // This frame should eventually become a keyframe if enough data
-            // has been processed and enough recording time has elapsed, or if
-            // this is the absolute first frame
-            if (frames.length === 1 || (charactersSinceLastKeyframe >= KEYFRAME_CHAR_INTERVAL
-                    && timestamp - lastKeyframeTimestamp >= KEYFRAME_TIME_INTERVAL)) {
+            // The absolute first frame is always a keyframe. All other
+            // keyframes are chosen during replay based on measured cost.
+            if (frames.length === 1)
                 frame.keyframe = true;
-                lastKeyframeTimestamp = timestamp;
-                charactersSinceLastKeyframe = 0;
-            }
 
             // Clear set of instructions in preparation for next frame
             instructions = [];
@@ -275,9 +566,122 @@ Guacamole.SessionRecording = function SessionRecording(tunnel) {
 
     };
 
+    /**
+     * Returns the approximate number of bytes of image data held by the given
+     * client state.
+     *
+     * @private
+     * @param {Object} state
+     *     An opaque representation of Guacamole.Client state from a prior call
+     *     to exportState().
+     *
+     * @returns {Number}
+     *     The approximate number of bytes of image data held by the given
+     *     client state.
+     */
+    var getStateSize = function getStateSize(state) {
+
+        var size = 0;
+
+        for (var key in state.layers) {
+            var layer = state.layers[key];
+            if (layer.bitmap)
+                size += layer.width * layer.height * 4;
+            else if (layer.url)
+                size += layer.url.length;
+        }
+
+        return size;
+
+    };
+
+    /**
+     * Marks the client state of the given frame as most recently used,
+     * protecting it from eviction.
+     *
+     * @private
+     * @param {Guacamole.SessionRecording._Frame} frame
+     *     The frame whose client state was just used.
+     */
+    var touchKeyframe = function touchKeyframe(frame) {
+        var index = keyframes.indexOf(frame);
+        if (index !== -1) {
+            keyframes.splice(index, 1);
+            keyframes.push(frame);
+        }
+    };
+
+    /**
+     * Releases the given client state once all drawing operations already
+     * queued within the display of the playback client have been performed,
+     * such that any pending import of that state is not affected.
+     *
+     * @private
+     * @param {Object} state
+     *     An opaque representation of Guacamole.Client state from a prior call
+     *     to exportState().
+     */
+    var releaseState = function releaseState(state) {
+        playbackClient.getDisplay().flush(function stateUnused() {
+            playbackClient.releaseState(state);
+        });
+    };
+
+    /**
+     * Stores the given client state within the given frame, evicting the
+     * client state of least-recently used keyframes as necessary to remain
+     * within keyframeMemoryLimit. The client state of the first frame is
+     * never evicted, as seeking requires at least one keyframe, nor is the
+     * client state being stored or that most recently restored. The limit
+     * may thus be exceeded if those states alone exceed it.
+     *
+     * @private
+     * @param {Guacamole.SessionRecording._Frame} frame
+     *     The frame which should receive the given client state.
+     *
+     * @param {Object} state
+     *     An opaque representation of Guacamole.Client state from a prior call
+     *     to exportState().
+     */
+    var storeKeyframe = function storeKeyframe(frame, state) {
+
+        // Ignore duplicate snapshots of the same frame
+        if (frame.clientState) {
+            playbackClient.releaseState(state);
+            return;
+        }
+
+        frame.clientState = state;
+        if (frame === frames[0])
+            return;
+
+        keyframes.push(frame);
+        keyframeMemory += getStateSize(state);
+
+        // Evict least-recently used keyframes until within budget
+        var i = 0;
+        while (keyframeMemory > recording.keyframeMemoryLimit && i < keyframes.length) {
+
+            var evicted = keyframes[i];
+            if (evicted === frame || evicted === restoredKeyframe) {
+                i++;
+                continue;
+            }
+
+            keyframes.splice(i, 1);
+            keyframeMemory -= getStateSize(evicted.clientState);
+            releaseState(evicted.clientState);
+            evicted.clientState = null;
+
+        }
+
+    };
+
     /**
      * Replays the instructions associated with the given frame, sending those
-     * instructions to the playback client.
+     * instructions to the playback client. If replaying frames since the last
+     * keyframe has become sufficiently costly, the frame is flagged as a
+     * keyframe.
      *
      * @private
      * @param {Number} index
@@ -287,6 +691,7 @@ Guacamole.SessionRecording = function SessionRecording(tunnel) {
     var replayFrame = function replayFrame(index) {
 
         var frame = frames[index];
+        var startTime = new Date().getTime();
 
         // Replay all instructions within the retrieved frame
         for (var i = 0; i < frame.instructions.length; i++) {
@@ -294,11 +699,23 @@ Guacamole.SessionRecording = function SessionRecording(tunnel) {
             playbackTunnel.receiveInstruction(instruction.opcode, instruction.args);
         }
 
-        // Store client state if frame is flagged as a keyframe
-        if (frame.keyframe && !frame.clientState) {
+        // Flag frame as a keyframe once reaching it from the last keyframe
+        // has become too costly
+        replayCost += new Date().getTime() - startTime;
+        if (replayCost >= recording.keyframeInterval)
+            frame.keyframe = true;
+
+        if (!frame.keyframe)
+            return;
+
+        // Seeking from this frame need only replay subsequent frames
+        replayCost = 0;
+
+        // Asynchronously store client state if not already stored
+        if (!frame.clientState) {
             playbackClient.exportState(function storeClientState(state) {
-                frame.clientState = state;
-            });
+                storeKeyframe(frame, state);
+            }, true);
         }
 
     };
@@ -346,6 +763,9 @@ Guacamole.SessionRecording = function SessionRecording(tunnel) {
                 // current state
                 if (frame.clientState) {
                     playbackClient.importState(frame.clientState);
+                    restoredKeyframe = frame;
+                    touchKeyframe(frame);
+                    replayCost = 0;
                     break;
                 }
 
@@ -364,6 +784,10 @@ Guacamole.SessionRecording = function SessionRecording(tunnel) {
                 if (currentTime - startTime >= MAXIMUM_SEEK_TIME)
                     break;
 
+                // Stop seeking if the frame must first be read
+                if (!frames[startIndex].instructions)
+                    break;
+
                 replayFrame(startIndex);
             }
 
@@ -374,8 +798,15 @@ Guacamole.SessionRecording = function SessionRecording(tunnel) {
             if (recording.onseek)
                 recording.onseek(recording.getPosition());
 
+            // If the next frame is not loaded, continue once it has been read
+            if (currentFrame !== index && !frames[startIndex].instructions)
+                readFrames(startIndex, function framesRead() {
+                    seekToFrame(index, callback,
+                        Math.max(delay - (new Date().getTime() - startTime), 0));
+                });
+
             // If the seek operation has not yet completed, schedule continuation
-            if (currentFrame !== index)
+            else if (currentFrame !== index)
                 seekToFrame(index, callback,
                     Math.max(delay - (new Date().getTime() - startTime), 0));
 
@@ -395,6 +826,7 @@ Guacamole.SessionRecording = function SessionRecording(tunnel) {
      */
     var abortSeek = function abortSeek() {
         window.clearTimeout(seekTimeout);
+        pendingRead = null;
     };
 
     /**
@@ -433,6 +865,38 @@ Guacamole.SessionRecording = function SessionRecording(tunnel) {
 
     };
 
+    /**
+     * The approximate number of milliseconds of replay and rendering which
+     * may be required to reach any frame from the nearest keyframe. Frames
+     * are flagged as keyframes during replay based on the measured cost of
+     * replaying the frames preceding them, such that recordings which are
+     * expensive to render receive more frequent keyframes.
+     *
+     * @type {Number}
+     */
+    this.keyframeInterval = 100;
+
+    /**
+     * The maximum approximate number of bytes of image data which may be
+     * held by stored keyframes. Once exceeded, the least-recently used
+     * keyframes are discarded, and will be recreated if replayed again.
+     *
+     * @type {Number}
+     */
+    this.keyframeMemoryLimit = 256 * 1024 * 1024;
+
+    /**
+     * The maximum approximate number of bytes of the recording whose parsed
+     * instructions may be held in memory at any one time. Once exceeded, the
+     * instructions of the oldest loaded frames are discarded, and will be
+     * read again on demand. This applies only if the tunnel provides a
+     * readRange() function and the server supports range requests;
+     * otherwise, all frames are kept in memory.
+     *
+     * @type {Number}
+     */
+    this.frameMemoryLimit = 64 * 1024 * 1024;
+
     /**
      * Fired when new frames have become available while the recording is
      * being downloaded.
@@ -478,7 +942,16 @@ Guacamole.SessionRecording = function SessionRecording(tunnel) {
      *     The data to send to the tunnel when connecting.
      */
     this.connect = function connect(data) {
+
+        // All frames are already known if an index was provided
+        if (indexed) {
+            if (recording.onprogress)
+                recording.onprogress(recording.getDuration());
+            return;
+        }
+
         tunnel.connect(data);
+
     };
 
     /**
@@ -489,12 +962,47 @@ Guacamole.SessionRecording = function SessionRecording(tunnel) {
         tunnel.disconnect();
     };
 
+    /**
+     * Returns an index of all frames of the recording received thus far,
+     * including the frames chosen as keyframes during playback. The index may
+     * be serialized as JSON and provided when this recording is next loaded,
+     * avoiding a full download of the recording.
+     *
+     * @returns {Guacamole.SessionRecording.Index}
+     *     An index of all frames of the recording received thus far.
+     */
+    this.getIndex = function getIndex() {
+
+        var result = new Guacamole.SessionRecording.Index();
+
+        for (var i = 0; i < frames.length; i++) {
+
+            var frame = frames[i];
+            result.timestamps.push(frame.timestamp);
+            result.offsets.push(frame.start);
+
+            if (frame.keyframe)
+                result.keyframes.push(i);
+
+        }
+
+        // Terminate offsets with the end of the last frame
+        if (frames.length)
+            result.offsets.push(frames[frames.length - 1].end);
+
+        return result;
+
+    };
+
     /**
      * Returns the underlying display of the Guacamole.Client used by this
      * Guacamole.SessionRecording for playback. The display contains an Element
      * which can be added to the DOM, causing the display (and thus playback of
      * the recording) to become visible.
      *
+     * The onrender handler of the returned display is used internally to
+     * measure replay cost and must not be overwritten.
+     *
      * @return {Guacamole.Display}
      *     The underlying display of the Guacamole.Client used by this
      *     Guacamole.SessionRecording for playback.
@@ -666,9 +1174,18 @@ Guacamole.SessionRecording = function SessionRecording(tunnel) {
  *
  * @param {Guacamole.SessionRecording._Frame.Instruction[]} instructions
  *     All instructions which are necessary to generate this frame relative to
- *     the previous frame in the Guacamole session.
+ *     the previous frame in the Guacamole session, or null if those
+ *     instructions have not yet been read.
+ *
+ * @param {Number} start
+ *     The byte offset of the first instruction of this frame within the
+ *     recording.
+ *
+ * @param {Number} end
+ *     The byte offset within the recording immediately following the "sync"
+ *     instruction which terminates this frame.
  */
-Guacamole.SessionRecording._Frame = function _Frame(timestamp, instructions) {
+Guacamole.SessionRecording._Frame = function _Frame(timestamp, instructions, start, end) {
 
     /**
      * Whether this frame should be used as a keyframe if possible. This value
@@ -691,12 +1208,31 @@ Guacamole.SessionRecording._Frame = function _Frame(timestamp, instructions) {
 
     /**
      * All instructions which are necessary to generate this frame relative to
-     * the previous frame in the Guacamole session.
+     * the previous frame in the Guacamole session. If these instructions are
+     * not currently held in memory, this will be null, and the instructions
+     * must be read again from the recording using the byte offsets of this
+     * frame.
      *
      * @type {Guacamole.SessionRecording._Frame.Instruction[]}
      */
     this.instructions = instructions;
 
+    /**
+     * The byte offset of the first instruction of this frame within the
+     * recording.
+     *
+     * @type {Number}
+     */
+    this.start = start;
+
+    /**
+     * The byte offset within the recording immediately following the "sync"
+     * instruction which terminates this frame.
+     *
+     * @type {Number}
+     */
+    this.end = end;
+
     /**
      * A snapshot of client state after this frame was rendered, as returned by
      * a call to exportState(). If no such snapshot has been taken, this will
@@ -746,22 +1282,64 @@ Guacamole.SessionRecording._Frame.Instruction = function Instruction(opcode, arg
     this.args = args;
 
     /**
-     * Returns the approximate number of characters which make up this
-     * instruction. This value is only approximate as it excludes the length
-     * prefixes and various delimiters used by the Guacamole protocol; only
-     * the content of the opcode and each argument is taken into account.
+     * Returns the number of bytes occupied by the given element when encoded
+     * as UTF-8 within a Guacamole instruction, including its length prefix,
+     * the period following that prefix, and its terminator.
+     *
+     * @private
+     * @param {String} element
+     *     The element to measure.
+     *
+     * @returns {Number}
+     *     The number of bytes occupied by the given element.
+     */
+    var getElementSize = function getElementSize(element) {
+
+        var bytes = element.length;
+        var length = element.length;
+
+        // Account for multibyte characters, with surrogate pairs counting as
+        // a single four-byte character
+        for (var i = 0; i < element.length; i++) {
+
+            var c = element.charCodeAt(i);
+            if (c < 0x80)
+                continue;
+
+            if (c < 0x800)
+                bytes += 1;
+
+            else if (c >= 0xD800 && c <= 0xDBFF) {
+                bytes += 2;
+                length--;
+                i++;
+            }
+
+            else
+                bytes += 2;
+
+        }
+
+        return String(length).length + bytes + 2;
+
+    };
+
+    /**
+     * Returns the number of bytes which make up this instruction as encoded
+     * within the recording, including the length prefixes and delimiters
+     * used by the Guacamole protocol.
      *
      * @returns {Number}
-     *     The approximate size of this instruction, in characters.
+     *     The size of this instruction, in bytes.
      */
     this.getSize = function getSize() {
 
-        // Init with length of opcode
-        var size = instruction.opcode.length;
+        // Init with size of opcode
+        var size = getElementSize(instruction.opcode);
 
-        // Add length of all arguments
+        // Add size of all arguments
         for (var i = 0; i < instruction.args.length; i++)
-            size += instruction.args[i].length;
+            size += getElementSize(instruction.args[i]);
 
         return size;
 
@@ -769,6 +1347,48 @@ Guacamole.SessionRecording._Frame.Instruction = function Instruction(opcode, arg
 
 };
 
+/**
+ * An index of the frames within a Guacamole session recording, describing
+ * where each frame may be found within the recording without requiring the
+ * recording to be parsed. An index may be obtained from an existing
+ * Guacamole.SessionRecording with getIndex(), and is directly serializable as
+ * JSON.
+ *
+ * @constructor
+ * @param {Guacamole.SessionRecording.Index|Object} [template={}]
+ *     The object whose properties should be copied within the new
+ *     Guacamole.SessionRecording.Index.
+ */
+Guacamole.SessionRecording.Index = function Index(template) {
+
+    template = template || {};
+
+    /**
+     * The timestamp of each frame, as dictated by the "sync" instruction
+     * which terminates the frame.
+     *
+     * @type {Number[]}
+     */
+    this.timestamps = template.timestamps || [];
+
+    /**
+     * The byte offset of the start of each frame within the recording,
+     * followed by the byte offset immediately following the last frame. This
+     * array thus contains one more element than the timestamps array.
+     *
+     * @type {Number[]}
+     */
+    this.offsets = template.offsets || [];
+
+    /**
+     * The indices of all frames which should be used as keyframes.
+     *
+     * @type {Number[]}
+     */
+    this.keyframes = template.keyframes || [];
+
+};
+
 /**
  * A read-only Guacamole.Tunnel implementation which streams instructions
  * received through explicit calls to its receiveInstruction() function.
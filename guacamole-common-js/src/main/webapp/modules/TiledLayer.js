@@ -0,0 +1,1504 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+var Guacamole = Guacamole || {};
+
+/**
+ * Drawing surface which provides the same drawing instructions as
+ * Guacamole.Layer, but which stores its image data within fixed-size tiles
+ * that are allocated only when first drawn to. Resizing a TiledLayer affects
+ * only the tiles along the edges being moved, and never copies the image as
+ * a whole. This makes TiledLayer well-suited to large, sparsely-drawn
+ * off-screen buffers.
+ *
+ * Unlike Guacamole.Layer, there is no single canvas element backing a
+ * TiledLayer, and a TiledLayer cannot be displayed directly. The
+ * getCanvas() function is still provided, but must assemble a new canvas
+ * from the allocated tiles each time the contents of the layer change.
+ *
+ * As this implementation is also used within the worker of
+ * Guacamole.OffscreenRenderer, it must not depend on anything other than
+ * Guacamole.Layer.Pixel.
+ *
+ * @constructor
+ *
+ * @param {Number} width The width of the TiledLayer, in pixels.
+ * @param {Number} height The height of the TiledLayer, in pixels.
+ */
+Guacamole.TiledLayer = function TiledLayer(width, height) {
+
+    /**
+     * Reference to this TiledLayer.
+     *
+     * @private
+     * @type {Guacamole.TiledLayer}
+     */
+    var layer = this;
+
+    /**
+     * The width and height of each tile, in pixels. Tiles along the right
+     * and bottom edges of the layer may be smaller.
+     *
+     * @private
+     * @constant
+     * @type {Number}
+     */
+    var TILE_SIZE = 256;
+
+    /**
+     * The number of pixels the width or height of a layer must change before
+     * the bounds of the underlying storage are changed. As with
+     * Guacamole.Layer, the storage is kept at dimensions which are integer
+     * multiples of this factor.
+     *
+     * @private
+     * @constant
+     * @type {Number}
+     */
+    var CANVAS_SIZE_FACTOR = 64;
+
+    /**
+     * Map of all Guacamole channel masks to HTML5 canvas composite operation
+     * names. Not all channel mask combinations are currently implemented.
+     *
+     * @private
+     * @type {Object.<Number, String>}
+     */
+    var compositeOperation = {
+     /* 0x0 NOT IMPLEMENTED */
+        0x1: "destination-in",
+        0x2: "destination-out",
+     /* 0x3 NOT IMPLEMENTED */
+        0x4: "source-in",
+     /* 0x5 NOT IMPLEMENTED */
+        0x6: "source-atop",
+     /* 0x7 NOT IMPLEMENTED */
+        0x8: "source-out",
+        0x9: "destination-atop",
+        0xA: "xor",
+        0xB: "destination-over",
+        0xC: "copy",
+     /* 0xD NOT IMPLEMENTED */
+        0xE: "source-over",
+        0xF: "lighter"
+    };
+
+    /**
+     * All composite operations which affect the destination outside the
+     * area being drawn, and thus must be applied to every allocated tile
+     * rather than only those beneath the drawing operation.
+     *
+     * @private
+     * @type {Object.<String, Boolean>}
+     */
+    var unboundedOperation = {
+        "copy"             : true,
+        "source-in"        : true,
+        "destination-in"   : true,
+        "source-out"       : true,
+        "destination-atop" : true
+    };
+
+    /**
+     * All allocated tiles, stored by the string "COLUMN,ROW". Each tile is
+     * an object containing its canvas ("canvas"), the 2D context of that
+     * canvas ("context"), and the location of its upper-left corner within
+     * the layer ("x" and "y").
+     *
+     * @private
+     * @type {Object.<String, Object>}
+     */
+    var tiles = {};
+
+    /**
+     * The width of the storage backing this layer. Drawing operations
+     * outside this width have no effect.
+     *
+     * @private
+     * @type {Number}
+     */
+    var storageWidth = 0;
+
+    /**
+     * The height of the storage backing this layer. Drawing operations
+     * outside this height have no effect.
+     *
+     * @private
+     * @type {Number}
+     */
+    var storageHeight = 0;
+
+    /**
+     * Canvas reused for assembling image data which spans several tiles, or
+     * null if no such canvas has yet been needed.
+     *
+     * @private
+     * @type {HTMLCanvasElement}
+     */
+    var scratch = null;
+
+    /**
+     * The canvas most recently returned by getCanvas(), or null if the
+     * contents of this layer have changed since.
+     *
+     * @private
+     * @type {HTMLCanvasElement}
+     */
+    var assembled = null;
+
+    /**
+     * Creates a new drawing state having the default transform, composite
+     * operation, and miter limit, and no clipping region.
+     *
+     * @private
+     * @returns {Object}
+     *     A new drawing state.
+     */
+    var createState = function createState() {
+        return {
+            'matrix'     : [1, 0, 0, 1, 0, 0],
+            'composite'  : 'source-over',
+            'miterLimit' : 10,
+            'clips'      : [],
+            'clipBounds' : null
+        };
+    };
+
+    /**
+     * Returns a copy of the given drawing state which can be modified
+     * without affecting the original.
+     *
+     * @private
+     * @param {Object} state
+     *     The drawing state to copy.
+     *
+     * @returns {Object}
+     *     A copy of the given drawing state.
+     */
+    var copyState = function copyState(state) {
+        return {
+            'matrix'     : state.matrix.slice(),
+            'composite'  : state.composite,
+            'miterLimit' : state.miterLimit,
+            'clips'      : state.clips.slice(),
+            'clipBounds' : state.clipBounds
+        };
+    };
+
+    /**
+     * The current drawing state, equivalent to the state of the 2D context
+     * of a Guacamole.Layer. As tile contexts are shared by all states, this
+     * state is reapplied to each tile for every drawing operation.
+     *
+     * @private
+     * @type {Object}
+     */
+    var state = createState();
+
+    /**
+     * The state restored by reset(). As with the canvas of a
+     * Guacamole.Layer, this is the state in effect when the storage of this
+     * layer was last resized.
+     *
+     * @private
+     * @type {Object}
+     */
+    var initialState = copyState(state);
+
+    /**
+     * All states pushed with push() and not yet popped.
+     *
+     * @private
+     * @type {Object[]}
+     */
+    var stack = [];
+
+    /**
+     * All segments of the current path, in order. Each segment is an object
+     * containing the name of the 2D context function which adds that segment
+     * ("op"), the arguments of that function ("args"), and the transform in
+     * effect when the segment was added ("matrix").
+     *
+     * @private
+     * @type {Object[]}
+     */
+    var path = [];
+
+    /**
+     * The bounding rectangle of the current path, within the coordinate
+     * space of the layer, as an object containing the left, top, right and
+     * bottom edges ("x1", "y1", "x2" and "y2"), or null if the current path
+     * is empty.
+     *
+     * @private
+     * @type {Object}
+     */
+    var pathBounds = null;
+
+    /**
+     * Whether a new path should be started with the next path drawing
+     * operations.
+     *
+     * @private
+     * @type {Boolean}
+     */
+    var pathClosed = true;
+
+    /**
+     * Returns the bounding rectangle of the given points after being
+     * transformed by the current transform, expanded outward to whole
+     * pixels.
+     *
+     * @private
+     * @param {Number[]} points
+     *     The X and Y coordinates of each point, in sequence.
+     *
+     * @returns {Object}
+     *     The bounding rectangle of the transformed points, as an object
+     *     containing the left, top, right and bottom edges ("x1", "y1", "x2"
+     *     and "y2").
+     */
+    var transformBounds = function transformBounds(points) {
+
+        var m = state.matrix;
+        var x1 = Infinity, y1 = Infinity, x2 = -Infinity, y2 = -Infinity;
+
+        for (var i = 0; i < points.length; i += 2) {
+
+            var x = m[0] * points[i] + m[2] * points[i+1] + m[4];
+            var y = m[1] * points[i] + m[3] * points[i+1] + m[5];
+
+            x1 = Math.min(x1, x);
+            y1 = Math.min(y1, y);
+            x2 = Math.max(x2, x);
+            y2 = Math.max(y2, y);
+
+        }
+
+        return {
+            'x1' : Math.floor(x1),
+            'y1' : Math.floor(y1),
+            'x2' : Math.ceil(x2),
+            'y2' : Math.ceil(y2)
+        };
+
+    };
+
+    /**
+     * Returns the bounding rectangle of the given rectangle after being
+     * transformed by the current transform.
+     *
+     * @private
+     * @param {Number} x The X coordinate of the upper-left corner.
+     * @param {Number} y The Y coordinate of the upper-left corner.
+     * @param {Number} w The width of the rectangle.
+     * @param {Number} h The height of the rectangle.
+     *
+     * @returns {Object}
+     *     The bounding rectangle of the transformed rectangle.
+     */
+    var transformRect = function transformRect(x, y, w, h) {
+        return transformBounds([x, y, x + w, y, x, y + h, x + w, y + h]);
+    };
+
+    /**
+     * Returns the tile at the given column and row, allocating that tile if
+     * it does not yet exist.
+     *
+     * @private
+     * @param {Number} col The column of the tile.
+     * @param {Number} row The row of the tile.
+     *
+     * @returns {Object}
+     *     The tile at the given column and row.
+     */
+    var getTile = function getTile(col, row) {
+
+        var key = col + ',' + row;
+        var tile = tiles[key];
+        if (tile)
+            return tile;
+
+        var x = col * TILE_SIZE;
+        var y = row * TILE_SIZE;
+
+        var canvas = document.createElement("canvas");
+        canvas.width  = Math.min(TILE_SIZE, storageWidth  - x);
+        canvas.height = Math.min(TILE_SIZE, storageHeight - y);
+
+        tile = tiles[key] = {
+            'canvas'  : canvas,
+            'context' : canvas.getContext("2d"),
+            'x'       : x,
+            'y'       : y
+        };
+
+        return tile;
+
+    };
+
+    /**
+     * Frees the given tile, releasing the memory used by its canvas.
+     *
+     * @private
+     * @param {String} key
+     *     The key of the tile within the tiles map.
+     */
+    var freeTile = function freeTile(key) {
+
+        var canvas = tiles[key].canvas;
+        canvas.width = canvas.height = 0;
+
+        delete tiles[key];
+
+    };
+
+    /**
+     * Returns all tiles which intersect the given rectangle, clipped to the
+     * bounds of the storage backing this layer.
+     *
+     * @private
+     * @param {Number} x1 The left edge of the rectangle.
+     * @param {Number} y1 The top edge of the rectangle.
+     * @param {Number} x2 The right edge of the rectangle (exclusive).
+     * @param {Number} y2 The bottom edge of the rectangle (exclusive).
+     *
+     * @param {Boolean} allocate
+     *     Whether tiles which have not yet been allocated should be
+     *     allocated. If false, only tiles which already exist are returned.
+     *
+     * @returns {Object[]}
+     *     All tiles intersecting the given rectangle.
+     */
+    var getTiles = function getTiles(x1, y1, x2, y2, allocate) {
+
+        x1 = Math.max(x1, 0);
+        y1 = Math.max(y1, 0);
+        x2 = Math.min(x2, storageWidth);
+        y2 = Math.min(y2, storageHeight);
+
+        var found = [];
+        if (x1 >= x2 || y1 >= y2)
+            return found;
+
+        var lastCol = Math.floor((x2 - 1) / TILE_SIZE);
+        var lastRow = Math.floor((y2 - 1) / TILE_SIZE);
+
+        for (var row = Math.floor(y1 / TILE_SIZE); row <= lastRow; row++) {
+            for (var col = Math.floor(x1 / TILE_SIZE); col <= lastCol; col++) {
+
+                if (allocate)
+                    found.push(getTile(col, row));
+
+                else if (tiles[col + ',' + row])
+                    found.push(tiles[col + ',' + row]);
+
+            }
+        }
+
+        return found;
+
+    };
+
+    /**
+     * Sets the transform of the given tile's context to the given transform,
+     * relative to the location of that tile within the layer.
+     *
+     * @private
+     * @param {Object} tile The tile whose transform should be set.
+     * @param {Number[]} m The transform to apply.
+     */
+    var setMatrix = function setMatrix(tile, m) {
+        tile.context.setTransform(m[0], m[1], m[2], m[3],
+                m[4] - tile.x, m[5] - tile.y);
+    };
+
+    /**
+     * Rebuilds the given path within the context of the given tile.
+     *
+     * @private
+     * @param {Object} tile The tile whose context should receive the path.
+     * @param {Object[]} segments The segments of the path.
+     */
+    var replayPath = function replayPath(tile, segments) {
+
+        var context = tile.context;
+        context.beginPath();
+
+        for (var i = 0; i < segments.length; i++) {
+            var segment = segments[i];
+            setMatrix(tile, segment.matrix);
+            context[segment.op].apply(context, segment.args);
+        }
+
+    };
+
+    /**
+     * Invokes the given function for each tile affected by a drawing
+     * operation covering the given bounding rectangle, with the context of
+     * that tile configured with the current clipping region, composite
+     * operation, miter limit, and transform. Tiles beneath the rectangle are
+     * allocated if necessary.
+     *
+     * @private
+     * @param {Object} bounds
+     *     The bounding rectangle of the drawing operation, or null if the
+     *     drawing operation does not cover any area.
+     *
+     * @param {function} draw
+     *     The function to invoke for each tile, receiving the tile and its
+     *     2D context.
+     */
+    var paint = function paint(bounds, draw) {
+
+        var clip = state.clipBounds || {
+            'x1' : 0, 'y1' : 0,
+            'x2' : storageWidth, 'y2' : storageHeight
+        };
+
+        // Only the area within the clipping region can be affected
+        var affected = [];
+        if (bounds)
+            affected = getTiles(
+                Math.max(bounds.x1, clip.x1), Math.max(bounds.y1, clip.y1),
+                Math.min(bounds.x2, clip.x2), Math.min(bounds.y2, clip.y2),
+                true);
+
+        // Operations which affect the destination outside the drawn area
+        // must also be applied to all other existing tiles
+        if (unboundedOperation[state.composite]) {
+            var existing = getTiles(clip.x1, clip.y1, clip.x2, clip.y2, false);
+            for (var i = 0; i < existing.length; i++) {
+                if (affected.indexOf(existing[i]) === -1)
+                    affected.push(existing[i]);
+            }
+        }
+
+        for (var j = 0; j < affected.length; j++) {
+
+            var tile = affected[j];
+            var context = tile.context;
+            context.save();
+
+            // Apply clipping region
+            for (var k = 0; k < state.clips.length; k++) {
+                replayPath(tile, state.clips[k]);
+                context.clip();
+            }
+
+            context.globalCompositeOperation = state.composite;
+            context.miterLimit = state.miterLimit;
+            setMatrix(tile, state.matrix);
+
+            draw(tile, context);
+            context.restore();
+
+        }
+
+        assembled = null;
+
+    };
+
+    /**
+     * Returns the image data within the given rectangle of this layer. Areas
+     * not covered by any allocated tile are fully transparent.
+     *
+     * @private
+     * @param {Number} x The X coordinate of the upper-left corner.
+     * @param {Number} y The Y coordinate of the upper-left corner.
+     * @param {Number} w The width of the rectangle.
+     * @param {Number} h The height of the rectangle.
+     *
+     * @returns {ImageData}
+     *     The image data within the given rectangle.
+     */
+    var getImageData = function getImageData(x, y, w, h) {
+
+        if (!scratch)
+            scratch = document.createElement("canvas");
+
+        var data = scratch.getContext("2d").createImageData(w, h);
+        var pixels = new Uint32Array(data.data.buffer);
+
+        var found = getTiles(x, y, x + w, y + h, false);
+        for (var i = 0; i < found.length; i++) {
+
+            var tile = found[i];
+
+            // Determine the portion of the rectangle within this tile
+            var x1 = Math.max(x, tile.x);
+            var y1 = Math.max(y, tile.y);
+            var x2 = Math.min(x + w, tile.x + tile.canvas.width);
+            var y2 = Math.min(y + h, tile.y + tile.canvas.height);
+
+            var part = tile.context.getImageData(x1 - tile.x, y1 - tile.y,
+                    x2 - x1, y2 - y1);
+            var partPixels = new Uint32Array(part.data.buffer);
+
+            // Copy each row into place
+            var partWidth = x2 - x1;
+            for (var row = 0; row < y2 - y1; row++) {
+                pixels.set(
+                    partPixels.subarray(row * partWidth, (row + 1) * partWidth),
+                    (y1 - y + row) * w + x1 - x
+                );
+            }
+
+        }
+
+        return data;
+
+    };
+
+    /**
+     * Replaces the image data within this layer with the given image data,
+     * without regard for the current transform, clipping region, or
+     * composite operation, just as CanvasRenderingContext2D.putImageData().
+     *
+     * @private
+     * @param {ImageData} data The image data to draw.
+     * @param {Number} x The destination X coordinate.
+     * @param {Number} y The destination Y coordinate.
+     */
+    var putImageData = function putImageData(data, x, y) {
+
+        var found = getTiles(x, y, x + data.width, y + data.height, true);
+        for (var i = 0; i < found.length; i++) {
+
+            var tile = found[i];
+
+            // Draw only the portion of the image data within this tile
+            var dirtyX = Math.max(0, tile.x - x);
+            var dirtyY = Math.max(0, tile.y - y);
+            var dirtyWidth  = Math.min(data.width,  tile.x + tile.canvas.width  - x) - dirtyX;
+            var dirtyHeight = Math.min(data.height, tile.y + tile.canvas.height - y) - dirtyY;
+
+            tile.context.putImageData(data, x - tile.x, y - tile.y,
+                    dirtyX, dirtyY, dirtyWidth, dirtyHeight);
+
+        }
+
+        assembled = null;
+
+    };
+
+    /**
+     * Adds the given segment to the current path, starting a new path if the
+     * current path is closed.
+     *
+     * @private
+     * @param {String} op
+     *     The name of the 2D context function which adds the segment.
+     *
+     * @param {Array} args
+     *     The arguments to pass to that function.
+     *
+     * @param {Number[]} points
+     *     The X and Y coordinates of points, in sequence, whose bounding
+     *     rectangle contains the segment.
+     */
+    var addSegment = function addSegment(op, args, points) {
+
+        // Start a new path if current path is closed
+        if (pathClosed) {
+            path = [];
+            pathBounds = null;
+            pathClosed = false;
+        }
+
+        path.push({
+            'op'     : op,
+            'args'   : args,
+            'matrix' : state.matrix.slice()
+        });
+
+        var bounds = transformBounds(points);
+        if (pathBounds)
+            bounds = {
+                'x1' : Math.min(pathBounds.x1, bounds.x1),
+                'y1' : Math.min(pathBounds.y1, bounds.y1),
+                'x2' : Math.max(pathBounds.x2, bounds.x2),
+                'y2' : Math.max(pathBounds.y2, bounds.y2)
+            };
+
+        pathBounds = bounds;
+
+    };
+
+    /**
+     * Returns the bounding rectangle of the current path after being stroked
+     * with the given line style.
+     *
+     * @private
+     * @param {String} join The line join style.
+     * @param {Number} thickness The line thickness in pixels.
+     *
+     * @returns {Object}
+     *     The bounding rectangle of the stroked path, or null if the current
+     *     path is empty.
+     */
+    var strokeBounds = function strokeBounds(join, thickness) {
+
+        if (!pathBounds)
+            return null;
+
+        // Line thickness is scaled by the transform in effect when stroking
+        var m = state.matrix;
+        var scale = Math.sqrt(m[0] * m[0] + m[1] * m[1])
+                  + Math.sqrt(m[2] * m[2] + m[3] * m[3]);
+
+        // Square caps and miter joins may extend beyond half the thickness
+        var extent = thickness / 2 * scale * Math.max(Math.SQRT2,
+                join === "miter" ? state.miterLimit : 1);
+
+        var padding = Math.ceil(extent) + 1;
+        return {
+            'x1' : pathBounds.x1 - padding,
+            'y1' : pathBounds.y1 - padding,
+            'x2' : pathBounds.x2 + padding,
+            'y2' : pathBounds.y2 + padding
+        };
+
+    };
+
+    /**
+     * Resizes the storage backing this TiledLayer. Only tiles along the
+     * edges being moved are affected. This function should only be used
+     * internally.
+     *
+     * @private
+     * @param {Number} [newWidth=0]
+     *     The new width to assign to this Layer.
+     *
+     * @param {Number} [newHeight=0]
+     *     The new height to assign to this Layer.
+     */
+    var resize = function resize(newWidth, newHeight) {
+
+        // Default size to zero
+        newWidth = newWidth || 0;
+        newHeight = newHeight || 0;
+
+        // Calculate new dimensions of storage
+        var newStorageWidth  = Math.ceil(newWidth  / CANVAS_SIZE_FACTOR) * CANVAS_SIZE_FACTOR;
+        var newStorageHeight = Math.ceil(newHeight / CANVAS_SIZE_FACTOR) * CANVAS_SIZE_FACTOR;
+
+        // Resize only if storage dimensions are actually changing
+        if (storageWidth !== newStorageWidth || storageHeight !== newStorageHeight) {
+
+            // As with Guacamole.Layer, only data within the old and new
+            // dimensions of the layer is preserved
+            var keepWidth  = Math.min(layer.width  || 0, newWidth);
+            var keepHeight = Math.min(layer.height || 0, newHeight);
+
+            for (var key in tiles) {
+
+                var tile = tiles[key];
+                var canvas = tile.canvas;
+
+                // Free tiles which no longer contain preserved data
+                if (tile.x >= keepWidth || tile.y >= keepHeight) {
+                    freeTile(key);
+                    continue;
+                }
+
+                var tileWidth  = Math.min(TILE_SIZE, newStorageWidth  - tile.x);
+                var tileHeight = Math.min(TILE_SIZE, newStorageHeight - tile.y);
+
+                // Tiles not along the edges are unaffected
+                if (tile.x + canvas.width <= keepWidth
+                        && tile.y + canvas.height <= keepHeight
+                        && canvas.width === tileWidth
+                        && canvas.height === tileHeight)
+                    continue;
+
+                // Copy preserved data out of tile
+                var data = tile.context.getImageData(0, 0,
+                        Math.min(canvas.width,  keepWidth  - tile.x),
+                        Math.min(canvas.height, keepHeight - tile.y));
+
+                // Resizing the canvas clears its contents
+                canvas.width  = tileWidth;
+                canvas.height = tileHeight;
+                tile.context.putImageData(data, 0, 0);
+
+            }
+
+            storageWidth = newStorageWidth;
+            storageHeight = newStorageHeight;
+
+            // Acknowledge reset of state (as happens on resize of canvas),
+            // preserving composite operation
+            var composite = state.composite;
+            state = createState();
+            state.composite = composite;
+            initialState = copyState(state);
+            stack = [];
+            path = [];
+            pathBounds = null;
+
+            assembled = null;
+
+        }
+
+        // If the storage size is not changing, manually force state reset
+        else
+            layer.reset();
+
+        // Assign new layer dimensions
+        layer.width = newWidth;
+        layer.height = newHeight;
+
+    };
+
+    /**
+     * Given the X and Y coordinates of the upper-left corner of a rectangle
+     * and the rectangle's width and height, resize the layer as necessary to
+     * ensure that the rectangle fits within the layer's coordinate space.
+     * This function will only make the layer larger.
+     *
+     * @private
+     * @param {Number} x The X coordinate of the upper-left corner of the
+     *                   rectangle to fit.
+     * @param {Number} y The Y coordinate of the upper-left corner of the
+     *                   rectangle to fit.
+     * @param {Number} w The width of the the rectangle to fit.
+     * @param {Number} h The height of the the rectangle to fit.
+     */
+    var fitRect = function fitRect(x, y, w, h) {
+        layer.resize(Math.max(layer.width, x + w), Math.max(layer.height, y + h));
+    };
+
+    /**
+     * Set to true if this TiledLayer should resize itself to accomodate the
+     * dimensions of any drawing operation, and false (the default) otherwise.
+     *
+     * @see Guacamole.Layer#autosize
+     * @type {Boolean}
+     * @default false
+     */
+    this.autosize = false;
+
+    /**
+     * The current width of this layer.
+     *
+     * @type {Number}
+     */
+    this.width = width;
+
+    /**
+     * The current height of this layer.
+     *
+     * @type {Number}
+     */
+    this.height = height;
+
+    /**
+     * Returns a canvas element containing the contents of this TiledLayer.
+     * As with Guacamole.Layer, the dimensions of the canvas may not exactly
+     * match those of the layer. The canvas is assembled from the allocated
+     * tiles, is reused only until the contents of the layer change, and must
+     * not be modified.
+     *
+     * @returns {!HTMLCanvasElement}
+     *     A canvas element containing the contents of this TiledLayer.
+     */
+    this.getCanvas = function getCanvas() {
+
+        if (assembled)
+            return assembled;
+
+        var canvas = document.createElement("canvas");
+        canvas.width = storageWidth;
+        canvas.height = storageHeight;
+
+        var context = canvas.getContext("2d");
+        for (var key in tiles)
+            context.drawImage(tiles[key].canvas, tiles[key].x, tiles[key].y);
+
+        return assembled = canvas;
+
+    };
+
+    /**
+     * Returns a new canvas element containing the same image as this
+     * TiledLayer, having the exact same dimensions as the layer.
+     *
+     * @returns {!HTMLCanvasElement}
+     *     A new canvas element containing a copy of the image content of
+     *     this TiledLayer.
+     */
+    this.toCanvas = function toCanvas() {
+
+        var canvas = document.createElement("canvas");
+        canvas.width = layer.width;
+        canvas.height = layer.height;
+
+        var context = canvas.getContext("2d");
+        for (var key in tiles)
+            context.drawImage(tiles[key].canvas, tiles[key].x, tiles[key].y);
+
+        return canvas;
+
+    };
+
+    /**
+     * Returns a canvas containing the given rectangle of this TiledLayer,
+     * along with the location of that rectangle within the returned canvas.
+     * If the rectangle lies within a single tile, that tile is returned
+     * directly.
+     *
+     * @see Guacamole.Layer#getRegion
+     * @param {Number} x The X coordinate of the upper-left corner of the
+     *                   rectangle.
+     * @param {Number} y The Y coordinate of the upper-left corner of the
+     *                   rectangle.
+     * @param {Number} w The width of the rectangle.
+     * @param {Number} h The height of the rectangle.
+     *
+     * @returns {Object}
+     *     An object containing the canvas ("canvas"), the location of the
+     *     clipped rectangle within that canvas ("x" and "y"), and the
+     *     dimensions of the clipped rectangle ("width" and "height"), or null
+     *     if the clipped rectangle is empty.
+     */
+    this.getRegion = function getRegion(x, y, w, h) {
+
+        // If entire rectangle outside storage, stop
+        if (x >= storageWidth || y >= storageHeight) return null;
+
+        // Otherwise, clip rectangle to area
+        if (x + w > storageWidth)
+            w = storageWidth - x;
+
+        if (y + h > storageHeight)
+            h = storageHeight - y;
+
+        // Stop if nothing to read
+        if (w === 0 || h === 0) return null;
+
+        // Use tile directly if rectangle is entirely within that tile
+        var col = Math.floor(x / TILE_SIZE);
+        var row = Math.floor(y / TILE_SIZE);
+        var tile = tiles[col + ',' + row];
+        if (tile && x >= 0 && y >= 0
+                && x + w <= tile.x + tile.canvas.width
+                && y + h <= tile.y + tile.canvas.height)
+            return {
+                'canvas' : tile.canvas,
+                'x'      : x - tile.x,
+                'y'      : y - tile.y,
+                'width'  : w,
+                'height' : h
+            };
+
+        // Otherwise, assemble the rectangle within the scratch canvas
+        if (!scratch)
+            scratch = document.createElement("canvas");
+
+        if (scratch.width < w || scratch.height < h) {
+            scratch.width  = Math.max(scratch.width,  w);
+            scratch.height = Math.max(scratch.height, h);
+        }
+
+        var context = scratch.getContext("2d");
+        context.clearRect(0, 0, w, h);
+
+        // Draw each tile in place rather than reading back its pixels. As
+        // tiles do not overlap and are drawn onto transparent pixels, this
+        // reproduces each tile exactly, including partially-transparent
+        // pixels.
+        var found = getTiles(x, y, x + w, y + h, false);
+        for (var i = 0; i < found.length; i++)
+            context.drawImage(found[i].canvas, found[i].x - x, found[i].y - y);
+
+        return {
+            'canvas' : scratch,
+            'x'      : 0,
+            'y'      : 0,
+            'width'  : w,
+            'height' : h
+        };
+
+    };
+
+    /**
+     * Changes the size of this TiledLayer to the given width and height.
+     * Resizing is only attempted if the new size provided is actually
+     * different from the current size.
+     *
+     * @param {Number} newWidth The new width to assign to this Layer.
+     * @param {Number} newHeight The new height to assign to this Layer.
+     */
+    this.resize = function(newWidth, newHeight) {
+        if (newWidth !== layer.width || newHeight !== layer.height)
+            resize(newWidth, newHeight);
+    };
+
+    /**
+     * Frees all tiles allocated by this TiledLayer. The TiledLayer must not
+     * be used after it has been disposed.
+     */
+    this.dispose = function dispose() {
+
+        for (var key in tiles)
+            freeTile(key);
+
+        if (scratch)
+            scratch.width = scratch.height = 0;
+
+        scratch = null;
+        assembled = null;
+
+    };
+
+    /**
+     * Draws the specified image at the given coordinates. The image specified
+     * must already be loaded.
+     *
+     * @see Guacamole.Layer#drawImage
+     * @param {Number} x
+     *     The destination X coordinate.
+     *
+     * @param {Number} y
+     *     The destination Y coordinate.
+     *
+     * @param {CanvasImageSource} image
+     *     The image to draw. Note that this is not a URL.
+     */
+    this.drawImage = function(x, y, image) {
+        if (layer.autosize) fitRect(x, y, image.width, image.height);
+        paint(transformRect(x, y, image.width, image.height), function drawTile(tile, context) {
+            context.drawImage(image, x, y);
+        });
+    };
+
+    /**
+     * Transfer a rectangle of image data from one Layer to this TiledLayer
+     * using the specified transfer function.
+     *
+     * @see Guacamole.Layer#transfer
+     * @param {Guacamole.Layer|Guacamole.TiledLayer} srcLayer
+     *     The Layer to copy image data from.
+     *
+     * @param {Number} srcx The X coordinate of the upper-left corner of the
+     *                      rectangle within the source Layer's coordinate
+     *                      space to copy data from.
+     * @param {Number} srcy The Y coordinate of the upper-left corner of the
+     *                      rectangle within the source Layer's coordinate
+     *                      space to copy data from.
+     * @param {Number} srcw The width of the rectangle within the source Layer's
+     *                      coordinate space to copy data from.
+     * @param {Number} srch The height of the rectangle within the source
+     *                      Layer's coordinate space to copy data from.
+     * @param {Number} x The destination X coordinate.
+     * @param {Number} y The destination Y coordinate.
+     * @param {Function} transferFunction The transfer function to use to
+     *                                    transfer data from source to
+     *                                    destination.
+     */
+    this.transfer = function(srcLayer, srcx, srcy, srcw, srch, x, y, transferFunction) {
+
+        // Stop if nothing to draw
+        var region = srcLayer.getRegion(srcx, srcy, srcw, srch);
+        if (!region) return;
+
+        srcw = region.width;
+        srch = region.height;
+
+        if (layer.autosize) fitRect(x, y, srcw, srch);
+
+        // Get image data from src and dst
+        var src = region.canvas.getContext("2d").getImageData(region.x, region.y, srcw, srch);
+        var dst = getImageData(x, y, srcw, srch);
+
+        // Apply transfer to all pixels at once if a kernel is available
+        if (transferFunction.kernel) {
+            transferFunction.kernel(
+                new Uint32Array(src.data.buffer),
+                new Uint32Array(dst.data.buffer),
+                srcw * srch
+            );
+            putImageData(dst, x, y);
+            return;
+        }
+
+        // Otherwise, apply transfer for each pixel
+        for (var i=0; i<srcw*srch*4; i+=4) {
+
+            // Get source pixel environment
+            var src_pixel = new Guacamole.Layer.Pixel(
+                src.data[i],
+                src.data[i+1],
+                src.data[i+2],
+                src.data[i+3]
+            );
+
+            // Get destination pixel environment
+            var dst_pixel = new Guacamole.Layer.Pixel(
+                dst.data[i],
+                dst.data[i+1],
+                dst.data[i+2],
+                dst.data[i+3]
+            );
+
+            // Apply transfer function
+            transferFunction(src_pixel, dst_pixel);
+
+            // Save pixel data
+            dst.data[i  ] = dst_pixel.red;
+            dst.data[i+1] = dst_pixel.green;
+            dst.data[i+2] = dst_pixel.blue;
+            dst.data[i+3] = dst_pixel.alpha;
+
+        }
+
+        // Draw image data
+        putImageData(dst, x, y);
+
+    };
+
+    /**
+     * Put a rectangle of image data from one Layer to this TiledLayer
+     * directly without performing any alpha blending. Simply copy the data.
+     *
+     * @see Guacamole.Layer#put
+     * @param {Guacamole.Layer|Guacamole.TiledLayer} srcLayer
+     *     The Layer to copy image data from.
+     *
+     * @param {Number} srcx The X coordinate of the upper-left corner of the
+     *                      rectangle within the source Layer's coordinate
+     *                      space to copy data from.
+     * @param {Number} srcy The Y coordinate of the upper-left corner of the
+     *                      rectangle within the source Layer's coordinate
+     *                      space to copy data from.
+     * @param {Number} srcw The width of the rectangle within the source Layer's
+     *                      coordinate space to copy data from.
+     * @param {Number} srch The height of the rectangle within the source
+     *                      Layer's coordinate space to copy data from.
+     * @param {Number} x The destination X coordinate.
+     * @param {Number} y The destination Y coordinate.
+     */
+    this.put = function(srcLayer, srcx, srcy, srcw, srch, x, y) {
+
+        // Stop if nothing to draw
+        var region = srcLayer.getRegion(srcx, srcy, srcw, srch);
+        if (!region) return;
+
+        srcw = region.width;
+        srch = region.height;
+
+        if (layer.autosize) fitRect(x, y, srcw, srch);
+
+        // Get image data from src and dst
+        var src = region.canvas.getContext("2d").getImageData(region.x, region.y, srcw, srch);
+        putImageData(src, x, y);
+
+    };
+
+    /**
+     * Copy a rectangle of image data from one Layer to this TiledLayer.
+     *
+     * @see Guacamole.Layer#copy
+     * @param {Guacamole.Layer|Guacamole.TiledLayer} srcLayer
+     *     The Layer to copy image data from.
+     *
+     * @param {Number} srcx The X coordinate of the upper-left corner of the
+     *                      rectangle within the source Layer's coordinate
+     *                      space to copy data from.
+     * @param {Number} srcy The Y coordinate of the upper-left corner of the
+     *                      rectangle within the source Layer's coordinate
+     *                      space to copy data from.
+     * @param {Number} srcw The width of the rectangle within the source Layer's
+     *                      coordinate space to copy data from.
+     * @param {Number} srch The height of the rectangle within the source
+     *                      Layer's coordinate space to copy data from.
+     * @param {Number} x The destination X coordinate.
+     * @param {Number} y The destination Y coordinate.
+     */
+    this.copy = function(srcLayer, srcx, srcy, srcw, srch, x, y) {
+
+        // Stop if nothing to draw
+        var region = srcLayer.getRegion(srcx, srcy, srcw, srch);
+        if (!region) return;
+
+        srcw = region.width;
+        srch = region.height;
+
+        if (layer.autosize) fitRect(x, y, srcw, srch);
+
+        // A tile of this layer may be both source and destination, so copy
+        // the source rectangle out first
+        var source = region.canvas;
+        var sx = region.x;
+        var sy = region.y;
+        if (srcLayer === layer) {
+            source = document.createElement("canvas");
+            source.width = srcw;
+            source.height = srch;
+            source.getContext("2d").drawImage(region.canvas,
+                    sx, sy, srcw, srch, 0, 0, srcw, srch);
+            sx = sy = 0;
+        }
+
+        paint(transformRect(x, y, srcw, srch), function copyTile(tile, context) {
+            context.drawImage(source, sx, sy, srcw, srch, x, y, srcw, srch);
+        });
+
+    };
+
+    /**
+     * Starts a new path at the specified point.
+     *
+     * @param {Number} x The X coordinate of the point to draw.
+     * @param {Number} y The Y coordinate of the point to draw.
+     */
+    this.moveTo = function(x, y) {
+        if (layer.autosize) fitRect(x, y, 0, 0);
+        addSegment("moveTo", [x, y], [x, y]);
+    };
+
+    /**
+     * Add the specified line to the current path.
+     *
+     * @param {Number} x The X coordinate of the endpoint of the line to draw.
+     * @param {Number} y The Y coordinate of the endpoint of the line to draw.
+     */
+    this.lineTo = function(x, y) {
+        if (layer.autosize) fitRect(x, y, 0, 0);
+        addSegment("lineTo", [x, y], [x, y]);
+    };
+
+    /**
+     * Add the specified arc to the current path.
+     *
+     * @param {Number} x The X coordinate of the center of the circle which
+     *                   will contain the arc.
+     * @param {Number} y The Y coordinate of the center of the circle which
+     *                   will contain the arc.
+     * @param {Number} radius The radius of the circle.
+     * @param {Number} startAngle The starting angle of the arc, in radians.
+     * @param {Number} endAngle The ending angle of the arc, in radians.
+     * @param {Boolean} negative Whether the arc should be drawn in order of
+     *                           decreasing angle.
+     */
+    this.arc = function(x, y, radius, startAngle, endAngle, negative) {
+        if (layer.autosize) fitRect(x, y, 0, 0);
+        addSegment("arc", [x, y, radius, startAngle, endAngle, negative],
+                [x - radius, y - radius, x + radius, y + radius,
+                 x - radius, y + radius, x + radius, y - radius]);
+    };
+
+    /**
+     * Starts a new path at the specified point.
+     *
+     * @param {Number} cp1x The X coordinate of the first control point.
+     * @param {Number} cp1y The Y coordinate of the first control point.
+     * @param {Number} cp2x The X coordinate of the second control point.
+     * @param {Number} cp2y The Y coordinate of the second control point.
+     * @param {Number} x The X coordinate of the endpoint of the curve.
+     * @param {Number} y The Y coordinate of the endpoint of the curve.
+     */
+    this.curveTo = function(cp1x, cp1y, cp2x, cp2y, x, y) {
+        if (layer.autosize) fitRect(x, y, 0, 0);
+        addSegment("bezierCurveTo", [cp1x, cp1y, cp2x, cp2y, x, y],
+                [cp1x, cp1y, cp2x, cp2y, x, y]);
+    };
+
+    /**
+     * Closes the current path by connecting the end point with the start
+     * point (if any) with a straight line.
+     */
+    this.close = function() {
+        path.push({ 'op' : 'closePath', 'args' : [], 'matrix' : state.matrix.slice() });
+        pathClosed = true;
+    };
+
+    /**
+     * Add the specified rectangle to the current path.
+     *
+     * @param {Number} x The X coordinate of the upper-left corner of the
+     *                   rectangle to draw.
+     * @param {Number} y The Y coordinate of the upper-left corner of the
+     *                   rectangle to draw.
+     * @param {Number} w The width of the rectangle to draw.
+     * @param {Number} h The height of the rectangle to draw.
+     */
+    this.rect = function(x, y, w, h) {
+        if (layer.autosize) fitRect(x, y, w, h);
+        addSegment("rect", [x, y, w, h], [x, y, x + w, y, x, y + h, x + w, y + h]);
+    };
+
+    /**
+     * Clip all future drawing operations by the current path. The current path
+     * is implicitly closed. The current path can continue to be reused
+     * for other operations (such as fillColor()) but a new path will be started
+     * once a path drawing operation (path() or rect()) is used.
+     */
+    this.clip = function() {
+
+        // Narrow clipping region to current path
+        var bounds = pathBounds || { 'x1' : 0, 'y1' : 0, 'x2' : 0, 'y2' : 0 };
+        var clip = state.clipBounds;
+        if (clip)
+            bounds = {
+                'x1' : Math.max(clip.x1, bounds.x1),
+                'y1' : Math.max(clip.y1, bounds.y1),
+                'x2' : Math.min(clip.x2, bounds.x2),
+                'y2' : Math.min(clip.y2, bounds.y2)
+            };
+
+        state.clips.push(path.slice());
+        state.clipBounds = bounds;
+
+        // Path now implicitly closed
+        pathClosed = true;
+
+    };
+
+    /**
+     * Stroke the current path with the specified color. The current path
+     * is implicitly closed. The current path can continue to be reused
+     * for other operations (such as clip()) but a new path will be started
+     * once a path drawing operation (path() or rect()) is used.
+     *
+     * @param {String} cap The line cap style. Can be "round", "square",
+     *                     or "butt".
+     * @param {String} join The line join style. Can be "round", "bevel",
+     *                      or "miter".
+     * @param {Number} thickness The line thickness in pixels.
+     * @param {Number} r The red component of the color to fill.
+     * @param {Number} g The green component of the color to fill.
+     * @param {Number} b The blue component of the color to fill.
+     * @param {Number} a The alpha component of the color to fill.
+     */
+    this.strokeColor = function(cap, join, thickness, r, g, b, a) {
+
+        var segments = path;
+        paint(strokeBounds(join, thickness), function strokeTile(tile, context) {
+            replayPath(tile, segments);
+            setMatrix(tile, state.matrix);
+            context.lineCap = cap;
+            context.lineJoin = join;
+            context.lineWidth = thickness;
+            context.strokeStyle = "rgba(" + r + "," + g + "," + b + "," + a/255.0 + ")";
+            context.stroke();
+        });
+
+        // Path now implicitly closed
+        pathClosed = true;
+
+    };
+
+    /**
+     * Fills the current path with the specified color. The current path
+     * is implicitly closed. The current path can continue to be reused
+     * for other operations (such as clip()) but a new path will be started
+     * once a path drawing operation (path() or rect()) is used.
+     *
+     * @param {Number} r The red component of the color to fill.
+     * @param {Number} g The green component of the color to fill.
+     * @param {Number} b The blue component of the color to fill.
+     * @param {Number} a The alpha component of the color to fill.
+     */
+    this.fillColor = function(r, g, b, a) {
+
+        var segments = path;
+        paint(pathBounds, function fillTile(tile, context) {
+            replayPath(tile, segments);
+            setMatrix(tile, state.matrix);
+            context.fillStyle = "rgba(" + r + "," + g + "," + b + "," + a/255.0 + ")";
+            context.fill();
+        });
+
+        // Path now implicitly closed
+        pathClosed = true;
+
+    };
+
+    /**
+     * Stroke the current path with the image within the specified layer. The
+     * image data will be tiled infinitely within the stroke. The current path
+     * is implicitly closed. The current path can continue to be reused
+     * for other operations (such as clip()) but a new path will be started
+     * once a path drawing operation (path() or rect()) is used.
+     *
+     * @param {String} cap The line cap style. Can be "round", "square",
+     *                     or "butt".
+     * @param {String} join The line join style. Can be "round", "bevel",
+     *                      or "miter".
+     * @param {Number} thickness The line thickness in pixels.
+     * @param {Guacamole.Layer|Guacamole.TiledLayer} srcLayer
+     *     The layer to use as a repeating pattern within the stroke.
+     */
+    this.strokeLayer = function(cap, join, thickness, srcLayer) {
+
+        var segments = path;
+        var pattern = srcLayer.getCanvas();
+        paint(strokeBounds(join, thickness), function strokeTile(tile, context) {
+            replayPath(tile, segments);
+            setMatrix(tile, state.matrix);
+            context.lineCap = cap;
+            context.lineJoin = join;
+            context.lineWidth = thickness;
+            context.strokeStyle = context.createPattern(pattern, "repeat");
+            context.stroke();
+        });
+
+        // Path now implicitly closed
+        pathClosed = true;
+
+    };
+
+    /**
+     * Fills the current path with the image within the specified layer. The
+     * image data will be tiled infinitely within the stroke. The current path
+     * is implicitly closed. The current path can continue to be reused
+     * for other operations (such as clip()) but a new path will be started
+     * once a path drawing operation (path() or rect()) is used.
+     *
+     * @param {Guacamole.Layer|Guacamole.TiledLayer} srcLayer
+     *     The layer to use as a repeating pattern within the fill.
+     */
+    this.fillLayer = function(srcLayer) {
+
+        var segments = path;
+        var pattern = srcLayer.getCanvas();
+        paint(pathBounds, function fillTile(tile, context) {
+            replayPath(tile, segments);
+            setMatrix(tile, state.matrix);
+            context.fillStyle = context.createPattern(pattern, "repeat");
+            context.fill();
+        });
+
+        // Path now implicitly closed
+        pathClosed = true;
+
+    };
+
+    /**
+     * Push current layer state onto stack.
+     */
+    this.push = function() {
+        stack.push(copyState(state));
+    };
+
+    /**
+     * Pop layer state off stack.
+     */
+    this.pop = function() {
+        if (stack.length > 0)
+            state = stack.pop();
+    };
+
+    /**
+     * Reset the layer, clearing the stack, the current path, and any transform
+     * matrix. As with Guacamole.Layer, the image content of the layer is
+     * unaffected.
+     */
+    this.reset = function() {
+
+        // Clear stack and restore to initial state
+        stack = [];
+        state = copyState(initialState);
+
+        // Clear path
+        path = [];
+        pathBounds = null;
+        pathClosed = false;
+
+    };
+
+    /**
+     * Sets the given affine transform (defined with six values from the
+     * transform's matrix).
+     *
+     * @param {Number} a The first value in the affine transform's matrix.
+     * @param {Number} b The second value in the affine transform's matrix.
+     * @param {Number} c The third value in the affine transform's matrix.
+     * @param {Number} d The fourth value in the affine transform's matrix.
+     * @param {Number} e The fifth value in the affine transform's matrix.
+     * @param {Number} f The sixth value in the affine transform's matrix.
+     */
+    this.setTransform = function(a, b, c, d, e, f) {
+        state.matrix = [a, b, c, d, e, f];
+    };
+
+    /**
+     * Applies the given affine transform (defined with six values from the
+     * transform's matrix).
+     *
+     * @param {Number} a The first value in the affine transform's matrix.
+     * @param {Number} b The second value in the affine transform's matrix.
+     * @param {Number} c The third value in the affine transform's matrix.
+     * @param {Number} d The fourth value in the affine transform's matrix.
+     * @param {Number} e The fifth value in the affine transform's matrix.
+     * @param {Number} f The sixth value in the affine transform's matrix.
+     */
+    this.transform = function(a, b, c, d, e, f) {
+        var m = state.matrix;
+        state.matrix = [
+            m[0] * a + m[2] * b,
+            m[1] * a + m[3] * b,
+            m[0] * c + m[2] * d,
+            m[1] * c + m[3] * d,
+            m[0] * e + m[2] * f + m[4],
+            m[1] * e + m[3] * f + m[5]
+        ];
+    };
+
+    /**
+     * Sets the channel mask for future operations on this TiledLayer.
+     *
+     * @see Guacamole.Layer#setChannelMask
+     * @param {Number} mask The channel mask for future operations on this
+     *                      Layer.
+     */
+    this.setChannelMask = function(mask) {
+        if (compositeOperation[mask])
+            state.composite = compositeOperation[mask];
+    };
+
+    /**
+     * Sets the miter limit for stroke operations using the miter join. This
+     * limit is the maximum ratio of the size of the miter join to the stroke
+     * width. If this ratio is exceeded, the miter will not be drawn for that
+     * joint of the path.
+     *
+     * @param {Number} limit The miter limit for stroke operations using the
+     *                       miter join.
+     */
+    this.setMiterLimit = function(limit) {
+        if (limit > 0)
+            state.miterLimit = limit;
+    };
+
+    // Initialize storage dimensions
+    resize(width, height);
+
+};
+
+/**
+ * Whether Guacamole.Display should store off-screen buffers as
+ * Guacamole.TiledLayer rather than Guacamole.Layer. This is disabled by
+ * default and affects only buffers created after it is set.
+ *
+ * @type {Boolean}
+ */
+Guacamole.TiledLayer.enabled = false;
@@ -54,6 +54,16 @@ Guacamole.Tunnel = function() {
      */
     this.sendMessage = function(elements) {};
 
+    /**
+     * Immediately sends any messages which have been queued by sendMessage()
+     * but not yet sent. Tunnels may batch messages sent within the same task,
+     * sending them together once that task completes. Calling this function
+     * sends such messages without waiting, and should be used for messages
+     * whose latency matters more than the cost of sending them separately.
+     * Tunnels which do not batch messages need not implement this function.
+     */
+    this.flush = function() {};
+
     /**
      * Changes the stored numeric state of this tunnel, firing the onstatechange
      * event if the new state is different and a handler has been defined.
@@ -223,6 +233,32 @@ Guacamole.Tunnel.State = {
 
 };
 
+/**
+ * Schedules the given function to be invoked once the currently-executing
+ * task has completed, before control returns to the browser event loop. If
+ * the browser supports neither queueMicrotask() nor promises, the function is
+ * invoked immediately.
+ *
+ * @private
+ * @param {function} callback
+ *     The function to invoke.
+ */
+Guacamole.Tunnel.queueMicrotask = function queueMicrotask(callback) {
+
+    // Use native microtask queue if available
+    if (window.queueMicrotask)
+        window.queueMicrotask(callback);
+
+    // Otherwise, approximate using a promise resolution
+    else if (window.Promise)
+        window.Promise.resolve().then(callback);
+
+    // Without either, there is no way to defer until the task completes
+    else
+        callback();
+
+};
+
 /**
  * Guacamole Tunnel implemented over HTTP via XMLHttpRequest.
  * 
@@ -263,6 +299,15 @@ Guacamole.HTTPTunnel = function(tunnelURL, crossDomain, extraTunnelHeaders) {
     var sendingMessages = false;
     var outputMessageBuffer = "";
 
+    /**
+     * Whether a flush of outputMessageBuffer has been scheduled to occur once
+     * the current task completes.
+     *
+     * @private
+     * @type {Boolean}
+     */
+    var flushScheduled = false;
+
     // If requests are expected to be cross-domain, the cookie that the HTTP
     // tunnel depends on will only be sent if withCredentials is true
     var withCredentials = !!crossDomain;
@@ -387,9 +432,17 @@ Guacamole.HTTPTunnel = function(tunnelURL, crossDomain, extraTunnelHeaders) {
 
         }
 
+        // Send any messages queued prior to a clean disconnect (such as the
+        // "disconnect" instruction itself) rather than dropping them
+        if (status.code === Guacamole.Status.Code.SUCCESS && !sendingMessages)
+            sendPendingMessages();
+
         // Reset output message buffer
         sendingMessages = false;
 
+        // Stop any in-progress streaming reads
+        abortStreamingRequests();
+
         // Mark as closed
         tunnel.setState(Guacamole.Tunnel.State.CLOSED);
 
@@ -432,7 +485,21 @@ Guacamole.HTTPTunnel = function(tunnelURL, crossDomain, extraTunnelHeaders) {
         // Add message to buffer
         outputMessageBuffer += message;
 
-        // Send if not currently sending
+        // Send once the current task completes if not currently sending,
+        // such that all messages sent within that task share one request
+        if (!sendingMessages && !flushScheduled) {
+            flushScheduled = true;
+            Guacamole.Tunnel.queueMicrotask(tunnel.flush);
+        }
+
+    };
+
+    this.flush = function flush() {
+
+        flushScheduled = false;
+
+        // Queued messages will be sent automatically once any in-progress
+        // request completes
         if (!sendingMessages)
             sendPendingMessages();
 
@@ -480,12 +547,32 @@ Guacamole.HTTPTunnel = function(tunnelURL, crossDomain, extraTunnelHeaders) {
 
     }
 
+    /**
+     * Returns the value of the given header within the given response, which
+     * may be either an XMLHttpRequest or a Response returned by fetch().
+     *
+     * @private
+     * @param {XMLHttpRequest|Response} response
+     *     The response to read the header from.
+     *
+     * @param {String} name
+     *     The name of the header to read.
+     *
+     * @returns {String}
+     *     The value of the header, or null if the header is not present.
+     */
+    function getResponseHeader(response, name) {
+        if (response.headers)
+            return response.headers.get(name);
+        return response.getResponseHeader(name);
+    }
+
     function handleHTTPTunnelError(xmlhttprequest) {
 
         // Pull status code directly from headers provided by Guacamole
-        var code = parseInt(xmlhttprequest.getResponseHeader("Guacamole-Status-Code"));
+        var code = parseInt(getResponseHeader(xmlhttprequest, "Guacamole-Status-Code"));
         if (code) {
-            var message = xmlhttprequest.getResponseHeader("Guacamole-Error-Message");
+            var message = getResponseHeader(xmlhttprequest, "Guacamole-Error-Message");
             close_tunnel(new Guacamole.Status(code, message));
         }
 
@@ -509,14 +596,27 @@ Guacamole.HTTPTunnel = function(tunnelURL, crossDomain, extraTunnelHeaders) {
 
         var dataUpdateEvents = 0;
 
-        // The location of the last element's terminator
-        var elementEnd = -1;
+        // The number of characters of the response already parsed
+        var parsedLength = 0;
 
-        // Where to start the next length search or the next element
-        var startIndex = 0;
+        // Whether the end of the response has been reached
+        var responseComplete = false;
 
-        // Parsed elements
-        var elements = new Array();
+        // Parser for the instructions within this response
+        var parser = new Guacamole.Parser();
+        parser.oninstruction = function instructionReceived(opcode, args) {
+
+            // An empty internal instruction marks the end of the response
+            if (opcode === Guacamole.Tunnel.INTERNAL_DATA_OPCODE && args.length === 0) {
+                responseComplete = true;
+                return;
+            }
+
+            // Call instruction handler.
+            if (!responseComplete && tunnel.oninstruction)
+                tunnel.oninstruction(opcode, args);
+
+        };
 
         function parseResponse() {
 
@@ -577,83 +677,39 @@ Guacamole.HTTPTunnel = function(tunnelURL, crossDomain, extraTunnelHeaders) {
                 // Do not attempt to parse if data could not be read
                 catch (e) { return; }
 
-                // While search is within currently received data
-                while (elementEnd < current.length) {
-
-                    // If we are waiting for element data
-                    if (elementEnd >= startIndex) {
-
-                        // We now have enough data for the element. Parse.
-                        var element = current.substring(startIndex, elementEnd);
-                        var terminator = current.substring(elementEnd, elementEnd+1);
+                // Parse only the data received since the last call
+                if (current.length > parsedLength) {
 
-                        // Add element to array
-                        elements.push(element);
-
-                        // If last element, handle instruction
-                        if (terminator === ";") {
-
-                            // Get opcode
-                            var opcode = elements.shift();
-
-                            // Call instruction handler.
-                            if (tunnel.oninstruction)
-                                tunnel.oninstruction(opcode, elements);
-
-                            // Clear elements
-                            elements.length = 0;
-
-                        }
-
-                        // Start searching for length at character after
-                        // element terminator
-                        startIndex = elementEnd + 1;
+                    var packet = current.substring(parsedLength);
+                    parsedLength = current.length;
 
+                    // Close the tunnel if the response cannot be parsed
+                    try {
+                        parser.receive(packet);
+                    }
+                    catch (e) {
+                        close_tunnel(new Guacamole.Status(Guacamole.Status.Code.SERVER_ERROR, e.message));
+                        return;
                     }
 
-                    // Search for end of length
-                    var lengthEnd = current.indexOf(".", startIndex);
-                    if (lengthEnd !== -1) {
-
-                        // Parse length
-                        var length = parseInt(current.substring(elementEnd+1, lengthEnd));
-
-                        // If we're done parsing, handle the next response.
-                        if (length === 0) {
-
-                            // Clean up interval if polling
-                            if (interval)
-                                clearInterval(interval);
-                           
-                            // Clean up object
-                            xmlhttprequest.onreadystatechange = null;
-                            xmlhttprequest.abort();
-
-                            // Start handling next request
-                            if (nextRequest)
-                                handleResponse(nextRequest);
-
-                            // Done parsing
-                            break;
+                }
 
-                        }
+                // If we're done parsing, handle the next response.
+                if (responseComplete) {
 
-                        // Calculate start of element
-                        startIndex = lengthEnd + 1;
+                    // Clean up interval if polling
+                    if (interval)
+                        clearInterval(interval);
 
-                        // Calculate location of element terminator
-                        elementEnd = startIndex + length;
+                    // Clean up object
+                    xmlhttprequest.onreadystatechange = null;
+                    xmlhttprequest.abort();
 
-                    }
-                    
-                    // If no period yet, continue search when more data
-                    // is received
-                    else {
-                        startIndex = current.length;
-                        break;
-                    }
+                    // Start handling next request
+                    if (nextRequest)
+                        handleResponse(nextRequest);
 
-                } // end parse loop
+                }
 
             }
 
@@ -705,6 +761,222 @@ Guacamole.HTTPTunnel = function(tunnelURL, crossDomain, extraTunnelHeaders) {
 
     }
 
+    /**
+     * Whether tunnel reads should be performed using fetch() and a
+     * ReadableStream, parsing each chunk of the response as it arrives. If
+     * false, reads are performed using XMLHttpRequest, repeatedly re-reading
+     * the growing responseText.
+     *
+     * @private
+     * @constant
+     * @type {Boolean}
+     */
+    var STREAMING_ENABLED = typeof fetch === 'function'
+                         && typeof ReadableStream !== 'undefined'
+                         && typeof AbortController !== 'undefined'
+                         && Guacamole.Parser.isBinarySupported();
+
+    /**
+     * All streaming read requests which have been made but have not yet
+     * completed. Each request is an object containing the AbortController
+     * which may be used to abort the request ("controller") and a Promise
+     * which resolves with the Response once its headers have been received
+     * ("response").
+     *
+     * @private
+     * @type {Object[]}
+     */
+    var activeStreamingRequests = [];
+
+    /**
+     * Aborts the given streaming read request, if it has not already
+     * completed.
+     *
+     * @private
+     * @param {Object} request
+     *     The streaming read request to abort, as returned by
+     *     makeStreamingRequest().
+     */
+    function abortStreamingRequest(request) {
+
+        var index = activeStreamingRequests.indexOf(request);
+        if (index !== -1)
+            activeStreamingRequests.splice(index, 1);
+
+        request.controller.abort();
+
+    }
+
+    /**
+     * Aborts all streaming read requests which have not yet completed.
+     *
+     * @private
+     */
+    function abortStreamingRequests() {
+        while (activeStreamingRequests.length)
+            abortStreamingRequest(activeStreamingRequests[0]);
+    }
+
+    /**
+     * Begins a new tunnel read request using fetch(). The body of the
+     * response is not consumed until the request is passed to
+     * handleStreamingResponse().
+     *
+     * @private
+     * @returns {Object}
+     *     An object containing the AbortController which may be used to abort
+     *     the request ("controller") and a Promise which resolves with the
+     *     Response once its headers have been received ("response").
+     */
+    function makeStreamingRequest() {
+
+        var controller = new AbortController();
+
+        // Make request, increment request ID
+        var request = {
+            controller : controller,
+            response   : fetch(TUNNEL_READ + tunnel.uuid + ":" + (request_id++), {
+                method      : 'GET',
+                headers     : extraHeaders,
+                credentials : withCredentials ? 'include' : 'same-origin',
+                cache       : 'no-store',
+                signal      : controller.signal
+            })
+        };
+
+        activeStreamingRequests.push(request);
+        return request;
+
+    }
+
+    /**
+     * Reads the body of the response to the given streaming read request,
+     * parsing and dispatching each instruction as soon as the chunk
+     * containing it is received. Once the end of the response is reached,
+     * handling continues with the next request, which is made as soon as the
+     * headers of the current response have been received.
+     *
+     * @private
+     * @param {Object} request
+     *     The streaming read request to handle, as returned by
+     *     makeStreamingRequest().
+     */
+    function handleStreamingResponse(request) {
+
+        var nextRequest = null;
+
+        // Whether the end of the response has been reached
+        var responseComplete = false;
+
+        // Parser for the instructions within this response
+        var parser = new Guacamole.Parser();
+        parser.oninstruction = function instructionReceived(opcode, args) {
+
+            // An empty internal instruction marks the end of the response
+            if (opcode === Guacamole.Tunnel.INTERNAL_DATA_OPCODE && args.length === 0) {
+                responseComplete = true;
+                return;
+            }
+
+            // Call instruction handler.
+            if (!responseComplete && tunnel.oninstruction)
+                tunnel.oninstruction(opcode, args);
+
+        };
+
+        // Close the tunnel if the request fails at the network level, unless
+        // the failure is the result of the request being aborted
+        var requestFailed = function requestFailed() {
+
+            if (request.controller.signal.aborted || !tunnel.isConnected())
+                return;
+
+            abortStreamingRequests();
+            close_tunnel(new Guacamole.Status(Guacamole.Status.Code.UPSTREAM_NOT_FOUND));
+
+        };
+
+        // Close the tunnel if the response cannot be handled, such as if a
+        // received chunk cannot be parsed (closing the tunnel also aborts all
+        // outstanding requests)
+        var responseFailed = function responseFailed(e) {
+            close_tunnel(new Guacamole.Status(Guacamole.Status.Code.SERVER_ERROR, e.message));
+        };
+
+        request.response.then(function responseReceived(response) {
+
+            // Do not handle responses if not connected
+            if (!tunnel.isConnected()) {
+                abortStreamingRequest(request);
+                return;
+            }
+
+            reset_timeout();
+
+            // Halt on error during request
+            if (response.status !== 200) {
+                abortStreamingRequests();
+                handleHTTPTunnelError(response);
+                return;
+            }
+
+            // Start next request as soon as possible
+            nextRequest = makeStreamingRequest();
+
+            var reader = response.body.getReader();
+            var readChunk = function readChunk() {
+                reader.read().then(function chunkReceived(result) {
+
+                    // Do not handle responses if not connected
+                    if (!tunnel.isConnected()) {
+                        abortStreamingRequests();
+                        return;
+                    }
+
+                    // If the response ended without the end-of-instructions
+                    // marker, the server has either closed the tunnel or
+                    // failed, either of which will be reported by the
+                    // response to the next request
+                    if (result.done) {
+                        abortStreamingRequest(request);
+                        handleStreamingResponse(nextRequest);
+                        return;
+                    }
+
+                    reset_timeout();
+                    parser.receive(result.value);
+
+                    // If we're done parsing, handle the next response
+                    if (responseComplete) {
+                        abortStreamingRequest(request);
+                        handleStreamingResponse(nextRequest);
+                        return;
+                    }
+
+                    readChunk();
+
+                }, requestFailed).then(null, responseFailed);
+            };
+
+            readChunk();
+
+        }, requestFailed).then(null, responseFailed);
+
+    }
+
+    /**
+     * Begins reading instructions from the tunnel, using the streaming fetch()
+     * transport if supported by the browser and XMLHttpRequest otherwise.
+     *
+     * @private
+     */
+    function startReading() {
+        if (STREAMING_ENABLED)
+            handleStreamingResponse(makeStreamingRequest());
+        else
+            handleResponse(makeRequest());
+    }
+
     this.connect = function(data) {
 
         // Start waiting for connect
@@ -740,7 +1012,7 @@ Guacamole.HTTPTunnel = function(tunnelURL, crossDomain, extraTunnelHeaders) {
             }, PING_FREQUENCY);
 
             // Start reading data
-            handleResponse(makeRequest());
+            startReading();
 
         };
 
@@ -781,6 +1053,15 @@ Guacamole.WebSocketTunnel = function(tunnelURL) {
      */
     var socket = null;
 
+    /**
+     * The parser used to parse instructions received over the WebSocket.
+     * A new parser is created for each connection.
+     *
+     * @private
+     * @type {Guacamole.Parser}
+     */
+    var parser = null;
+
     /**
      * The current receive timeout ID, if any.
      * @private
@@ -824,6 +1105,24 @@ Guacamole.WebSocketTunnel = function(tunnelURL) {
      */
     var PING_FREQUENCY = 500;
 
+    /**
+     * All messages which have been queued by sendMessage() but not yet sent
+     * over the WebSocket, concatenated together.
+     *
+     * @private
+     * @type {String}
+     */
+    var outputMessageBuffer = "";
+
+    /**
+     * Whether a flush of outputMessageBuffer has been scheduled to occur once
+     * the current task completes.
+     *
+     * @private
+     * @type {Boolean}
+     */
+    var flushScheduled = false;
+
     // Transform current URL to WebSocket URL
 
     // If not already a websocket URL
@@ -911,6 +1210,14 @@ Guacamole.WebSocketTunnel = function(tunnelURL) {
         if (status.code !== Guacamole.Status.Code.SUCCESS && tunnel.onerror)
             tunnel.onerror(status);
 
+        // Send any messages queued prior to a clean disconnect (such as the
+        // "disconnect" instruction itself) rather than dropping them
+        if (status.code === Guacamole.Status.Code.SUCCESS)
+            tunnel.flush();
+
+        // Messages queued for a failed connection can no longer be sent
+        outputMessageBuffer = "";
+
         // Mark as closed
         tunnel.setState(Guacamole.Tunnel.State.CLOSED);
 
@@ -951,7 +1258,28 @@ Guacamole.WebSocketTunnel = function(tunnelURL) {
         // Final terminator
         message += ";";
 
-        socket.send(message);
+        // Queue message, sending all messages queued within the current task
+        // together as a single WebSocket message once that task completes
+        outputMessageBuffer += message;
+        if (!flushScheduled) {
+            flushScheduled = true;
+            Guacamole.Tunnel.queueMicrotask(tunnel.flush);
+        }
+
+    };
+
+    this.flush = function flush() {
+
+        flushScheduled = false;
+
+        // Do not attempt to send messages if not connected
+        if (!tunnel.isConnected() || !outputMessageBuffer)
+            return;
+
+        var messages = outputMessageBuffer;
+        outputMessageBuffer = "";
+
+        socket.send(messages);
 
     };
 
@@ -962,6 +1290,28 @@ Guacamole.WebSocketTunnel = function(tunnelURL) {
         // Mark the tunnel as connecting
         tunnel.setState(Guacamole.Tunnel.State.CONNECTING);
 
+        // Parse instructions received from the socket
+        parser = new Guacamole.Parser();
+        parser.oninstruction = function instructionReceived(opcode, args) {
+
+            // Update state and UUID when first instruction received
+            if (tunnel.uuid === null) {
+
+                // Associate tunnel UUID if received
+                if (opcode === Guacamole.Tunnel.INTERNAL_DATA_OPCODE)
+                    tunnel.setUUID(args[0]);
+
+                // Tunnel is now open and UUID is available
+                tunnel.setState(Guacamole.Tunnel.State.OPEN);
+
+            }
+
+            // Call instruction handler.
+            if (opcode !== Guacamole.Tunnel.INTERNAL_DATA_OPCODE && tunnel.oninstruction)
+                tunnel.oninstruction(opcode, args);
+
+        };
+
         // Connect socket
         socket = new WebSocket(tunnelURL + "?" + data, "guacamole");
 
@@ -997,72 +1347,13 @@ Guacamole.WebSocketTunnel = function(tunnelURL) {
 
             reset_timeout();
 
-            var message = event.data;
-            var startIndex = 0;
-            var elementEnd;
-
-            var elements = [];
-
-            do {
-
-                // Search for end of length
-                var lengthEnd = message.indexOf(".", startIndex);
-                if (lengthEnd !== -1) {
-
-                    // Parse length
-                    var length = parseInt(message.substring(elementEnd+1, lengthEnd));
-
-                    // Calculate start of element
-                    startIndex = lengthEnd + 1;
-
-                    // Calculate location of element terminator
-                    elementEnd = startIndex + length;
-
-                }
-                
-                // If no period, incomplete instruction.
-                else
-                    close_tunnel(new Guacamole.Status(Guacamole.Status.Code.SERVER_ERROR, "Incomplete instruction."));
-
-                // We now have enough data for the element. Parse.
-                var element = message.substring(startIndex, elementEnd);
-                var terminator = message.substring(elementEnd, elementEnd+1);
-
-                // Add element to array
-                elements.push(element);
-
-                // If last element, handle instruction
-                if (terminator === ";") {
-
-                    // Get opcode
-                    var opcode = elements.shift();
-
-                    // Update state and UUID when first instruction received
-                    if (tunnel.uuid === null) {
-
-                        // Associate tunnel UUID if received
-                        if (opcode === Guacamole.Tunnel.INTERNAL_DATA_OPCODE)
-                            tunnel.setUUID(elements[0]);
-
-                        // Tunnel is now open and UUID is available
-                        tunnel.setState(Guacamole.Tunnel.State.OPEN);
-
-                    }
-
-                    // Call instruction handler.
-                    if (opcode !== Guacamole.Tunnel.INTERNAL_DATA_OPCODE && tunnel.oninstruction)
-                        tunnel.oninstruction(opcode, elements);
-
-                    // Clear elements
-                    elements.length = 0;
-
-                }
-
-                // Start searching for length at character after
-                // element terminator
-                startIndex = elementEnd + 1;
-
-            } while (startIndex < message.length);
+            // Close the tunnel if the message cannot be parsed
+            try {
+                parser.receive(event.data);
+            }
+            catch (e) {
+                close_tunnel(new Guacamole.Status(Guacamole.Status.Code.SERVER_ERROR, e.message));
+            }
 
         };
 
@@ -1134,6 +1425,7 @@ Guacamole.ChainedTunnel = function(tunnelChain) {
         // Set own functions to tunnel's functions
         chained_tunnel.disconnect  = tunnel.disconnect;
         chained_tunnel.sendMessage = tunnel.sendMessage;
+        chained_tunnel.flush       = tunnel.flush;
 
         /**
          * Fails the currently-attached tunnel, attaching a new tunnel if
@@ -1265,7 +1557,12 @@ Guacamole.ChainedTunnel.prototype = new Guacamole.Tunnel();
 /**
  * Guacamole Tunnel which replays a Guacamole protocol dump from a static file
  * received via HTTP. Instructions within the file are parsed and handled as
- * quickly as possible, while the file is being downloaded.
+ * quickly as possible, while the file is being downloaded. Where supported by
+ * the browser, the file is streamed using fetch() such that data which has
+ * already been parsed need not be retained. Arbitrary byte ranges of the file
+ * may also be read independently of the tunnel connection with readRange(),
+ * and isRangeSupported() reports whether the server has been observed to
+ * support reading those ranges without downloading the entire file.
  *
  * @constructor
  * @augments Guacamole.Tunnel
@@ -1300,6 +1597,40 @@ Guacamole.StaticHTTPTunnel = function StaticHTTPTunnel(url, crossDomain, extraTu
      */
     var xhr = null;
 
+    /**
+     * The AbortController of the current, in-progress streaming request made
+     * using fetch(). If no such request is in progress, this will be null.
+     *
+     * @private
+     * @type {AbortController}
+     */
+    var abortController = null;
+
+    /**
+     * Whether the file should be downloaded using fetch() and a
+     * ReadableStream, parsing each chunk as it arrives. If false, the file is
+     * downloaded using XMLHttpRequest, repeatedly re-reading the growing
+     * responseText.
+     *
+     * @private
+     * @constant
+     * @type {Boolean}
+     */
+    var STREAMING_ENABLED = typeof fetch === 'function'
+                         && typeof ReadableStream !== 'undefined'
+                         && typeof AbortController !== 'undefined'
+                         && Guacamole.Parser.isBinarySupported();
+
+    /**
+     * Whether the server providing the file supports HTTP range requests, as
+     * observed from the responses received thus far, or null if this is not
+     * yet known.
+     *
+     * @private
+     * @type {Boolean}
+     */
+    var rangeSupported = null;
+
     /**
      * Additional headers to be sent in tunnel requests. This dictionary can be
      * populated with key/value header pairs to pass information such as authentication
@@ -1326,6 +1657,131 @@ Guacamole.StaticHTTPTunnel = function StaticHTTPTunnel(url, crossDomain, extraTu
         }
     }
 
+    /**
+     * Updates whether the server is known to support HTTP range requests
+     * based on the "Accept-Ranges" header of a response. The header may be
+     * absent or, for cross-domain requests, inaccessible, in which case
+     * nothing is learned.
+     *
+     * @private
+     * @param {String} acceptRanges
+     *     The value of the "Accept-Ranges" header, or null if the header is
+     *     absent or inaccessible.
+     */
+    function updateRangeSupport(acceptRanges) {
+        if (acceptRanges === 'bytes')
+            rangeSupported = true;
+        else if (acceptRanges === 'none')
+            rangeSupported = false;
+    }
+
+    /**
+     * Notifies the onerror handler of the failure of the given HTTP request,
+     * if any such handler is set.
+     *
+     * @private
+     * @param {XMLHttpRequest|Response} response
+     *     The failed request.
+     */
+    function requestFailed(response) {
+        if (tunnel.onerror)
+            tunnel.onerror(new Guacamole.Status(
+                Guacamole.Status.Code.fromHTTPCode(response.status), response.statusText));
+    }
+
+    /**
+     * Notifies the onerror handler that received data could not be handled,
+     * such as if the data could not be parsed, and closes the tunnel.
+     *
+     * @private
+     * @param {Error} e
+     *     The error thrown while handling the received data.
+     */
+    function parseFailed(e) {
+
+        if (tunnel.onerror)
+            tunnel.onerror(new Guacamole.Status(
+                Guacamole.Status.Code.SERVER_ERROR, e.message));
+
+        tunnel.disconnect();
+
+    }
+
+    /**
+     * Downloads the file using fetch(), passing each received chunk to the
+     * given parser as it arrives.
+     *
+     * @private
+     * @param {Guacamole.Parser} parser
+     *     The parser which should receive the contents of the file.
+     */
+    function streamFile(parser) {
+
+        var controller = abortController = new AbortController();
+
+        // Close tunnel upon failure, unless the tunnel was closed by the
+        // request being aborted
+        var streamFailed = function streamFailed() {
+            if (!controller.signal.aborted) {
+                requestFailed({ 'status' : 0, 'statusText' : null });
+                tunnel.disconnect();
+            }
+        };
+
+        fetch(url, {
+            method      : 'GET',
+            headers     : extraHeaders,
+            credentials : crossDomain ? 'include' : 'same-origin',
+            signal      : controller.signal
+        }).then(function responseReceived(response) {
+
+            if (controller.signal.aborted)
+                return;
+
+            // Fail if file could not be downloaded via HTTP
+            if (!response.ok) {
+                requestFailed(response);
+                tunnel.disconnect();
+                return;
+            }
+
+            // Connection is open
+            tunnel.setState(Guacamole.Tunnel.State.OPEN);
+            updateRangeSupport(response.headers.get('Accept-Ranges'));
+
+            var reader = response.body.getReader();
+            var readChunk = function readChunk() {
+                reader.read().then(function chunkReceived(result) {
+
+                    if (controller.signal.aborted)
+                        return;
+
+                    // Clean up and close when done
+                    if (result.done) {
+                        tunnel.disconnect();
+                        return;
+                    }
+
+                    // Close the tunnel if the chunk cannot be parsed
+                    try {
+                        parser.receive(result.value);
+                    }
+                    catch (e) {
+                        parseFailed(e);
+                        return;
+                    }
+
+                    readChunk();
+
+                }, streamFailed);
+            };
+
+            readChunk();
+
+        }, streamFailed);
+
+    }
+
     this.sendMessage = function sendMessage(elements) {
         // Do nothing
     };
@@ -1338,6 +1794,21 @@ Guacamole.StaticHTTPTunnel = function StaticHTTPTunnel(url, crossDomain, extraTu
         // Connection is now starting
         tunnel.setState(Guacamole.Tunnel.State.CONNECTING);
 
+        // Create Guacamole protocol parser specifically for this connection
+        var parser = new Guacamole.Parser();
+
+        // Invoke tunnel's oninstruction handler for each parsed instruction
+        parser.oninstruction = function instructionReceived(opcode, args) {
+            if (tunnel.oninstruction)
+                tunnel.oninstruction(opcode, args);
+        };
+
+        // Stream file without retaining its contents, if possible
+        if (STREAMING_ENABLED) {
+            streamFile(parser);
+            return;
+        }
+
         // Start a new connection
         xhr = new XMLHttpRequest();
         xhr.open('GET', url);
@@ -1348,18 +1819,13 @@ Guacamole.StaticHTTPTunnel = function StaticHTTPTunnel(url, crossDomain, extraTu
 
         var offset = 0;
 
-        // Create Guacamole protocol parser specifically for this connection
-        var parser = new Guacamole.Parser();
-
-        // Invoke tunnel's oninstruction handler for each parsed instruction
-        parser.oninstruction = function instructionReceived(opcode, args) {
-            if (tunnel.oninstruction)
-                tunnel.oninstruction(opcode, args);
-        };
-
         // Continuously parse received data
         xhr.onreadystatechange = function readyStateChanged() {
 
+            // Note whether ranges are supported once headers are received
+            if (xhr.readyState === 2)
+                updateRangeSupport(xhr.getResponseHeader('Accept-Ranges'));
+
             // Parse while data is being received
             if (xhr.readyState === 3 || xhr.readyState === 4) {
 
@@ -1371,8 +1837,19 @@ Guacamole.StaticHTTPTunnel = function StaticHTTPTunnel(url, crossDomain, extraTu
 
                 // Parse only the portion of data which is newly received
                 if (offset < length) {
-                    parser.receive(buffer.substring(offset));
+
+                    var data = buffer.substring(offset);
                     offset = length;
+
+                    // Close the tunnel if the data cannot be parsed
+                    try {
+                        parser.receive(data);
+                    }
+                    catch (e) {
+                        parseFailed(e);
+                        return;
+                    }
+
                 }
 
             }
@@ -1387,10 +1864,7 @@ Guacamole.StaticHTTPTunnel = function StaticHTTPTunnel(url, crossDomain, extraTu
         xhr.onerror = function httpError() {
 
             // Fail if file could not be downloaded via HTTP
-            if (tunnel.onerror)
-                tunnel.onerror(new Guacamole.Status(
-                    Guacamole.Status.Code.fromHTTPCode(xhr.status), xhr.statusText));
-
+            requestFailed(xhr);
             tunnel.disconnect();
         };
 
@@ -1404,11 +1878,92 @@ Guacamole.StaticHTTPTunnel = function StaticHTTPTunnel(url, crossDomain, extraTu
             xhr = null;
         }
 
+        // Likewise abort any streaming request
+        if (abortController) {
+            abortController.abort();
+            abortController = null;
+        }
+
         // Connection is now closed
         tunnel.setState(Guacamole.Tunnel.State.CLOSED);
 
     };
 
+    /**
+     * Reads the given range of bytes from the file using an HTTP range
+     * request, independently of any connection of this tunnel. The range must
+     * begin and end on instruction boundaries, such that the data read can be
+     * decoded and parsed on its own. If the server does not support range
+     * requests, the entire file is downloaded and the requested range is
+     * extracted.
+     *
+     * @param {Number} start
+     *     The offset of the first byte to read.
+     *
+     * @param {Number} end
+     *     The offset of the byte following the last byte to read.
+     *
+     * @param {function} callback
+     *     The callback to invoke with the Uint8Array containing the requested
+     *     range once it has been read. If the range cannot be read, the
+     *     onerror handler is invoked, and the callback receives null.
+     */
+    this.readRange = function readRange(start, end, callback) {
+
+        var request = new XMLHttpRequest();
+        request.open('GET', url);
+        request.withCredentials = !!crossDomain;
+        addExtraHeaders(request, extraHeaders);
+        request.setRequestHeader('Range', 'bytes=' + start + '-' + (end - 1));
+        request.responseType = 'arraybuffer';
+
+        request.onload = function rangeReceived() {
+
+            // Server honored range request
+            if (request.status === 206) {
+                rangeSupported = true;
+                callback(new Uint8Array(request.response));
+            }
+
+            // Server ignored range request and returned entire file
+            else if (request.status === 200) {
+                rangeSupported = false;
+                callback(new Uint8Array(request.response, start, end - start));
+            }
+
+            // Fail if range could not be downloaded via HTTP
+            else {
+                requestFailed(request);
+                callback(null);
+            }
+
+        };
+
+        request.onerror = function rangeFailed() {
+            requestFailed(request);
+            callback(null);
+        };
+
+        request.send(null);
+
+    };
+
+    /**
+     * Returns whether the server providing the file supports HTTP range
+     * requests, such that readRange() downloads only the requested range
+     * rather than the entire file. Support is determined from the
+     * "Accept-Ranges" header of the response to the initial download, if
+     * that header is accessible, and otherwise from the response to the
+     * first invocation of readRange().
+     *
+     * @returns {Boolean}
+     *     true if range requests are known to be supported, false if they are
+     *     known not to be supported, or null if this is not yet known.
+     */
+    this.isRangeSupported = function isRangeSupported() {
+        return rangeSupported;
+    };
+
 };
 
 Guacamole.StaticHTTPTunnel.prototype = new Guacamole.Tunnel();
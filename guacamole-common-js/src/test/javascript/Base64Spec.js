@@ -0,0 +1,92 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/* global Guacamole, expect */
+
+describe("Guacamole.Base64", function Base64Spec() {
+
+    /**
+     * Returns a new Uint8Array containing the given number of random bytes.
+     *
+     * @param {Number} length
+     *     The number of bytes to generate.
+     *
+     * @returns {Uint8Array}
+     *     A new Uint8Array containing random bytes.
+     */
+    var randomBytes = function randomBytes(length) {
+        var bytes = new Uint8Array(length);
+        for (var i = 0; i < bytes.length; i++)
+            bytes[i] = Math.floor(Math.random() * 256);
+        return bytes;
+    };
+
+    /**
+     * Encodes the given bytes using window.btoa(), the reference against
+     * which Guacamole.Base64 is tested.
+     *
+     * @param {Uint8Array} bytes
+     *     The data to encode.
+     *
+     * @returns {String}
+     *     The base64 encoding of the given data.
+     */
+    var btoaBytes = function btoaBytes(bytes) {
+        var binary = '';
+        for (var i = 0; i < bytes.length; i++)
+            binary += String.fromCharCode(bytes[i]);
+        return window.btoa(binary);
+    };
+
+    it("should encode data of every length identically to btoa()", function() {
+        for (var length = 0; length <= 64; length++) {
+            var bytes = randomBytes(length);
+            expect(Guacamole.Base64.encode(bytes)).toBe(btoaBytes(bytes));
+        }
+    });
+
+    it("should encode subarrays and data larger than a blob", function() {
+        var bytes = randomBytes(65536);
+        expect(Guacamole.Base64.encode(bytes)).toBe(btoaBytes(bytes));
+        expect(Guacamole.Base64.encode(bytes.subarray(1000, 7048)))
+                .toBe(btoaBytes(bytes.subarray(1000, 7048)));
+    });
+
+    it("should decode data produced by btoa() of every length", function() {
+        for (var length = 0; length <= 64; length++) {
+            var bytes = randomBytes(length);
+            var decoded = Guacamole.Base64.decode(btoaBytes(bytes));
+            expect(decoded.buffer.byteLength).toBe(length);
+            expect(Array.prototype.slice.call(decoded))
+                    .toEqual(Array.prototype.slice.call(bytes));
+        }
+    });
+
+    it("should decode data without padding", function() {
+        expect(Array.prototype.slice.call(Guacamole.Base64.decode("QQ"))).toEqual([0x41]);
+        expect(Array.prototype.slice.call(Guacamole.Base64.decode("QUI"))).toEqual([0x41, 0x42]);
+    });
+
+    it("should reject data which is not base64", function() {
+        expect(function() { Guacamole.Base64.decode("QUJD*"); }).toThrow();
+        expect(function() { Guacamole.Base64.decode("QUJ\u0143"); }).toThrow();
+        expect(function() { Guacamole.Base64.decode("Q"); }).toThrow();
+    });
+
+});
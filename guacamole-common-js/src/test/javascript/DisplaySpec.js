@@ -0,0 +1,137 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/* global Guacamole, expect */
+
+describe("Guacamole.Display", function DisplaySpec() {
+
+    /**
+     * The Guacamole.Display being tested.
+     *
+     * @type {Guacamole.Display}
+     */
+    var display;
+
+    /**
+     * The default layer of the Guacamole.Display being tested.
+     *
+     * @type {Guacamole.Display.VisibleLayer}
+     */
+    var layer;
+
+    /**
+     * A buffer filled with opaque blue, to be copied onto the default layer.
+     *
+     * @type {Guacamole.Layer}
+     */
+    var buffer;
+
+    /**
+     * Returns the RGBA pixel data of the entire contents of the given canvas.
+     *
+     * @param {HTMLCanvasElement} canvas
+     *     The canvas to read.
+     *
+     * @returns {Number[]}
+     *     The RGBA pixel data of the given canvas.
+     */
+    var getPixels = function getPixels(canvas) {
+        return Array.prototype.slice.call(canvas.getContext('2d')
+                .getImageData(0, 0, canvas.width, canvas.height).data);
+    };
+
+    /**
+     * Fills the entire default layer with opaque red and updates the
+     * composite of the display, such that later changes are drawn to the
+     * composite only within the areas marked as changed.
+     *
+     * @param {function} callback
+     *     The function to invoke once the composite has been updated.
+     */
+    var fillAndFlatten = function fillAndFlatten(callback) {
+
+        display.rect(layer, 0, 0, 64, 64);
+        display.fillColor(layer, 255, 0, 0, 255);
+
+        display.resize(buffer, 16, 16);
+        display.rect(buffer, 0, 0, 16, 16);
+        display.fillColor(buffer, 0, 0, 255, 255);
+
+        display.flush(function frameRendered() {
+            display.flatten(function flattened() {
+                callback();
+            });
+        });
+
+    };
+
+    /**
+     * Verifies that the flattened display matches the current contents of
+     * the default layer.
+     *
+     * @param {function} done
+     *     The function to invoke once verification is complete.
+     */
+    var expectCompositeCurrent = function expectCompositeCurrent(done) {
+        display.flush(function frameRendered() {
+            display.flatten(function flattened(canvas) {
+                expect(getPixels(canvas)).toEqual(getPixels(layer.toCanvas()));
+                done();
+            });
+        });
+    };
+
+    beforeEach(function() {
+        display = new Guacamole.Display();
+        layer = display.getDefaultLayer();
+        display.resize(layer, 64, 64);
+        buffer = display.createBuffer();
+    });
+
+    it("should update the entire composite after unbounded operations", function(done) {
+        fillAndFlatten(function() {
+
+            // Drawing with "copy" clears all of the layer outside the area
+            // drawn
+            display.setChannelMask(layer, Guacamole.Layer.SRC);
+            display.copy(buffer, 0, 0, 16, 16, layer, 8, 8);
+
+            expectCompositeCurrent(done);
+
+        });
+    });
+
+    it("should restore unbounded channel masks when popping layer state", function(done) {
+        fillAndFlatten(function() {
+
+            // The unbounded mask is restored by pop(), despite a bounded
+            // mask being set in the meantime
+            display.setChannelMask(layer, Guacamole.Layer.IN);
+            display.push(layer);
+            display.setChannelMask(layer, Guacamole.Layer.OVER);
+            display.pop(layer);
+
+            display.copy(buffer, 0, 0, 16, 16, layer, 8, 8);
+
+            expectCompositeCurrent(done);
+
+        });
+    });
+
+});
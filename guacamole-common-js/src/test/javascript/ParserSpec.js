@@ -0,0 +1,123 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/* global Guacamole, expect */
+
+describe("Guacamole.Parser", function ParserSpec() {
+
+    /**
+     * Test data containing several instructions, including empty elements
+     * and characters which are multibyte when encoded as UTF-8.
+     *
+     * @type {String}
+     */
+    var DATA = '4.sync,8.12345678;'
+             + '3.img,1.1,2.14,1.0,9.image/png,1.0,1.0;'
+             + '4.blob,1.1,0.;'
+             + '4.name,5.überé;'
+             + '0.,4.ping;'
+             + '3.nop;';
+
+    /**
+     * The instructions represented by {@link DATA}, as arrays containing the
+     * opcode followed by all parameters.
+     *
+     * @type {String[][]}
+     */
+    var EXPECTED = [
+        [ 'sync', '12345678' ],
+        [ 'img', '1', '14', '0', 'image/png', '0', '0' ],
+        [ 'blob', '1', '' ],
+        [ 'name', 'überé' ],
+        [ '', 'ping' ],
+        [ 'nop' ]
+    ];
+
+    /**
+     * The parser under test.
+     *
+     * @type {Guacamole.Parser}
+     */
+    var parser;
+
+    /**
+     * All instructions received from the parser under test, as arrays
+     * containing the opcode followed by all parameters.
+     *
+     * @type {String[][]}
+     */
+    var received;
+
+    beforeEach(function() {
+        received = [];
+        parser = new Guacamole.Parser();
+        parser.oninstruction = function(opcode, parameters) {
+            received.push([ opcode ].concat(parameters));
+        };
+    });
+
+    it("should parse instructions received all at once", function() {
+        parser.receive(DATA);
+        expect(received).toEqual(EXPECTED);
+    });
+
+    it("should parse instructions regardless of how data is split", function() {
+        for (var split = 1; split < DATA.length; split++) {
+
+            received = [];
+            parser.receive(DATA.substring(0, split));
+            parser.receive(DATA.substring(split));
+
+            expect(received).toEqual(EXPECTED);
+
+        }
+    });
+
+    it("should parse instructions received one character at a time", function() {
+        for (var i = 0; i < DATA.length; i++)
+            parser.receive(DATA.charAt(i));
+        expect(received).toEqual(EXPECTED);
+    });
+
+    it("should parse UTF-8 binary data split within multibyte characters", function() {
+
+        if (!Guacamole.Parser.isBinarySupported())
+            return;
+
+        var bytes = new TextEncoder().encode(DATA);
+        for (var i = 0; i < bytes.length; i++)
+            parser.receive(bytes.subarray(i, i + 1));
+
+        expect(received).toEqual(EXPECTED);
+
+    });
+
+    it("should reject non-numeric element lengths", function() {
+        expect(function() {
+            parser.receive('4x.sync;');
+        }).toThrow();
+    });
+
+    it("should reject illegal terminators", function() {
+        expect(function() {
+            parser.receive('4.sync:');
+        }).toThrow();
+    });
+
+});
@@ -0,0 +1,156 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/* global Guacamole, expect */
+
+describe("Guacamole.RawAudioPlayer", function RawAudioPlayerSpec() {
+
+    /**
+     * Loads the AudioWorkletProcessor used by Guacamole.RawAudioPlayer
+     * outside of any AudioWorkletGlobalScope, providing minimal stand-ins for
+     * the globals of that scope, and returns a new instance of that processor
+     * for the given audio format.
+     *
+     * @param {Number} rate
+     *     The sample rate of the raw PCM received by the processor.
+     *
+     * @param {Number} outputRate
+     *     The sample rate of the AudioContext that the processor would
+     *     output to.
+     *
+     * @param {Number} channels
+     *     The number of channels of the raw PCM received by the processor.
+     *
+     * @returns {Object}
+     *     A new instance of the AudioWorkletProcessor.
+     */
+    var createProcessor = function createProcessor(rate, outputRate, channels) {
+
+        var Processor = null;
+
+        var AudioWorkletProcessor = function AudioWorkletProcessor() {
+            this.port = { 'postMessage' : function postMessage() {} };
+        };
+
+        var registerProcessor = function registerProcessor(name, processor) {
+            Processor = processor;
+        };
+
+        var Reflect = {
+            'construct' : function construct(target, args, newTarget) {
+                var instance = Object.create(newTarget.prototype);
+                target.apply(instance, args);
+                return instance;
+            }
+        };
+
+        var ObjectStub = {
+            'setPrototypeOf' : function setPrototypeOf(obj, proto) {
+                obj.__proto__ = proto;
+                return obj;
+            }
+        };
+
+        /* jshint evil:true */
+        new Function('AudioWorkletProcessor', 'registerProcessor', 'sampleRate',
+                'currentTime', 'Reflect', 'Object',
+                '(' + Guacamole.RawAudioPlayer.processor + ')("test");')
+            (AudioWorkletProcessor, registerProcessor, outputRate, 0, Reflect, ObjectStub);
+
+        return new Processor({
+            'processorOptions' : {
+                'channels'       : channels,
+                'rate'           : rate,
+                'bytesPerSample' : 2,
+                'maxLatency'     : 1
+            }
+        });
+
+    };
+
+    /**
+     * Sends each of the given packets of 16-bit samples to the given
+     * processor, followed by the end of the stream, and returns the first
+     * rendered block of audio for each channel.
+     *
+     * @param {Object} processor
+     *     The processor to send the packets to.
+     *
+     * @param {Number} channels
+     *     The number of channels of audio within each packet.
+     *
+     * @param {Number[][]} packets
+     *     The interleaved samples of each packet.
+     *
+     * @returns {Float32Array[]}
+     *     The rendered audio of each channel.
+     */
+    var render = function render(processor, channels, packets) {
+
+        for (var i = 0; i < packets.length; i++)
+            processor.port.onmessage({ 'data' : new Int16Array(packets[i]).buffer });
+
+        processor.port.onmessage({ 'data' : null });
+
+        var output = [];
+        for (var channel = 0; channel < channels; channel++)
+            output.push(new Float32Array(128));
+
+        processor.process([], [ output ]);
+        return output;
+
+    };
+
+    it("should interpolate up to and across the ends of packets", function() {
+
+        // Doubling the rate of a ramp should produce a finer ramp, with the
+        // final output frame of each packet landing exactly on the final
+        // input frame
+        var output = render(createProcessor(24000, 48000, 1), 1, [
+            [ 0, 4096, 8192, 12288 ],
+            [ 16384, 20480 ]
+        ])[0];
+
+        for (var i = 0; i <= 10; i++)
+            expect(output[i]).toBe(i * 2048 / 32768);
+
+        expect(output[11]).toBe(0);
+
+    });
+
+    it("should resample each channel independently", function() {
+
+        var output = render(createProcessor(32000, 48000, 2), 2, [
+            [ 16384, -16384, 16384, -16384, 16384, -16384 ]
+        ]);
+
+        // Two input frames span three output frames
+        for (var i = 0; i < 3; i++) {
+            expect(output[0][i]).toBe(0.5);
+            expect(output[1][i]).toBe(-0.5);
+        }
+
+        for (var j = 0; j < 128; j++) {
+            expect(isNaN(output[0][j])).toBe(false);
+            expect(isNaN(output[1][j])).toBe(false);
+        }
+
+    });
+
+});
@@ -0,0 +1,197 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/* global Guacamole, expect */
+
+describe("Guacamole.SessionRecording", function SessionRecordingSpec() {
+
+    /**
+     * Instructions containing ASCII, multibyte, and surrogate pair
+     * characters, each followed by a "sync" instruction such that each
+     * forms a separate frame.
+     *
+     * @type {Array[]}
+     */
+    var INSTRUCTIONS = [
+        [ 'name', 'plain' ],
+        [ 'sync', '100' ],
+        [ 'name', 'café' ],
+        [ 'sync', '200' ],
+        [ 'name', '€5', 'é€' ],
+        [ 'sync', '300' ],
+        [ 'name', '😀 😀', '😀😀😀😀😀😀😀😀😀' ],
+        [ 'sync', '400' ],
+        [ 'argv', '😀', '', 'x😀é' ],
+        [ 'sync', '500' ]
+    ];
+
+    /**
+     * Returns the number of bytes occupied by the given string when encoded
+     * as UTF-8.
+     *
+     * @param {String} str
+     *     The string to measure.
+     *
+     * @returns {Number}
+     *     The number of bytes occupied by the given string when encoded as
+     *     UTF-8.
+     */
+    var getUTF8Length = function getUTF8Length(str) {
+        return unescape(encodeURIComponent(str)).length;
+    };
+
+    /**
+     * Encodes the given instruction as it would appear within a Guacamole
+     * session recording, with the length of each element given in Unicode
+     * codepoints.
+     *
+     * @param {String[]} instruction
+     *     The opcode of the instruction, followed by all of its arguments.
+     *
+     * @returns {String}
+     *     The given instruction, encoded using the Guacamole protocol.
+     */
+    var encodeInstruction = function encodeInstruction(instruction) {
+
+        var elements = [];
+        for (var i = 0; i < instruction.length; i++) {
+            var element = instruction[i];
+            var length = element.replace(/[\uD800-\uDBFF][\uDC00-\uDFFF]/g, '_').length;
+            elements.push(length + '.' + element);
+        }
+
+        return elements.join(',') + ';';
+
+    };
+
+    /**
+     * Returns a new Guacamole.Tunnel which supports reading ranges of the
+     * recording, recording the start and end of each range read within the
+     * given array.
+     *
+     * @param {Boolean} rangeSupported
+     *     The value that the isRangeSupported() function of the tunnel should
+     *     return.
+     *
+     * @param {Array[]} reads
+     *     The array which should receive the start and end of each range
+     *     read.
+     *
+     * @returns {Guacamole.Tunnel}
+     *     A new Guacamole.Tunnel which records all ranges read.
+     */
+    var createTunnel = function createTunnel(rangeSupported, reads) {
+
+        var tunnel = new Guacamole.Tunnel();
+
+        tunnel.readRange = function readRange(start, end, callback) {
+            reads.push([ start, end ]);
+        };
+
+        tunnel.isRangeSupported = function isRangeSupported() {
+            return rangeSupported;
+        };
+
+        return tunnel;
+
+    };
+
+    /**
+     * Sends all instructions within INSTRUCTIONS through the given tunnel,
+     * as if received from the recording.
+     *
+     * @param {Guacamole.Tunnel} tunnel
+     *     The tunnel which should receive the instructions.
+     */
+    var receiveAll = function receiveAll(tunnel) {
+        for (var i = 0; i < INSTRUCTIONS.length; i++)
+            tunnel.oninstruction(INSTRUCTIONS[i][0], INSTRUCTIONS[i].slice(1));
+    };
+
+    it("should measure instructions in bytes of UTF-8", function() {
+        for (var i = 0; i < INSTRUCTIONS.length; i++) {
+            var instruction = new Guacamole.SessionRecording._Frame.Instruction(
+                    INSTRUCTIONS[i][0], INSTRUCTIONS[i].slice(1));
+            expect(instruction.getSize()).toBe(getUTF8Length(encodeInstruction(INSTRUCTIONS[i])));
+        }
+    });
+
+    it("should index frames at their byte offsets", function() {
+
+        var tunnel = createTunnel(true, []);
+        var recording = new Guacamole.SessionRecording(tunnel);
+        receiveAll(tunnel);
+
+        // Each frame begins immediately after the preceding sync
+        var expected = [ 0 ];
+        var offset = 0;
+        for (var i = 0; i < INSTRUCTIONS.length; i++) {
+            offset += getUTF8Length(encodeInstruction(INSTRUCTIONS[i]));
+            if (INSTRUCTIONS[i][0] === 'sync')
+                expected.push(offset);
+        }
+
+        var index = recording.getIndex();
+        expect(index.offsets).toEqual(expected);
+        expect(index.timestamps).toEqual([ 100, 200, 300, 400, 500 ]);
+
+    });
+
+    it("should survive serialization of the index as JSON", function() {
+
+        var tunnel = createTunnel(true, []);
+        var recording = new Guacamole.SessionRecording(tunnel);
+        receiveAll(tunnel);
+
+        var index = recording.getIndex();
+        var copy = new Guacamole.SessionRecording.Index(JSON.parse(JSON.stringify(index)));
+
+        expect(copy.timestamps).toEqual(index.timestamps);
+        expect(copy.offsets).toEqual(index.offsets);
+        expect(copy.keyframes).toEqual(index.keyframes);
+
+        var empty = new Guacamole.SessionRecording.Index();
+        expect(empty.timestamps).toEqual([]);
+        expect(empty.offsets).toEqual([]);
+        expect(empty.keyframes).toEqual([]);
+
+    });
+
+    it("should read frames on demand only if ranges are supported", function() {
+
+        // Frames are retained without reading anything if ranges are known
+        // to be unsupported
+        var unsupportedReads = [];
+        var unsupported = createTunnel(false, unsupportedReads);
+        new Guacamole.SessionRecording(unsupported).frameMemoryLimit = 1;
+        receiveAll(unsupported);
+        expect(unsupportedReads.length).toBe(0);
+
+        // Support is tested once, using the first frame, if not yet known
+        var unknownReads = [];
+        var unknown = createTunnel(null, unknownReads);
+        new Guacamole.SessionRecording(unknown).frameMemoryLimit = 1;
+        receiveAll(unknown);
+        expect(unknownReads.length).toBe(1);
+        expect(unknownReads[0]).toEqual([ 0, getUTF8Length(
+                encodeInstruction(INSTRUCTIONS[0]) + encodeInstruction(INSTRUCTIONS[1])) ]);
+
+    });
+
+});
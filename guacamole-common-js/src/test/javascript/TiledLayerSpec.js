@@ -0,0 +1,196 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/* global Guacamole, expect */
+
+describe("Guacamole.TiledLayer", function TiledLayerSpec() {
+
+    /**
+     * The width and height of each tile of a Guacamole.TiledLayer, in
+     * pixels.
+     *
+     * @type {Number}
+     */
+    var TILE_SIZE = 256;
+
+    /**
+     * Returns the RGBA pixel data of the entire contents of the given layer.
+     *
+     * @param {Guacamole.Layer|Guacamole.TiledLayer} layer
+     *     The layer to read.
+     *
+     * @returns {Number[]}
+     *     The RGBA pixel data of the given layer.
+     */
+    var getPixels = function getPixels(layer) {
+        var canvas = layer.toCanvas();
+        return Array.prototype.slice.call(canvas.getContext('2d')
+                .getImageData(0, 0, canvas.width, canvas.height).data);
+    };
+
+    /**
+     * Verifies that the given TiledLayer has the same dimensions and
+     * contents as the given Guacamole.Layer, which serves as the reference
+     * implementation. Each color component may differ by at most one.
+     *
+     * @param {Guacamole.TiledLayer} tiled
+     *     The TiledLayer to verify.
+     *
+     * @param {Guacamole.Layer} reference
+     *     The Guacamole.Layer that the TiledLayer should match.
+     */
+    var expectSame = function expectSame(tiled, reference) {
+
+        expect(tiled.width).toBe(reference.width);
+        expect(tiled.height).toBe(reference.height);
+
+        var actual = getPixels(tiled);
+        var expected = getPixels(reference);
+        expect(actual.length).toBe(expected.length);
+
+        var mismatched = 0;
+        for (var i = 0; i < actual.length; i++) {
+            if (Math.abs(actual[i] - expected[i]) > 1)
+                mismatched++;
+        }
+
+        expect(mismatched).toBe(0);
+
+    };
+
+    /**
+     * Invokes the given function with a new Guacamole.Layer and with a new
+     * Guacamole.TiledLayer, each of the given size, verifying that both
+     * layers have the same contents afterwards.
+     *
+     * @param {Number} width
+     *     The width of both layers.
+     *
+     * @param {Number} height
+     *     The height of both layers.
+     *
+     * @param {Function} draw
+     *     The function to invoke with each layer.
+     */
+    var drawBoth = function drawBoth(width, height, draw) {
+
+        var reference = new Guacamole.Layer(width, height);
+        var tiled = new Guacamole.TiledLayer(width, height);
+
+        draw(reference);
+        draw(tiled);
+
+        expectSame(tiled, reference);
+
+    };
+
+    /**
+     * Fills a grid of partially-transparent rectangles of varying color
+     * across the given layer, such that the rectangles straddle the edges of
+     * tiles.
+     *
+     * @param {Guacamole.Layer|Guacamole.TiledLayer} layer
+     *     The layer to draw upon.
+     */
+    var drawPattern = function drawPattern(layer) {
+        for (var y = 0; y < layer.height; y += 40) {
+            for (var x = 0; x < layer.width; x += 40) {
+                layer.rect(x + 3, y + 5, 37, 33);
+                layer.fillColor((x * 7) & 0xFF, (y * 5) & 0xFF, (x + y) & 0xFF,
+                        ((x + y) / 40) % 2 ? 13 : 200);
+            }
+        }
+    };
+
+    it("should allocate only the tiles which are drawn to", function() {
+
+        var layer = new Guacamole.TiledLayer(TILE_SIZE * 3, TILE_SIZE * 3);
+        layer.rect(10, 10, 20, 20);
+        layer.fillColor(255, 0, 0, 255);
+
+        // Regions within an allocated tile are read from that tile directly
+        var drawn = layer.getRegion(15, 15, 10, 10);
+        expect(drawn.x).toBe(15);
+        expect(drawn.y).toBe(15);
+        expect(drawn.canvas.width).toBe(TILE_SIZE);
+        expect(drawn.canvas.height).toBe(TILE_SIZE);
+
+        // Regions within tiles never drawn to are empty
+        var empty = layer.getRegion(TILE_SIZE * 2 + 10, TILE_SIZE * 2 + 10, 10, 10);
+        expect(empty.canvas).not.toBe(drawn.canvas);
+        var data = empty.canvas.getContext('2d').getImageData(empty.x, empty.y, 10, 10).data;
+        expect(Math.max.apply(Math, Array.prototype.slice.call(data))).toBe(0);
+
+    });
+
+    it("should draw across the edges of tiles", function() {
+        drawBoth(TILE_SIZE * 2 + 30, TILE_SIZE + 70, drawPattern);
+    });
+
+    it("should preserve contents when resized across the edges of tiles", function() {
+        drawBoth(TILE_SIZE + 100, TILE_SIZE + 100, function(layer) {
+            drawPattern(layer);
+            layer.resize(TILE_SIZE - 30, TILE_SIZE + 10);
+            layer.resize(TILE_SIZE * 2 + 20, TILE_SIZE - 50);
+            layer.rect(TILE_SIZE - 20, 10, 60, 60);
+            layer.fillColor(0, 0, 255, 128);
+        });
+    });
+
+    it("should copy regions spanning several tiles exactly", function() {
+
+        drawBoth(TILE_SIZE * 2, TILE_SIZE * 2, function(layer) {
+            drawPattern(layer);
+            layer.copy(layer, TILE_SIZE - 50, TILE_SIZE - 60, 100, 120, 10, 20);
+        });
+
+        // Copy between separate layers, with regions spanning tiles in both
+        var referenceSource = new Guacamole.Layer(TILE_SIZE * 2, TILE_SIZE * 2);
+        var tiledSource = new Guacamole.TiledLayer(TILE_SIZE * 2, TILE_SIZE * 2);
+        drawPattern(referenceSource);
+        drawPattern(tiledSource);
+
+        var reference = new Guacamole.Layer(TILE_SIZE * 2, TILE_SIZE * 2);
+        var tiled = new Guacamole.TiledLayer(TILE_SIZE * 2, TILE_SIZE * 2);
+        reference.copy(referenceSource, 200, 180, 150, 160, TILE_SIZE - 70, TILE_SIZE - 80);
+        tiled.copy(tiledSource, 200, 180, 150, 160, TILE_SIZE - 70, TILE_SIZE - 80);
+
+        expectSame(tiled, reference);
+
+    });
+
+    it("should apply unbounded composite operations to every tile", function() {
+
+        // Channel masks for "source-in", "destination-in", "source-out",
+        // "destination-atop" and "copy", each of which affects the
+        // destination outside the area drawn
+        var masks = [ 0x4, 0x1, 0x8, 0x9, 0xC ];
+
+        for (var i = 0; i < masks.length; i++) {
+            drawBoth(TILE_SIZE * 3, TILE_SIZE * 2, function(layer) {
+                drawPattern(layer);
+                layer.setChannelMask(masks[i]);
+                layer.rect(TILE_SIZE - 40, TILE_SIZE - 40, 80, 80);
+                layer.fillColor(0, 128, 0, 200);
+            });
+        }
+
+    });
+
+});
@@ -0,0 +1,129 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/* global Guacamole, expect */
+
+describe("Guacamole.Client.DefaultTransferKernel", function TransferKernelSpec() {
+
+    /**
+     * The number of pixels to transfer within each test.
+     *
+     * @type {Number}
+     */
+    var PIXELS = 1024;
+
+    /**
+     * Returns a new Uint8ClampedArray containing random RGBA pixel data.
+     *
+     * @param {Number} pixels
+     *     The number of pixels to generate.
+     *
+     * @returns {Uint8ClampedArray}
+     *     A new Uint8ClampedArray containing the given number of random
+     *     RGBA pixels.
+     */
+    var randomPixels = function randomPixels(pixels) {
+        var data = new Uint8ClampedArray(pixels * 4);
+        for (var i = 0; i < data.length; i++)
+            data[i] = Math.floor(Math.random() * 256);
+        return data;
+    };
+
+    /**
+     * Applies the given per-pixel transfer function to copies of the given
+     * pixel data, returning the resulting destination pixel data.
+     *
+     * @param {Function} transferFunction
+     *     The per-pixel transfer function to apply.
+     *
+     * @param {Uint8ClampedArray} src
+     *     The source pixel data.
+     *
+     * @param {Uint8ClampedArray} dst
+     *     The destination pixel data. This array is not modified.
+     *
+     * @returns {Uint8ClampedArray}
+     *     The destination pixel data resulting from the transfer.
+     */
+    var applyPerPixel = function applyPerPixel(transferFunction, src, dst) {
+
+        var result = new Uint8ClampedArray(dst);
+
+        for (var i = 0; i < result.length; i += 4) {
+
+            var srcPixel = new Guacamole.Layer.Pixel(src[i], src[i+1], src[i+2], src[i+3]);
+            var dstPixel = new Guacamole.Layer.Pixel(result[i], result[i+1], result[i+2], result[i+3]);
+
+            transferFunction(srcPixel, dstPixel);
+
+            result[i  ] = dstPixel.red;
+            result[i+1] = dstPixel.green;
+            result[i+2] = dstPixel.blue;
+            result[i+3] = dstPixel.alpha;
+
+        }
+
+        return result;
+
+    };
+
+    /**
+     * Applies the given transfer kernel to copies of the given pixel data,
+     * returning the resulting destination pixel data.
+     *
+     * @param {Function} kernel
+     *     The transfer kernel to apply.
+     *
+     * @param {Uint8ClampedArray} src
+     *     The source pixel data.
+     *
+     * @param {Uint8ClampedArray} dst
+     *     The destination pixel data. This array is not modified.
+     *
+     * @returns {Uint8ClampedArray}
+     *     The destination pixel data resulting from the transfer.
+     */
+    var applyKernel = function applyKernel(kernel, src, dst) {
+        var result = new Uint8ClampedArray(dst);
+        kernel(new Uint32Array(src.buffer), new Uint32Array(result.buffer), src.length / 4);
+        return result;
+    };
+
+    it("should provide a kernel for each of the 16 raster operations", function() {
+        for (var index = 0x0; index <= 0xF; index++) {
+            expect(typeof Guacamole.Client.DefaultTransferKernel[index]).toBe('function');
+            expect(Guacamole.Client.DefaultTransferFunction[index].kernel)
+                    .toBe(Guacamole.Client.DefaultTransferKernel[index]);
+        }
+    });
+
+    it("should produce the same results as the per-pixel transfer functions", function() {
+
+        var src = randomPixels(PIXELS);
+        var dst = randomPixels(PIXELS);
+
+        for (var index = 0x0; index <= 0xF; index++) {
+            var expected = applyPerPixel(Guacamole.Client.DefaultTransferFunction[index], src, dst);
+            var actual = applyKernel(Guacamole.Client.DefaultTransferKernel[index], src, dst);
+            expect(Array.prototype.slice.call(actual)).toEqual(Array.prototype.slice.call(expected));
+        }
+
+    });
+
+});
@@ -0,0 +1,514 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+package org.apache.guacamole.cache;
+
+import java.util.ArrayDeque;
+import java.util.Comparator;
+import java.util.Deque;
+import java.util.HashMap;
+import java.util.Map;
+import java.util.PriorityQueue;
+import java.util.Queue;
+
+/**
+ * Thread-safe map whose entries each have an associated expiration timestamp,
+ * after which they are automatically and implicitly removed. Entries are
+ * indexed by key within a hash table and additionally tracked in order of
+ * expiration, such that expired entries can be removed without scanning the
+ * entire map. As entries are typically added with a fixed lifetime, and thus
+ * in order of expiration, both insertion and expiration are amortized O(1)
+ * operations. Entries which are added out of expiration order are tracked
+ * separately at O(log n) cost. If the map has a capacity, adding an entry
+ * while the map is full evicts the entry which would otherwise expire
+ * soonest.
+ *
+ * @param <K>
+ *     The type of the keys stored within this map.
+ *
+ * @param <V>
+ *     The type of the values stored within this map.
+ */
+public class ExpiringMap<K, V> {
+
+    /**
+     * A single entry within an ExpiringMap.
+     *
+     * @param <K>
+     *     The type of the key of this entry.
+     *
+     * @param <V>
+     *     The type of the value of this entry.
+     */
+    private static class Entry<K, V> {
+
+        /**
+         * The key of this entry.
+         */
+        private final K key;
+
+        /**
+         * The value of this entry.
+         */
+        private final V value;
+
+        /**
+         * The time after which this entry is expired, as a UNIX-style epoch
+         * timestamp in milliseconds.
+         */
+        private final long expires;
+
+        /**
+         * Creates a new Entry having the given key, value, and expiration
+         * timestamp.
+         *
+         * @param key
+         *     The key of the entry.
+         *
+         * @param value
+         *     The value of the entry.
+         *
+         * @param expires
+         *     The time after which the entry is expired, as a UNIX-style epoch
+         *     timestamp in milliseconds.
+         */
+        public Entry(K key, V value, long expires) {
+            this.key = key;
+            this.value = value;
+            this.expires = expires;
+        }
+
+    }
+
+    /**
+     * Comparator which orders entries by expiration timestamp, earliest
+     * first.
+     */
+    private static final Comparator<Entry<?, ?>> EXPIRATION_ORDER =
+            new Comparator<Entry<?, ?>>() {
+
+        @Override
+        public int compare(Entry<?, ?> a, Entry<?, ?> b) {
+            return Long.compare(a.expires, b.expires);
+        }
+
+    };
+
+    /**
+     * The minimum number of entries which must be tracked within the
+     * expiration queues before those queues are checked for removed entries.
+     * This prevents maps containing few entries from being compacted
+     * repeatedly.
+     */
+    private static final int MIN_COMPACT_SIZE = 64;
+
+    /**
+     * The maximum number of entries that may be stored within this map at
+     * any one time.
+     */
+    private final int capacity;
+
+    /**
+     * All current entries, indexed by key.
+     */
+    private final Map<K, Entry<K, V>> entries = new HashMap<>();
+
+    /**
+     * Entries which were added in order of expiration, earliest first. An
+     * entry within this queue may have already been removed from the map, in
+     * which case it is simply discarded when it reaches the head of the
+     * queue.
+     */
+    private final Deque<Entry<K, V>> orderedQueue = new ArrayDeque<>();
+
+    /**
+     * Entries which were added out of order of expiration, and thus could
+     * not be appended to orderedQueue. As with orderedQueue, an entry within
+     * this queue may have already been removed from the map.
+     */
+    private final PriorityQueue<Entry<K, V>> unorderedQueue =
+            new PriorityQueue<>(11, EXPIRATION_ORDER);
+
+    /**
+     * Creates a new ExpiringMap which may contain an unlimited number of
+     * entries.
+     */
+    public ExpiringMap() {
+        this(Integer.MAX_VALUE);
+    }
+
+    /**
+     * Creates a new ExpiringMap which may contain at most the given number of
+     * unexpired entries. Once this limit is reached, adding a new entry
+     * evicts the entry which would otherwise expire soonest.
+     *
+     * @param capacity
+     *     The maximum number of entries that may be stored within the map at
+     *     any one time.
+     */
+    public ExpiringMap(int capacity) {
+        this.capacity = capacity;
+    }
+
+    /**
+     * Returns the current time, as a UNIX-style epoch timestamp in
+     * milliseconds. All expiration checks are performed relative to this
+     * time.
+     *
+     * @return
+     *     The current time, in milliseconds.
+     */
+    protected long getCurrentTime() {
+        return System.currentTimeMillis();
+    }
+
+    /**
+     * Returns whether the given entry has expired relative to the given time.
+     * An entry remains valid through the exact millisecond of its expiration
+     * timestamp, expiring only once the current time is strictly later.
+     *
+     * @param entry
+     *     The entry to test.
+     *
+     * @param now
+     *     The current time, in milliseconds.
+     *
+     * @return
+     *     true if the given entry has expired, false otherwise.
+     */
+    private static boolean isExpired(Entry<?, ?> entry, long now) {
+        return now > entry.expires;
+    }
+
+    /**
+     * Returns whether the given entry is still the entry stored for its key.
+     * Entries which have been removed or replaced remain within the
+     * expiration queues until discarded or compacted away.
+     *
+     * @param entry
+     *     The entry to test.
+     *
+     * @return
+     *     true if the given entry is still stored within this map, false
+     *     otherwise.
+     */
+    private boolean isIndexed(Entry<K, V> entry) {
+        return entries.get(entry.key) == entry;
+    }
+
+    /**
+     * Removes the given entry from the index, if it is still the entry
+     * stored for its key.
+     *
+     * @param entry
+     *     The entry to remove.
+     *
+     * @return
+     *     true if the entry was removed from the index, false if the entry
+     *     had already been removed.
+     */
+    private boolean unindex(Entry<K, V> entry) {
+
+        if (!isIndexed(entry))
+            return false;
+
+        entries.remove(entry.key);
+        return true;
+
+    }
+
+    /**
+     * Removes the entry which would otherwise expire soonest, making room
+     * for a new entry while this map is at capacity.
+     */
+    private void evictNext() {
+
+        Entry<K, V> entry;
+        do {
+
+            Entry<K, V> ordered = orderedQueue.peekFirst();
+            Entry<K, V> unordered = unorderedQueue.peek();
+
+            // Both queues are empty only if the map is also empty
+            if (ordered == null && unordered == null)
+                return;
+
+            // Take whichever queue head expires first
+            if (unordered == null || (ordered != null && ordered.expires <= unordered.expires))
+                entry = orderedQueue.pollFirst();
+            else
+                entry = unorderedQueue.poll();
+
+        } while (!unindex(entry));
+
+    }
+
+    /**
+     * Discards entries which have been removed from the index but remain
+     * within the expiration queues, if such entries make up the majority of
+     * those queues. As compaction only occurs once the queues have at least
+     * doubled in size relative to the index, its cost is amortized O(1) per
+     * removal, and the memory used by the queues remains proportional to the
+     * number of entries actually stored.
+     */
+    private void compact() {
+
+        int queued = orderedQueue.size() + unorderedQueue.size();
+        if (queued < MIN_COMPACT_SIZE || queued <= entries.size() * 2)
+            return;
+
+        orderedQueue.removeIf(entry -> !isIndexed(entry));
+        unorderedQueue.removeIf(entry -> !isIndexed(entry));
+
+    }
+
+    /**
+     * Removes all expired entries from the given queue and from the index,
+     * stopping at the first unexpired entry.
+     *
+     * @param queue
+     *     The queue to remove expired entries from.
+     *
+     * @param now
+     *     The current time, in milliseconds.
+     */
+    private void removeExpired(Queue<Entry<K, V>> queue, long now) {
+        Entry<K, V> head;
+        while ((head = queue.peek()) != null && isExpired(head, now)) {
+            queue.poll();
+            unindex(head);
+        }
+    }
+
+    /**
+     * Removes all expired entries from this map. Only expired entries are
+     * visited, thus the cost of this operation is proportional to the number
+     * of entries removed. This function is invoked automatically whenever an
+     * entry is added, but may also be invoked manually to release memory
+     * while the map is otherwise idle.
+     */
+    public synchronized void removeExpired() {
+        long now = getCurrentTime();
+        removeExpired(orderedQueue, now);
+        removeExpired(unorderedQueue, now);
+    }
+
+    /**
+     * Returns the unexpired entry stored for the given key, if any.
+     *
+     * @param key
+     *     The key of the entry to retrieve.
+     *
+     * @return
+     *     The unexpired entry stored for the given key, or null if there is no
+     *     such entry.
+     */
+    private Entry<K, V> getEntry(K key) {
+        Entry<K, V> entry = entries.get(key);
+        if (entry == null || isExpired(entry, getCurrentTime()))
+            return null;
+        return entry;
+    }
+
+    /**
+     * Stores the given value under the given key if no unexpired value is
+     * already stored under that key. Expired entries are automatically
+     * removed prior to storing the new entry.
+     *
+     * @param key
+     *     The key to store the value under.
+     *
+     * @param value
+     *     The value to store.
+     *
+     * @param expires
+     *     The time after which the entry should expire, as a UNIX-style epoch
+     *     timestamp in milliseconds.
+     *
+     * @return
+     *     true if the value was stored, false if an unexpired value is already
+     *     stored under the given key or if the given expiration timestamp has
+     *     already passed.
+     */
+    public synchronized boolean putIfAbsent(K key, V value, long expires) {
+
+        removeExpired();
+
+        // Refuse to replace existing entries (any existing entry is
+        // necessarily unexpired, as expired entries were removed above)
+        if (entries.containsKey(key))
+            return false;
+
+        return store(key, value, expires);
+
+    }
+
+    /**
+     * Stores the given value under the given key, replacing any value
+     * already stored under that key. Expired entries are automatically
+     * removed prior to storing the new entry.
+     *
+     * @param key
+     *     The key to store the value under.
+     *
+     * @param value
+     *     The value to store.
+     *
+     * @param expires
+     *     The time after which the entry should expire, as a UNIX-style epoch
+     *     timestamp in milliseconds.
+     *
+     * @return
+     *     The unexpired value previously stored under the given key, or null
+     *     if there was no such value. If the given expiration timestamp has
+     *     already passed, the previous value is still removed, but the given
+     *     value is not stored.
+     */
+    public synchronized V put(K key, V value, long expires) {
+
+        removeExpired();
+
+        // The replaced entry remains within its expiration queue until it
+        // would have expired or the queue is compacted, just as if removed
+        Entry<K, V> previous = entries.remove(key);
+        store(key, value, expires);
+        compact();
+
+        return previous != null ? previous.value : null;
+
+    }
+
+    /**
+     * Stores a new entry having the given key, value, and expiration
+     * timestamp, evicting other entries as necessary to remain within
+     * capacity. No entry may already be stored under the given key.
+     *
+     * @param key
+     *     The key to store the value under.
+     *
+     * @param value
+     *     The value to store.
+     *
+     * @param expires
+     *     The time after which the entry should expire, as a UNIX-style epoch
+     *     timestamp in milliseconds.
+     *
+     * @return
+     *     true if the entry was stored, false if the given expiration
+     *     timestamp has already passed.
+     */
+    private boolean store(K key, V value, long expires) {
+
+        // Refuse entries which are already expired
+        if (getCurrentTime() > expires)
+            return false;
+
+        // Make room for the new entry if at capacity
+        while (entries.size() >= capacity && !entries.isEmpty())
+            evictNext();
+
+        Entry<K, V> entry = new Entry<>(key, value, expires);
+        entries.put(key, entry);
+
+        // Entries arriving in order of expiration can simply be appended
+        Entry<K, V> tail = orderedQueue.peekLast();
+        if (tail == null || tail.expires <= expires)
+            orderedQueue.addLast(entry);
+        else
+            unorderedQueue.add(entry);
+
+        return true;
+
+    }
+
+    /**
+     * Returns the unexpired value stored under the given key, if any.
+     *
+     * @param key
+     *     The key of the value to retrieve.
+     *
+     * @return
+     *     The unexpired value stored under the given key, or null if there is
+     *     no such value.
+     */
+    public synchronized V get(K key) {
+        Entry<K, V> entry = getEntry(key);
+        return entry != null ? entry.value : null;
+    }
+
+    /**
+     * Returns whether an unexpired value is stored under the given key.
+     *
+     * @param key
+     *     The key to test.
+     *
+     * @return
+     *     true if an unexpired value is stored under the given key, false
+     *     otherwise.
+     */
+    public synchronized boolean containsKey(K key) {
+        return getEntry(key) != null;
+    }
+
+    /**
+     * Removes and returns the unexpired value stored under the given key, if
+     * any.
+     *
+     * @param key
+     *     The key of the value to remove.
+     *
+     * @return
+     *     The unexpired value that was stored under the given key, or null if
+     *     there was no such value.
+     */
+    public synchronized V remove(K key) {
+
+        Entry<K, V> entry = getEntry(key);
+        if (entry == null)
+            return null;
+
+        // The entry remains within its expiration queue until it would have
+        // expired or the queue is compacted, at which point it is discarded
+        entries.remove(key);
+        compact();
+        return entry.value;
+
+    }
+
+    /**
+     * Removes all entries from this map, regardless of expiration.
+     */
+    public synchronized void clear() {
+        entries.clear();
+        orderedQueue.clear();
+        unorderedQueue.clear();
+    }
+
+    /**
+     * Returns the number of unexpired entries stored within this map.
+     *
+     * @return
+     *     The number of unexpired entries stored within this map.
+     */
+    public synchronized int size() {
+        removeExpired();
+        return entries.size();
+    }
+
+}
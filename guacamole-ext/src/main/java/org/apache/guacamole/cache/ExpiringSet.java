@@ -0,0 +1,146 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+package org.apache.guacamole.cache;
+
+/**
+ * Thread-safe set whose members each have an associated expiration
+ * timestamp, after which they are automatically and implicitly removed. As
+ * with ExpiringMap, upon which this set is based, both insertion and
+ * expiration are amortized O(1) operations.
+ *
+ * @param <E>
+ *     The type of the members of this set.
+ */
+public class ExpiringSet<E> {
+
+    /**
+     * The map whose keys are the members of this set.
+     */
+    private final ExpiringMap<E, Boolean> members;
+
+    /**
+     * Creates a new ExpiringSet which may contain an unlimited number of
+     * members.
+     */
+    public ExpiringSet() {
+        this(Integer.MAX_VALUE);
+    }
+
+    /**
+     * Creates a new ExpiringSet which may contain at most the given number of
+     * unexpired members. Once this limit is reached, adding a new member
+     * evicts the member which would otherwise expire soonest.
+     *
+     * @param capacity
+     *     The maximum number of members that may be stored within the set at
+     *     any one time.
+     */
+    public ExpiringSet(int capacity) {
+        this.members = new ExpiringMap<E, Boolean>(capacity) {
+
+            @Override
+            protected long getCurrentTime() {
+                return ExpiringSet.this.getCurrentTime();
+            }
+
+        };
+    }
+
+    /**
+     * Returns the current time, as a UNIX-style epoch timestamp in
+     * milliseconds. All expiration checks are performed relative to this
+     * time.
+     *
+     * @return
+     *     The current time, in milliseconds.
+     */
+    protected long getCurrentTime() {
+        return System.currentTimeMillis();
+    }
+
+    /**
+     * Adds the given member to this set if it is not already present.
+     * Expired members are automatically removed prior to adding the new
+     * member.
+     *
+     * @param member
+     *     The member to add.
+     *
+     * @param expires
+     *     The time after which the member should expire, as a UNIX-style epoch
+     *     timestamp in milliseconds.
+     *
+     * @return
+     *     true if the member was added, false if the member is already
+     *     present and unexpired or if the given expiration timestamp has
+     *     already passed.
+     */
+    public boolean add(E member, long expires) {
+        return members.putIfAbsent(member, Boolean.TRUE, expires);
+    }
+
+    /**
+     * Returns whether the given member is present within this set and has
+     * not expired.
+     *
+     * @param member
+     *     The member to test.
+     *
+     * @return
+     *     true if the given member is present and unexpired, false otherwise.
+     */
+    public boolean contains(E member) {
+        return members.containsKey(member);
+    }
+
+    /**
+     * Removes the given member from this set.
+     *
+     * @param member
+     *     The member to remove.
+     *
+     * @return
+     *     true if the given member was present and unexpired prior to being
+     *     removed, false otherwise.
+     */
+    public boolean remove(E member) {
+        return members.remove(member) != null;
+    }
+
+    /**
+     * Removes all expired members from this set. This function is invoked
+     * automatically whenever a member is added, but may also be invoked
+     * manually to release memory while the set is otherwise idle.
+     */
+    public void removeExpired() {
+        members.removeExpired();
+    }
+
+    /**
+     * Returns the number of unexpired members within this set.
+     *
+     * @return
+     *     The number of unexpired members within this set.
+     */
+    public int size() {
+        return members.size();
+    }
+
+}
@@ -68,6 +68,32 @@ public interface AuthenticatedUser extends Identifiable {
      */
     Set<String> getEffectiveUserGroups();
 
+    /**
+     * Returns a fingerprint of the identity of this authenticated user, or
+     * null if this authenticated user does not provide such a fingerprint. If
+     * the fingerprint of an authenticated user is unchanged when their
+     * session is re-authenticated, and no new credentials were provided,
+     * the web application may reuse the UserContexts already associated with
+     * that session rather than updating them, as those UserContexts are
+     * expected to be equivalent. Implementations must therefore ensure that
+     * the fingerprint changes if anything affecting those UserContexts
+     * changes, such as the username, effective user groups, or credentials.
+     * {@link IdentityFingerprint} may be used to generate fingerprints from
+     * these values. UserContexts are only ever reused if produced and
+     * decorated entirely by AuthenticationProviders which allow this via
+     * {@link AuthenticationProvider#isUserContextReusable()}.
+     *
+     * <p>The default implementation returns null, and the UserContexts of
+     * the user will always be updated when re-authenticating.
+     *
+     * @return
+     *     A fingerprint of the identity of this authenticated user, or null if
+     *     no fingerprint is available.
+     */
+    default String getIdentityFingerprint() {
+        return null;
+    }
+
     /**
      * Invalidates this authenticated user and their associated token such that
      * they are no longer logged in. This function will be automatically
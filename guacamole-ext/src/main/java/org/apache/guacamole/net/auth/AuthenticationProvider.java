@@ -241,6 +241,32 @@ public interface AuthenticationProvider {
             AuthenticatedUser authenticatedUser,
             Credentials credentials) throws GuacamoleException;
 
+    /**
+     * Returns whether the UserContexts provided by this
+     * AuthenticationProvider, as well as any decoration it applies to the
+     * UserContexts of other AuthenticationProviders, depend only on the
+     * identity of the user as described by
+     * {@link AuthenticatedUser#getIdentityFingerprint()}. If every
+     * AuthenticationProvider involved in producing a UserContext returns
+     * true, and the fingerprint of the user is unchanged when their session
+     * is re-authenticated without new credentials, the web application may
+     * reuse that UserContext without invoking updateUserContext() or
+     * redecorate(). AuthenticationProviders which did not decorate a
+     * particular UserContext, returning it unchanged from decorate(), are
+     * not considered to be involved in producing that UserContext.
+     *
+     * <p>The default implementation returns false, and updateUserContext()
+     * and redecorate() are always invoked when re-authenticating.
+     *
+     * @return
+     *     true if the UserContexts and decorations of this
+     *     AuthenticationProvider may be reused while the identity fingerprint
+     *     of the user is unchanged, false otherwise.
+     */
+    default boolean isUserContextReusable() {
+        return false;
+    }
+
     /**
      * Frees all resources associated with this AuthenticationProvider. This
      * function will be automatically invoked when the Guacamole server is
@@ -0,0 +1,211 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+package org.apache.guacamole.net.auth;
+
+import java.nio.ByteBuffer;
+import java.nio.charset.StandardCharsets;
+import java.security.GeneralSecurityException;
+import java.security.SecureRandom;
+import java.util.ArrayList;
+import java.util.Base64;
+import java.util.Collections;
+import java.util.List;
+import java.util.Map;
+import java.util.Set;
+import java.util.TreeMap;
+import javax.crypto.Mac;
+import javax.crypto.spec.SecretKeySpec;
+
+/**
+ * Utility class for generating identity fingerprints, as may be returned by
+ * {@link AuthenticatedUser#getIdentityFingerprint()}. A fingerprint is an
+ * HMAC-SHA256 of the username, the effective user groups, and the username
+ * and password within the credentials of an authenticated user, optionally
+ * including any parameter tokens derived from that user's identity. The HMAC
+ * key is generated randomly when this class is loaded and is never exposed,
+ * such that a fingerprint cannot be used to test guesses of the password,
+ * and fingerprints are only comparable within the same running instance of
+ * the web application.
+ */
+public class IdentityFingerprint {
+
+    /**
+     * The name of the HMAC algorithm used to generate fingerprints.
+     */
+    private static final String ALGORITHM = "HmacSHA256";
+
+    /**
+     * The number of bytes in the randomly-generated HMAC key.
+     */
+    private static final int KEY_LENGTH = 32;
+
+    /**
+     * The HMAC key used to generate all fingerprints, generated randomly
+     * when this class is loaded.
+     */
+    private static final SecretKeySpec KEY;
+
+    static {
+        byte[] key = new byte[KEY_LENGTH];
+        new SecureRandom().nextBytes(key);
+        KEY = new SecretKeySpec(key, ALGORITHM);
+    }
+
+    /**
+     * This class is a utility class and should not be instantiated.
+     */
+    private IdentityFingerprint() {}
+
+    /**
+     * Adds the given value to the given HMAC, prefixed with its length such
+     * that the boundaries between consecutive values are unambiguous. A null
+     * value is distinguished from an empty value.
+     *
+     * @param mac
+     *     The HMAC to update.
+     *
+     * @param value
+     *     The value to add to the HMAC, or null.
+     */
+    private static void update(Mac mac, String value) {
+
+        if (value == null) {
+            mac.update(ByteBuffer.allocate(4).putInt(-1).array());
+            return;
+        }
+
+        byte[] bytes = value.getBytes(StandardCharsets.UTF_8);
+        mac.update(ByteBuffer.allocate(4).putInt(bytes.length).array());
+        mac.update(bytes);
+
+    }
+
+    /**
+     * Generates an identity fingerprint from the given username, effective
+     * user groups, and credentials. Two fingerprints are equal only if all
+     * of these are equal, regardless of the order of the user groups.
+     *
+     * @param identifier
+     *     The username of the authenticated user.
+     *
+     * @param effectiveGroups
+     *     The identifiers of all user groups which apply to the authenticated
+     *     user.
+     *
+     * @param credentials
+     *     The credentials provided by the user when they authenticated, or
+     *     null if there are no such credentials.
+     *
+     * @return
+     *     An identity fingerprint of the given username, effective user
+     *     groups, and credentials.
+     */
+    public static String generate(String identifier,
+            Set<String> effectiveGroups, Credentials credentials) {
+        return generate(identifier, effectiveGroups, credentials, null);
+    }
+
+    /**
+     * Generates an identity fingerprint from the given username, effective
+     * user groups, credentials, and parameter tokens. Two fingerprints are
+     * equal only if all of these are equal, regardless of the order of the
+     * user groups or tokens.
+     *
+     * @param identifier
+     *     The username of the authenticated user.
+     *
+     * @param effectiveGroups
+     *     The identifiers of all user groups which apply to the authenticated
+     *     user.
+     *
+     * @param credentials
+     *     The credentials provided by the user when they authenticated, or
+     *     null if there are no such credentials.
+     *
+     * @param tokens
+     *     The parameter tokens derived from the identity of the authenticated
+     *     user, or null if there are no such tokens.
+     *
+     * @return
+     *     An identity fingerprint of the given username, effective user
+     *     groups, credentials, and parameter tokens.
+     */
+    public static String generate(String identifier,
+            Set<String> effectiveGroups, Credentials credentials,
+            Map<String, String> tokens) {
+
+        Mac mac;
+        try {
+            mac = Mac.getInstance(ALGORITHM);
+            mac.init(KEY);
+        }
+        catch (GeneralSecurityException e) {
+            throw new UnsupportedOperationException("Unexpected lack of HMAC-SHA256 support.", e);
+        }
+
+        update(mac, identifier);
+
+        // Group order must not affect the fingerprint
+        List<String> groups = new ArrayList<>(effectiveGroups);
+        Collections.sort(groups);
+        mac.update(ByteBuffer.allocate(4).putInt(groups.size()).array());
+        for (String group : groups)
+            update(mac, group);
+
+        if (credentials != null) {
+            update(mac, credentials.getUsername());
+            update(mac, credentials.getPassword());
+        }
+        else {
+            update(mac, null);
+            update(mac, null);
+        }
+
+        // Token order must not affect the fingerprint
+        if (tokens != null) {
+            Map<String, String> sortedTokens = new TreeMap<>(tokens);
+            mac.update(ByteBuffer.allocate(4).putInt(sortedTokens.size()).array());
+            for (Map.Entry<String, String> token : sortedTokens.entrySet()) {
+                update(mac, token.getKey());
+                update(mac, token.getValue());
+            }
+        }
+
+        return Base64.getEncoder().encodeToString(mac.doFinal());
+
+    }
+
+    /**
+     * Generates an identity fingerprint from the username, effective user
+     * groups, and credentials of the given authenticated user.
+     *
+     * @param authenticatedUser
+     *     The authenticated user to generate a fingerprint for.
+     *
+     * @return
+     *     An identity fingerprint of the given authenticated user.
+     */
+    public static String generate(AuthenticatedUser authenticatedUser) {
+        return generate(authenticatedUser.getIdentifier(),
+                authenticatedUser.getEffectiveUserGroups(),
+                authenticatedUser.getCredentials());
+    }
+
+}
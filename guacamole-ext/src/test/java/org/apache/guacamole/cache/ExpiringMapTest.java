@@ -0,0 +1,268 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+package org.apache.guacamole.cache;
+
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertFalse;
+import static org.junit.Assert.assertNull;
+import static org.junit.Assert.assertTrue;
+import org.junit.Test;
+
+/**
+ * Test which verifies the expiration behavior of ExpiringMap and
+ * ExpiringSet.
+ */
+public class ExpiringMapTest {
+
+    /**
+     * ExpiringMap whose notion of the current time is controlled by the test.
+     */
+    private static class TestMap extends ExpiringMap<String, String> {
+
+        /**
+         * The current time, in milliseconds.
+         */
+        private long now = 0;
+
+        /**
+         * Creates a new TestMap with the given capacity.
+         *
+         * @param capacity
+         *     The maximum number of entries that may be stored within the
+         *     map.
+         */
+        public TestMap(int capacity) {
+            super(capacity);
+        }
+
+        @Override
+        protected long getCurrentTime() {
+            return now;
+        }
+
+    }
+
+    /**
+     * Verifies that entries are available until their expiration timestamp
+     * has passed, regardless of the order in which they were added.
+     */
+    @Test
+    public void testExpiration() {
+
+        TestMap map = new TestMap(Integer.MAX_VALUE);
+        assertTrue(map.putIfAbsent("a", "A", 100));
+        assertTrue(map.putIfAbsent("c", "C", 300));
+        assertTrue(map.putIfAbsent("b", "B", 200));
+        assertEquals(3, map.size());
+
+        map.now = 100;
+        assertEquals("A", map.get("a"));
+
+        map.now = 150;
+        assertNull(map.get("a"));
+        assertEquals("B", map.get("b"));
+        assertEquals(2, map.size());
+
+        map.now = 250;
+        assertFalse(map.containsKey("b"));
+        assertTrue(map.containsKey("c"));
+        assertEquals(1, map.size());
+
+        map.now = 301;
+        assertEquals(0, map.size());
+
+    }
+
+    /**
+     * Verifies that existing entries are not replaced, that removed entries
+     * are no longer available, and that removed keys may be reused.
+     */
+    @Test
+    public void testPutAndRemove() {
+
+        TestMap map = new TestMap(Integer.MAX_VALUE);
+        assertTrue(map.putIfAbsent("a", "A", 100));
+        assertFalse(map.putIfAbsent("a", "other", 200));
+        assertEquals("A", map.remove("a"));
+        assertNull(map.remove("a"));
+
+        // Re-adding a removed key must not be affected by the stale entry
+        // which remains within the expiration queue
+        assertTrue(map.putIfAbsent("a", "A2", 200));
+        map.now = 150;
+        assertEquals("A2", map.get("a"));
+
+        // Entries which have already expired are refused
+        assertFalse(map.putIfAbsent("b", "B", 149));
+
+    }
+
+    /**
+     * Verifies that an entry remains available through the exact millisecond
+     * of its expiration timestamp, expiring only once that timestamp has
+     * passed.
+     */
+    @Test
+    public void testExpirationBoundary() {
+
+        TestMap map = new TestMap(Integer.MAX_VALUE);
+        assertTrue(map.putIfAbsent("a", "A", 100));
+
+        map.now = 100;
+        assertTrue(map.containsKey("a"));
+        assertTrue(map.putIfAbsent("b", "B", 100));
+
+        map.now = 101;
+        assertFalse(map.containsKey("a"));
+        assertFalse(map.containsKey("b"));
+        assertFalse(map.putIfAbsent("c", "C", 100));
+
+    }
+
+    /**
+     * Verifies that put() replaces existing entries, including their
+     * expiration timestamps.
+     */
+    @Test
+    public void testReplace() {
+
+        TestMap map = new TestMap(Integer.MAX_VALUE);
+        assertNull(map.put("a", "A", 100));
+        assertEquals("A", map.put("a", "A2", 300));
+        assertEquals(1, map.size());
+
+        // The stale expiration of the replaced entry must not remove the
+        // entry which replaced it
+        map.now = 200;
+        assertEquals("A2", map.get("a"));
+
+        map.now = 301;
+        assertNull(map.get("a"));
+
+        // Replacing with an already-expired entry removes the existing entry
+        assertNull(map.put("b", "B", 400));
+        assertEquals("B", map.put("b", "B2", 300));
+        assertNull(map.get("b"));
+
+    }
+
+    /**
+     * Verifies that adding an entry while the map is at capacity evicts the
+     * entry which would otherwise expire soonest, regardless of the order in
+     * which entries were added.
+     */
+    @Test
+    public void testCapacity() {
+
+        TestMap map = new TestMap(2);
+        assertTrue(map.putIfAbsent("b", "B", 200));
+        assertTrue(map.putIfAbsent("a", "A", 100));
+        assertTrue(map.putIfAbsent("c", "C", 300));
+        assertEquals(2, map.size());
+        assertNull(map.get("a"));
+        assertEquals("B", map.get("b"));
+        assertEquals("C", map.get("c"));
+
+        // Removed entries must not be counted, nor evicted a second time
+        assertEquals("B", map.remove("b"));
+        assertTrue(map.putIfAbsent("d", "D", 400));
+        assertEquals("C", map.get("c"));
+        assertEquals("D", map.get("d"));
+
+        assertTrue(map.putIfAbsent("e", "E", 50));
+        assertNull(map.get("c"));
+        assertEquals("D", map.get("d"));
+        assertEquals("E", map.get("e"));
+
+    }
+
+    /**
+     * Verifies that entries remain available and expire correctly while
+     * other entries are repeatedly added and removed, such that removed
+     * entries are compacted out of the expiration queues.
+     */
+    @Test
+    public void testRemoveChurn() {
+
+        TestMap map = new TestMap(Integer.MAX_VALUE);
+        assertTrue(map.putIfAbsent("late", "L", 1000000));
+        assertTrue(map.putIfAbsent("early", "E", 10));
+
+        for (int i = 0; i < 10000; i++) {
+            assertTrue(map.putIfAbsent("key-" + i, "value", 100 + (i % 7)));
+            assertEquals("value", map.remove("key-" + i));
+        }
+
+        assertEquals(2, map.size());
+        assertEquals("E", map.get("early"));
+        assertEquals("L", map.get("late"));
+
+        map.now = 11;
+        assertEquals(1, map.size());
+        assertEquals("L", map.get("late"));
+
+    }
+
+    /**
+     * Verifies that ExpiringSet members are consumed by remove() exactly
+     * once.
+     */
+    @Test
+    public void testSet() {
+
+        ExpiringSet<String> set = new ExpiringSet<>();
+        long expires = System.currentTimeMillis() + 60000;
+        assertTrue(set.add("nonce", expires));
+        assertFalse(set.add("nonce", expires));
+        assertTrue(set.contains("nonce"));
+        assertTrue(set.remove("nonce"));
+        assertFalse(set.remove("nonce"));
+
+    }
+
+    /**
+     * Adds and gradually expires 100,000 entries, verifying that all entries
+     * expire. As only expired entries are visited, this completes in time
+     * proportional to the number of entries, whereas a full scan per
+     * insertion would be quadratic.
+     */
+    @Test(timeout = 10000)
+    public void testLargeMap() {
+
+        final int count = 100000;
+        TestMap map = new TestMap(Integer.MAX_VALUE);
+
+        for (int i = 0; i < count; i++)
+            assertTrue(map.putIfAbsent("key-" + i, "value", 60000 + i));
+
+        assertEquals(count, map.size());
+
+        // Advance time gradually, expiring entries in small batches as would
+        // happen as new entries continue to be added
+        for (int i = 0; i < count; i += 100) {
+            map.now = 60000 + i + 100;
+            map.removeExpired();
+        }
+
+        assertEquals(0, map.size());
+
+    }
+
+}
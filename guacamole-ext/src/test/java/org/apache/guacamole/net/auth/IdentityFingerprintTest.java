@@ -0,0 +1,119 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+package org.apache.guacamole.net.auth;
+
+import java.lang.reflect.Proxy;
+import java.util.Arrays;
+import java.util.Collections;
+import java.util.HashSet;
+import java.util.LinkedHashSet;
+import javax.servlet.http.HttpServletRequest;
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertNotEquals;
+import org.junit.Test;
+
+/**
+ * Test which verifies that IdentityFingerprint generates fingerprints which
+ * change if and only if the identity of the user changes.
+ */
+public class IdentityFingerprintTest {
+
+    /**
+     * Returns new Credentials containing the given username and password,
+     * associated with a stub HTTP request.
+     *
+     * @param username
+     *     The username to include within the Credentials.
+     *
+     * @param password
+     *     The password to include within the Credentials.
+     *
+     * @return
+     *     New Credentials containing the given username and password.
+     */
+    private static Credentials credentials(String username, String password) {
+
+        HttpServletRequest request = (HttpServletRequest) Proxy.newProxyInstance(
+                IdentityFingerprintTest.class.getClassLoader(),
+                new Class<?>[] { HttpServletRequest.class },
+                (proxy, method, args) -> null);
+
+        return new Credentials(username, password, request);
+
+    }
+
+    /**
+     * Verifies that fingerprints of identical identities are equal,
+     * regardless of the order of the user groups.
+     */
+    @Test
+    public void testEqualIdentities() {
+
+        Credentials credentials = credentials("user", "pass");
+
+        assertEquals(
+            IdentityFingerprint.generate("user",
+                    new LinkedHashSet<>(Arrays.asList("a", "b", "c")), credentials),
+            IdentityFingerprint.generate("user",
+                    new LinkedHashSet<>(Arrays.asList("c", "b", "a")), credentials)
+        );
+
+    }
+
+    /**
+     * Verifies that changing the username, user groups, password, or tokens
+     * of an identity changes its fingerprint, including where the change
+     * only moves the boundary between adjacent values.
+     */
+    @Test
+    public void testDifferentIdentities() {
+
+        String fingerprint = IdentityFingerprint.generate("user",
+                new HashSet<>(Arrays.asList("a", "b")),
+                credentials("user", "pass"));
+
+        assertNotEquals(fingerprint, IdentityFingerprint.generate("other",
+                new HashSet<>(Arrays.asList("a", "b")),
+                credentials("user", "pass")));
+
+        assertNotEquals(fingerprint, IdentityFingerprint.generate("user",
+                new HashSet<>(Arrays.asList("a")),
+                credentials("user", "pass")));
+
+        assertNotEquals(fingerprint, IdentityFingerprint.generate("user",
+                new HashSet<>(Arrays.asList("ab")),
+                credentials("user", "pass")));
+
+        assertNotEquals(fingerprint, IdentityFingerprint.generate("user",
+                new HashSet<>(Arrays.asList("a", "b")),
+                credentials("user", "other")));
+
+        assertNotEquals(fingerprint, IdentityFingerprint.generate("user",
+                new HashSet<>(Arrays.asList("a", "b")),
+                credentials("user", null)));
+
+        assertNotEquals(fingerprint, IdentityFingerprint.generate("user",
+                new HashSet<>(Arrays.asList("a", "b")),
+                credentials("user", "pass"),
+                Collections.singletonMap("TOKEN", "value")));
+
+    }
+
+}
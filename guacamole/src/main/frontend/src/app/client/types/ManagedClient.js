@@ -36,7 +36,6 @@ angular.module('client').factory('ManagedClient', ['$rootScope', '$injector',
     const ManagedShareLink       = $injector.get('ManagedShareLink');
 
     // Required services
-    const $document               = $injector.get('$document');
     const $q                      = $injector.get('$q');
     const $window                 = $injector.get('$window');
     const activeConnectionService = $injector.get('activeConnectionService');
@@ -146,6 +145,15 @@ angular.module('client').factory('ManagedClient', ['$rootScope', '$injector',
          */
         this.thumbnail = template.thumbnail;
 
+        /**
+         * Whether a new thumbnail is currently being generated for this
+         * connection. Further thumbnail updates are skipped until that
+         * thumbnail is available.
+         *
+         * @type Boolean
+         */
+        this.thumbnailPending = false;
+
         /**
          * The current state of all parameters requested by the server via
          * "required" instructions, where each object key is the name of a
@@ -493,8 +501,10 @@ angular.module('client').factory('ManagedClient', ['$rootScope', '$injector',
             var thumbnail = managedClient.thumbnail;
             var timestamp = new Date().getTime();
 
-            // Update thumbnail if it doesn't exist or is old
-            if (!thumbnail || timestamp - thumbnail.timestamp >= THUMBNAIL_UPDATE_FREQUENCY) {
+            // Update thumbnail if it doesn't exist or is old, skipping the
+            // update entirely if the display has not changed
+            if (!thumbnail || (timestamp - thumbnail.timestamp >= THUMBNAIL_UPDATE_FREQUENCY
+                    && thumbnail.revision !== client.getDisplay().getRevision())) {
                 $rootScope.$apply(function updateClientThumbnail() {
                     ManagedClient.updateThumbnail(managedClient);
                 });
@@ -907,8 +917,8 @@ angular.module('client').factory('ManagedClient', ['$rootScope', '$injector',
 
     /**
      * Store the thumbnail of the given managed client within the connection
-     * history under its associated ID. If the client is not connected, this
-     * function has no effect.
+     * history under its associated ID. If the client is not connected, or a
+     * thumbnail is already being generated, this function has no effect.
      *
      * @param {ManagedClient} managedClient
      *     The client whose history entry should be updated.
@@ -917,35 +927,66 @@ angular.module('client').factory('ManagedClient', ['$rootScope', '$injector',
 
         var display = managedClient.client.getDisplay();
 
+        // Do not start generating another thumbnail while one is already
+        // being generated (sync instructions may arrive much more often than
+        // thumbnails can be generated)
+        if (managedClient.thumbnailPending)
+            return;
+
         // Update stored thumbnail of previous connection
         if (display && display.getWidth() > 0 && display.getHeight() > 0) {
 
-            // Get screenshot
-            var canvas = display.flatten();
+            var revision = display.getRevision();
+            managedClient.thumbnailPending = true;
 
-            // Calculate scale of thumbnail (max 320x240, max zoom 100%)
-            var scale = Math.min(320 / canvas.width, 240 / canvas.height, 1);
+            // Generate thumbnail (max 320x240, max zoom 100%) asynchronously,
+            // scaling only the portions of the display which have changed
+            display.createThumbnail(320, 240, function thumbnailAvailable(thumbnail) {
 
-            // Create thumbnail canvas
-            var thumbnail = $document[0].createElement("canvas");
-            thumbnail.width  = canvas.width*scale;
-            thumbnail.height = canvas.height*scale;
+                if (!thumbnail) {
+                    managedClient.thumbnailPending = false;
+                    return;
+                }
 
-            // Scale screenshot to thumbnail
-            var context = thumbnail.getContext("2d");
-            context.drawImage(canvas,
-                0, 0, canvas.width, canvas.height,
-                0, 0, thumbnail.width, thumbnail.height
-            );
+                // Store updated thumbnail within client, allowing further
+                // updates only once the new thumbnail and its timestamp are
+                // visible to onsync
+                $rootScope.$evalAsync(function storeThumbnail() {
+                    managedClient.thumbnail = new ManagedClientThumbnail({
+                        timestamp : new Date().getTime(),
+                        canvas    : thumbnail,
+                        revision  : revision
+                    });
+                    managedClient.thumbnailPending = false;
+                });
 
-            // Store updated thumbnail within client
-            managedClient.thumbnail = new ManagedClientThumbnail({
-                timestamp : new Date().getTime(),
-                canvas    : thumbnail
-            });
+                // Encode historical thumbnail without blocking, using WebP
+                // where supported (toBlob() falls back to PNG otherwise)
+                if (thumbnail.toBlob) {
+                    thumbnail.toBlob(function thumbnailEncoded(blob) {
+
+                        if (!blob)
+                            return;
+
+                        var reader = new FileReader();
+                        reader.onload = function thumbnailRead() {
+                            $rootScope.$evalAsync(function updateHistory() {
+                                guacHistory.updateThumbnail(managedClient.id, reader.result);
+                            });
+                        };
+                        reader.readAsDataURL(blob);
+
+                    }, 'image/webp', 0.8);
+                }
+
+                // Encode synchronously if toBlob() is unsupported
+                else {
+                    $rootScope.$evalAsync(function updateHistory() {
+                        guacHistory.updateThumbnail(managedClient.id, thumbnail.toDataURL("image/png"));
+                    });
+                }
 
-            // Update historical thumbnail
-            guacHistory.updateThumbnail(managedClient.id, thumbnail.toDataURL("image/png"));
+            });
 
         }
 
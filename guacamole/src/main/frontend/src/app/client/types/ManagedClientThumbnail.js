@@ -51,6 +51,15 @@ angular.module('client').factory('ManagedClientThumbnail', [function defineManag
          */
         this.canvas = template.canvas;
 
+        /**
+         * The revision of the Guacamole client display at the time this
+         * thumbnail was generated, as returned by
+         * Guacamole.Display.getRevision().
+         *
+         * @type Number
+         */
+        this.revision = template.revision;
+
     };
 
     return ManagedClientThumbnail;
@@ -48,6 +48,15 @@ public class GuacamoleSession {
      * The user associated with this session.
      */
     private AuthenticatedUser authenticatedUser;
+
+    /**
+     * The identity fingerprint of the associated user at the time that user
+     * was associated with this session, or null if the user did not provide
+     * a fingerprint. As an AuthenticatedUser may be updated in place when
+     * re-authenticated, this is recorded separately such that later changes
+     * can be detected.
+     */
+    private String identityFingerprint;
     
     /**
      * All UserContexts associated with this session. Each
@@ -89,6 +98,7 @@ public class GuacamoleSession {
             throws GuacamoleException {
         this.lastAccessedTime = System.currentTimeMillis();
         this.authenticatedUser = authenticatedUser;
+        this.identityFingerprint = authenticatedUser.getIdentityFingerprint();
         this.userContexts = userContexts;
     }
 
@@ -111,6 +121,22 @@ public class GuacamoleSession {
      */
     public void setAuthenticatedUser(AuthenticatedUser authenticatedUser) {
         this.authenticatedUser = authenticatedUser;
+        this.identityFingerprint = authenticatedUser.getIdentityFingerprint();
+    }
+
+    /**
+     * Returns the identity fingerprint that the associated user reported
+     * when they were most recently associated with this session, as
+     * returned by {@link AuthenticatedUser#getIdentityFingerprint()} at that
+     * time.
+     *
+     * @return
+     *     The identity fingerprint of the associated user as of their most
+     *     recent association with this session, or null if no fingerprint was
+     *     provided.
+     */
+    public String getIdentityFingerprint() {
+        return identityFingerprint;
     }
 
     /**
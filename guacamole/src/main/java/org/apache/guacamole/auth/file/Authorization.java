@@ -61,6 +61,15 @@ public class Authorization {
      */
     private String password;
 
+    /**
+     * The MD5 hash of the password, decoded from the hex representation stored
+     * within the password, or null if the hash has not yet been decoded. The
+     * hash is decoded only when first needed for validation, such that
+     * parsing a user mapping containing many users does not require decoding
+     * every hash.
+     */
+    private volatile byte[] passwordHash;
+
     /**
      * The encoding used when the password was hashed.
      */
@@ -72,41 +81,6 @@ public class Authorization {
     private Map<String, GuacamoleConfiguration> configs = new
             TreeMap<String, GuacamoleConfiguration>();
 
-    /**
-     * Lookup table of hex bytes characters by value.
-     */
-    private static final char HEX_CHARS[] = {
-        '0', '1', '2', '3', '4', '5', '6', '7',
-        '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'
-    };
-
-    /**
-     * Produces a String containing the bytes provided in hexadecimal notation.
-     *
-     * @param bytes The bytes to convert into hex.
-     * @return A String containing the hex representation of the given bytes.
-     */
-    private static String getHexString(byte[] bytes) {
-
-        // If null byte array given, return null
-        if (bytes == null)
-            return null;
-
-        // Create string builder for holding the hex representation,
-        // pre-calculating the exact length
-        StringBuilder hex = new StringBuilder(2 * bytes.length);
-
-        // Convert each byte into a pair of hex digits
-        for (byte b : bytes) {
-            hex.append(HEX_CHARS[(b & 0xF0) >> 4])
-               .append(HEX_CHARS[ b & 0x0F      ]);
-        }
-
-        // Return the string produced
-        return hex.toString();
-
-    }
-
     /**
      * Returns the username associated with this authorization.
      *
@@ -144,6 +118,7 @@ public class Authorization {
      */
     public void setPassword(String password) {
         this.password = password;
+        this.passwordHash = null;
     }
 
     /**
@@ -163,6 +138,58 @@ public class Authorization {
      */
     public void setEncoding(Encoding encoding) {
         this.encoding = encoding;
+        this.passwordHash = null;
+    }
+
+    /**
+     * Decodes the given String of hexadecimal digits into the bytes it
+     * represents. Both uppercase and lowercase digits are accepted.
+     *
+     * @param hex The String of hexadecimal digits to decode.
+     * @return The bytes represented by the given String, or null if the String
+     *         is not valid hexadecimal.
+     */
+    private static byte[] decodeHexString(String hex) {
+
+        // Hex strings must consist of pairs of digits
+        if (hex == null || hex.length() % 2 != 0)
+            return null;
+
+        byte[] bytes = new byte[hex.length() / 2];
+        for (int i = 0; i < bytes.length; i++) {
+
+            int high = Character.digit(hex.charAt(i * 2),     16);
+            int low  = Character.digit(hex.charAt(i * 2 + 1), 16);
+
+            if (high == -1 || low == -1)
+                return null;
+
+            bytes[i] = (byte) ((high << 4) | low);
+
+        }
+
+        return bytes;
+
+    }
+
+    /**
+     * Returns the MD5 hash of the password associated with this
+     * authorization, decoding that hash from its hex representation if it has
+     * not yet been decoded.
+     *
+     * @return The MD5 hash of the password, or null if the stored password
+     *         is not a valid hex representation of a hash.
+     */
+    private byte[] getPasswordHash() {
+
+        byte[] hash = passwordHash;
+        if (hash == null) {
+            hash = decodeHexString(password);
+            passwordHash = hash;
+        }
+
+        return hash;
+
     }
 
     /**
@@ -194,9 +221,12 @@ public class Authorization {
 
                     // Compare hashed password
                     try {
+                        byte[] hash = getPasswordHash();
+                        if (hash == null)
+                            return false;
+
                         MessageDigest digest = MessageDigest.getInstance("MD5");
-                        String hashedPassword = getHexString(digest.digest(password.getBytes("UTF-8")));
-                        return hashedPassword.equals(this.password.toUpperCase());
+                        return MessageDigest.isEqual(hash, digest.digest(password.getBytes("UTF-8")));
                     }
                     catch (UnsupportedEncodingException e) {
                         throw new UnsupportedOperationException("Unexpected lack of UTF-8 support.", e);
@@ -21,7 +21,15 @@ package org.apache.guacamole.auth.file;
 
 import java.io.File;
 import java.io.IOException;
+import java.nio.file.ClosedWatchServiceException;
+import java.nio.file.FileSystems;
+import java.nio.file.Path;
+import java.nio.file.StandardWatchEventKinds;
+import java.nio.file.WatchEvent;
+import java.nio.file.WatchKey;
+import java.nio.file.WatchService;
 import java.util.Map;
+import java.util.concurrent.TimeUnit;
 import javax.xml.parsers.ParserConfigurationException;
 import javax.xml.parsers.SAXParser;
 import javax.xml.parsers.SAXParserFactory;
@@ -39,7 +47,8 @@ import org.xml.sax.SAXException;
 /**
  * Authenticates users against a static list of username/password pairs.
  * Each username/password may be associated with multiple configurations.
- * This list is stored in an XML file which is reread if modified.
+ * This list is stored in an XML file which is reread in the background if
+ * modified, such that authentication never waits for the file to be parsed.
  */
 public class FileAuthenticationProvider extends SimpleAuthenticationProvider {
 
@@ -48,113 +57,278 @@ public class FileAuthenticationProvider extends SimpleAuthenticationProvider {
      */
     private final Logger logger = LoggerFactory.getLogger(FileAuthenticationProvider.class);
 
+    /**
+     * The maximum number of seconds to wait for a change to the user mapping
+     * file to be reported before explicitly checking its modification time.
+     * This check is a fallback for filesystems where changes are not reliably
+     * reported by a WatchService, such as network filesystems.
+     */
+    private static final long POLL_INTERVAL = 5;
+
+    /**
+     * The number of milliseconds to wait after a change to the user mapping
+     * file is reported before rereading the file, allowing further writes to
+     * the file by the same save operation to complete.
+     */
+    private static final long SETTLE_DELAY = 250;
+
     /**
      * The time the user mapping file was last modified. If the file has never
      * been read, and thus no modification time exists, this will be
-     * Long.MIN_VALUE.
+     * Long.MIN_VALUE. This is only accessed by the thread reading the file.
      */
     private long lastModified = Long.MIN_VALUE;
 
     /**
-     * The parsed UserMapping read when the user mapping file was last parsed.
+     * The parsed UserMapping read when the user mapping file was last parsed,
+     * or null if the file does not exist or could not be parsed. A
+     * UserMapping is never modified once stored here, and is replaced as a
+     * whole when the file is reread.
      */
-    private UserMapping cachedUserMapping;
+    private volatile UserMapping cachedUserMapping;
 
     /**
      * Guacamole server environment.
      */
     private final Environment environment = LocalEnvironment.getInstance();
 
+    /**
+     * The user mapping file within GUACAMOLE_HOME.
+     */
+    private final File userMappingFile;
+
+    /**
+     * The WatchService reporting changes to the contents of GUACAMOLE_HOME, or
+     * null if changes cannot be watched and the modification time of the file
+     * must be polled instead.
+     */
+    private final WatchService watchService;
+
+    /**
+     * The background thread which rereads the user mapping file whenever it
+     * changes.
+     */
+    private final Thread reloadThread;
+
     /**
      * The filename to use for the user mapping.
      */
     public static final String USER_MAPPING_FILENAME = "user-mapping.xml";
-    
+
+    /**
+     * Creates a new FileAuthenticationProvider which reads the user mapping
+     * from GUACAMOLE_HOME/user-mapping.xml. The file is read immediately, and
+     * reread in the background whenever it changes.
+     */
+    public FileAuthenticationProvider() {
+
+        File guacHome = environment.getGuacamoleHome();
+        userMappingFile = new File(guacHome, USER_MAPPING_FILENAME);
+
+        // Read initial user mapping before any authentication attempt
+        reloadUserMapping();
+
+        // Watch GUACAMOLE_HOME for changes, falling back to polling alone if
+        // a WatchService is not available
+        WatchService service = null;
+        try {
+            service = FileSystems.getDefault().newWatchService();
+            guacHome.toPath().register(service,
+                    StandardWatchEventKinds.ENTRY_CREATE,
+                    StandardWatchEventKinds.ENTRY_MODIFY,
+                    StandardWatchEventKinds.ENTRY_DELETE);
+        }
+        catch (IOException | UnsupportedOperationException e) {
+            logger.debug("Changes to \"{}\" cannot be watched and will be "
+                    + "detected by polling only.", guacHome, e);
+            closeQuietly(service);
+            service = null;
+        }
+
+        watchService = service;
+
+        reloadThread = new Thread(new Runnable() {
+
+            @Override
+            public void run() {
+                watchUserMapping();
+            }
+
+        }, "user-mapping-reload");
+        reloadThread.setDaemon(true);
+        reloadThread.start();
+
+    }
+
     @Override
     public String getIdentifier() {
         return "default";
     }
 
     /**
-     * Returns a UserMapping containing all authorization data given within
-     * GUACAMOLE_HOME/user-mapping.xml. If the XML file has been modified or has
-     * not yet been read, this function may reread the file.
+     * Closes the given WatchService, ignoring any errors. If the WatchService
+     * is null, this function has no effect.
      *
-     * @return
-     *     A UserMapping containing all authorization data within the user
-     *     mapping XML file, or null if the file cannot be found/parsed.
+     * @param service
+     *     The WatchService to close, or null.
      */
-    private UserMapping getUserMapping() {
+    private void closeQuietly(WatchService service) {
 
-        // Read user mapping from GUACAMOLE_HOME/user-mapping.xml
-        File userMappingFile = new File(environment.getGuacamoleHome(), USER_MAPPING_FILENAME);
+        if (service == null)
+            return;
 
-        // Abort if user mapping does not exist
-        if (!userMappingFile.exists()) {
-            logger.debug("User mapping file \"{}\" does not exist and will not be read.", userMappingFile);
-            return null;
+        try {
+            service.close();
+        }
+        catch (IOException e) {
+            logger.debug("Unable to close WatchService.", e);
         }
 
-        // Refresh user mapping if file has changed
-        if (lastModified < userMappingFile.lastModified()) {
+    }
 
-            logger.debug("Reading user mapping file: \"{}\"", userMappingFile);
+    /**
+     * Waits for changes to the user mapping file, rereading the file each time
+     * it changes. If no change is reported within the polling interval, the
+     * modification time of the file is checked explicitly. This function
+     * returns only once the provider is shut down.
+     */
+    private void watchUserMapping() {
 
-            // Set up XML parser
-            SAXParser parser;
-            try {
-                parser = SAXParserFactory.newInstance().newSAXParser();
-            }
-            catch (ParserConfigurationException e) {
-                logger.error("Unable to create XML parser for reading \"{}\": {}", USER_MAPPING_FILENAME, e.getMessage());
-                logger.debug("An instance of SAXParser could not be created.", e);
-                return null;
-            }
-            catch (SAXException e) {
-                logger.error("Unable to create XML parser for reading \"{}\": {}", USER_MAPPING_FILENAME, e.getMessage());
-                logger.debug("An instance of SAXParser could not be created.", e);
-                return null;
-            }
+        try {
+            while (!Thread.currentThread().isInterrupted()) {
 
-            // Parse document
-            try {
+                // Simply poll if changes cannot be watched
+                if (watchService == null) {
+                    Thread.sleep(TimeUnit.SECONDS.toMillis(POLL_INTERVAL));
+                    reloadUserMapping();
+                    continue;
+                }
 
-                // Get handler for root element
-                UserMappingTagHandler userMappingHandler =
-                        new UserMappingTagHandler();
+                WatchKey key = watchService.poll(POLL_INTERVAL, TimeUnit.SECONDS);
+                if (key != null) {
 
-                // Set up document handler
-                DocumentHandler contentHandler = new DocumentHandler(
-                        "user-mapping", userMappingHandler);
+                    // Ignore changes to files other than the user mapping
+                    boolean changed = false;
+                    for (WatchEvent<?> event : key.pollEvents()) {
+                        Object context = event.context();
+                        if (event.kind() == StandardWatchEventKinds.OVERFLOW
+                                || (context instanceof Path
+                                    && USER_MAPPING_FILENAME.equals(context.toString())))
+                            changed = true;
+                    }
 
-                // Read and parse file
-                parser.parse(userMappingFile, contentHandler);
+                    key.reset();
 
-                // Store mod time and user mapping
-                lastModified = userMappingFile.lastModified();
-                cachedUserMapping = userMappingHandler.asUserMapping();
+                    // Allow any remaining writes to settle
+                    if (changed)
+                        Thread.sleep(SETTLE_DELAY);
 
-            }
+                }
 
-            // If the file is unreadable, return no mapping
-            catch (IOException e) {
-                logger.warn("Unable to read user mapping file \"{}\": {}", userMappingFile, e.getMessage());
-                logger.debug("Error reading user mapping file.", e);
-                return null;
-            }
+                reloadUserMapping();
 
-            // If the file cannot be parsed, return no mapping
-            catch (SAXException e) {
-                logger.warn("User mapping file \"{}\" is not valid: {}", userMappingFile, e.getMessage());
-                logger.debug("Error parsing user mapping file.", e);
-                return null;
             }
+        }
 
+        // Stop once shut down
+        catch (InterruptedException | ClosedWatchServiceException e) {
+            logger.debug("Stopped watching user mapping file for changes.");
         }
 
-        // Return (possibly cached) user mapping
-        return cachedUserMapping;
+    }
+
+    /**
+     * Rereads GUACAMOLE_HOME/user-mapping.xml if it has been modified or has
+     * not yet been read, replacing the cached UserMapping only once the file
+     * has been completely parsed. If the file does not exist or cannot be
+     * parsed, the cached UserMapping is cleared.
+     */
+    private synchronized void reloadUserMapping() {
+
+        // Clear user mapping if file does not exist
+        if (!userMappingFile.exists()) {
+            if (lastModified != Long.MIN_VALUE || cachedUserMapping != null)
+                logger.debug("User mapping file \"{}\" does not exist and will not be read.", userMappingFile);
+            lastModified = Long.MIN_VALUE;
+            cachedUserMapping = null;
+            return;
+        }
+
+        // Do not reread file if unchanged
+        long modified = userMappingFile.lastModified();
+        if (modified == lastModified)
+            return;
+
+        // Do not reread an invalid file until it changes again
+        lastModified = modified;
+
+        logger.debug("Reading user mapping file: \"{}\"", userMappingFile);
+
+        // Set up XML parser
+        SAXParser parser;
+        try {
+            parser = SAXParserFactory.newInstance().newSAXParser();
+        }
+        catch (ParserConfigurationException e) {
+            logger.error("Unable to create XML parser for reading \"{}\": {}", USER_MAPPING_FILENAME, e.getMessage());
+            logger.debug("An instance of SAXParser could not be created.", e);
+            cachedUserMapping = null;
+            return;
+        }
+        catch (SAXException e) {
+            logger.error("Unable to create XML parser for reading \"{}\": {}", USER_MAPPING_FILENAME, e.getMessage());
+            logger.debug("An instance of SAXParser could not be created.", e);
+            cachedUserMapping = null;
+            return;
+        }
+
+        // Parse document
+        try {
+
+            // Get handler for root element
+            UserMappingTagHandler userMappingHandler =
+                    new UserMappingTagHandler();
+
+            // Set up document handler
+            DocumentHandler contentHandler = new DocumentHandler(
+                    "user-mapping", userMappingHandler);
 
+            // Read and parse file
+            parser.parse(userMappingFile, contentHandler);
+
+            // Atomically replace user mapping only once fully parsed
+            cachedUserMapping = userMappingHandler.asUserMapping();
+
+        }
+
+        // If the file is unreadable, provide no mapping
+        catch (IOException e) {
+            logger.warn("Unable to read user mapping file \"{}\": {}", userMappingFile, e.getMessage());
+            logger.debug("Error reading user mapping file.", e);
+            cachedUserMapping = null;
+        }
+
+        // If the file cannot be parsed, provide no mapping
+        catch (SAXException e) {
+            logger.warn("User mapping file \"{}\" is not valid: {}", userMappingFile, e.getMessage());
+            logger.debug("Error parsing user mapping file.", e);
+            cachedUserMapping = null;
+        }
+
+    }
+
+    /**
+     * Returns a UserMapping containing all authorization data given within
+     * GUACAMOLE_HOME/user-mapping.xml. The file is not read by this function;
+     * the UserMapping returned is the one most recently read in the
+     * background.
+     *
+     * @return
+     *     A UserMapping containing all authorization data within the user
+     *     mapping XML file, or null if the file cannot be found/parsed.
+     */
+    private UserMapping getUserMapping() {
+        return cachedUserMapping;
     }
 
     @Override
@@ -177,4 +351,10 @@ public class FileAuthenticationProvider extends SimpleAuthenticationProvider {
 
     }
 
+    @Override
+    public void shutdown() {
+        reloadThread.interrupt();
+        closeQuietly(watchService);
+    }
+
 }
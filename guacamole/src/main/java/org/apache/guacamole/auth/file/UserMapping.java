@@ -23,7 +23,9 @@ import java.util.HashMap;
 import java.util.Map;
 
 /**
- * Mapping of all usernames to corresponding authorizations.
+ * Mapping of all usernames to corresponding authorizations. A UserMapping is
+ * populated only while the user mapping file is being parsed, and is treated
+ * as read-only once parsing has completed.
  */
 public class UserMapping {
 
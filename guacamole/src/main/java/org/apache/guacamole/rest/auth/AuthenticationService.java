@@ -337,9 +337,84 @@ public class AuthenticationService {
 
     }
 
+    /**
+     * Returns whether the identity of the user of the given existing session
+     * is unchanged following re-authentication, such that UserContexts
+     * produced and decorated only by AuthenticationProviders which allow it
+     * may be reused without being updated. This is only the case if the
+     * user reports an identity fingerprint, that fingerprint is unchanged
+     * since the session was created or last updated, and no new username or
+     * password has been provided.
+     *
+     * @param existingSession
+     *     The current GuacamoleSession.
+     *
+     * @param authenticatedUser
+     *     The AuthenticatedUser that has successfully re-authenticated.
+     *
+     * @param credentials
+     *     The Credentials provided by the user in the most recent
+     *     authentication attempt.
+     *
+     * @return
+     *     true if the identity of the user is unchanged, false otherwise.
+     */
+    private boolean isIdentityUnchanged(GuacamoleSession existingSession,
+            AuthenticatedUser authenticatedUser, Credentials credentials) {
+
+        // New credentials may affect the UserContexts of any provider
+        if (credentials.getUsername() != null || credentials.getPassword() != null)
+            return false;
+
+        String fingerprint = authenticatedUser.getIdentityFingerprint();
+        if (fingerprint == null)
+            return false;
+
+        // The AuthenticatedUser of the session may have been updated in
+        // place, thus the fingerprint recorded by the session must be used
+        AuthenticatedUser previousUser = existingSession.getAuthenticatedUser();
+        return authenticatedUser.getAuthenticationProvider() == previousUser.getAuthenticationProvider()
+                && fingerprint.equals(existingSession.getIdentityFingerprint());
+
+    }
+
+    /**
+     * Returns whether the given UserContext may be reused without being
+     * updated while the identity of its user is unchanged. This is only the
+     * case if the AuthenticationProvider that produced the UserContext and
+     * every AuthenticationProvider that actually decorated it allow such
+     * reuse. Layers whose AuthenticationProviders left the UserContext
+     * unchanged do not affect whether it may be reused.
+     *
+     * @param userContext
+     *     The UserContext to test.
+     *
+     * @return
+     *     true if the given UserContext may be reused without being updated,
+     *     false otherwise.
+     */
+    private boolean isReusable(DecoratedUserContext userContext) {
+
+        // Each layer of actual decoration must be reusable
+        for (DecoratedUserContext layer = userContext; layer != null;
+                layer = layer.getDecoratedUserContext()) {
+            if (layer.isDecorating()
+                    && !layer.getDecoratingAuthenticationProvider().isUserContextReusable())
+                return false;
+        }
+
+        // As must the UserContext itself
+        return userContext.getUndecoratedUserContext()
+                .getAuthenticationProvider().isUserContextReusable();
+
+    }
+
     /**
      * Returns all UserContexts associated with the given AuthenticatedUser,
-     * updating existing UserContexts, if any. If no UserContexts are yet
+     * updating existing UserContexts, if any. If the identity of the user is
+     * unchanged, as determined by its identity fingerprint, existing
+     * UserContexts whose AuthenticationProviders allow it are reused without
+     * being updated. If no UserContexts are yet
      * associated with the given AuthenticatedUser, new UserContexts are
      * generated by polling each available AuthenticationProvider.
      *
@@ -371,10 +446,19 @@ public class AuthenticationService {
         // If UserContexts already exist, update them and add to the list
         if (existingSession != null) {
 
+            boolean identityUnchanged = isIdentityUnchanged(existingSession,
+                    authenticatedUser, credentials);
+
             // Update all old user contexts
             List<DecoratedUserContext> oldUserContexts = existingSession.getUserContexts();
             for (DecoratedUserContext userContext : oldUserContexts) {
 
+                // Reuse UserContexts unaffected by the re-authentication
+                if (identityUnchanged && isReusable(userContext)) {
+                    userContexts.add(userContext);
+                    continue;
+                }
+
                 UserContext oldUserContext = userContext.getUndecoratedUserContext();
 
                 // Update existing UserContext
@@ -49,6 +49,12 @@ public class DecoratedUserContext extends DelegatingUserContext {
      */
     private final DecoratedUserContext decoratedUserContext;
 
+    /**
+     * Whether the AuthenticationProvider associated with this layer actually
+     * applied decoration, rather than returning the UserContext unchanged.
+     */
+    private final boolean decorating;
+
     /**
      * Decorates a newly-created UserContext (as would be returned by
      * getUserContext()), invoking the decorate() function of the given
@@ -196,6 +202,7 @@ public class DecoratedUserContext extends DelegatingUserContext {
         // The wrapped UserContext is undecorated
         this.undecoratedUserContext = userContext;
         this.decoratedUserContext = null;
+        this.decorating = (getDelegateUserContext() != userContext);
 
     }
 
@@ -236,6 +243,7 @@ public class DecoratedUserContext extends DelegatingUserContext {
         // The wrapped UserContext has at least one layer of decoration
         this.undecoratedUserContext = userContext.getUndecoratedUserContext();
         this.decoratedUserContext = userContext;
+        this.decorating = (getDelegateUserContext() != userContext);
 
     }
 
@@ -277,6 +285,7 @@ public class DecoratedUserContext extends DelegatingUserContext {
         // The wrapped UserContext is undecorated
         this.undecoratedUserContext = userContext;
         this.decoratedUserContext = null;
+        this.decorating = (getDelegateUserContext() != userContext);
 
     }
 
@@ -319,6 +328,7 @@ public class DecoratedUserContext extends DelegatingUserContext {
         // The wrapped UserContext has at least one layer of decoration
         this.undecoratedUserContext = userContext.getUndecoratedUserContext();
         this.decoratedUserContext = userContext;
+        this.decorating = (getDelegateUserContext() != userContext);
 
     }
 
@@ -344,6 +354,20 @@ public class DecoratedUserContext extends DelegatingUserContext {
         return decoratingAuthenticationProvider;
     }
 
+    /**
+     * Returns whether the AuthenticationProvider which applied this layer of
+     * decoration actually decorated the UserContext beneath this layer. This
+     * will be false if that AuthenticationProvider originated the
+     * UserContext, or if it returned the UserContext unchanged.
+     *
+     * @return
+     *     true if this layer applies decoration provided by its
+     *     AuthenticationProvider, false otherwise.
+     */
+    public boolean isDecorating() {
+        return decorating;
+    }
+
     /**
      * Returns the DecoratedUserContext representing the next layer of
      * decoration, itself decorated by this DecoratedUserContext. If no further
@@ -0,0 +1,454 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+package org.apache.guacamole.rest.auth;
+
+import com.google.inject.AbstractModule;
+import com.google.inject.Guice;
+import com.google.inject.TypeLiteral;
+import java.lang.reflect.Proxy;
+import java.util.Arrays;
+import java.util.Collections;
+import java.util.HashMap;
+import java.util.List;
+import java.util.Map;
+import javax.servlet.http.HttpServletRequest;
+import org.apache.guacamole.GuacamoleException;
+import org.apache.guacamole.GuacamoleSession;
+import org.apache.guacamole.environment.DelegatingEnvironment;
+import org.apache.guacamole.environment.Environment;
+import org.apache.guacamole.net.auth.AbstractAuthenticatedUser;
+import org.apache.guacamole.net.auth.AbstractAuthenticationProvider;
+import org.apache.guacamole.net.auth.AbstractUserContext;
+import org.apache.guacamole.net.auth.AuthenticatedUser;
+import org.apache.guacamole.net.auth.AuthenticationProvider;
+import org.apache.guacamole.net.auth.Credentials;
+import org.apache.guacamole.net.auth.DelegatingUserContext;
+import org.apache.guacamole.net.auth.IdentityFingerprint;
+import org.apache.guacamole.net.auth.User;
+import org.apache.guacamole.net.auth.UserContext;
+import org.apache.guacamole.net.event.listener.Listener;
+import org.junit.Test;
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertNotSame;
+import static org.junit.Assert.assertSame;
+
+/**
+ * Test which verifies that AuthenticationService reuses the UserContexts of
+ * an existing session when that session is re-authenticated without any
+ * change in identity, and updates those UserContexts otherwise.
+ */
+public class AuthenticationServiceTest {
+
+    /**
+     * AuthenticatedUser which reports an identity fingerprint derived from
+     * its username, groups, and credentials.
+     */
+    private static class TestAuthenticatedUser extends AbstractAuthenticatedUser {
+
+        /**
+         * The AuthenticationProvider that authenticated this user.
+         */
+        private final AuthenticationProvider authProvider;
+
+        /**
+         * The credentials provided when this user authenticated.
+         */
+        private final Credentials credentials;
+
+        /**
+         * Creates a new TestAuthenticatedUser having the username within the
+         * given credentials.
+         *
+         * @param authProvider
+         *     The AuthenticationProvider that authenticated the user.
+         *
+         * @param credentials
+         *     The credentials provided when the user authenticated.
+         */
+        public TestAuthenticatedUser(AuthenticationProvider authProvider,
+                Credentials credentials) {
+            this.authProvider = authProvider;
+            this.credentials = credentials;
+            setIdentifier(credentials.getUsername());
+        }
+
+        @Override
+        public AuthenticationProvider getAuthenticationProvider() {
+            return authProvider;
+        }
+
+        @Override
+        public Credentials getCredentials() {
+            return credentials;
+        }
+
+        @Override
+        public String getIdentityFingerprint() {
+            return IdentityFingerprint.generate(this);
+        }
+
+    }
+
+    /**
+     * UserContext which provides no data.
+     */
+    private static class TestUserContext extends AbstractUserContext {
+
+        /**
+         * The AuthenticationProvider that produced this UserContext.
+         */
+        private final AuthenticationProvider authProvider;
+
+        /**
+         * Creates a new TestUserContext produced by the given
+         * AuthenticationProvider.
+         *
+         * @param authProvider
+         *     The AuthenticationProvider that produced the UserContext.
+         */
+        public TestUserContext(AuthenticationProvider authProvider) {
+            this.authProvider = authProvider;
+        }
+
+        @Override
+        public User self() {
+            return null;
+        }
+
+        @Override
+        public AuthenticationProvider getAuthenticationProvider() {
+            return authProvider;
+        }
+
+    }
+
+    /**
+     * AuthenticationProvider which optionally authenticates users and
+     * produces UserContexts, optionally decorates the UserContexts of other
+     * AuthenticationProviders, and counts the number of times its
+     * UserContexts have been updated.
+     */
+    private static class TestAuthenticationProvider extends AbstractAuthenticationProvider {
+
+        /**
+         * Whether this AuthenticationProvider authenticates users and
+         * produces UserContexts.
+         */
+        private final boolean producing;
+
+        /**
+         * Whether this AuthenticationProvider decorates the UserContexts of
+         * other AuthenticationProviders.
+         */
+        private final boolean decorating;
+
+        /**
+         * The value to return from isUserContextReusable().
+         */
+        private final boolean reusable;
+
+        /**
+         * The number of times updateUserContext() has been invoked.
+         */
+        private int updates = 0;
+
+        /**
+         * Creates a new TestAuthenticationProvider having the given behavior.
+         *
+         * @param producing
+         *     Whether the AuthenticationProvider should authenticate users
+         *     and produce UserContexts.
+         *
+         * @param decorating
+         *     Whether the AuthenticationProvider should decorate the
+         *     UserContexts of other AuthenticationProviders.
+         *
+         * @param reusable
+         *     The value to return from isUserContextReusable().
+         */
+        public TestAuthenticationProvider(boolean producing,
+                boolean decorating, boolean reusable) {
+            this.producing = producing;
+            this.decorating = decorating;
+            this.reusable = reusable;
+        }
+
+        @Override
+        public String getIdentifier() {
+            return "test";
+        }
+
+        @Override
+        public AuthenticatedUser authenticateUser(Credentials credentials)
+                throws GuacamoleException {
+
+            if (!producing)
+                return null;
+
+            return new TestAuthenticatedUser(this, credentials);
+
+        }
+
+        @Override
+        public UserContext getUserContext(AuthenticatedUser authenticatedUser)
+                throws GuacamoleException {
+
+            if (!producing)
+                return null;
+
+            return new TestUserContext(this);
+
+        }
+
+        @Override
+        public UserContext updateUserContext(UserContext context,
+                AuthenticatedUser authenticatedUser, Credentials credentials)
+                throws GuacamoleException {
+            updates++;
+            return new TestUserContext(this);
+        }
+
+        @Override
+        public UserContext decorate(UserContext context,
+                AuthenticatedUser authenticatedUser, Credentials credentials)
+                throws GuacamoleException {
+
+            if (!decorating)
+                return context;
+
+            return new DelegatingUserContext(context);
+
+        }
+
+        @Override
+        public boolean isUserContextReusable() {
+            return reusable;
+        }
+
+    }
+
+    /**
+     * TokenSessionMap which stores sessions in a simple HashMap.
+     */
+    private static class TestTokenSessionMap implements TokenSessionMap {
+
+        /**
+         * All sessions, by auth token.
+         */
+        private final Map<String, GuacamoleSession> sessions = new HashMap<>();
+
+        @Override
+        public void put(String authToken, GuacamoleSession session) {
+            sessions.put(authToken, session);
+        }
+
+        @Override
+        public GuacamoleSession get(String authToken) {
+            return sessions.get(authToken);
+        }
+
+        @Override
+        public GuacamoleSession remove(String authToken) {
+            return sessions.remove(authToken);
+        }
+
+        @Override
+        public void shutdown() {
+            sessions.clear();
+        }
+
+    }
+
+    /**
+     * Creates an AuthenticationService which uses the given
+     * AuthenticationProviders, in order.
+     *
+     * @param authProviders
+     *     The AuthenticationProviders to use.
+     *
+     * @return
+     *     A new AuthenticationService using the given AuthenticationProviders.
+     */
+    private static AuthenticationService createService(
+            AuthenticationProvider... authProviders) {
+
+        final List<AuthenticationProvider> providers = Arrays.asList(authProviders);
+
+        return Guice.createInjector(new AbstractModule() {
+
+            @Override
+            protected void configure() {
+                bind(Environment.class).toInstance(new DelegatingEnvironment(null));
+                bind(new TypeLiteral<List<AuthenticationProvider>>() {}).toInstance(providers);
+                bind(new TypeLiteral<List<Listener>>() {}).toInstance(Collections.<Listener>emptyList());
+                bind(TokenSessionMap.class).toInstance(new TestTokenSessionMap());
+                bind(AuthTokenGenerator.class).toInstance(new AuthTokenGenerator() {
+
+                    private int tokens = 0;
+
+                    @Override
+                    public String getToken() {
+                        return "token-" + (tokens++);
+                    }
+
+                });
+            }
+
+        }).getInstance(AuthenticationService.class);
+
+    }
+
+    /**
+     * Returns new Credentials containing the given username and password and
+     * associated with a stub HTTP request.
+     *
+     * @param username
+     *     The username to include within the Credentials, or null.
+     *
+     * @param password
+     *     The password to include within the Credentials, or null.
+     *
+     * @return
+     *     New Credentials containing the given username and password.
+     */
+    private static Credentials credentials(String username, String password) {
+
+        HttpServletRequest request = (HttpServletRequest) Proxy.newProxyInstance(
+                AuthenticationServiceTest.class.getClassLoader(),
+                new Class<?>[] { HttpServletRequest.class },
+                (proxy, method, args) -> null);
+
+        return new Credentials(username, password, request);
+
+    }
+
+    /**
+     * Authenticates as "user" using the given AuthenticationService, then
+     * re-authenticates the resulting session with the given credentials,
+     * returning the UserContext of that session before and after
+     * re-authentication.
+     *
+     * @param service
+     *     The AuthenticationService to authenticate against.
+     *
+     * @param credentials
+     *     The credentials to provide when re-authenticating.
+     *
+     * @return
+     *     The UserContext of the session prior to re-authentication, followed
+     *     by the UserContext of the session after re-authentication.
+     *
+     * @throws GuacamoleException
+     *     If authentication or re-authentication fails.
+     */
+    private static UserContext[] reauthenticate(AuthenticationService service,
+            Credentials credentials) throws GuacamoleException {
+
+        String token = service.authenticate(credentials("user", "pass"), null);
+        UserContext before = service.getUserContexts(token).get(0);
+
+        assertEquals(token, service.authenticate(credentials, token));
+        UserContext after = service.getUserContexts(token).get(0);
+
+        return new UserContext[] { before, after };
+
+    }
+
+    /**
+     * Verifies that a UserContext is reused on repeat login if its identity
+     * is unchanged and its AuthenticationProvider allows reuse, even if it
+     * has passed through AuthenticationProviders which do not decorate it
+     * and do not allow reuse.
+     *
+     * @throws GuacamoleException
+     *     If authentication or re-authentication fails.
+     */
+    @Test
+    public void testReused() throws GuacamoleException {
+
+        TestAuthenticationProvider provider = new TestAuthenticationProvider(true, false, true);
+        AuthenticationService service = createService(provider,
+                new TestAuthenticationProvider(false, false, false));
+
+        UserContext[] contexts = reauthenticate(service, credentials(null, null));
+        assertSame(contexts[0], contexts[1]);
+        assertEquals(0, provider.updates);
+
+    }
+
+    /**
+     * Verifies that a UserContext is updated on repeat login if new
+     * credentials are provided.
+     *
+     * @throws GuacamoleException
+     *     If authentication or re-authentication fails.
+     */
+    @Test
+    public void testUpdatedForNewCredentials() throws GuacamoleException {
+
+        TestAuthenticationProvider provider = new TestAuthenticationProvider(true, false, true);
+        AuthenticationService service = createService(provider);
+
+        UserContext[] contexts = reauthenticate(service, credentials("user", "pass"));
+        assertNotSame(contexts[0], contexts[1]);
+        assertEquals(1, provider.updates);
+
+    }
+
+    /**
+     * Verifies that a UserContext is updated on repeat login if its
+     * AuthenticationProvider does not allow reuse.
+     *
+     * @throws GuacamoleException
+     *     If authentication or re-authentication fails.
+     */
+    @Test
+    public void testUpdatedIfNotReusable() throws GuacamoleException {
+
+        TestAuthenticationProvider provider = new TestAuthenticationProvider(true, false, false);
+        AuthenticationService service = createService(provider);
+
+        UserContext[] contexts = reauthenticate(service, credentials(null, null));
+        assertNotSame(contexts[0], contexts[1]);
+        assertEquals(1, provider.updates);
+
+    }
+
+    /**
+     * Verifies that a UserContext is updated on repeat login if it has been
+     * decorated by an AuthenticationProvider which does not allow reuse.
+     *
+     * @throws GuacamoleException
+     *     If authentication or re-authentication fails.
+     */
+    @Test
+    public void testUpdatedIfDecorationNotReusable() throws GuacamoleException {
+
+        TestAuthenticationProvider provider = new TestAuthenticationProvider(true, false, true);
+        AuthenticationService service = createService(provider,
+                new TestAuthenticationProvider(false, true, false));
+
+        UserContext[] contexts = reauthenticate(service, credentials(null, null));
+        assertNotSame(contexts[0], contexts[1]);
+        assertEquals(1, provider.updates);
+
+    }
+
+}